@@ -0,0 +1,231 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/bench/bench_cqueue.c
+ * @Description: 双锁队列 hcqueue（轮询/阻塞）与单互斥锁包装 hqueue 的多线程争用对比
+ * @other: None
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/queue/hcqueue.h"
+#include "../src/queue/hqueue.h"
+#include "bench_util.h"
+
+/* 单互斥锁基线：所有生产者与消费者争用同一把锁 */
+typedef struct {
+    pthread_mutex_t lock;
+    hqueue_ptr_t queue;
+} mutex_queue_t;
+
+typedef struct {
+    const char* name;
+    void* (*create)(void);
+    void (*destroy)(void* q);
+    hlib_status_t (*push)(void* q, uint64_t* value);
+    hlib_status_t (*pop)(void* q, uint64_t* value);
+} queue_ops_t;
+
+typedef struct {
+    const queue_ops_t* ops;
+    void* queue;
+    uint32_t per_producer;
+    uint64_t total;
+    atomic_uint_fast64_t consumed;
+    atomic_uint_fast64_t checksum;
+    pthread_barrier_t start;
+} bench_ctx_t;
+
+static uint32_t s_items = 1u << 20;
+
+#if HLIBC_USE_STATIC_ALLOC
+/* 静态模式下队列容量有限，生产者满时等待 */
+#define BENCH_QUEUE_CAPACITY    1024u
+#endif
+
+/* ==================== 被测队列 ==================== */
+
+#if HLIBC_USE_STATIC_ALLOC
+static void* cq_create(void)
+{
+    /* buffer 按缓存行对齐，队列结构体正好位于起始位置，销毁时可直接 free */
+    uint32_t size = HCQUEUE_CALC_BUFFER_SIZE(uint64_t, BENCH_QUEUE_CAPACITY);
+    return hcqueue_create_static(aligned_alloc(HLIBC_CACHE_LINE_SIZE, size), size,
+                                 sizeof(uint64_t));
+}
+
+static void cq_destroy(void* q)
+{
+    hcqueue_destroy_static((hcqueue_ptr_t)q);
+    free(q);
+}
+#else
+static void* cq_create(void) { return hcqueue_create(sizeof(uint64_t)); }
+static void cq_destroy(void* q) { hcqueue_destroy((hcqueue_ptr_t)q); }
+#endif
+
+static hlib_status_t cq_push(void* q, uint64_t* value)
+{
+    return hcqueue_push((hcqueue_ptr_t)q, value, sizeof(*value), NULL);
+}
+
+static hlib_status_t cq_pop(void* q, uint64_t* value)
+{
+    return hcqueue_pop((hcqueue_ptr_t)q, value);
+}
+
+/* 阻塞接口：满/空时睡眠，超时只用于让消费者发现所有数据已被取完 */
+static hlib_status_t cq_push_wait(void* q, uint64_t* value)
+{
+    return hcqueue_push_wait((hcqueue_ptr_t)q, value, sizeof(*value), NULL, -1);
+}
+
+static hlib_status_t cq_pop_wait(void* q, uint64_t* value)
+{
+    return hcqueue_pop_wait((hcqueue_ptr_t)q, value, 10);
+}
+
+static void* mq_create(void)
+{
+    mutex_queue_t* mq = (mutex_queue_t*)malloc(sizeof(*mq));
+    pthread_mutex_init(&mq->lock, NULL);
+#if HLIBC_USE_STATIC_ALLOC
+    uint32_t size = HQUEUE_CALC_BUFFER_SIZE(uint64_t, BENCH_QUEUE_CAPACITY);
+    mq->queue = hqueue_create_static(malloc(size), size, sizeof(uint64_t));
+#else
+    mq->queue = hqueue_create(sizeof(uint64_t));
+#endif
+    return mq;
+}
+
+static void mq_destroy(void* q)
+{
+    mutex_queue_t* mq = (mutex_queue_t*)q;
+    hqueue_destroy(mq->queue);
+#if HLIBC_USE_STATIC_ALLOC
+    free(mq->queue); /* hqueue 结构体位于 buffer 起始位置 */
+#endif
+    pthread_mutex_destroy(&mq->lock);
+    free(mq);
+}
+
+static hlib_status_t mq_push(void* q, uint64_t* value)
+{
+    mutex_queue_t* mq = (mutex_queue_t*)q;
+    pthread_mutex_lock(&mq->lock);
+    hlib_status_t ret = hqueue_push(mq->queue, value, sizeof(*value), NULL);
+    pthread_mutex_unlock(&mq->lock);
+    return ret;
+}
+
+static hlib_status_t mq_pop(void* q, uint64_t* value)
+{
+    mutex_queue_t* mq = (mutex_queue_t*)q;
+    hlib_status_t ret = HLIB_ERROR;
+    pthread_mutex_lock(&mq->lock);
+    if (!hqueue_empty(mq->queue)) {
+        *value = *(uint64_t*)hqueue_front(mq->queue);
+        ret = hqueue_pop(mq->queue);
+    }
+    pthread_mutex_unlock(&mq->lock);
+    return ret;
+}
+
+static const queue_ops_t s_queues[] = {
+    { "hcqueue", cq_create, cq_destroy, cq_push, cq_pop },
+    { "hcqueue wait", cq_create, cq_destroy, cq_push_wait, cq_pop_wait },
+    { "mutex+hqueue", mq_create, mq_destroy, mq_push, mq_pop },
+};
+
+/* ==================== 线程 ==================== */
+
+static void* producer_main(void* arg)
+{
+    bench_ctx_t* ctx = (bench_ctx_t*)arg;
+    pthread_barrier_wait(&ctx->start);
+    for (uint32_t i = 1; i <= ctx->per_producer; ++i) {
+        uint64_t value = i;
+        while (ctx->ops->push(ctx->queue, &value) != HLIB_OK) sched_yield();
+    }
+    return NULL;
+}
+
+static void* consumer_main(void* arg)
+{
+    bench_ctx_t* ctx = (bench_ctx_t*)arg;
+    uint64_t sum = 0;
+    pthread_barrier_wait(&ctx->start);
+    while (atomic_load_explicit(&ctx->consumed, memory_order_relaxed) < ctx->total) {
+        uint64_t value;
+        if (ctx->ops->pop(ctx->queue, &value) == HLIB_OK) {
+            sum += value;
+            atomic_fetch_add_explicit(&ctx->consumed, 1, memory_order_relaxed);
+        } else {
+            sched_yield();
+        }
+    }
+    atomic_fetch_add(&ctx->checksum, sum);
+    return NULL;
+}
+
+static int run(const queue_ops_t* ops, uint32_t producers, uint32_t consumers)
+{
+    bench_ctx_t ctx;
+    pthread_t threads[64];
+    uint32_t n = producers + consumers;
+
+    ctx.ops = ops;
+    ctx.queue = ops->create();
+    ctx.per_producer = s_items / producers;
+    ctx.total = (uint64_t)ctx.per_producer * producers;
+    atomic_init(&ctx.consumed, 0);
+    atomic_init(&ctx.checksum, 0);
+    pthread_barrier_init(&ctx.start, NULL, n + 1);
+
+    for (uint32_t i = 0; i < n; ++i)
+        pthread_create(&threads[i], NULL, i < producers ? producer_main : consumer_main, &ctx);
+    pthread_barrier_wait(&ctx.start);
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t i = 0; i < n; ++i) pthread_join(threads[i], NULL);
+    uint64_t ns = bench_now_ns() - t0;
+
+    uint64_t expect = (uint64_t)producers * ctx.per_producer * (ctx.per_producer + 1) / 2;
+    int ok = atomic_load(&ctx.checksum) == expect;
+    char shape[16];
+    snprintf(shape, sizeof(shape), "%up/%uc", producers, consumers);
+    printf("%-13s %-7s %10.2f Mops/s %8.2f ns/item%s\n", ops->name, shape,
+           (double)ctx.total * 1e3 / (double)ns, (double)ns / (double)ctx.total,
+           ok ? "" : "  CHECKSUM MISMATCH");
+
+    pthread_barrier_destroy(&ctx.start);
+    ops->destroy(ctx.queue);
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t max_threads = 4;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            s_items = 1u << 14;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            max_threads = (uint32_t)strtoul(argv[++i], NULL, 10);
+            if (max_threads == 0 || max_threads > 32) max_threads = 4;
+        } else {
+            fprintf(stderr, "usage: %s [--quick] [--threads N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    int ok = 1;
+    printf("items: %u\n", s_items);
+    for (uint32_t t = 1; t <= max_threads; t *= 2) {
+        for (size_t q = 0; q < sizeof(s_queues) / sizeof(s_queues[0]); ++q)
+            ok &= run(&s_queues[q], t, t);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/bench/bench_executor.c
+ * @Description: hexecutor 任务提交与执行吞吐量随工作线程数的扩展性
+ * @other: None
+ */
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../src/executor/hexecutor.h"
+#include "bench_util.h"
+
+/* 同时未完成的任务数上限，也是批量提交的最大批次 */
+#define BENCH_TASK_CAPACITY     4096u
+#define BENCH_BATCH             256u
+/* 每个任务的计算量 */
+#define BENCH_TASK_WORK         64u
+
+typedef struct {
+    const char* name;
+    void (*run)(hexecutor_ptr_t executor);
+} workload_t;
+
+static uint32_t s_tasks = 1u << 20;
+static uint32_t s_spawn_depth = 19;
+static hexecutor_ptr_t s_executor;
+static atomic_uint_fast64_t s_checksum;
+static atomic_uint_fast64_t s_executed;
+
+/* ==================== 任务 ==================== */
+
+static uint64_t task_work(uint64_t x)
+{
+    for (uint32_t i = 0; i < BENCH_TASK_WORK; ++i)
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+    return x;
+}
+
+static void leaf_task(void* arg)
+{
+    uint64_t v = task_work((uint64_t)(uintptr_t)arg);
+    BENCH_KEEP(v);
+    atomic_fetch_add_explicit(&s_checksum, (uint64_t)(uintptr_t)arg, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s_executed, 1, memory_order_relaxed);
+}
+
+/* 二叉分裂：任务内部提交子任务，走工作线程本地队列与窃取路径 */
+static void spawn_task(void* arg)
+{
+    uintptr_t depth = (uintptr_t)arg;
+    leaf_task((void*)(uintptr_t)1);
+    for (int child = 0; child < 2 && depth > 0; ++child) {
+        /* 任务池满时就地执行，保证不丢任务 */
+        if (hexecutor_submit(s_executor, spawn_task, (void*)(depth - 1)) != HLIB_OK)
+            spawn_task((void*)(depth - 1));
+    }
+}
+
+/* ==================== 负载 ==================== */
+
+/* 外部线程逐个提交 */
+static void run_single(hexecutor_ptr_t executor)
+{
+    for (uint32_t i = 1; i <= s_tasks; ++i) {
+        while (hexecutor_submit(executor, leaf_task, (void*)(uintptr_t)i) != HLIB_OK)
+            sched_yield();
+    }
+    hexecutor_wait_all(executor);
+}
+
+/* 外部线程批量提交 */
+static void run_batch(hexecutor_ptr_t executor)
+{
+    htask_t batch[BENCH_BATCH];
+    uint32_t next = 1;
+    while (next <= s_tasks) {
+        uint32_t n = 0;
+        for (; n < BENCH_BATCH && next + n <= s_tasks; ++n) {
+            batch[n].fn = leaf_task;
+            batch[n].arg = (void*)(uintptr_t)(next + n);
+        }
+        uint32_t done = hexecutor_submit_batch(executor, batch, n);
+        if (done == 0) sched_yield();
+        next += done;
+    }
+    hexecutor_wait_all(executor);
+}
+
+static void run_spawn(hexecutor_ptr_t executor)
+{
+    hexecutor_submit(executor, spawn_task, (void*)(uintptr_t)s_spawn_depth);
+    hexecutor_wait_all(executor);
+}
+
+static const workload_t s_workloads[] = {
+    { "submit", run_single },
+    { "batch", run_batch },
+    { "spawn", run_spawn },
+};
+
+/* ==================== 驱动 ==================== */
+
+static hexecutor_ptr_t executor_create(uint32_t workers)
+{
+#if HLIBC_USE_STATIC_ALLOC
+    /* buffer 按缓存行对齐，线程池结构体正好位于起始位置，销毁时可直接 free */
+    uint32_t size = HEXECUTOR_CALC_BUFFER_SIZE(workers, BENCH_TASK_CAPACITY);
+    return hexecutor_create_static(aligned_alloc(HLIBC_CACHE_LINE_SIZE, size), size,
+                                   workers, BENCH_TASK_CAPACITY);
+#else
+    return hexecutor_create(workers, BENCH_TASK_CAPACITY);
+#endif
+}
+
+static void executor_destroy(hexecutor_ptr_t executor)
+{
+    hexecutor_destroy(executor);
+#if HLIBC_USE_STATIC_ALLOC
+    free(executor);
+#endif
+}
+
+static int run(const workload_t* workload, uint32_t workers, double* base_rate)
+{
+    s_executor = executor_create(workers);
+    if (s_executor == NULL) {
+        printf("%-7s %3u workers: create failed\n", workload->name, workers);
+        return 0;
+    }
+    atomic_store(&s_checksum, 0);
+    atomic_store(&s_executed, 0);
+
+    uint64_t t0 = bench_now_ns();
+    workload->run(s_executor);
+    uint64_t ns = bench_now_ns() - t0;
+
+    uint64_t executed = atomic_load(&s_executed);
+    uint64_t expect_tasks, expect_sum;
+    if (workload->run == run_spawn) {
+        expect_tasks = (2ull << s_spawn_depth) - 1;
+        expect_sum = expect_tasks;
+    } else {
+        expect_tasks = s_tasks;
+        expect_sum = (uint64_t)s_tasks * (s_tasks + 1) / 2;
+    }
+    int ok = executed == expect_tasks && atomic_load(&s_checksum) == expect_sum;
+
+    double rate = (double)executed * 1e3 / (double)ns;
+    if (workers == 1) *base_rate = rate;
+    printf("%-7s %3u workers %10.2f Mtasks/s %8.2f ns/task  x%.2f%s\n", workload->name, workers,
+           rate, (double)ns / (double)executed, rate / *base_rate,
+           ok ? "" : "  CHECKSUM MISMATCH");
+
+    executor_destroy(s_executor);
+    s_executor = NULL;
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t max_workers = cpus > 0 ? (uint32_t)cpus : 1u;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            s_tasks = 1u << 14;
+            s_spawn_depth = 13;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            max_workers = (uint32_t)strtoul(argv[++i], NULL, 10);
+            if (max_workers == 0 || max_workers > 256) max_workers = 4;
+        } else {
+            fprintf(stderr, "usage: %s [--quick] [--threads N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    int ok = 1;
+    printf("tasks: %u, spawn depth: %u, max workers: %u\n", s_tasks, s_spawn_depth, max_workers);
+    for (size_t w = 0; w < sizeof(s_workloads) / sizeof(s_workloads[0]); ++w) {
+        double base_rate = 0.0;
+        /* 1, 2, 4, ... 直到 max_workers（不是 2 的幂时最后补测一次） */
+        for (uint32_t t = 1;; t = t * 2 < max_workers ? t * 2 : max_workers) {
+            ok &= run(&s_workloads[w], t, &base_rate);
+            if (t == max_workers) break;
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/bench/bench_hist.h
+ * @Description: 基准测试公共工具：HDR 风格的对数-线性延迟直方图
+ * @other: None
+ */
+#ifndef __HLIBC_BENCH_HIST_H__
+#define __HLIBC_BENCH_HIST_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <string.h>
+
+/*********************
+ *      MACROS
+ *********************/
+
+/*
+ * 每个 2 的幂区间分成 2^BENCH_HIST_SUB_BITS 个等宽的桶，小于 2^BENCH_HIST_SUB_BITS 的值精确记录，
+ * 相对误差不超过 1 / 2^BENCH_HIST_SUB_BITS（默认约 3%），覆盖整个 uint64_t 范围
+ */
+#define BENCH_HIST_SUB_BITS     5u
+#define BENCH_HIST_SUB_COUNT    (1u << BENCH_HIST_SUB_BITS)
+#define BENCH_HIST_BUCKETS      ((64u - BENCH_HIST_SUB_BITS + 1u) << BENCH_HIST_SUB_BITS)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint64_t counts[BENCH_HIST_BUCKETS];
+    uint64_t total;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+} bench_hist_t;
+
+/**********************
+ *   INLINE FUNCTIONS
+ **********************/
+
+static inline void bench_hist_init(bench_hist_t* hist)
+{
+    memset(hist, 0, sizeof(*hist));
+    hist->min = UINT64_MAX;
+}
+
+/* 值 -> 桶下标：shift 为值在桶内被舍去的低位数，桶下标 = shift * SUB_COUNT + 最高的 SUB_BITS + 1 位 */
+static inline uint32_t bench_hist_index(uint64_t value)
+{
+    if (value < BENCH_HIST_SUB_COUNT) return (uint32_t)value;
+    uint32_t shift = (uint32_t)(63 - __builtin_clzll(value)) - BENCH_HIST_SUB_BITS;
+    return shift * BENCH_HIST_SUB_COUNT + (uint32_t)(value >> shift);
+}
+
+/* 桶中的最大值（与 HdrHistogram 一样，分位数按桶的上界报告，不会低估） */
+static inline uint64_t bench_hist_bucket_max(uint32_t index)
+{
+    if (index < 2 * BENCH_HIST_SUB_COUNT) return index;
+    uint32_t shift = index / BENCH_HIST_SUB_COUNT - 1u;
+    uint64_t top = BENCH_HIST_SUB_COUNT + index % BENCH_HIST_SUB_COUNT;
+    return ((top + 1u) << shift) - 1u;
+}
+
+static inline void bench_hist_record(bench_hist_t* hist, uint64_t value)
+{
+    ++hist->counts[bench_hist_index(value)];
+    ++hist->total;
+    hist->sum += value;
+    if (value < hist->min) hist->min = value;
+    if (value > hist->max) hist->max = value;
+}
+
+/* 把 src 合并到 dst，各线程分别记录后在结束时汇总 */
+static inline void bench_hist_merge(bench_hist_t* dst, const bench_hist_t* src)
+{
+    for (uint32_t i = 0; i < BENCH_HIST_BUCKETS; ++i) dst->counts[i] += src->counts[i];
+    dst->total += src->total;
+    dst->sum += src->sum;
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+}
+
+/**
+ * 分位数：至少 q 比例的记录不大于返回值
+ * @param q 0 到 1 之间，1 返回精确的最大值
+ */
+static inline uint64_t bench_hist_percentile(const bench_hist_t* hist, double q)
+{
+    if (hist->total == 0) return 0;
+    if (q >= 1.0) return hist->max;
+    /* 第 ceil(q * total) 个记录 */
+    double target = q * (double)hist->total;
+    uint64_t rank = (uint64_t)target;
+    if ((double)rank < target || rank == 0) ++rank;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < BENCH_HIST_BUCKETS; ++i) {
+        seen += hist->counts[i];
+        if (seen >= rank) {
+            uint64_t v = bench_hist_bucket_max(i);
+            return v < hist->max ? v : hist->max;
+        }
+    }
+    return hist->max;
+}
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __HLIBC_BENCH_HIST_H__ */
@@ -0,0 +1,409 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/bench/bench_latency.c
+ * @Description: 线程间交接延迟：每个元素在 push 时打时间戳、在 pop 时计算耗时，按直方图报告尾延迟
+ * @other: None
+ */
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/queue/hcqueue.h"
+#include "../src/queue/hqueue.h"
+#include "../src/stack/hwsdeque.h"
+#include "bench_hist.h"
+#include "bench_util.h"
+
+#define BENCH_MAX_THREADS       64u
+/* 消费者空转多少次后让出 CPU */
+#define BENCH_SPIN_LIMIT        256u
+
+#if HLIBC_USE_STATIC_ALLOC
+/* 静态模式下队列容量有限，生产者满时重试，重试时重新打时间戳 */
+#define BENCH_QUEUE_CAPACITY    1024u
+#endif
+
+/* 单互斥锁基线：所有生产者与消费者争用同一把锁 */
+typedef struct {
+    pthread_mutex_t lock;
+    hqueue_ptr_t queue;
+} mutex_queue_t;
+
+typedef struct {
+    const char* name;
+    bool single_producer;       /* 只允许一个生产者（工作窃取队列的拥有者） */
+    void* (*create)(void);
+    void (*destroy)(void* q);
+    hlib_status_t (*push)(void* q, uint64_t* value);
+    hlib_status_t (*pop)(void* q, uint64_t* value);
+} queue_ops_t;
+
+typedef struct {
+    uint32_t items;             /* 每个生产者放入的元素数 */
+    uint32_t producers;
+    uint32_t consumers;
+    uint64_t interval_ns;       /* 每个生产者相邻两次 push 的间隔，0 表示不限速 */
+    uint32_t cpu_count;         /* cpus 中的有效项数，0 表示不绑定 */
+    int cpus[BENCH_MAX_THREADS];
+} options_t;
+
+typedef struct bench_ctx bench_ctx_t;
+
+typedef struct {
+    bench_ctx_t* ctx;
+    uint32_t index;             /* 线程序号：先生产者后消费者，也是绑定 CPU 的序号 */
+    bench_hist_t hist;          /* 消费者各自记录，结束后合并 */
+} thread_arg_t;
+
+struct bench_ctx {
+    const queue_ops_t* ops;
+    const options_t* opt;
+    void* queue;
+    uint64_t total;
+    atomic_uint_fast64_t consumed;
+    pthread_barrier_t start;
+};
+
+/* ==================== 被测队列 ==================== */
+
+#if HLIBC_USE_STATIC_ALLOC
+static void* cq_create(void)
+{
+    /* buffer 按缓存行对齐，队列结构体正好位于起始位置，销毁时可直接 free */
+    uint32_t size = HCQUEUE_CALC_BUFFER_SIZE(uint64_t, BENCH_QUEUE_CAPACITY);
+    return hcqueue_create_static(aligned_alloc(HLIBC_CACHE_LINE_SIZE, size), size,
+                                 sizeof(uint64_t));
+}
+
+static void cq_destroy(void* q)
+{
+    hcqueue_destroy_static((hcqueue_ptr_t)q);
+    free(q);
+}
+#else
+static void* cq_create(void) { return hcqueue_create(sizeof(uint64_t)); }
+static void cq_destroy(void* q) { hcqueue_destroy((hcqueue_ptr_t)q); }
+#endif
+
+static hlib_status_t cq_push(void* q, uint64_t* value)
+{
+    return hcqueue_push((hcqueue_ptr_t)q, value, sizeof(*value), NULL);
+}
+
+static hlib_status_t cq_pop(void* q, uint64_t* value)
+{
+    return hcqueue_pop((hcqueue_ptr_t)q, value);
+}
+
+/* 阻塞接口：空时睡眠，超时只用于让消费者发现所有数据已被取完 */
+static hlib_status_t cq_pop_wait(void* q, uint64_t* value)
+{
+    return hcqueue_pop_wait((hcqueue_ptr_t)q, value, 10);
+}
+
+#if HLIBC_USE_STATIC_ALLOC
+static void* ws_create(void)
+{
+    uint32_t size = HWSDEQUE_CALC_BUFFER_SIZE(uint64_t, BENCH_QUEUE_CAPACITY);
+    void* buffer = malloc(size);
+    hwsdeque_ptr_t deque = hwsdeque_create_static(buffer, size, sizeof(uint64_t));
+    /* 容器位于 buffer 内部（按缓存行对齐），记下 buffer 以便释放 */
+    void** box = (void**)malloc(2 * sizeof(void*));
+    box[0] = deque;
+    box[1] = buffer;
+    return box;
+}
+
+static void ws_destroy(void* q)
+{
+    void** box = (void**)q;
+    hwsdeque_destroy_static((hwsdeque_ptr_t)box[0]);
+    free(box[1]);
+    free(box);
+}
+
+#define WS_DEQUE(q) ((hwsdeque_ptr_t)((void**)(q))[0])
+#else
+static void* ws_create(void) { return hwsdeque_create(sizeof(uint64_t), 0); }
+static void ws_destroy(void* q) { hwsdeque_destroy((hwsdeque_ptr_t)q); }
+
+#define WS_DEQUE(q) ((hwsdeque_ptr_t)(q))
+#endif
+
+/* 拥有者在 bottom 端放入，消费者从 top 端窃取：先进先出的交接 */
+static hlib_status_t ws_push(void* q, uint64_t* value)
+{
+    return hwsdeque_push(WS_DEQUE(q), value, sizeof(*value));
+}
+
+static hlib_status_t ws_steal(void* q, uint64_t* value)
+{
+    return hwsdeque_steal(WS_DEQUE(q), value);
+}
+
+static void* mq_create(void)
+{
+    mutex_queue_t* mq = (mutex_queue_t*)malloc(sizeof(*mq));
+    pthread_mutex_init(&mq->lock, NULL);
+#if HLIBC_USE_STATIC_ALLOC
+    uint32_t size = HQUEUE_CALC_BUFFER_SIZE(uint64_t, BENCH_QUEUE_CAPACITY);
+    mq->queue = hqueue_create_static(malloc(size), size, sizeof(uint64_t));
+#else
+    mq->queue = hqueue_create(sizeof(uint64_t));
+#endif
+    return mq;
+}
+
+static void mq_destroy(void* q)
+{
+    mutex_queue_t* mq = (mutex_queue_t*)q;
+    hqueue_destroy(mq->queue);
+#if HLIBC_USE_STATIC_ALLOC
+    free(mq->queue); /* hqueue 结构体位于 buffer 起始位置 */
+#endif
+    pthread_mutex_destroy(&mq->lock);
+    free(mq);
+}
+
+static hlib_status_t mq_push(void* q, uint64_t* value)
+{
+    mutex_queue_t* mq = (mutex_queue_t*)q;
+    pthread_mutex_lock(&mq->lock);
+    hlib_status_t ret = hqueue_push(mq->queue, value, sizeof(*value), NULL);
+    pthread_mutex_unlock(&mq->lock);
+    return ret;
+}
+
+static hlib_status_t mq_pop(void* q, uint64_t* value)
+{
+    mutex_queue_t* mq = (mutex_queue_t*)q;
+    hlib_status_t ret = HLIB_ERROR;
+    pthread_mutex_lock(&mq->lock);
+    if (!hqueue_empty(mq->queue)) {
+        *value = *(uint64_t*)hqueue_front(mq->queue);
+        ret = hqueue_pop(mq->queue);
+    }
+    pthread_mutex_unlock(&mq->lock);
+    return ret;
+}
+
+static const queue_ops_t s_queues[] = {
+    { "hcqueue", false, cq_create, cq_destroy, cq_push, cq_pop },
+    { "hcqueue wait", false, cq_create, cq_destroy, cq_push, cq_pop_wait },
+    { "hwsdeque", true, ws_create, ws_destroy, ws_push, ws_steal },
+    { "mutex+hqueue", false, mq_create, mq_destroy, mq_push, mq_pop },
+};
+
+/* ==================== 线程 ==================== */
+
+/* 把当前线程绑定到第 index 个指定的 CPU（循环使用） */
+static void pin_thread(const options_t* opt, uint32_t index)
+{
+    if (opt->cpu_count == 0) return;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(opt->cpus[index % opt->cpu_count], &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+        fprintf(stderr, "warning: cannot pin thread %u to cpu %d\n", index,
+                opt->cpus[index % opt->cpu_count]);
+#endif
+}
+
+static void* producer_main(void* p)
+{
+    thread_arg_t* arg = (thread_arg_t*)p;
+    bench_ctx_t* ctx = arg->ctx;
+    const options_t* opt = ctx->opt;
+    pin_thread(opt, arg->index);
+    pthread_barrier_wait(&ctx->start);
+
+    uint64_t next = bench_now_ns();
+    for (uint32_t i = 0; i < opt->items; ++i) {
+        /* 限速：忙等到预定的发送时间，不让睡眠的唤醒延迟混进结果 */
+        if (opt->interval_ns != 0) {
+            next += opt->interval_ns;
+            while (bench_now_ns() < next) {
+            }
+        }
+        uint64_t stamp = bench_now_ns();
+        while (ctx->ops->push(ctx->queue, &stamp) != HLIB_OK) {
+            sched_yield();
+            stamp = bench_now_ns();
+        }
+    }
+    return NULL;
+}
+
+static void* consumer_main(void* p)
+{
+    thread_arg_t* arg = (thread_arg_t*)p;
+    bench_ctx_t* ctx = arg->ctx;
+    uint32_t idle = 0;
+    pin_thread(ctx->opt, arg->index);
+    pthread_barrier_wait(&ctx->start);
+
+    while (atomic_load_explicit(&ctx->consumed, memory_order_relaxed) < ctx->total) {
+        uint64_t stamp;
+        if (ctx->ops->pop(ctx->queue, &stamp) == HLIB_OK) {
+            bench_hist_record(&arg->hist, bench_now_ns() - stamp);
+            atomic_fetch_add_explicit(&ctx->consumed, 1, memory_order_relaxed);
+            idle = 0;
+        } else if (++idle >= BENCH_SPIN_LIMIT) {
+            sched_yield();
+            idle = 0;
+        }
+    }
+    return NULL;
+}
+
+static int run(const queue_ops_t* ops, const options_t* opt)
+{
+    bench_ctx_t ctx;
+    pthread_t threads[BENCH_MAX_THREADS];
+    uint32_t n = opt->producers + opt->consumers;
+    thread_arg_t* args = (thread_arg_t*)malloc(n * sizeof(thread_arg_t));
+    if (args == NULL) return 0;
+
+    ctx.ops = ops;
+    ctx.opt = opt;
+    ctx.queue = ops->create();
+    ctx.total = (uint64_t)opt->items * opt->producers;
+    atomic_init(&ctx.consumed, 0);
+    pthread_barrier_init(&ctx.start, NULL, n);
+
+    for (uint32_t i = 0; i < n; ++i) {
+        args[i].ctx = &ctx;
+        args[i].index = i;
+        bench_hist_init(&args[i].hist);
+        pthread_create(&threads[i], NULL, i < opt->producers ? producer_main : consumer_main,
+                       &args[i]);
+    }
+    for (uint32_t i = 0; i < n; ++i) pthread_join(threads[i], NULL);
+
+    bench_hist_t hist;
+    bench_hist_init(&hist);
+    for (uint32_t i = opt->producers; i < n; ++i) bench_hist_merge(&hist, &args[i].hist);
+
+    int ok = hist.total == ctx.total;
+    char shape[16];
+    snprintf(shape, sizeof(shape), "%up/%uc", opt->producers, opt->consumers);
+    printf("%-13s %-7s %10.1f %10llu %10llu %10llu %10llu%s\n", ops->name, shape,
+           hist.total ? (double)hist.sum / (double)hist.total : 0.0,
+           (unsigned long long)bench_hist_percentile(&hist, 0.50),
+           (unsigned long long)bench_hist_percentile(&hist, 0.99),
+           (unsigned long long)bench_hist_percentile(&hist, 0.999),
+           (unsigned long long)hist.max, ok ? "" : "  COUNT MISMATCH");
+
+    pthread_barrier_destroy(&ctx.start);
+    ops->destroy(ctx.queue);
+    free(args);
+    return ok;
+}
+
+/* ==================== 命令行 ==================== */
+
+/* 解析 "0,2,4-7" 形式的 CPU 列表 */
+static bool parse_cpus(const char* text, options_t* opt)
+{
+    opt->cpu_count = 0;
+    while (*text != '\0') {
+        char* end;
+        long first = strtol(text, &end, 10);
+        long last = first;
+        if (end == text || first < 0) return false;
+        if (*end == '-') {
+            text = end + 1;
+            last = strtol(text, &end, 10);
+            if (end == text || last < first) return false;
+        }
+        for (long cpu = first; cpu <= last && opt->cpu_count < BENCH_MAX_THREADS; ++cpu)
+            opt->cpus[opt->cpu_count++] = (int)cpu;
+        if (*end == ',') ++end;
+        else if (*end != '\0') return false;
+        text = end;
+    }
+    return opt->cpu_count != 0;
+}
+
+/* 依次绑定到进程当前允许使用的 CPU */
+static void default_cpus(options_t* opt)
+{
+    opt->cpu_count = 0;
+#ifdef __linux__
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) return;
+    for (int cpu = 0; cpu < CPU_SETSIZE && opt->cpu_count < BENCH_MAX_THREADS; ++cpu)
+        if (CPU_ISSET(cpu, &set)) opt->cpus[opt->cpu_count++] = cpu;
+#endif
+}
+
+static void usage(const char* argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--quick] [--items N] [--producers P] [--consumers C]\n"
+            "          [--interval NS] [--pin | --cpus LIST]\n"
+            "  --items N      items pushed by each producer (default 1048576)\n"
+            "  --producers P  producer threads (default 1)\n"
+            "  --consumers C  consumer threads (default 1)\n"
+            "  --interval NS  pace each producer to one push every NS ns (default 1000, 0 = flat out)\n"
+            "  --pin          pin thread i to the i-th CPU this process may run on\n"
+            "  --cpus LIST    pin thread i to the i-th CPU of LIST, e.g. 0,2,4-7\n"
+            "threads are numbered producers first, then consumers\n",
+            argv0);
+}
+
+int main(int argc, char** argv)
+{
+    options_t opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.items = 1u << 20;
+    opt.producers = 1;
+    opt.consumers = 1;
+    opt.interval_ns = 1000;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            opt.items = 1u << 12;
+        } else if (strcmp(argv[i], "--items") == 0 && i + 1 < argc) {
+            opt.items = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--producers") == 0 && i + 1 < argc) {
+            opt.producers = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--consumers") == 0 && i + 1 < argc) {
+            opt.consumers = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+            opt.interval_ns = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--pin") == 0) {
+            default_cpus(&opt);
+        } else if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc) {
+            if (!parse_cpus(argv[++i], &opt)) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (opt.items == 0 || opt.producers == 0 || opt.consumers == 0 ||
+        opt.producers + opt.consumers > BENCH_MAX_THREADS) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    int ok = 1;
+    printf("items/producer: %u, interval: %llu ns, pinned: %s, latency in ns\n", opt.items,
+           (unsigned long long)opt.interval_ns, opt.cpu_count ? "yes" : "no");
+    printf("%-13s %-7s %10s %10s %10s %10s %10s\n", "queue", "shape", "mean", "p50", "p99",
+           "p99.9", "max");
+    for (size_t q = 0; q < sizeof(s_queues) / sizeof(s_queues[0]); ++q) {
+        /* 工作窃取队列只有拥有者能放入 */
+        if (s_queues[q].single_producer && opt.producers != 1) continue;
+        ok &= run(&s_queues[q], &opt);
+    }
+    return ok ? 0 : 1;
+}
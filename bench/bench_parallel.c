@@ -0,0 +1,244 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/bench/bench_parallel.c
+ * @Description: hparallel 并行遍历/归约/计数随工作线程数的扩展性
+ * @other: None
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../src/executor/hparallel.h"
+#include "bench_util.h"
+
+#define BENCH_TASK_CAPACITY     256u
+/* 每个负载重复的遍数，取最快的一遍 */
+#define BENCH_ROUNDS            5u
+
+typedef struct {
+    uint64_t id;
+    uint32_t flags;
+    float value;
+} record_t;
+
+typedef struct {
+    uint64_t id_sum;
+    uint64_t count;
+    double value_sum;
+} summary_t;
+
+typedef struct {
+    const char* name;
+    uint64_t (*run)(hexecutor_ptr_t executor, const hparallel_range_t* range);
+} workload_t;
+
+static uint32_t s_records = 1u << 22;
+
+/* ==================== 回调 ==================== */
+
+static uint32_t record_hash(uint64_t id)
+{
+    id ^= id >> 33;
+    id *= 0xff51afd7ed558ccdull;
+    id ^= id >> 33;
+    return (uint32_t)id;
+}
+
+/* 原地重算标志位，结果只取决于 id，重复执行结果不变 */
+static bool tag_span(hdata_ptr_t base, uint32_t count, void* ctx)
+{
+    record_t* rec = (record_t*)base;
+    (void)ctx;
+    for (uint32_t i = 0; i < count; ++i) rec[i].flags = record_hash(rec[i].id);
+    return true;
+}
+
+static void summary_fold(hdata_ptr_t acc, hcdata_ptr_t base, uint32_t count, void* ctx)
+{
+    summary_t* sum = (summary_t*)acc;
+    const record_t* rec = (const record_t*)base;
+    (void)ctx;
+    for (uint32_t i = 0; i < count; ++i) {
+        sum->id_sum += rec[i].id;
+        sum->value_sum += rec[i].value;
+    }
+    sum->count += count;
+}
+
+static void summary_combine(hdata_ptr_t acc, hcdata_ptr_t other, void* ctx)
+{
+    summary_t* sum = (summary_t*)acc;
+    const summary_t* part = (const summary_t*)other;
+    (void)ctx;
+    sum->id_sum += part->id_sum;
+    sum->count += part->count;
+    sum->value_sum += part->value_sum;
+}
+
+static bool flagged(hcdata_ptr_t data, void* ctx)
+{
+    (void)ctx;
+    return (((const record_t*)data)->flags & 7u) == 0;
+}
+
+/* ==================== 负载：返回值用于与串行结果比对 ==================== */
+
+static uint64_t run_for_each(hexecutor_ptr_t executor, const hparallel_range_t* range)
+{
+    return hparallel_for_each(executor, range, tag_span, NULL);
+}
+
+static uint64_t run_reduce(hexecutor_ptr_t executor, const hparallel_range_t* range)
+{
+    summary_t sum = { 0, 0, 0.0 };
+    hparallel_reduce(executor, range, &sum, sizeof(sum), summary_fold, summary_combine, NULL);
+    BENCH_KEEP(sum.value_sum);
+    return sum.id_sum ^ (sum.count << 40);
+}
+
+static uint64_t run_count_if(hexecutor_ptr_t executor, const hparallel_range_t* range)
+{
+    return hparallel_count_if(executor, range, flagged, NULL);
+}
+
+static const workload_t s_workloads[] = {
+    { "for_each", run_for_each },
+    { "reduce", run_reduce },
+    { "count_if", run_count_if },
+};
+
+/* ==================== 数据 ==================== */
+
+#if HLIBC_USE_STATIC_ALLOC
+/* 静态模式：数据放在开启覆盖模式的环形队列中，多写入三分之一使其回绕，遍历时分成两段 */
+static void* s_queue_buffer;
+
+static void data_create(hparallel_range_t* range)
+{
+    uint32_t size = HQUEUE_CALC_BUFFER_SIZE(record_t, s_records);
+    s_queue_buffer = aligned_alloc(HLIBC_STATIC_ALIGN, HLIBC_ALIGN_UP(size, HLIBC_STATIC_ALIGN));
+    hqueue_ptr_t queue = hqueue_create_static(s_queue_buffer, size, sizeof(record_t));
+    hqueue_set_overwrite(queue, true);
+    for (uint32_t i = 0; i < s_records + s_records / 3; ++i) {
+        record_t rec = { i, 0, (float)(i % 1000) * 0.5f };
+        hqueue_push(queue, &rec, sizeof(rec), NULL);
+    }
+    hparallel_range_hqueue(range, queue);
+}
+
+static void data_destroy(void)
+{
+    free(s_queue_buffer);
+}
+#else
+/* 动态模式：普通数组 */
+static record_t* s_records_array;
+
+static void data_create(hparallel_range_t* range)
+{
+    s_records_array = (record_t*)malloc((size_t)s_records * sizeof(record_t));
+    for (uint32_t i = 0; i < s_records; ++i) {
+        record_t rec = { i, 0, (float)(i % 1000) * 0.5f };
+        s_records_array[i] = rec;
+    }
+    hparallel_range_init(range, s_records_array, s_records, sizeof(record_t));
+}
+
+static void data_destroy(void)
+{
+    free(s_records_array);
+}
+#endif
+
+/* ==================== 驱动 ==================== */
+
+static hexecutor_ptr_t executor_create(uint32_t workers)
+{
+#if HLIBC_USE_STATIC_ALLOC
+    uint32_t size = HEXECUTOR_CALC_BUFFER_SIZE(workers, BENCH_TASK_CAPACITY);
+    return hexecutor_create_static(aligned_alloc(HLIBC_CACHE_LINE_SIZE, size), size,
+                                   workers, BENCH_TASK_CAPACITY);
+#else
+    return hexecutor_create(workers, BENCH_TASK_CAPACITY);
+#endif
+}
+
+static void executor_destroy(hexecutor_ptr_t executor)
+{
+    hexecutor_destroy(executor);
+#if HLIBC_USE_STATIC_ALLOC
+    free(executor);
+#endif
+}
+
+/* workers 为 0 表示不使用线程池，在调用线程串行执行，作为基线 */
+static int run(const workload_t* workload, const hparallel_range_t* range, uint32_t workers,
+               uint64_t* expect, double* base_ns)
+{
+    hexecutor_ptr_t executor = NULL;
+    if (workers > 0 && (executor = executor_create(workers)) == NULL) {
+        printf("%-8s %3u workers: create failed\n", workload->name, workers);
+        return 0;
+    }
+
+    uint64_t best = UINT64_MAX, result = 0;
+    for (uint32_t round = 0; round < BENCH_ROUNDS; ++round) {
+        uint64_t t0 = bench_now_ns();
+        result = workload->run(executor, range);
+        uint64_t ns = bench_now_ns() - t0;
+        if (ns < best) best = ns;
+    }
+    if (workers == 0) {
+        *expect = result;
+        *base_ns = (double)best;
+    }
+    int ok = result == *expect;
+
+    uint64_t records = (uint64_t)range->count[0] + range->count[1];
+    double bytes = (double)records * (double)range->type_size;
+    printf("%-8s %3u workers %9.3f ms %8.2f GB/s  x%.2f%s\n", workload->name, workers,
+           (double)best / 1e6, bytes / (double)best, *base_ns / (double)best,
+           ok ? "" : "  RESULT MISMATCH");
+
+    if (executor != NULL) executor_destroy(executor);
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t max_workers = cpus > 0 ? (uint32_t)cpus : 1u;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            s_records = 1u << 16;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            max_workers = (uint32_t)strtoul(argv[++i], NULL, 10);
+            if (max_workers == 0 || max_workers > 256) max_workers = 4;
+        } else {
+            fprintf(stderr, "usage: %s [--quick] [--threads N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    hparallel_range_t range;
+    data_create(&range);
+    printf("records: %u x %u bytes in %u span(s), max workers: %u\n",
+           range.count[0] + range.count[1], range.type_size, range.count[1] ? 2u : 1u,
+           max_workers);
+
+    int ok = 1;
+    for (size_t w = 0; w < sizeof(s_workloads) / sizeof(s_workloads[0]); ++w) {
+        uint64_t expect = 0;
+        double base_ns = 0.0;
+        ok &= run(&s_workloads[w], &range, 0, &expect, &base_ns);
+        /* 1, 2, 4, ... 直到 max_workers（不是 2 的幂时最后补测一次） */
+        for (uint32_t t = 1;; t = t * 2 < max_workers ? t * 2 : max_workers) {
+            ok &= run(&s_workloads[w], &range, t, &expect, &base_ns);
+            if (t == max_workers) break;
+        }
+    }
+    data_destroy();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,1026 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/bench/bench_suite.cpp
+ * @Description: hlist/hqueue/hstack/hlru/hbtree/htimer_wheel/hpool/hring 热路径基准测试，对比 std::vector/std::deque/std::list
+ * @other: None
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "../src/btree/hbtree.h"
+#include "../src/list/hlist.h"
+#include "../src/lru/hlru.h"
+#include "../src/pool/hpool.h"
+#include "../src/queue/hqueue.h"
+#include "../src/queue/hring.h"
+#include "../src/stack/hstack.h"
+#include "../src/timer/htimer_wheel.h"
+#include "bench_util.h"
+
+namespace {
+
+/* 每批操作计时一次，摊薄 clock_gettime 的开销；延迟分位数按批内平均值统计 */
+const uint32_t kBatch = 64;
+/* 遍历类操作的重复次数 */
+const uint32_t kScanRounds = 8;
+/* LRU 缓存的容量，键在 2 倍容量的范围内随机取，命中率约一半 */
+const uint32_t kLruCapacity = 256;
+/* 范围查询每次覆盖的键数 */
+const uint32_t kRangeKeys = 64;
+/* 短生命周期容器的元素个数：创建、压入、弹出、销毁算一次操作 */
+const uint32_t kShortLived = 8;
+/* 有序链表对照组的元素数上限，线性查找的总耗时随它平方增长 */
+const uint32_t kSortedListKeys = 4096;
+/* 定时器的延迟在 [1, kTimerSpan] 内随机取 */
+const uint32_t kTimerSpan = 4096;
+/* 变长消息的最大负载与稳定状态下队列中积压的消息数 */
+const uint32_t kMaxMessage = 4096;
+const uint32_t kMessageBacklog = 64;
+/* 变长链表元素的负载在 [8, 8 + kMaxRecord) 内 */
+const uint32_t kMaxRecord = 120;
+
+struct options {
+    uint32_t elements = 1u << 17;
+    const char* json_path = nullptr;
+};
+
+struct result {
+    std::string container;
+    std::string impl;
+    std::string op;
+    uint32_t elem_size;
+    uint64_t ops;
+    double ns_per_op;
+    double ops_per_sec;
+    double p50_ns;
+    double p99_ns;
+    double p999_ns;
+};
+
+std::vector<result> g_results;
+
+template <uint32_t N>
+struct elem {
+    unsigned char bytes[N];
+};
+
+template <uint32_t N>
+inline elem<N> make_elem(uint32_t i)
+{
+    elem<N> e;
+    std::memset(e.bytes, (int)(i & 0xff), N);
+    return e;
+}
+
+double percentile(std::vector<double>& samples, double q)
+{
+    if (samples.empty()) return 0.0;
+    size_t k = (size_t)(q * (double)(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+}
+
+/* 记录一项结果，samples 为各次计时折算到单个操作的耗时 */
+void add_result(const char* container, const char* impl, const char* op_name, uint32_t elem_size,
+                uint64_t n, uint64_t total, std::vector<double>& samples)
+{
+    result r;
+    r.container = container;
+    r.impl = impl;
+    r.op = op_name;
+    r.elem_size = elem_size;
+    r.ops = n;
+    r.ns_per_op = n ? (double)total / (double)n : 0.0;
+    r.ops_per_sec = total ? (double)n * 1e9 / (double)total : 0.0;
+    r.p50_ns = percentile(samples, 0.50);
+    r.p99_ns = percentile(samples, 0.99);
+    r.p999_ns = percentile(samples, 0.999);
+    g_results.push_back(r);
+}
+
+/* 执行 n 次 op(i)，记录吞吐与延迟分位数 */
+template <class Op>
+void measure(const char* container, const char* impl, const char* op_name, uint32_t elem_size,
+             uint32_t n, Op op)
+{
+    std::vector<double> samples;
+    samples.reserve(n / kBatch + 1);
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < n; i += kBatch) {
+        uint32_t end = std::min(n, i + kBatch);
+        uint64_t t0 = bench_now_ns();
+        for (uint32_t j = i; j < end; ++j) op(j);
+        uint64_t dt = bench_now_ns() - t0;
+        total += dt;
+        samples.push_back((double)dt / (double)(end - i));
+    }
+    add_result(container, impl, op_name, elem_size, n, total, samples);
+}
+
+/* 整体遍历 n 个元素的操作：重复 kScanRounds 遍，每遍计时一次，按元素折算 */
+template <class Scan>
+void measure_scan(const char* container, const char* impl, const char* op_name,
+                  uint32_t elem_size, uint32_t n, Scan scan)
+{
+    std::vector<double> samples;
+    uint64_t total = 0;
+    for (uint32_t round = 0; round < kScanRounds; ++round) {
+        uint64_t t0 = bench_now_ns();
+        scan();
+        uint64_t dt = bench_now_ns() - t0;
+        total += dt;
+        samples.push_back((double)dt / (double)n);
+    }
+    add_result(container, impl, op_name, elem_size, (uint64_t)n * kScanRounds, total, samples);
+}
+
+/* ==================== 容器创建（两种分配模式） ==================== */
+
+#if HLIBC_USE_STATIC_ALLOC
+/* 静态模式的缓冲区由基准程序申请，库本身不做动态分配 */
+struct static_buffer {
+    /* 按 HLIBC_STATIC_ALIGN 对齐，BUFFER_SIZE 宏算出的大小才恰好够用 */
+    explicit static_buffer(size_t size)
+        : ptr(aligned_alloc(HLIBC_STATIC_ALIGN, HLIBC_ALIGN_UP(size, HLIBC_STATIC_ALIGN))),
+          size((uint32_t)size)
+    {
+        if (ptr == nullptr) {
+            std::fprintf(stderr, "out of memory\n");
+            std::exit(1);
+        }
+    }
+    ~static_buffer() { std::free(ptr); }
+    void* ptr;
+    uint32_t size;
+};
+#endif
+
+struct stack_holder {
+    stack_holder(uint32_t type_size, uint32_t capacity)
+#if HLIBC_USE_STATIC_ALLOC
+        : buffer(HSTACK_BUFFER_SIZE(type_size, capacity)),
+          handle(hstack_create_static(buffer.ptr, buffer.size, type_size))
+#else
+        : handle(hstack_create(type_size))
+#endif
+    {
+        (void)capacity;
+    }
+    ~stack_holder() { hstack_destroy(handle); }
+#if HLIBC_USE_STATIC_ALLOC
+    static_buffer buffer;
+#endif
+    hstack_ptr_t handle;
+};
+
+struct queue_holder {
+    queue_holder(uint32_t type_size, uint32_t capacity)
+#if HLIBC_USE_STATIC_ALLOC
+        : buffer(HQUEUE_BUFFER_SIZE(type_size, capacity)),
+          handle(hqueue_create_static(buffer.ptr, buffer.size, type_size))
+#else
+        : handle(hqueue_create(type_size))
+#endif
+    {
+        (void)capacity;
+    }
+    ~queue_holder() { hqueue_destroy(handle); }
+#if HLIBC_USE_STATIC_ALLOC
+    static_buffer buffer;
+#endif
+    hqueue_ptr_t handle;
+};
+
+struct list_holder {
+    list_holder(uint32_t type_size, uint32_t capacity)
+#if HLIBC_USE_STATIC_ALLOC
+        : buffer(HLIST_BUFFER_SIZE(type_size, capacity)),
+          handle(hlist_create_static(buffer.ptr, buffer.size, type_size))
+#else
+        : handle(hlist_create(type_size))
+#endif
+    {
+        (void)capacity;
+    }
+    ~list_holder() { hlist_destroy(handle); }
+#if HLIBC_USE_STATIC_ALLOC
+    static_buffer buffer;
+#endif
+    hlist_ptr_t handle;
+};
+
+struct lru_holder {
+    lru_holder(uint32_t key_size, uint32_t value_size, uint32_t capacity)
+#if HLIBC_USE_STATIC_ALLOC
+        : buffer(HLRU_BUFFER_SIZE(key_size, value_size, capacity)),
+          handle(hlru_create_static(buffer.ptr, buffer.size, key_size, value_size, capacity))
+#else
+        : handle(hlru_create(key_size, value_size, capacity))
+#endif
+    {
+    }
+    ~lru_holder() { hlru_destroy(handle); }
+#if HLIBC_USE_STATIC_ALLOC
+    static_buffer buffer;
+#endif
+    hlru_ptr_t handle;
+};
+
+struct btree_holder {
+    btree_holder(uint32_t key_size, uint32_t value_size, uint32_t capacity)
+#if HLIBC_USE_STATIC_ALLOC
+        : buffer(HBTREE_BUFFER_SIZE(key_size, value_size, capacity)),
+          handle(hbtree_create_static(buffer.ptr, buffer.size, key_size, value_size,
+                                      hbtree_cmp_u64))
+#else
+        : handle(hbtree_create(key_size, value_size, hbtree_cmp_u64))
+#endif
+    {
+        (void)capacity;
+    }
+    ~btree_holder() { hbtree_destroy(handle); }
+#if HLIBC_USE_STATIC_ALLOC
+    static_buffer buffer;
+#endif
+    hbtree_ptr_t handle;
+};
+
+struct pool_holder {
+    pool_holder(uint32_t block_size, uint32_t count)
+#if HLIBC_USE_STATIC_ALLOC
+        : buffer(HPOOL_BUFFER_SIZE(block_size, count)),
+          handle(hpool_create_static(buffer.ptr, buffer.size, block_size))
+#else
+        : handle(hpool_create(block_size))
+#endif
+    {
+        (void)count;
+    }
+    ~pool_holder() { hpool_destroy(handle); }
+#if HLIBC_USE_STATIC_ALLOC
+    static_buffer buffer;
+#endif
+    hpool_ptr_t handle;
+};
+
+struct timer_wheel_holder {
+    explicit timer_wheel_holder(uint32_t capacity)
+#if HLIBC_USE_STATIC_ALLOC
+        : buffer(HTIMER_WHEEL_BUFFER_SIZE(capacity)),
+          handle(htimer_wheel_create_static(buffer.ptr, buffer.size, 0))
+#else
+        : handle(htimer_wheel_create(0))
+#endif
+    {
+        (void)capacity;
+    }
+    ~timer_wheel_holder() { htimer_wheel_destroy(handle); }
+#if HLIBC_USE_STATIC_ALLOC
+    static_buffer buffer;
+#endif
+    htimer_wheel_ptr_t handle;
+};
+
+struct ring_holder {
+    explicit ring_holder(uint32_t bytes)
+#if HLIBC_USE_STATIC_ALLOC
+        : buffer(HRING_BUFFER_SIZE(bytes)), handle(hring_create_static(buffer.ptr, buffer.size))
+#else
+        : handle(hring_create(0))
+#endif
+    {
+        (void)bytes;
+    }
+    ~ring_holder() { hring_destroy(handle); }
+#if HLIBC_USE_STATIC_ALLOC
+    static_buffer buffer;
+#endif
+    hring_ptr_t handle;
+};
+
+/* ==================== hlibc ==================== */
+
+bool sum_first_byte(void* data, void* ctx)
+{
+    *(uint64_t*)ctx += *(const unsigned char*)data;
+    return true;
+}
+
+bool sum_first_byte_batch(void* const* items, uint32_t count, void* ctx)
+{
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < count; ++i) sum += *(const unsigned char*)items[i];
+    *(uint64_t*)ctx += sum;
+    return true;
+}
+
+template <uint32_t N>
+void bench_hstack(uint32_t n)
+{
+    stack_holder s(N, n);
+    uint64_t sum = 0;
+    measure("hstack", "hlibc", "push", N, n, [&](uint32_t i) {
+        elem<N> e = make_elem<N>(i);
+        hstack_push(s.handle, &e, N, NULL);
+    });
+    measure_scan("hstack", "hlibc", "foreach", N, n, [&]() {
+        hstack_foreach(s.handle, sum_first_byte, &sum);
+    });
+    measure("hstack", "hlibc", "pop", N, n, [&](uint32_t) {
+        sum += *(const unsigned char*)hstack_top(s.handle);
+        hstack_pop(s.handle);
+    });
+    BENCH_KEEP(sum);
+}
+
+template <uint32_t N>
+void bench_hqueue(uint32_t n)
+{
+    queue_holder q(N, n);
+    uint64_t sum = 0;
+    measure("hqueue", "hlibc", "push", N, n, [&](uint32_t i) {
+        elem<N> e = make_elem<N>(i);
+        hqueue_push(q.handle, &e, N, NULL);
+    });
+    measure_scan("hqueue", "hlibc", "foreach", N, n, [&]() {
+        hqueue_foreach(q.handle, sum_first_byte, &sum);
+    });
+    measure("hqueue", "hlibc", "pop", N, n, [&](uint32_t) {
+        sum += *(const unsigned char*)hqueue_front(q.handle);
+        hqueue_pop(q.handle);
+    });
+    BENCH_KEEP(sum);
+}
+
+#if !HLIBC_USE_STATIC_ALLOC
+/* 短生命周期的 stack/queue：堆上创建与栈帧内联创建对比，内联版本全程不调用分配器 */
+template <uint32_t N>
+void bench_short_lived(uint32_t n)
+{
+    uint64_t sum = 0;
+    auto fill_stack = [&](hstack_ptr_t s, uint32_t i) {
+        for (uint32_t k = 0; k < kShortLived; ++k) {
+            elem<N> e = make_elem<N>(i + k);
+            hstack_push(s, &e, N, NULL);
+        }
+        while (!hstack_empty(s)) {
+            sum += *(const unsigned char*)hstack_top(s);
+            hstack_pop(s);
+        }
+    };
+    auto fill_queue = [&](hqueue_ptr_t q, uint32_t i) {
+        for (uint32_t k = 0; k < kShortLived; ++k) {
+            elem<N> e = make_elem<N>(i + k);
+            hqueue_push(q, &e, N, NULL);
+        }
+        while (!hqueue_empty(q)) {
+            sum += *(const unsigned char*)hqueue_front(q);
+            hqueue_pop(q);
+        }
+    };
+    measure("hstack", "hlibc", "short", N, n, [&](uint32_t i) {
+        hstack_ptr_t s = hstack_create(N);
+        fill_stack(s, i);
+        hstack_destroy(s);
+    });
+    measure("hstack", "hlibc-inline", "short", N, n, [&](uint32_t i) {
+        HSTACK_DEFINE_INLINE(s, elem<N>, kShortLived);
+        fill_stack(s, i);
+        hstack_destroy(s);
+    });
+    measure("hqueue", "hlibc", "short", N, n, [&](uint32_t i) {
+        hqueue_ptr_t q = hqueue_create(N);
+        fill_queue(q, i);
+        hqueue_destroy(q);
+    });
+    measure("hqueue", "hlibc-inline", "short", N, n, [&](uint32_t i) {
+        HQUEUE_DEFINE_INLINE(q, elem<N>, kShortLived);
+        fill_queue(q, i);
+        hqueue_destroy(q);
+    });
+    BENCH_KEEP(sum);
+}
+#endif
+
+template <uint32_t N>
+void bench_hlist(uint32_t n)
+{
+    list_holder l(N, 2 * n);
+    uint64_t sum = 0;
+    measure("hlist", "hlibc", "push", N, n, [&](uint32_t i) {
+        elem<N> e = make_elem<N>(i);
+        hlist_push_back(l.handle, &e, N);
+    });
+    hlist_iterator_ptr_t it = hlist_begin(l.handle);
+    measure("hlist", "hlibc", "iterate", N, n, [&](uint32_t) {
+        sum += *(const unsigned char*)hlist_iter_data(it);
+        hlist_iter_forward(&it);
+    });
+    measure_scan("hlist", "hlibc", "foreach", N, n, [&]() {
+        hlist_foreach(l.handle, sum_first_byte, &sum);
+    });
+    measure_scan("hlist", "hlibc", "batch", N, n, [&]() {
+        hlist_foreach_batch(l.handle, sum_first_byte_batch, &sum);
+    });
+    /* 在链表中部的固定位置之前反复插入 */
+    hlist_iterator_ptr_t mid = hlist_begin(l.handle);
+    hlist_iter_forward_to(&mid, (int)(n / 2));
+    measure("hlist", "hlibc", "insert", N, n, [&](uint32_t i) {
+        elem<N> e = make_elem<N>(i);
+        hlist_insert(l.handle, mid, &e, N);
+    });
+    measure("hlist", "hlibc", "pop", N, n, [&](uint32_t) {
+        sum += *(const unsigned char*)hlist_front(l.handle);
+        hlist_pop_front(l.handle);
+    });
+    BENCH_KEEP(sum);
+}
+
+#if HLIBC_USE_STATIC_ALLOC
+/* 随机位置插入打乱节点池顺序后遍历，再压缩节点池后遍历 */
+template <uint32_t N>
+void bench_hlist_compact(uint32_t n)
+{
+    list_holder l(N, n);
+    std::vector<hlist_iterator_ptr_t> nodes;
+    nodes.reserve(n);
+    uint64_t sum = 0;
+    uint32_t seed = 12345;
+    for (uint32_t i = 0; i < n; ++i) {
+        elem<N> e = make_elem<N>(i);
+        seed = seed * 1664525u + 1013904223u;
+        /* 静态模式下节点地址不变，插到一个随机的已有节点之前 */
+        hlist_iterator_ptr_t pos = nodes.empty() ? hlist_begin(l.handle) : nodes[(seed >> 8) % nodes.size()];
+        hlist_insert(l.handle, pos, &e, N);
+        hlist_iter_backward(&pos);
+        nodes.push_back(pos);
+    }
+    measure_scan("hlist", "hlibc", "scan-frg", N, n, [&]() {
+        hlist_foreach(l.handle, sum_first_byte, &sum);
+    });
+    uint64_t t0 = bench_now_ns();
+    hlist_compact(l.handle, 0);
+    uint64_t dt = bench_now_ns() - t0;
+    std::vector<double> samples(1, (double)dt / (double)n);
+    add_result("hlist", "hlibc", "compact", N, n, dt, samples);
+    measure_scan("hlist", "hlibc", "scan-cmp", N, n, [&]() {
+        hlist_foreach(l.handle, sum_first_byte, &sum);
+    });
+    BENCH_KEEP(sum);
+}
+#endif
+
+bool sum_value_first_byte(const void* key, void* value, void* ctx)
+{
+    (void)key;
+    *(uint64_t*)ctx += *(const unsigned char*)value;
+    return true;
+}
+
+/* 0 .. n - 1 的一个固定的随机排列 */
+std::vector<uint32_t> shuffled(uint32_t n)
+{
+    std::vector<uint32_t> order(n);
+    for (uint32_t i = 0; i < n; ++i) order[i] = i;
+    uint32_t seed = 12345;
+    for (uint32_t i = n; i > 1; --i) {
+        seed = seed * 1664525u + 1013904223u;
+        std::swap(order[i - 1], order[(seed >> 8) % i]);
+    }
+    return order;
+}
+
+/* 键为 0, 2, 4, ...，查询的键随机；range 每次扫描 kRangeKeys 个连续的键 */
+template <uint32_t N>
+void bench_hbtree(uint32_t n)
+{
+    std::vector<uint64_t> keys(n);
+    std::vector<elem<N>> values(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        keys[i] = 2ull * i;
+        values[i] = make_elem<N>(i);
+    }
+    std::vector<uint32_t> order = shuffled(n);
+    uint64_t sum = 0;
+    {
+        btree_holder t(sizeof(uint64_t), N, n);
+        measure("hbtree", "hlibc", "put", N, n, [&](uint32_t i) {
+            hbtree_put(t.handle, &keys[order[i]], &values[order[i]]);
+        });
+    }
+    btree_holder t(sizeof(uint64_t), N, n);
+    uint64_t t0 = bench_now_ns();
+    hbtree_bulk_load(t.handle, keys.data(), values.data(), n);
+    uint64_t dt = bench_now_ns() - t0;
+    std::vector<double> samples(1, (double)dt / (double)n);
+    add_result("hbtree", "hlibc", "bulk", N, n, dt, samples);
+    measure("hbtree", "hlibc", "get", N, n, [&](uint32_t i) {
+        sum += ((const elem<N>*)hbtree_get(t.handle, &keys[order[i]]))->bytes[0];
+    });
+    measure("hbtree", "hlibc", "range", N, n, [&](uint32_t i) {
+        uint64_t lo = keys[order[i]];
+        uint64_t hi = lo + 2ull * kRangeKeys;
+        hbtree_foreach_range(t.handle, &lo, &hi, sum_value_first_byte, &sum);
+    });
+    BENCH_KEEP(sum);
+}
+
+/* 对照：按键排序的 hlist，查找与定位范围起点都是线性扫描 */
+template <uint32_t N>
+void bench_hlist_sorted(uint32_t n)
+{
+    struct entry {
+        uint64_t key;
+        elem<N> value;
+    };
+    uint32_t m = std::min(n, kSortedListKeys);
+    list_holder l(sizeof(entry), m);
+    for (uint32_t i = 0; i < m; ++i) {
+        entry e = { 2ull * i, make_elem<N>(i) };
+        hlist_push_back(l.handle, &e, sizeof(e));
+    }
+    std::vector<uint32_t> order = shuffled(m);
+    uint64_t sum = 0;
+    auto seek = [&](uint64_t key) {
+        hlist_iterator_ptr_t it = hlist_begin(l.handle);
+        while (((const entry*)hlist_iter_data(it))->key < key) hlist_iter_forward(&it);
+        return it;
+    };
+    measure("hbtree", "hlist-scan", "get", N, m, [&](uint32_t i) {
+        sum += ((const entry*)hlist_iter_data(seek(2ull * order[i])))->value.bytes[0];
+    });
+    measure("hbtree", "hlist-scan", "range", N, m, [&](uint32_t i) {
+        hlist_iterator_ptr_t it = seek(2ull * order[i]);
+        for (uint32_t k = std::min(kRangeKeys, m - order[i]); k > 0; --k) {
+            sum += ((const entry*)hlist_iter_data(it))->value.bytes[0];
+            hlist_iter_forward(&it);
+        }
+    });
+    BENCH_KEEP(sum);
+}
+
+/* 申请 n 个块并写入首字节，再按乱序全部归还 */
+template <uint32_t N>
+void bench_hpool(uint32_t n)
+{
+    pool_holder p(N, n);
+    std::vector<void*> blocks(n);
+    std::vector<uint32_t> order = shuffled(n);
+    measure("hpool", "hlibc", "alloc", N, n, [&](uint32_t i) {
+        blocks[i] = hpool_alloc(p.handle);
+        *(unsigned char*)blocks[i] = (unsigned char)i;
+    });
+    measure("hpool", "hlibc", "free", N, n,
+            [&](uint32_t i) { hpool_free(p.handle, blocks[order[i]]); });
+}
+
+/* 对照：同样的申请/归还顺序直接使用 malloc/free */
+template <uint32_t N>
+void bench_malloc(uint32_t n)
+{
+    std::vector<void*> blocks(n);
+    std::vector<uint32_t> order = shuffled(n);
+    measure("hpool", "malloc", "alloc", N, n, [&](uint32_t i) {
+        blocks[i] = std::malloc(N);
+        *(unsigned char*)blocks[i] = (unsigned char)i;
+    });
+    measure("hpool", "malloc", "free", N, n, [&](uint32_t i) { std::free(blocks[order[i]]); });
+}
+
+/* 消息长度在 [20, kMaxMessage] 内：多数为 20 到 255 字节的短消息，每 16 条中有一条长消息 */
+inline uint32_t message_len(uint32_t i)
+{
+    uint32_t h = (i * 2654435761u) >> 8;
+    return 20 + h % ((i & 15) == 0 ? kMaxMessage - 19 : 236);
+}
+
+/* 稳定状态：队列中保持 kMessageBacklog 条消息，每次操作写入一条新消息并读出最早的一条 */
+void bench_hring(uint32_t n, const unsigned char* payload)
+{
+    ring_holder r(2 * kMessageBacklog * (uint32_t)HRING_RECORD_SIZE(kMaxMessage));
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < kMessageBacklog; ++i) hring_push(r.handle, payload, message_len(i));
+    measure("hring", "hlibc", "pushpop", 0, n, [&](uint32_t i) {
+        uint32_t len = message_len(i + kMessageBacklog);
+        void* dst = hring_reserve(r.handle, len);
+        std::memcpy(dst, payload, len);
+        hring_commit(r.handle, len);
+        const unsigned char* msg = (const unsigned char*)hring_peek(r.handle, &len);
+        sum += msg[len - 1];
+        hring_pop(r.handle);
+    });
+    BENCH_KEEP(sum);
+}
+
+/* 对照：hqueue 的元素按最大消息长度填充，每条消息都复制整个元素 */
+void bench_hqueue_padded(uint32_t n, const unsigned char* payload)
+{
+    struct message {
+        uint32_t len;
+        unsigned char bytes[kMaxMessage];
+    };
+    queue_holder q(sizeof(message), kMessageBacklog + 1);
+    std::vector<message> scratch(1);
+    message& m = scratch[0];
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < kMessageBacklog; ++i) {
+        m.len = message_len(i);
+        std::memcpy(m.bytes, payload, m.len);
+        hqueue_push(q.handle, &m, sizeof(message), NULL);
+    }
+    measure("hring", "hqueue-pad", "pushpop", 0, n, [&](uint32_t i) {
+        m.len = message_len(i + kMessageBacklog);
+        std::memcpy(m.bytes, payload, m.len);
+        hqueue_push(q.handle, &m, sizeof(message), NULL);
+        const message* msg = (const message*)hqueue_front(q.handle);
+        sum += msg->bytes[msg->len - 1];
+        hqueue_pop(q.handle);
+    });
+    BENCH_KEEP(sum);
+}
+
+/* 对照：每条消息单独 malloc，队列中只存指针 */
+void bench_malloc_messages(uint32_t n, const unsigned char* payload)
+{
+    std::deque<unsigned char*> q;
+    uint64_t sum = 0;
+    auto push = [&](uint32_t len) {
+        unsigned char* msg = (unsigned char*)std::malloc(sizeof(uint32_t) + len);
+        std::memcpy(msg, &len, sizeof(len));
+        std::memcpy(msg + sizeof(uint32_t), payload, len);
+        q.push_back(msg);
+    };
+    for (uint32_t i = 0; i < kMessageBacklog; ++i) push(message_len(i));
+    measure("hring", "malloc", "pushpop", 0, n, [&](uint32_t i) {
+        push(message_len(i + kMessageBacklog));
+        unsigned char* msg = q.front();
+        uint32_t len;
+        std::memcpy(&len, msg, sizeof(len));
+        sum += msg[sizeof(uint32_t) + len - 1];
+        std::free(msg);
+        q.pop_front();
+    });
+    for (unsigned char* msg : q) std::free(msg);
+    BENCH_KEEP(sum);
+}
+
+#if !HLIBC_USE_STATIC_ALLOC
+inline uint32_t record_len(uint32_t i)
+{
+    return 8 + ((i * 2654435761u) >> 8) % kMaxRecord;
+}
+
+bool sum_last_byte_sized(void* data, uint32_t size, void* ctx)
+{
+    *(uint64_t*)ctx += ((const unsigned char*)data)[size - 1];
+    return true;
+}
+
+/* 变长记录：负载紧跟在节点之后，遍历时直接读取 */
+void bench_hlist_var(uint32_t n, const unsigned char* payload)
+{
+    hlist_ptr_t l = hlist_create_var();
+    uint64_t sum = 0;
+    measure("hlist", "var", "push", 0, n, [&](uint32_t i) {
+        hlist_push_back(l, const_cast<unsigned char*>(payload), record_len(i));
+    });
+    measure_scan("hlist", "var", "foreach", 0, n,
+                 [&]() { hlist_foreach_sized(l, sum_last_byte_sized, &sum); });
+    hlist_destroy(l);
+    BENCH_KEEP(sum);
+}
+
+/* 对照：定长 hlist 中存放指向单独 malloc 的记录的指针，遍历时多一次间接访问 */
+void bench_hlist_blob(uint32_t n, const unsigned char* payload)
+{
+    hlist_ptr_t l = hlist_create(sizeof(unsigned char*));
+    uint64_t sum = 0;
+    measure("hlist", "ptr-blob", "push", 0, n, [&](uint32_t i) {
+        uint32_t len = record_len(i);
+        unsigned char* blob = (unsigned char*)std::malloc(sizeof(uint32_t) + len);
+        std::memcpy(blob, &len, sizeof(len));
+        std::memcpy(blob + sizeof(uint32_t), payload, len);
+        hlist_push_back(l, &blob, sizeof(blob));
+    });
+    measure_scan("hlist", "ptr-blob", "foreach", 0, n, [&]() {
+        hlist_foreach(l, [](void* data, void* ctx) {
+            const unsigned char* blob = *(unsigned char* const*)data;
+            uint32_t len;
+            std::memcpy(&len, blob, sizeof(len));
+            *(uint64_t*)ctx += blob[sizeof(uint32_t) + len - 1];
+            return true;
+        }, &sum);
+    });
+    hlist_foreach(l, [](void* data, void*) {
+        std::free(*(unsigned char**)data);
+        return true;
+    }, nullptr);
+    hlist_destroy(l);
+    BENCH_KEEP(sum);
+}
+#endif
+
+inline uint64_t timer_delay(uint32_t i)
+{
+    return ((i * 2654435761u) >> 8) % kTimerSpan + 1;
+}
+
+void count_timer(htimer_wheel_ptr_t, void* ctx)
+{
+    ++*(uint64_t*)ctx;
+}
+
+/* 推进时间直到 expected 个定时器全部到期，按定时器折算 */
+template <class Advance>
+void measure_expire(const char* impl, uint64_t expected, Advance advance)
+{
+    uint64_t t0 = bench_now_ns();
+    advance();
+    uint64_t dt = bench_now_ns() - t0;
+    std::vector<double> samples(1, (double)dt / (double)expected);
+    add_result("htimer", impl, "expire", 0, expected, dt, samples);
+}
+
+/* 添加 n 个随机延迟的定时器，取消其中一半，再推进时间让其余的到期 */
+void bench_htimer_wheel(uint32_t n)
+{
+    timer_wheel_holder w(n);
+    std::vector<htimer_t> timers(n);
+    uint64_t fired = 0;
+    measure("htimer", "hlibc", "add", 0, n, [&](uint32_t i) {
+        htimer_wheel_add(w.handle, timer_delay(i), count_timer, &fired, &timers[i]);
+    });
+    measure("htimer", "hlibc", "cancel", 0, n / 2,
+            [&](uint32_t i) { htimer_wheel_cancel(w.handle, &timers[2 * i]); });
+    uint64_t expected = htimer_wheel_size(w.handle);
+    measure_expire("hlibc", expected, [&] {
+        for (uint64_t now = 1; htimer_wheel_size(w.handle) != 0; ++now)
+            htimer_wheel_advance(w.handle, now);
+    });
+    BENCH_KEEP(fired);
+}
+
+/* 对照：按到期时间排序的 hlist，添加与取消都是线性查找，到期只看表头 */
+void bench_hlist_timers(uint32_t n)
+{
+    struct entry {
+        uint64_t expires;
+        uint32_t id;
+    };
+    uint32_t m = std::min(n, kSortedListKeys);
+    list_holder l(sizeof(entry), m);
+    uint64_t fired = 0;
+    measure("htimer", "hlist-sorted", "add", 0, m, [&](uint32_t i) {
+        entry e = { timer_delay(i), i };
+        hlist_iterator_ptr_t it = hlist_begin(l.handle);
+        while (it != hlist_end(l.handle) &&
+               ((const entry*)hlist_iter_data(it))->expires <= e.expires)
+            hlist_iter_forward(&it);
+        hlist_insert(l.handle, it, &e, sizeof(e));
+    });
+    measure("htimer", "hlist-sorted", "cancel", 0, m / 2, [&](uint32_t i) {
+        hlist_iterator_ptr_t it = hlist_begin(l.handle);
+        while (((const entry*)hlist_iter_data(it))->id != 2 * i) hlist_iter_forward(&it);
+        hlist_erase(l.handle, it);
+    });
+    uint64_t expected = hlist_size(l.handle);
+    measure_expire("hlist-sorted", expected, [&] {
+        for (uint64_t now = 1; hlist_size(l.handle) != 0; ++now) {
+            while (hlist_size(l.handle) != 0 &&
+                   ((const entry*)hlist_front(l.handle))->expires <= now) {
+                hlist_pop_front(l.handle);
+                ++fired;
+            }
+        }
+    });
+    BENCH_KEEP(fired);
+}
+
+inline uint32_t lru_key(uint32_t i)
+{
+    return ((i * 2654435761u) >> 8) % (2 * kLruCapacity);
+}
+
+/* 命中则读取，未命中则写入（缓存满时淘汰最旧的条目） */
+template <uint32_t N>
+void bench_hlru(uint32_t n)
+{
+    lru_holder c(sizeof(uint32_t), N, kLruCapacity);
+    uint64_t sum = 0;
+    measure("hlru", "hlibc", "get/put", N, n, [&](uint32_t i) {
+        uint32_t key = lru_key(i);
+        const elem<N>* hit = (const elem<N>*)hlru_get(c.handle, &key);
+        if (hit != nullptr) {
+            sum += hit->bytes[0];
+        } else {
+            elem<N> e = make_elem<N>(i);
+            hlru_put(c.handle, &key, &e);
+        }
+    });
+    BENCH_KEEP(sum);
+}
+
+/* 对照：手写的 hlist + 线性查找，命中后移到表头 */
+template <uint32_t N>
+void bench_hlist_lru(uint32_t n)
+{
+    struct entry {
+        uint32_t key;
+        elem<N> value;
+    };
+    list_holder l(sizeof(entry), kLruCapacity);
+    uint64_t sum = 0;
+    measure("hlru", "hlist-scan", "get/put", N, n, [&](uint32_t i) {
+        uint32_t key = lru_key(i);
+        hlist_iterator_ptr_t it = hlist_begin(l.handle);
+        for (uint32_t k = hlist_size(l.handle); k > 0; --k, hlist_iter_forward(&it)) {
+            const entry* e = (const entry*)hlist_iter_data(it);
+            if (e->key == key) {
+                sum += e->value.bytes[0];
+                hlist_move(l.handle, hlist_begin(l.handle), it);
+                return;
+            }
+        }
+        if (hlist_size(l.handle) >= kLruCapacity) hlist_pop_back(l.handle);
+        entry e = { key, make_elem<N>(i) };
+        hlist_push_front(l.handle, &e, sizeof(e));
+    });
+    BENCH_KEEP(sum);
+}
+
+/* ==================== std 基线 ==================== */
+
+template <uint32_t N>
+void bench_std_vector(uint32_t n)
+{
+    std::vector<elem<N>> v;
+    uint64_t sum = 0;
+    measure("hstack", "std::vector", "push", N, n, [&](uint32_t i) { v.push_back(make_elem<N>(i)); });
+    measure("hstack", "std::vector", "pop", N, n, [&](uint32_t) {
+        sum += v.back().bytes[0];
+        v.pop_back();
+    });
+    BENCH_KEEP(sum);
+}
+
+template <uint32_t N>
+void bench_std_deque(uint32_t n)
+{
+    std::deque<elem<N>> d;
+    uint64_t sum = 0;
+    measure("hqueue", "std::deque", "push", N, n, [&](uint32_t i) { d.push_back(make_elem<N>(i)); });
+    measure("hqueue", "std::deque", "pop", N, n, [&](uint32_t) {
+        sum += d.front().bytes[0];
+        d.pop_front();
+    });
+    BENCH_KEEP(sum);
+}
+
+template <uint32_t N>
+void bench_std_list(uint32_t n)
+{
+    std::list<elem<N>> l;
+    uint64_t sum = 0;
+    measure("hlist", "std::list", "push", N, n, [&](uint32_t i) { l.push_back(make_elem<N>(i)); });
+    typename std::list<elem<N>>::iterator it = l.begin();
+    measure("hlist", "std::list", "iterate", N, n, [&](uint32_t) {
+        sum += it->bytes[0];
+        ++it;
+    });
+    typename std::list<elem<N>>::iterator mid = std::next(l.begin(), n / 2);
+    measure("hlist", "std::list", "insert", N, n,
+            [&](uint32_t i) { l.insert(mid, make_elem<N>(i)); });
+    measure("hlist", "std::list", "pop", N, n, [&](uint32_t) {
+        sum += l.front().bytes[0];
+        l.pop_front();
+    });
+    BENCH_KEEP(sum);
+}
+
+template <uint32_t N>
+void bench_elem_size(uint32_t n)
+{
+    bench_hstack<N>(n);
+    bench_std_vector<N>(n);
+    bench_hqueue<N>(n);
+    bench_std_deque<N>(n);
+#if !HLIBC_USE_STATIC_ALLOC
+    bench_short_lived<N>(n);
+#endif
+    bench_hlist<N>(n);
+    bench_std_list<N>(n);
+#if HLIBC_USE_STATIC_ALLOC
+    bench_hlist_compact<N>(n);
+#endif
+    bench_hlru<N>(n);
+    bench_hlist_lru<N>(n);
+    bench_hbtree<N>(n);
+    bench_hlist_sorted<N>(n);
+    bench_hpool<N>(n);
+    bench_malloc<N>(n);
+}
+
+/* ==================== 输出 ==================== */
+
+const char* mode_name() { return HLIBC_USE_STATIC_ALLOC ? "static" : "dynamic"; }
+
+void print_table(uint32_t n)
+{
+    std::printf("mode: %s, elements: %u, batch: %u\n", mode_name(), n, kBatch);
+    std::printf("%-7s %-12s %-8s %5s %10s %14s %9s %9s %9s\n", "target", "impl", "op",
+                "size", "ns/op", "ops/s", "p50", "p99", "p99.9");
+    for (const result& r : g_results) {
+        std::printf("%-7s %-12s %-8s %5u %10.2f %14.0f %9.2f %9.2f %9.2f\n", r.container.c_str(),
+                    r.impl.c_str(), r.op.c_str(), r.elem_size, r.ns_per_op, r.ops_per_sec,
+                    r.p50_ns, r.p99_ns, r.p999_ns);
+    }
+}
+
+bool write_json(const char* path, uint32_t n)
+{
+    FILE* fp = std::strcmp(path, "-") == 0 ? stdout : std::fopen(path, "w");
+    if (fp == nullptr) return false;
+    std::fprintf(fp, "{\n  \"suite\": \"hlibc_bench\",\n  \"mode\": \"%s\",\n", mode_name());
+    std::fprintf(fp, "  \"elements\": %u,\n  \"batch\": %u,\n  \"results\": [\n", n, kBatch);
+    for (size_t i = 0; i < g_results.size(); ++i) {
+        const result& r = g_results[i];
+        std::fprintf(fp,
+                     "    {\"container\": \"%s\", \"impl\": \"%s\", \"op\": \"%s\", "
+                     "\"elem_size\": %u, \"ops\": %llu, \"ns_per_op\": %.3f, "
+                     "\"ops_per_sec\": %.0f, \"p50_ns\": %.3f, \"p99_ns\": %.3f, "
+                     "\"p999_ns\": %.3f}%s\n",
+                     r.container.c_str(), r.impl.c_str(), r.op.c_str(), r.elem_size,
+                     (unsigned long long)r.ops, r.ns_per_op, r.ops_per_sec, r.p50_ns, r.p99_ns,
+                     r.p999_ns, i + 1 < g_results.size() ? "," : "");
+    }
+    std::fprintf(fp, "  ]\n}\n");
+    if (fp != stdout) std::fclose(fp);
+    return true;
+}
+
+void usage(const char* argv0)
+{
+    std::fprintf(stderr,
+                 "usage: %s [--quick] [--elements N] [--json FILE|-]\n"
+                 "  --quick       run with a small element count (smoke test)\n"
+                 "  --elements N  elements per measurement (default 131072)\n"
+                 "  --json FILE   write machine-readable results, '-' for stdout\n",
+                 argv0);
+}
+
+} /* namespace */
+
+int main(int argc, char** argv)
+{
+    options opt;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            opt.elements = 1u << 10;
+        } else if (std::strcmp(argv[i], "--elements") == 0 && i + 1 < argc) {
+            opt.elements = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            opt.json_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (opt.elements == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    bench_elem_size<8>(opt.elements);
+    bench_elem_size<64>(opt.elements);
+    bench_elem_size<256>(opt.elements);
+    /* 定时器与元素大小无关，只测一次 */
+    bench_htimer_wheel(opt.elements);
+    bench_hlist_timers(opt.elements);
+    /* 变长消息的长度分布固定，同样只测一次 */
+    std::vector<unsigned char> payload(kMaxMessage);
+    for (uint32_t i = 0; i < kMaxMessage; ++i) payload[i] = (unsigned char)i;
+    bench_hring(opt.elements, payload.data());
+    bench_hqueue_padded(opt.elements, payload.data());
+    bench_malloc_messages(opt.elements, payload.data());
+#if !HLIBC_USE_STATIC_ALLOC
+    bench_hlist_var(opt.elements, payload.data());
+    bench_hlist_blob(opt.elements, payload.data());
+#endif
+
+    if (opt.json_path != nullptr) {
+        if (!write_json(opt.json_path, opt.elements)) {
+            std::fprintf(stderr, "cannot write %s\n", opt.json_path);
+            return 1;
+        }
+        if (std::strcmp(opt.json_path, "-") == 0) return 0;
+    }
+    print_table(opt.elements);
+    return 0;
+}
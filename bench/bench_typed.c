@@ -0,0 +1,240 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/bench/bench_typed.c
+ * @Description: 类型特化容器（*_DECLARE）与通用 void* 接口的性能对比
+ * @other: None
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/list/hlist.h"
+#include "../src/list/hlist_typed.h"
+#include "../src/queue/hqueue.h"
+#include "../src/queue/hqueue_typed.h"
+#include "../src/stack/hstack.h"
+#include "../src/stack/hstack_typed.h"
+#include "bench_util.h"
+
+typedef struct {
+    uint64_t v[8];
+} rec64_t;
+
+HSTACK_DECLARE(int_stack, int)
+HQUEUE_DECLARE(int_queue, int)
+HLIST_DECLARE(int_list, int)
+HSTACK_DECLARE(rec_stack, rec64_t)
+HQUEUE_DECLARE(rec_queue, rec64_t)
+HLIST_DECLARE(rec_list, rec64_t)
+
+static uint32_t s_count = 1u << 20;
+
+static void report(const char* container, const char* type, const char* api,
+                   uint64_t ns, uint64_t ops)
+{
+    printf("%-6s %-6s %-8s %8.2f ns/op\n", container, type, api,
+           (double)ns / (double)ops);
+}
+
+static int make_int(uint32_t i) { return (int)i; }
+
+static rec64_t make_rec64(uint32_t i)
+{
+    rec64_t r;
+    for (int k = 0; k < 8; ++k) r.v[k] = i + (uint64_t)k;
+    return r;
+}
+
+/* ==================== 通用 void* 接口 ==================== */
+
+#define BENCH_GENERIC(T, tname, make)                                          \
+    static void bench_generic_##tname(void)                                    \
+    {                                                                          \
+        uint32_t n = s_count;                                                  \
+        uint64_t t0, sum = 0;                                                  \
+        T value;                                                               \
+                                                                               \
+        /* stack */                                                            \
+        hstack_ptr_t stack = bench_create_stack(sizeof(T), n);                 \
+        t0 = bench_now_ns();                                                   \
+        for (uint32_t i = 0; i < n; ++i) {                                     \
+            value = make(i);                                                   \
+            hstack_push(stack, &value, sizeof(T), NULL);                       \
+        }                                                                      \
+        while (!hstack_empty(stack)) {                                         \
+            sum += *(const uint8_t*)hstack_top(stack);                         \
+            hstack_pop(stack);                                                 \
+        }                                                                      \
+        report("stack", #tname, "generic", bench_now_ns() - t0, 2ull * n);     \
+        hstack_destroy(stack);                                                 \
+                                                                               \
+        /* queue */                                                            \
+        hqueue_ptr_t queue = bench_create_queue(sizeof(T), n);                 \
+        t0 = bench_now_ns();                                                   \
+        for (uint32_t i = 0; i < n; ++i) {                                     \
+            value = make(i);                                                   \
+            hqueue_push(queue, &value, sizeof(T), NULL);                       \
+        }                                                                      \
+        while (!hqueue_empty(queue)) {                                         \
+            sum += *(const uint8_t*)hqueue_front(queue);                       \
+            hqueue_pop(queue);                                                 \
+        }                                                                      \
+        report("queue", #tname, "generic", bench_now_ns() - t0, 2ull * n);     \
+        hqueue_destroy(queue);                                                 \
+                                                                               \
+        /* list：尾插 + 遍历 + 头删 */                                         \
+        hlist_ptr_t list = bench_create_list(sizeof(T), n);                    \
+        t0 = bench_now_ns();                                                   \
+        for (uint32_t i = 0; i < n; ++i) {                                     \
+            value = make(i);                                                   \
+            hlist_push_back(list, &value, sizeof(T));                          \
+        }                                                                      \
+        hlist_iterator_ptr_t it = hlist_begin(list);                           \
+        for (uint32_t i = 0; i < n; ++i) {                                     \
+            sum += *(const uint8_t*)hlist_iter_data(it);                       \
+            hlist_iter_forward(&it);                                           \
+        }                                                                      \
+        while (!hlist_empty(list)) hlist_pop_front(list);                      \
+        report("list", #tname, "generic", bench_now_ns() - t0, 3ull * n);      \
+        hlist_destroy(list);                                                   \
+        BENCH_KEEP(sum);                                                       \
+    }
+
+/* ==================== 类型特化接口 ==================== */
+
+#define BENCH_TYPED(T, tname, make)                                            \
+    static void bench_typed_##tname(void)                                      \
+    {                                                                          \
+        uint32_t n = s_count;                                                  \
+        uint64_t t0, sum = 0;                                                  \
+                                                                               \
+        tname##_stack_t stack;                                                 \
+        BENCH_INIT_TYPED(tname##_stack, &stack, T, n);                         \
+        t0 = bench_now_ns();                                                   \
+        for (uint32_t i = 0; i < n; ++i) tname##_stack_push(&stack, make(i));  \
+        while (!tname##_stack_empty(&stack)) {                                 \
+            sum += *(const uint8_t*)tname##_stack_top(&stack);                 \
+            tname##_stack_pop(&stack);                                         \
+        }                                                                      \
+        report("stack", #tname, "typed", bench_now_ns() - t0, 2ull * n);       \
+        BENCH_DESTROY_TYPED(tname##_stack, &stack);                            \
+                                                                               \
+        tname##_queue_t queue;                                                 \
+        BENCH_INIT_TYPED(tname##_queue, &queue, T, n);                         \
+        t0 = bench_now_ns();                                                   \
+        for (uint32_t i = 0; i < n; ++i) tname##_queue_push(&queue, make(i));  \
+        while (!tname##_queue_empty(&queue)) {                                 \
+            sum += *(const uint8_t*)tname##_queue_front(&queue);               \
+            tname##_queue_pop(&queue);                                         \
+        }                                                                      \
+        report("queue", #tname, "typed", bench_now_ns() - t0, 2ull * n);       \
+        BENCH_DESTROY_TYPED(tname##_queue, &queue);                            \
+                                                                               \
+        tname##_list_t list;                                                   \
+        BENCH_INIT_TYPED(tname##_list, &list, tname##_list_node_t, n);         \
+        t0 = bench_now_ns();                                                   \
+        for (uint32_t i = 0; i < n; ++i) tname##_list_push_back(&list, make(i));\
+        for (tname##_list_iter_t it = tname##_list_begin(&list);               \
+             it != tname##_list_end(&list); it = tname##_list_iter_next(it)) { \
+            sum += *(const uint8_t*)tname##_list_iter_data(it);                \
+        }                                                                      \
+        while (!tname##_list_empty(&list)) tname##_list_pop_front(&list);      \
+        report("list", #tname, "typed", bench_now_ns() - t0, 3ull * n);        \
+        BENCH_DESTROY_TYPED(tname##_list, &list);                              \
+        BENCH_KEEP(sum);                                                       \
+    }
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+
+static hstack_ptr_t bench_create_stack(uint32_t type_size, uint32_t n)
+{
+    (void)n;
+    return hstack_create(type_size);
+}
+
+static hqueue_ptr_t bench_create_queue(uint32_t type_size, uint32_t n)
+{
+    (void)n;
+    return hqueue_create(type_size);
+}
+
+static hlist_ptr_t bench_create_list(uint32_t type_size, uint32_t n)
+{
+    (void)n;
+    return hlist_create(type_size);
+}
+
+#define BENCH_INIT_TYPED(prefix, c, elem, n)    prefix##_init(c)
+#define BENCH_DESTROY_TYPED(prefix, c)          prefix##_destroy(c)
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+
+/* 静态模式的缓冲区由基准程序自己申请，库本身不做动态分配 */
+static void* s_buffers[8];
+static int s_buffer_count;
+
+static void* bench_buffer(size_t size)
+{
+    /* 按 HLIBC_STATIC_ALIGN 对齐，CALC 宏算出的大小才恰好够用 */
+    void* buffer = aligned_alloc(HLIBC_STATIC_ALIGN, HLIBC_ALIGN_UP(size, HLIBC_STATIC_ALIGN));
+    if (buffer == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    s_buffers[s_buffer_count++] = buffer;
+    return buffer;
+}
+
+static void bench_release_buffers(void)
+{
+    while (s_buffer_count > 0) free(s_buffers[--s_buffer_count]);
+}
+
+static hstack_ptr_t bench_create_stack(uint32_t type_size, uint32_t n)
+{
+    size_t size = HSTACK_BUFFER_SIZE(type_size, n);
+    return hstack_create_static(bench_buffer(size), (uint32_t)size, type_size);
+}
+
+static hqueue_ptr_t bench_create_queue(uint32_t type_size, uint32_t n)
+{
+    size_t size = HQUEUE_BUFFER_SIZE(type_size, n);
+    return hqueue_create_static(bench_buffer(size), (uint32_t)size, type_size);
+}
+
+static hlist_ptr_t bench_create_list(uint32_t type_size, uint32_t n)
+{
+    size_t size = HLIST_BUFFER_SIZE(type_size, n);
+    return hlist_create_static(bench_buffer(size), (uint32_t)size, type_size);
+}
+
+#define BENCH_INIT_TYPED(prefix, c, elem, n) \
+    prefix##_init_static(c, (elem*)bench_buffer((size_t)(n) * sizeof(elem)), n)
+#define BENCH_DESTROY_TYPED(prefix, c) \
+    (prefix##_destroy_static(c), bench_release_buffers())
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+BENCH_GENERIC(int, int, make_int)
+BENCH_GENERIC(rec64_t, rec, make_rec64)
+BENCH_TYPED(int, int, make_int)
+BENCH_TYPED(rec64_t, rec, make_rec64)
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quick") == 0) s_count = 1u << 12;
+    }
+
+    printf("elements: %u, mode: %s\n", s_count,
+           HLIBC_USE_STATIC_ALLOC ? "static" : "dynamic");
+    bench_generic_int();
+    bench_typed_int();
+    bench_generic_rec();
+    bench_typed_rec();
+#if HLIBC_USE_STATIC_ALLOC
+    bench_release_buffers();
+#endif
+    return 0;
+}
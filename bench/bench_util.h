@@ -0,0 +1,48 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/bench/bench_util.h
+ * @Description: 基准测试公共工具：计时与防止优化
+ * @other: None
+ */
+#ifndef __HLIBC_BENCH_UTIL_H__
+#define __HLIBC_BENCH_UTIL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <time.h>
+
+/*********************
+ *      MACROS
+ *********************/
+
+/* 阻止编译器把被测代码优化掉 */
+#if defined(__GNUC__) || defined(__clang__)
+#define BENCH_KEEP(value)   __asm__ __volatile__("" : : "g"(value) : "memory")
+#else
+#define BENCH_KEEP(value)   ((void)(value))
+#endif
+
+/**********************
+ *   INLINE FUNCTIONS
+ **********************/
+
+/* 单调时钟，单位纳秒 */
+static inline uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __HLIBC_BENCH_UTIL_H__ */
@@ -0,0 +1,330 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-19
+ * @FilePath: /hlibc/bench/check_concurrent.c
+ * @Description: 并发容器正确性检查：hcqueue 多生产者/多消费者、hwsdeque 拥有者/窃取者下的守恒与顺序
+ * @other: None
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/queue/hcqueue.h"
+#include "../src/stack/hwsdeque.h"
+
+/*
+ * 每个元素编码为 (线程号 << 32) | 序号，序号从 1 开始。
+ * 守恒：每个元素恰好被取出一次（seen 计数），顺序：同一消费者看到的同一生产者的序号严格递增。
+ */
+#define CHECK_MAX_THREADS   8u
+#define CHECK_VALUE(id, seq)    (((uint64_t)(id) << 32) | (seq))
+#define CHECK_ID(value)         ((uint32_t)((value) >> 32))
+#define CHECK_SEQ(value)        ((uint32_t)(value))
+
+typedef struct {
+    bool blocking;
+    hcqueue_ptr_t queue;
+    uint32_t producers;
+    uint32_t per_producer;
+    uint64_t total;
+    atomic_uint_fast64_t consumed;
+    atomic_uchar* seen;             /* 下标 id * per_producer + seq - 1 */
+    atomic_uint errors;
+    pthread_barrier_t start;
+} cqueue_check_t;
+
+typedef struct {
+    cqueue_check_t* check;
+    uint32_t id;
+} cqueue_thread_t;
+
+typedef struct {
+    hwsdeque_ptr_t deque;
+    uint32_t items;
+    atomic_uint_fast64_t taken;
+    atomic_uchar* seen;
+    atomic_uint errors;
+    pthread_barrier_t start;
+} wsdeque_check_t;
+
+static uint32_t s_items = 1u << 18;
+
+#if HLIBC_USE_STATIC_ALLOC
+/* 容量故意取非 2 的幂且很小，位置计数器会频繁回绕 */
+#define CHECK_CQUEUE_CAPACITY   3u
+#define CHECK_WSDEQUE_CAPACITY  64u
+#endif
+
+/* ==================== 公共 ==================== */
+
+/* 记录一次取出，重复取出计为错误 */
+static void mark_seen(atomic_uchar* seen, uint64_t index, atomic_uint* errors)
+{
+    if (atomic_fetch_add_explicit(&seen[index], 1, memory_order_relaxed) != 0)
+        atomic_fetch_add(errors, 1);
+}
+
+/* 统计从未被取出的元素 */
+static uint32_t count_missing(atomic_uchar* seen, uint64_t total)
+{
+    uint32_t missing = 0;
+    for (uint64_t i = 0; i < total; ++i)
+        missing += atomic_load_explicit(&seen[i], memory_order_relaxed) == 0 ? 1u : 0u;
+    return missing;
+}
+
+/* ==================== hcqueue ==================== */
+
+static hcqueue_ptr_t cq_create(void)
+{
+#if HLIBC_USE_STATIC_ALLOC
+    /* buffer 按缓存行对齐，队列结构体正好位于起始位置，销毁时可直接 free */
+    uint32_t size = HCQUEUE_CALC_BUFFER_SIZE(uint64_t, CHECK_CQUEUE_CAPACITY);
+    void* buffer = aligned_alloc(HLIBC_CACHE_LINE_SIZE,
+                                 HLIBC_ALIGN_UP(size, HLIBC_CACHE_LINE_SIZE));
+    hcqueue_ptr_t queue = hcqueue_create_static(buffer, size, sizeof(uint64_t));
+    if (queue != NULL && hcqueue_capacity(queue) != CHECK_CQUEUE_CAPACITY) {
+        printf("hcqueue capacity %u, expected %u\n", hcqueue_capacity(queue),
+               CHECK_CQUEUE_CAPACITY);
+        hcqueue_destroy_static(queue);
+        free(buffer);
+        return NULL;
+    }
+    return queue;
+#else
+    return hcqueue_create(sizeof(uint64_t));
+#endif
+}
+
+static void cq_destroy(hcqueue_ptr_t queue)
+{
+#if HLIBC_USE_STATIC_ALLOC
+    hcqueue_destroy_static(queue);
+    free(queue);
+#else
+    hcqueue_destroy(queue);
+#endif
+}
+
+static void* cq_producer_main(void* arg)
+{
+    cqueue_thread_t* self = (cqueue_thread_t*)arg;
+    cqueue_check_t* check = self->check;
+    pthread_barrier_wait(&check->start);
+    for (uint32_t seq = 1; seq <= check->per_producer; ++seq) {
+        uint64_t value = CHECK_VALUE(self->id, seq);
+        if (check->blocking) {
+            if (hcqueue_push_wait(check->queue, &value, sizeof(value), NULL, -1) != HLIB_OK)
+                atomic_fetch_add(&check->errors, 1);
+        } else {
+            while (hcqueue_push(check->queue, &value, sizeof(value), NULL) != HLIB_OK)
+                sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void* cq_consumer_main(void* arg)
+{
+    cqueue_thread_t* self = (cqueue_thread_t*)arg;
+    cqueue_check_t* check = self->check;
+    uint32_t last[CHECK_MAX_THREADS] = { 0 };
+    pthread_barrier_wait(&check->start);
+    while (atomic_load_explicit(&check->consumed, memory_order_relaxed) < check->total) {
+        uint64_t value;
+        hlib_status_t ret = check->blocking ? hcqueue_pop_wait(check->queue, &value, 10)
+                                            : hcqueue_pop(check->queue, &value);
+        if (ret != HLIB_OK) {
+            if (!check->blocking) sched_yield();
+            continue;
+        }
+        uint32_t id = CHECK_ID(value);
+        uint32_t seq = CHECK_SEQ(value);
+        if (id >= check->producers || seq == 0 || seq > check->per_producer || seq <= last[id]) {
+            atomic_fetch_add(&check->errors, 1);
+        } else {
+            last[id] = seq;
+            mark_seen(check->seen, (uint64_t)id * check->per_producer + seq - 1, &check->errors);
+        }
+        atomic_fetch_add_explicit(&check->consumed, 1, memory_order_relaxed);
+    }
+    return NULL;
+}
+
+static int check_cqueue(bool blocking, uint32_t producers, uint32_t consumers)
+{
+    cqueue_check_t check;
+    cqueue_thread_t threads[2 * CHECK_MAX_THREADS];
+    pthread_t handles[2 * CHECK_MAX_THREADS];
+    uint32_t n = producers + consumers;
+
+    check.blocking = blocking;
+    check.queue = cq_create();
+    if (check.queue == NULL) return 0;
+    check.producers = producers;
+    check.per_producer = s_items / producers;
+    check.total = (uint64_t)check.per_producer * producers;
+    atomic_init(&check.consumed, 0);
+    atomic_init(&check.errors, 0);
+    check.seen = (atomic_uchar*)calloc(check.total, sizeof(atomic_uchar));
+    pthread_barrier_init(&check.start, NULL, n);
+
+    for (uint32_t i = 0; i < n; ++i) {
+        threads[i].check = &check;
+        threads[i].id = i < producers ? i : i - producers;
+        pthread_create(&handles[i], NULL, i < producers ? cq_producer_main : cq_consumer_main,
+                       &threads[i]);
+    }
+    for (uint32_t i = 0; i < n; ++i) pthread_join(handles[i], NULL);
+
+    uint32_t errors = atomic_load(&check.errors);
+    uint32_t missing = count_missing(check.seen, check.total);
+    int ok = errors == 0 && missing == 0 && hcqueue_empty(check.queue);
+    char shape[16];
+    snprintf(shape, sizeof(shape), "%up/%uc", producers, consumers);
+    printf("%-14s %-7s %s", blocking ? "hcqueue wait" : "hcqueue", shape, ok ? "ok\n" : "FAILED");
+    if (!ok) printf(" (errors %u, missing %u)\n", errors, missing);
+
+    pthread_barrier_destroy(&check.start);
+    free(check.seen);
+    cq_destroy(check.queue);
+    return ok;
+}
+
+/* ==================== hwsdeque ==================== */
+
+static hwsdeque_ptr_t wsd_create(void)
+{
+#if HLIBC_USE_STATIC_ALLOC
+    /* 与 hcqueue 相同，buffer 按缓存行对齐，销毁时可直接 free 容器指针 */
+    uint32_t size = HWSDEQUE_CALC_BUFFER_SIZE(uint64_t, CHECK_WSDEQUE_CAPACITY);
+    return hwsdeque_create_static(aligned_alloc(HLIBC_CACHE_LINE_SIZE,
+                                                HLIBC_ALIGN_UP(size, HLIBC_CACHE_LINE_SIZE)),
+                                  size, sizeof(uint64_t));
+#else
+    return hwsdeque_create(sizeof(uint64_t), 0);
+#endif
+}
+
+/* 拥有者：放入全部元素，每放入几个就自己取出一个；静态分配下满了也自己取 */
+static void* wsd_owner_main(void* arg)
+{
+    wsdeque_check_t* check = (wsdeque_check_t*)arg;
+    pthread_barrier_wait(&check->start);
+    for (uint32_t seq = 1; seq <= check->items; ++seq) {
+        uint64_t value = seq;
+        while (hwsdeque_push(check->deque, &value, sizeof(value)) != HLIB_OK) {
+            uint64_t out;
+            if (hwsdeque_pop(check->deque, &out) == HLIB_OK) {
+                mark_seen(check->seen, out - 1, &check->errors);
+                atomic_fetch_add_explicit(&check->taken, 1, memory_order_relaxed);
+            }
+        }
+        if (seq % 3 == 0) {
+            uint64_t out;
+            if (hwsdeque_pop(check->deque, &out) == HLIB_OK) {
+                /* 拥有者取到的是自己最近放入且未被窃取的元素 */
+                if (out > seq) atomic_fetch_add(&check->errors, 1);
+                mark_seen(check->seen, out - 1, &check->errors);
+                atomic_fetch_add_explicit(&check->taken, 1, memory_order_relaxed);
+            }
+        }
+    }
+    return NULL;
+}
+
+/* 窃取者：top 端总是当前最早放入的元素，同一窃取者先后取到的序号严格递增 */
+static void* wsd_thief_main(void* arg)
+{
+    wsdeque_check_t* check = (wsdeque_check_t*)arg;
+    uint64_t last = 0;
+    pthread_barrier_wait(&check->start);
+    while (atomic_load_explicit(&check->taken, memory_order_relaxed) < check->items) {
+        uint64_t value;
+        hlib_status_t ret = hwsdeque_steal(check->deque, &value);
+        if (ret == HLIB_OK) {
+            if (value == 0 || value > check->items || value <= last) {
+                atomic_fetch_add(&check->errors, 1);
+            } else {
+                last = value;
+                mark_seen(check->seen, value - 1, &check->errors);
+            }
+            atomic_fetch_add_explicit(&check->taken, 1, memory_order_relaxed);
+        } else if (ret == HLIB_ERROR) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static int check_wsdeque(uint32_t thieves)
+{
+    wsdeque_check_t check;
+    pthread_t handles[CHECK_MAX_THREADS + 1];
+
+    check.deque = wsd_create();
+    if (check.deque == NULL) return 0;
+    check.items = s_items;
+    atomic_init(&check.taken, 0);
+    atomic_init(&check.errors, 0);
+    check.seen = (atomic_uchar*)calloc(check.items, sizeof(atomic_uchar));
+    pthread_barrier_init(&check.start, NULL, thieves + 1);
+
+    pthread_create(&handles[0], NULL, wsd_owner_main, &check);
+    for (uint32_t i = 1; i <= thieves; ++i)
+        pthread_create(&handles[i], NULL, wsd_thief_main, &check);
+    pthread_join(handles[0], NULL);
+    /* 拥有者放完后取走剩余的元素，窃取者同时继续窃取 */
+    uint64_t out;
+    while (hwsdeque_pop(check.deque, &out) == HLIB_OK) {
+        mark_seen(check.seen, out - 1, &check.errors);
+        atomic_fetch_add_explicit(&check.taken, 1, memory_order_relaxed);
+    }
+    for (uint32_t i = 1; i <= thieves; ++i) pthread_join(handles[i], NULL);
+
+    uint32_t errors = atomic_load(&check.errors);
+    uint32_t missing = count_missing(check.seen, check.items);
+    int ok = errors == 0 && missing == 0 && hwsdeque_empty(check.deque);
+    char shape[16];
+    snprintf(shape, sizeof(shape), "1o/%ut", thieves);
+    printf("%-14s %-7s %s", "hwsdeque", shape, ok ? "ok\n" : "FAILED");
+    if (!ok) printf(" (errors %u, missing %u)\n", errors, missing);
+
+    pthread_barrier_destroy(&check.start);
+    free(check.seen);
+#if HLIBC_USE_STATIC_ALLOC
+    hwsdeque_destroy_static(check.deque);
+    free(check.deque);
+#else
+    hwsdeque_destroy(check.deque);
+#endif
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t max_threads = 4;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            s_items = 1u << 15;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            max_threads = (uint32_t)strtoul(argv[++i], NULL, 10);
+            if (max_threads == 0 || max_threads > CHECK_MAX_THREADS) max_threads = 4;
+        } else {
+            fprintf(stderr, "usage: %s [--quick] [--threads N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    int ok = 1;
+    printf("items: %u\n", s_items);
+    for (uint32_t t = 1; t <= max_threads; t *= 2) {
+        ok &= check_cqueue(false, t, t);
+        ok &= check_cqueue(true, t, t);
+        ok &= check_wsdeque(t);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/example/cpp_example.cpp
+ * @Description: C++ 模板封装示例，支持动态和静态分配
+ * @other: None
+ */
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "../src/hlibc.hpp"
+
+extern "C" void cpp_example1(void);
+
+void cpp_example1(void)
+{
+#if HLIBC_USE_STATIC_ALLOC
+    HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t list_buf[HLIST_CALC_BUFFER_SIZE(std::string, 8)];
+    HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t queue_buf[HQUEUE_CALC_BUFFER_SIZE(std::unique_ptr<int>, 8)];
+    HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t stack_buf[HSTACK_CALC_BUFFER_SIZE(std::string, 8)];
+    hlibc::list<std::string> list(list_buf, sizeof(list_buf));
+    hlibc::queue<std::unique_ptr<int>> queue(queue_buf, sizeof(queue_buf));
+    hlibc::stack<std::string> stack(stack_buf, sizeof(stack_buf));
+#else
+    hlibc::list<std::string> list;
+    hlibc::queue<std::unique_ptr<int>> queue;
+    hlibc::stack<std::string> stack;
+#endif
+
+    /* 非平凡类型直接在容器节点中构造 */
+    list.emplace_back("world");
+    list.emplace_front("hello");
+    list.insert(std::next(list.begin()), ",");
+    for (const std::string& s : list) {
+        printf("%s ", s.c_str());
+    }
+    printf("\n");
+
+    /* 只能移动的类型 */
+    queue.push(std::unique_ptr<int>(new int(10)));
+    queue.emplace(new int(20));
+    while (!queue.empty()) {
+        std::unique_ptr<int> p = std::move(queue.front());
+        queue.pop();
+        printf("%d ", *p);
+    }
+    printf("\n");
+
+    stack.emplace(3, 'a');
+    stack.push("bb");
+    while (!stack.empty()) {
+        printf("%s ", stack.top().c_str());
+        stack.pop();
+    }
+    printf("\n");
+}
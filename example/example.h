@@ -17,4 +17,6 @@ void stack_example1(void);
 
 void queue_example1(void);
 
+void cpp_example1(void);
+
 #endif
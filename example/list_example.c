@@ -21,7 +21,7 @@ struct test_str
 void list_example1(void)
 {
 #if HLIBC_USE_STATIC_ALLOC
-  static uint8_t my_list_buffer[HLIST_CALC_BUFFER_SIZE(int, 8)];
+  HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t my_list_buffer[HLIST_CALC_BUFFER_SIZE(int, 8)];
   hlist_ptr_t list =
       hlist_create_static(my_list_buffer, sizeof(my_list_buffer), sizeof(int));
 #else
@@ -51,7 +51,7 @@ void list_example2(void)
 {
     struct test_str t1;
 #if HLIBC_USE_STATIC_ALLOC
-    static uint8_t my_list_buffer[HLIST_CALC_BUFFER_SIZE(struct test_str, 8)];
+    HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t my_list_buffer[HLIST_CALC_BUFFER_SIZE(struct test_str, 8)];
     hlist_ptr_t list = hlist_create_static(
         my_list_buffer, sizeof(my_list_buffer), sizeof(struct test_str));
 #else
@@ -76,7 +76,7 @@ void list_example2(void)
 void list_example3(void)
 {
 #if HLIBC_USE_STATIC_ALLOC
-  static uint8_t my_list_buffer[HLIST_CALC_BUFFER_SIZE(struct test_str*, 8)];
+  HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t my_list_buffer[HLIST_CALC_BUFFER_SIZE(struct test_str*, 8)];
   hlist_ptr_t list = hlist_create_static(my_list_buffer, sizeof(my_list_buffer),
                                          sizeof(struct test_str*));
 #else
@@ -23,5 +23,8 @@ int main(int argc, char** argv) {
   printf("---------queue data struct test---------\n");
   queue_example1();
 
+  printf("---------c++ wrapper test---------\n");
+  cpp_example1();
+
   return 0;
 }
@@ -22,7 +22,7 @@ static void copy_data(void* dest, const void* src)
 void queue_example1(void)
 {
 #if HLIBC_USE_STATIC_ALLOC
-  static uint8_t queue_buf[HQUEUE_CALC_BUFFER_SIZE(int, 8)];
+  HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t queue_buf[HQUEUE_CALC_BUFFER_SIZE(int, 8)];
   hqueue_ptr_t queue =
       hqueue_create_static(queue_buf, sizeof(queue_buf), sizeof(int));
 #else
@@ -22,7 +22,7 @@
 void stack_example1(void)
 {
 #if HLIBC_USE_STATIC_ALLOC
-  static uint8_t stack_buf[HSTACK_CALC_BUFFER_SIZE(int, 16)];
+  HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t stack_buf[HSTACK_CALC_BUFFER_SIZE(int, 16)];
   hstack_ptr_t stack =
       hstack_create_static(stack_buf, sizeof(stack_buf), sizeof(int));
 #else
@@ -0,0 +1,813 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/btree/hbtree.c
+ * @Description: 定长键值的 B+ 树有序映射，节点宽度为若干缓存行，叶子互相链接便于范围遍历
+ * @other: None
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "hbtree.h"
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+#include "../common/harena.h"
+#endif
+
+/*********************
+ *      MACROS
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/* 节点头，键数组紧随其后 */
+typedef struct btree_node {
+    uint32_t count;             /* 叶子：键值对数；内部节点：键数（子节点数为 count + 1） */
+    uint32_t leaf;
+    struct btree_node* prev;    /* 叶子链表，内部节点不使用 */
+    struct btree_node* next;
+} btree_node_t;
+
+struct hbtree {
+    btree_node_t* root;
+    btree_node_t* first;        /* 最左的叶子 */
+    hbtree_cmp_f cmp;           /* NULL 表示 memcmp */
+    uint8_t* scratch;           /* 两个键大小的暂存区，内部节点分裂时保存上移的键 */
+    uint32_t size;
+    uint32_t height;
+    uint32_t key_size;
+    uint32_t value_size;
+    uint32_t leaf_cap;
+    uint32_t inner_cap;
+    uint32_t value_offset;      /* 叶子中值数组的偏移 */
+    uint32_t child_offset;      /* 内部节点中子节点指针数组的偏移 */
+    uint32_t node_size;
+#if HLIBC_USE_STATIC_ALLOC == 0
+    harena_t arena;             /* 节点池，每个槽位一个节点 */
+#else
+    hpool_region_t nodes;       /* buffer 中的节点池 */
+#endif
+};
+
+_Static_assert(sizeof(btree_node_t) == HBTREE_NODE_HEADER_SIZE,
+               "HBTREE_NODE_HEADER_SIZE does not match btree_node_t");
+#if HLIBC_USE_STATIC_ALLOC == 1
+/* 头文件中的布局镜像必须与实际结构体一致 */
+_Static_assert(sizeof(struct hbtree) == HBTREE_STRUCT_SIZE &&
+               _Alignof(struct hbtree) == _Alignof(hbtree_static_layout_t),
+               "hbtree_static_layout_t does not match struct hbtree");
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void tree_init(hbtree_ptr_t tree, uint32_t key_size, uint32_t value_size,
+                      hbtree_cmp_f cmp);
+static bool node_reserve(hbtree_ptr_t tree, uint32_t count);
+static btree_node_t* node_alloc(hbtree_ptr_t tree, bool leaf);
+static void node_free(hbtree_ptr_t tree, btree_node_t* node);
+static void nodes_reset(hbtree_ptr_t tree);
+static uint32_t lower_bound(hbtree_ptr_t tree, btree_node_t* node, hcdata_ptr_t key);
+static uint32_t upper_bound(hbtree_ptr_t tree, btree_node_t* node, hcdata_ptr_t key);
+static btree_node_t* find_leaf(hbtree_ptr_t tree, hcdata_ptr_t key);
+static void leaf_insert(hbtree_ptr_t tree, btree_node_t* leaf, uint32_t pos,
+                        hcdata_ptr_t key, hcdata_ptr_t value);
+static btree_node_t* leaf_split(hbtree_ptr_t tree, btree_node_t* leaf, uint32_t pos,
+                                hcdata_ptr_t key, hcdata_ptr_t value);
+static void inner_insert(hbtree_ptr_t tree, btree_node_t* node, uint32_t pos,
+                         hcdata_ptr_t key, btree_node_t* child);
+static btree_node_t* inner_split(hbtree_ptr_t tree, btree_node_t* node, uint32_t pos,
+                                 hcdata_ptr_t* key, btree_node_t* child, uint8_t* up);
+static void rebalance(hbtree_ptr_t tree, btree_node_t* parent, uint32_t pos);
+static void merge(hbtree_ptr_t tree, btree_node_t* parent, uint32_t pos);
+static uint32_t bulk_chunk(uint32_t remaining, uint32_t cap, uint32_t min);
+static hcdata_ptr_t subtree_min(hbtree_ptr_t tree, btree_node_t* node);
+
+/* 节点内的数组 */
+static inline uint8_t* node_key(hbtree_ptr_t tree, btree_node_t* node, uint32_t i)
+{
+    return (uint8_t*)node + HBTREE_NODE_HEADER_SIZE + (size_t)i * tree->key_size;
+}
+
+static inline uint8_t* leaf_value(hbtree_ptr_t tree, btree_node_t* node, uint32_t i)
+{
+    return (uint8_t*)node + tree->value_offset + (size_t)i * tree->value_size;
+}
+
+static inline btree_node_t** node_children(hbtree_ptr_t tree, btree_node_t* node)
+{
+    return (btree_node_t**)((uint8_t*)node + tree->child_offset);
+}
+
+static inline int key_cmp(hbtree_ptr_t tree, hcdata_ptr_t a, hcdata_ptr_t b)
+{
+    return tree->cmp != NULL ? tree->cmp(a, b) : memcmp(a, b, tree->key_size);
+}
+
+/* 在节点之间或节点内部搬移键值对/键与子节点 */
+static inline void move_keys(hbtree_ptr_t tree, btree_node_t* dst, uint32_t di,
+                             btree_node_t* src, uint32_t si, uint32_t n)
+{
+    memmove(node_key(tree, dst, di), node_key(tree, src, si), (size_t)n * tree->key_size);
+}
+
+static inline void move_values(hbtree_ptr_t tree, btree_node_t* dst, uint32_t di,
+                               btree_node_t* src, uint32_t si, uint32_t n)
+{
+    memmove(leaf_value(tree, dst, di), leaf_value(tree, src, si), (size_t)n * tree->value_size);
+}
+
+static inline void move_children(hbtree_ptr_t tree, btree_node_t* dst, uint32_t di,
+                                 btree_node_t* src, uint32_t si, uint32_t n)
+{
+    memmove(node_children(tree, dst) + di, node_children(tree, src) + si,
+            (size_t)n * sizeof(btree_node_t*));
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/* ==================== 动态分配实现 ==================== */
+
+hbtree_ptr_t hbtree_create(uint32_t key_size, uint32_t value_size, hbtree_cmp_f cmp)
+{
+    if (key_size == 0 || value_size == 0) return NULL;
+    size_t size = HLIBC_ALIGN_UP(sizeof(struct hbtree), HARENA_ALIGN) + 2 * (size_t)key_size;
+    hbtree_ptr_t tree = (hbtree_ptr_t)hallocator_alloc(NULL, size);
+    if (tree == NULL) return NULL;
+    tree->scratch = (uint8_t*)tree + HLIBC_ALIGN_UP(sizeof(struct hbtree), HARENA_ALIGN);
+    harena_init(&tree->arena, (uint32_t)HBTREE_NODE_BYTES(key_size, value_size), NULL);
+    tree_init(tree, key_size, value_size, cmp);
+    return tree;
+}
+
+void hbtree_destroy(hbtree_ptr_t tree)
+{
+    harena_release(&tree->arena);
+    hallocator_free(NULL, tree,
+                    HLIBC_ALIGN_UP(sizeof(struct hbtree), HARENA_ALIGN) + 2 * (size_t)tree->key_size);
+}
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+/* ==================== 静态分配实现 ==================== */
+
+hbtree_ptr_t hbtree_create_static(void* buffer, uint32_t buffer_size, uint32_t key_size,
+                                  uint32_t value_size, hbtree_cmp_f cmp)
+{
+    if (buffer == NULL || key_size == 0 || value_size == 0) return NULL;
+
+    /* 未对齐的 buffer 先跳过开头的若干字节 */
+    uint8_t* base = (uint8_t*)HLIBC_ALIGN_UP((uintptr_t)buffer, HLIBC_STATIC_ALIGN);
+    size_t header_size = HLIBC_ALIGN_UP(sizeof(struct hbtree), HLIBC_STATIC_ALIGN) +
+                         HLIBC_ALIGN_UP(2 * (size_t)key_size, HLIBC_STATIC_ALIGN);
+    size_t used = (size_t)(base - (uint8_t*)buffer) + header_size;
+    size_t node_size = HBTREE_NODE_BYTES(key_size, value_size);
+    if (buffer_size < used + node_size) return NULL;
+
+    hbtree_ptr_t tree = (hbtree_ptr_t)base;
+    tree->scratch = base + HLIBC_ALIGN_UP(sizeof(struct hbtree), HLIBC_STATIC_ALIGN);
+    hpool_region_init(&tree->nodes, base + header_size, (uint32_t)node_size,
+                      (uint32_t)((buffer_size - used) / node_size));
+    tree_init(tree, key_size, value_size, cmp);
+    return tree;
+}
+
+void hbtree_destroy_static(hbtree_ptr_t tree)
+{
+    if (tree == NULL) return;
+    /* 静态分配不释放内存，只重置状态 */
+    hbtree_clear(tree);
+}
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+int hbtree_cmp_u32(hcdata_ptr_t a, hcdata_ptr_t b)
+{
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+int hbtree_cmp_u64(hcdata_ptr_t a, hcdata_ptr_t b)
+{
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+int hbtree_cmp_i32(hcdata_ptr_t a, hcdata_ptr_t b)
+{
+    int32_t x = *(const int32_t*)a, y = *(const int32_t*)b;
+    return (x > y) - (x < y);
+}
+
+int hbtree_cmp_i64(hcdata_ptr_t a, hcdata_ptr_t b)
+{
+    int64_t x = *(const int64_t*)a, y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+hlib_status_t hbtree_put(hbtree_ptr_t tree, hcdata_ptr_t key, hcdata_ptr_t value)
+{
+    btree_node_t* path[HBTREE_MAX_HEIGHT];
+    uint32_t slot[HBTREE_MAX_HEIGHT];
+    uint32_t depth = 0;
+
+    if (tree->root == NULL) {
+        if (!node_reserve(tree, 1)) return HLIBC_USE_STATIC_ALLOC ? HLIB_OVERFLOW : HLIB_ERROR;
+        tree->root = tree->first = node_alloc(tree, true);
+        tree->height = 1;
+    }
+
+    btree_node_t* node = tree->root;
+    while (!node->leaf) {
+        uint32_t i = upper_bound(tree, node, key);
+        path[depth] = node;
+        slot[depth++] = i;
+        node = node_children(tree, node)[i];
+    }
+    uint32_t pos = lower_bound(tree, node, key);
+    if (pos < node->count && key_cmp(tree, node_key(tree, node, pos), key) == 0) {
+        memcpy(leaf_value(tree, node, pos), value, tree->value_size);
+        return HLIB_OK;
+    }
+    if (node->count < tree->leaf_cap) {
+        leaf_insert(tree, node, pos, key, value);
+        ++tree->size;
+        return HLIB_OK;
+    }
+
+    /* 需要分裂：从叶子向上数连续满的节点（根也满时还要一个新根），先预留节点，失败时树保持不变 */
+    uint32_t need = 1, d = depth;
+    while (d > 0 && path[d - 1]->count == tree->inner_cap) {
+        ++need;
+        --d;
+    }
+    if (d == 0) ++need;
+    if (depth + 1 >= HBTREE_MAX_HEIGHT && d == 0) return HLIB_ERROR;
+    if (!node_reserve(tree, need)) return HLIBC_USE_STATIC_ALLOC ? HLIB_OVERFLOW : HLIB_ERROR;
+
+    /* 分隔键是右半部分的最小键，逐层插入父节点，父节点满时继续分裂 */
+    btree_node_t* right = leaf_split(tree, node, pos, key, value);
+    hcdata_ptr_t sep = node_key(tree, right, 0);
+    uint32_t turn = 0;
+    ++tree->size;
+    while (depth > 0) {
+        btree_node_t* parent = path[--depth];
+        if (parent->count < tree->inner_cap) {
+            inner_insert(tree, parent, slot[depth], sep, right);
+            return HLIB_OK;
+        }
+        /* 上移的键交替存放在两个暂存区中，不会覆盖正在插入的键 */
+        right = inner_split(tree, parent, slot[depth], &sep, right,
+                            tree->scratch + turn * tree->key_size);
+        turn ^= 1;
+    }
+
+    /* 根节点分裂，树长高一层 */
+    btree_node_t* root = node_alloc(tree, false);
+    root->count = 1;
+    memcpy(node_key(tree, root, 0), sep, tree->key_size);
+    node_children(tree, root)[0] = tree->root;
+    node_children(tree, root)[1] = right;
+    tree->root = root;
+    ++tree->height;
+    return HLIB_OK;
+}
+
+hlib_status_t hbtree_bulk_load(hbtree_ptr_t tree, hcdata_ptr_t keys, hcdata_ptr_t values,
+                               uint32_t count)
+{
+    if (tree->root != NULL) return HLIB_ERROR;
+    if (count == 0) return HLIB_OK;
+    const uint8_t* key = (const uint8_t*)keys;
+    const uint8_t* value = (const uint8_t*)values;
+    for (uint32_t i = 1; i < count; ++i) {
+        if (key_cmp(tree, key + (size_t)(i - 1) * tree->key_size,
+                    key + (size_t)i * tree->key_size) >= 0)
+            return HLIB_ERROR;
+    }
+
+    /* 逐层统计节点数并一次预留 */
+    uint32_t total = 0, height = 0;
+    for (uint32_t n = count, cap = tree->leaf_cap;; cap = tree->inner_cap + 1) {
+        n = n / cap + (n % cap != 0);
+        total += n;
+        ++height;
+        if (n == 1) break;
+    }
+    if (height > HBTREE_MAX_HEIGHT) return HLIB_ERROR;
+    if (!node_reserve(tree, total)) return HLIBC_USE_STATIC_ALLOC ? HLIB_OVERFLOW : HLIB_ERROR;
+
+    /* 叶子层：按顺序装满，最后两个叶子平分剩余的键以保证半满 */
+    btree_node_t* prev = NULL;
+    uint32_t level_nodes = 0;
+    for (uint32_t done = 0; done < count; ++level_nodes) {
+        btree_node_t* leaf = node_alloc(tree, true);
+        uint32_t n = bulk_chunk(count - done, tree->leaf_cap, tree->leaf_cap / 2);
+        memcpy(node_key(tree, leaf, 0), key + (size_t)done * tree->key_size,
+               (size_t)n * tree->key_size);
+        memcpy(leaf_value(tree, leaf, 0), value + (size_t)done * tree->value_size,
+               (size_t)n * tree->value_size);
+        leaf->count = n;
+        leaf->prev = prev;
+        if (prev != NULL) prev->next = leaf;
+        else tree->first = leaf;
+        prev = leaf;
+        done += n;
+    }
+
+    /* 内部节点层：把下一层的节点按顺序分组，组内第 i 个子树的最小键作为第 i - 1 个分隔键 */
+    btree_node_t* level = tree->first;
+    while (level_nodes > 1) {
+        btree_node_t* child = level;
+        btree_node_t* upper_prev = NULL;
+        uint32_t upper_nodes = 0;
+        for (uint32_t done = 0; done < level_nodes; ++upper_nodes) {
+            btree_node_t* node = node_alloc(tree, false);
+            uint32_t n = bulk_chunk(level_nodes - done, tree->inner_cap + 1,
+                                    tree->inner_cap / 2 + 1);
+            btree_node_t** children = node_children(tree, node);
+            for (uint32_t i = 0; i < n; ++i) {
+                if (i > 0) memcpy(node_key(tree, node, i - 1), subtree_min(tree, child), tree->key_size);
+                children[i] = child;
+                child = child->next;
+            }
+            node->count = n - 1;
+            /* 建树期间借用 next 把同一层的内部节点串起来 */
+            if (upper_prev != NULL) upper_prev->next = node;
+            else level = node;
+            upper_prev = node;
+            done += n;
+        }
+        level_nodes = upper_nodes;
+    }
+    /* 内部节点的 next 不再使用 */
+    for (btree_node_t* node = level; !node->leaf; node = node_children(tree, node)[0]) {
+        for (btree_node_t* it = node; it != NULL;) {
+            btree_node_t* next = it->next;
+            it->next = NULL;
+            it = next;
+        }
+    }
+
+    tree->root = level;
+    tree->height = height;
+    tree->size = count;
+    return HLIB_OK;
+}
+
+bool hbtree_remove(hbtree_ptr_t tree, hcdata_ptr_t key)
+{
+    btree_node_t* path[HBTREE_MAX_HEIGHT];
+    uint32_t slot[HBTREE_MAX_HEIGHT];
+    uint32_t depth = 0;
+    if (tree->root == NULL) return false;
+
+    btree_node_t* node = tree->root;
+    while (!node->leaf) {
+        uint32_t i = upper_bound(tree, node, key);
+        path[depth] = node;
+        slot[depth++] = i;
+        node = node_children(tree, node)[i];
+    }
+    uint32_t pos = lower_bound(tree, node, key);
+    if (pos == node->count || key_cmp(tree, node_key(tree, node, pos), key) != 0) return false;
+
+    /* 删除后父节点中的分隔键可能不再出现在叶子中，但仍然正确地划分左右子树，不需要更新 */
+    move_keys(tree, node, pos, node, pos + 1, node->count - pos - 1);
+    move_values(tree, node, pos, node, pos + 1, node->count - pos - 1);
+    --node->count;
+    --tree->size;
+
+    /* 自下而上修复不足半满的节点 */
+    while (depth > 0) {
+        uint32_t min = node->leaf ? tree->leaf_cap / 2 : tree->inner_cap / 2;
+        if (node->count >= min) break;
+        node = path[--depth];
+        rebalance(tree, node, slot[depth]);
+    }
+
+    btree_node_t* root = tree->root;
+    if (root->count == 0) {
+        /* 根只剩一个子节点时树降低一层；根叶子为空时树变为空树 */
+        tree->root = root->leaf ? NULL : node_children(tree, root)[0];
+        if (root->leaf) tree->first = NULL;
+        --tree->height;
+        node_free(tree, root);
+    }
+    return true;
+}
+
+void hbtree_clear(hbtree_ptr_t tree)
+{
+    nodes_reset(tree);
+    tree->root = NULL;
+    tree->first = NULL;
+    tree->size = 0;
+    tree->height = 0;
+}
+
+/*=======================
+ * Getter functions
+ *======================*/
+
+hdata_ptr_t hbtree_get(hbtree_ptr_t tree, hcdata_ptr_t key)
+{
+    btree_node_t* leaf = find_leaf(tree, key);
+    if (leaf == NULL) return NULL;
+    uint32_t pos = lower_bound(tree, leaf, key);
+    if (pos == leaf->count || key_cmp(tree, node_key(tree, leaf, pos), key) != 0) return NULL;
+    return leaf_value(tree, leaf, pos);
+}
+
+uint32_t hbtree_size(hbtree_ptr_t tree)
+{
+    return tree->size;
+}
+
+bool hbtree_empty(hbtree_ptr_t tree)
+{
+    return tree->size == 0;
+}
+
+uint32_t hbtree_height(hbtree_ptr_t tree)
+{
+    return tree->height;
+}
+
+/*=======================
+ * Other functions
+ *======================*/
+
+bool hbtree_first(hbtree_ptr_t tree, hbtree_iter_t* iter)
+{
+    iter->node = tree->first;
+    iter->index = 0;
+    return tree->first != NULL;
+}
+
+bool hbtree_lower_bound(hbtree_ptr_t tree, hcdata_ptr_t key, hbtree_iter_t* iter)
+{
+    btree_node_t* leaf = find_leaf(tree, key);
+    if (leaf == NULL) return false;
+    uint32_t pos = lower_bound(tree, leaf, key);
+    /* 所有键都小于 key 时位于下一个叶子的开头 */
+    if (pos == leaf->count) {
+        leaf = leaf->next;
+        pos = 0;
+    }
+    iter->node = leaf;
+    iter->index = pos;
+    return leaf != NULL;
+}
+
+bool hbtree_iter_next(hbtree_ptr_t tree, hbtree_iter_t* iter)
+{
+    btree_node_t* leaf = (btree_node_t*)iter->node;
+    (void)tree;
+    if (++iter->index < leaf->count) return true;
+    if (leaf->next == NULL) {
+        --iter->index;
+        return false;
+    }
+    iter->node = leaf->next;
+    iter->index = 0;
+    return true;
+}
+
+hcdata_ptr_t hbtree_iter_key(hbtree_ptr_t tree, const hbtree_iter_t* iter)
+{
+    return node_key(tree, (btree_node_t*)iter->node, iter->index);
+}
+
+hdata_ptr_t hbtree_iter_value(hbtree_ptr_t tree, const hbtree_iter_t* iter)
+{
+    return leaf_value(tree, (btree_node_t*)iter->node, iter->index);
+}
+
+uint32_t hbtree_foreach_range(hbtree_ptr_t tree, hcdata_ptr_t lo, hcdata_ptr_t hi,
+                              hbtree_range_f fn, void* ctx)
+{
+    hbtree_iter_t iter;
+    bool found = lo != NULL ? hbtree_lower_bound(tree, lo, &iter) : hbtree_first(tree, &iter);
+    if (!found) return 0;
+
+    btree_node_t* leaf = (btree_node_t*)iter.node;
+    uint32_t pos = iter.index;
+    uint32_t visited = 0;
+    while (leaf != NULL) {
+        /* 叶子的最大键不小于 hi 时只扫描到 hi 之前，并且这是最后一个叶子 */
+        uint32_t end = leaf->count;
+        bool last = hi != NULL && key_cmp(tree, node_key(tree, leaf, end - 1), hi) >= 0;
+        if (last) end = lower_bound(tree, leaf, hi);
+        else HLIBC_PREFETCH(leaf->next);
+        for (; pos < end; ++pos) {
+            ++visited;
+            if (!fn(node_key(tree, leaf, pos), leaf_value(tree, leaf, pos), ctx)) return visited;
+        }
+        if (last) break;
+        leaf = leaf->next;
+        pos = 0;
+    }
+    return visited;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void tree_init(hbtree_ptr_t tree, uint32_t key_size, uint32_t value_size,
+                      hbtree_cmp_f cmp)
+{
+    tree->cmp = cmp;
+    tree->key_size = key_size;
+    tree->value_size = value_size;
+    tree->node_size = (uint32_t)HBTREE_NODE_BYTES(key_size, value_size);
+    tree->leaf_cap = (uint32_t)HBTREE_LEAF_CAP(key_size, value_size);
+    tree->inner_cap = (uint32_t)HBTREE_INNER_CAP(key_size, value_size);
+    tree->value_offset = (uint32_t)HLIBC_ALIGN_UP(
+        HBTREE_NODE_HEADER_SIZE + (size_t)tree->leaf_cap * key_size, 8);
+    tree->child_offset = (uint32_t)HLIBC_ALIGN_UP(
+        HBTREE_NODE_HEADER_SIZE + (size_t)tree->inner_cap * key_size, sizeof(void*));
+    hbtree_clear(tree);
+}
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/* ==================== 动态分配内部函数 ==================== */
+
+static bool node_reserve(hbtree_ptr_t tree, uint32_t count)
+{
+    return harena_reserve(&tree->arena, count);
+}
+
+static btree_node_t* node_alloc(hbtree_ptr_t tree, bool leaf)
+{
+    btree_node_t* node = (btree_node_t*)harena_alloc(&tree->arena);
+    node->count = 0;
+    node->leaf = leaf;
+    node->prev = NULL;
+    node->next = NULL;
+    return node;
+}
+
+static void node_free(hbtree_ptr_t tree, btree_node_t* node)
+{
+    harena_free(&tree->arena, node);
+}
+
+static void nodes_reset(hbtree_ptr_t tree)
+{
+    harena_release(&tree->arena);
+}
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+/* ==================== 静态分配内部函数 ==================== */
+
+static bool node_reserve(hbtree_ptr_t tree, uint32_t count)
+{
+    return hpool_region_available(&tree->nodes) >= count;
+}
+
+static btree_node_t* node_alloc(hbtree_ptr_t tree, bool leaf)
+{
+    /* 调用前已经 node_reserve，不会失败 */
+    btree_node_t* node = (btree_node_t*)hpool_region_alloc(&tree->nodes);
+    node->count = 0;
+    node->leaf = leaf;
+    node->prev = NULL;
+    node->next = NULL;
+    return node;
+}
+
+static void node_free(hbtree_ptr_t tree, btree_node_t* node)
+{
+    hpool_region_free(&tree->nodes, node);
+}
+
+static void nodes_reset(hbtree_ptr_t tree)
+{
+    hpool_region_reset(&tree->nodes);
+}
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+/* 第一个不小于 key 的位置 */
+static uint32_t lower_bound(hbtree_ptr_t tree, btree_node_t* node, hcdata_ptr_t key)
+{
+    uint32_t lo = 0, hi = node->count;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (key_cmp(tree, node_key(tree, node, mid), key) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* 第一个大于 key 的位置，即内部节点中 key 所在子树的下标 */
+static uint32_t upper_bound(hbtree_ptr_t tree, btree_node_t* node, hcdata_ptr_t key)
+{
+    uint32_t lo = 0, hi = node->count;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (key_cmp(tree, node_key(tree, node, mid), key) <= 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static btree_node_t* find_leaf(hbtree_ptr_t tree, hcdata_ptr_t key)
+{
+    btree_node_t* node = tree->root;
+    if (node == NULL) return NULL;
+    while (!node->leaf) node = node_children(tree, node)[upper_bound(tree, node, key)];
+    return node;
+}
+
+static void leaf_insert(hbtree_ptr_t tree, btree_node_t* leaf, uint32_t pos,
+                        hcdata_ptr_t key, hcdata_ptr_t value)
+{
+    move_keys(tree, leaf, pos + 1, leaf, pos, leaf->count - pos);
+    move_values(tree, leaf, pos + 1, leaf, pos, leaf->count - pos);
+    memcpy(node_key(tree, leaf, pos), key, tree->key_size);
+    memcpy(leaf_value(tree, leaf, pos), value, tree->value_size);
+    ++leaf->count;
+}
+
+/* 满叶子插入后分成两半，返回新的右叶子 */
+static btree_node_t* leaf_split(hbtree_ptr_t tree, btree_node_t* leaf, uint32_t pos,
+                                hcdata_ptr_t key, hcdata_ptr_t value)
+{
+    btree_node_t* right = node_alloc(tree, true);
+    uint32_t cap = tree->leaf_cap;
+    uint32_t left_n = (cap + 1) / 2;
+
+    if (pos < left_n) {
+        /* 新键落在左半：左边少留一个，插入后恰好 left_n 个 */
+        move_keys(tree, right, 0, leaf, left_n - 1, cap - left_n + 1);
+        move_values(tree, right, 0, leaf, left_n - 1, cap - left_n + 1);
+        right->count = cap - left_n + 1;
+        leaf->count = left_n - 1;
+        leaf_insert(tree, leaf, pos, key, value);
+    } else {
+        move_keys(tree, right, 0, leaf, left_n, cap - left_n);
+        move_values(tree, right, 0, leaf, left_n, cap - left_n);
+        right->count = cap - left_n;
+        leaf->count = left_n;
+        leaf_insert(tree, right, pos - left_n, key, value);
+    }
+
+    right->prev = leaf;
+    right->next = leaf->next;
+    if (leaf->next != NULL) leaf->next->prev = right;
+    leaf->next = right;
+    return right;
+}
+
+/* 在 pos 处插入键，子节点插在它的右边 */
+static void inner_insert(hbtree_ptr_t tree, btree_node_t* node, uint32_t pos,
+                         hcdata_ptr_t key, btree_node_t* child)
+{
+    move_keys(tree, node, pos + 1, node, pos, node->count - pos);
+    move_children(tree, node, pos + 2, node, pos + 1, node->count - pos);
+    memcpy(node_key(tree, node, pos), key, tree->key_size);
+    node_children(tree, node)[pos + 1] = child;
+    ++node->count;
+}
+
+/*
+ * 满的内部节点插入 (key, child) 后分裂：把插入后的 cap + 1 个键看作一个序列，
+ * 中间的键上移（复制到 up，并通过 *key 返回），左右各留一半，返回新的右节点
+ */
+static btree_node_t* inner_split(hbtree_ptr_t tree, btree_node_t* node, uint32_t pos,
+                                 hcdata_ptr_t* key, btree_node_t* child, uint8_t* up)
+{
+    btree_node_t* right = node_alloc(tree, false);
+    uint32_t cap = tree->inner_cap;
+    uint32_t mid = (cap + 1) / 2;
+
+    if (pos < mid) {
+        /* 上移原来的第 mid - 1 个键，新键插入左半 */
+        memcpy(up, node_key(tree, node, mid - 1), tree->key_size);
+        move_keys(tree, right, 0, node, mid, cap - mid);
+        move_children(tree, right, 0, node, mid, cap - mid + 1);
+        right->count = cap - mid;
+        node->count = mid - 1;
+        inner_insert(tree, node, pos, *key, child);
+        *key = up;
+    } else if (pos == mid) {
+        /* 新键本身上移，新子节点成为右半的第一个子节点 */
+        move_keys(tree, right, 0, node, mid, cap - mid);
+        move_children(tree, right, 1, node, mid + 1, cap - mid);
+        node_children(tree, right)[0] = child;
+        right->count = cap - mid;
+        node->count = mid;
+    } else {
+        /* 上移原来的第 mid 个键，新键插入右半 */
+        memcpy(up, node_key(tree, node, mid), tree->key_size);
+        move_keys(tree, right, 0, node, mid + 1, cap - mid - 1);
+        move_children(tree, right, 0, node, mid + 1, cap - mid);
+        right->count = cap - mid - 1;
+        node->count = mid;
+        inner_insert(tree, right, pos - mid - 1, *key, child);
+        *key = up;
+    }
+    return right;
+}
+
+/* parent 的第 pos 个子节点不足半满：优先向兄弟借一个，兄弟也只有半满时合并 */
+static void rebalance(hbtree_ptr_t tree, btree_node_t* parent, uint32_t pos)
+{
+    btree_node_t** children = node_children(tree, parent);
+    btree_node_t* node = children[pos];
+    btree_node_t* left = pos > 0 ? children[pos - 1] : NULL;
+    btree_node_t* right = pos < parent->count ? children[pos + 1] : NULL;
+    uint32_t min = node->leaf ? tree->leaf_cap / 2 : tree->inner_cap / 2;
+
+    if (left != NULL && left->count > min) {
+        /* 左兄弟的最后一项移到本节点开头 */
+        move_keys(tree, node, 1, node, 0, node->count);
+        if (node->leaf) {
+            move_values(tree, node, 1, node, 0, node->count);
+            move_keys(tree, node, 0, left, left->count - 1, 1);
+            move_values(tree, node, 0, left, left->count - 1, 1);
+            memcpy(node_key(tree, parent, pos - 1), node_key(tree, node, 0), tree->key_size);
+        } else {
+            move_children(tree, node, 1, node, 0, node->count + 1);
+            memcpy(node_key(tree, node, 0), node_key(tree, parent, pos - 1), tree->key_size);
+            node_children(tree, node)[0] = node_children(tree, left)[left->count];
+            memcpy(node_key(tree, parent, pos - 1), node_key(tree, left, left->count - 1),
+                   tree->key_size);
+        }
+        --left->count;
+        ++node->count;
+    } else if (right != NULL && right->count > min) {
+        /* 右兄弟的第一项移到本节点末尾 */
+        if (node->leaf) {
+            move_keys(tree, node, node->count, right, 0, 1);
+            move_values(tree, node, node->count, right, 0, 1);
+            move_keys(tree, right, 0, right, 1, right->count - 1);
+            move_values(tree, right, 0, right, 1, right->count - 1);
+            memcpy(node_key(tree, parent, pos), node_key(tree, right, 0), tree->key_size);
+        } else {
+            memcpy(node_key(tree, node, node->count), node_key(tree, parent, pos), tree->key_size);
+            node_children(tree, node)[node->count + 1] = node_children(tree, right)[0];
+            memcpy(node_key(tree, parent, pos), node_key(tree, right, 0), tree->key_size);
+            move_keys(tree, right, 0, right, 1, right->count - 1);
+            move_children(tree, right, 0, right, 1, right->count);
+        }
+        --right->count;
+        ++node->count;
+    } else {
+        merge(tree, parent, left != NULL ? pos - 1 : pos);
+    }
+}
+
+/* 把 parent 的第 pos + 1 个子节点并入第 pos 个子节点，并删除两者之间的分隔键 */
+static void merge(hbtree_ptr_t tree, btree_node_t* parent, uint32_t pos)
+{
+    btree_node_t** children = node_children(tree, parent);
+    btree_node_t* left = children[pos];
+    btree_node_t* right = children[pos + 1];
+
+    if (left->leaf) {
+        move_keys(tree, left, left->count, right, 0, right->count);
+        move_values(tree, left, left->count, right, 0, right->count);
+        left->count += right->count;
+        left->next = right->next;
+        if (right->next != NULL) right->next->prev = left;
+    } else {
+        /* 分隔键下移到两组键之间 */
+        memcpy(node_key(tree, left, left->count), node_key(tree, parent, pos), tree->key_size);
+        move_keys(tree, left, left->count + 1, right, 0, right->count);
+        move_children(tree, left, left->count + 1, right, 0, right->count + 1);
+        left->count += right->count + 1;
+    }
+    node_free(tree, right);
+
+    move_keys(tree, parent, pos, parent, pos + 1, parent->count - pos - 1);
+    move_children(tree, parent, pos + 1, parent, pos + 2, parent->count - pos - 1);
+    --parent->count;
+}
+
+/* 批量建树时下一个节点的条目数：装满，但剩余的不足 min 个时最后两个节点平分 */
+static uint32_t bulk_chunk(uint32_t remaining, uint32_t cap, uint32_t min)
+{
+    if (remaining <= cap) return remaining;
+    if (remaining - cap < min) return remaining / 2;
+    return cap;
+}
+
+static hcdata_ptr_t subtree_min(hbtree_ptr_t tree, btree_node_t* node)
+{
+    while (!node->leaf) node = node_children(tree, node)[0];
+    return node_key(tree, node, 0);
+}
@@ -0,0 +1,288 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/btree/hbtree.h
+ * @Description: 定长键值的 B+ 树有序映射，节点宽度为若干缓存行，叶子互相链接便于范围遍历
+ * @other: None
+ */
+#ifndef __HLIBC_HBTREE_H__
+#define __HLIBC_HBTREE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../common/hcommon.h"
+#include "../common/hlibc_config.h"
+#include "../pool/hpool.h"
+
+/*********************
+ *      MACROS
+ *********************/
+
+/* 树的最大高度，也是插入/删除时在栈上记录路径的长度 */
+#define HBTREE_MAX_HEIGHT       24
+
+/* 节点至少能容纳的键数 */
+#define HBTREE_MIN_FANOUT       4
+
+/*
+ * 节点布局: [节点头][键数组][对齐填充][值数组（叶子）或子节点指针数组（内部节点）]
+ * 键连续存放，节点内二分查找只触及键所在的缓存行
+ */
+#define HBTREE_NODE_HEADER_SIZE (8 + 2 * sizeof(void*)) /* count + leaf + prev + next */
+
+#define HBTREE_SLOT_BYTES(key_size, value_size) \
+  ((size_t)(key_size) + ((size_t)(value_size) > sizeof(void*) ? (size_t)(value_size) : sizeof(void*)))
+
+/* 节点大小：HLIBC_BTREE_NODE_SIZE，键值过大时放大到能容纳 HBTREE_MIN_FANOUT 个键 */
+#define HBTREE_NODE_BYTES(key_size, value_size)                                            \
+  HLIBC_ALIGN_UP(HBTREE_NODE_HEADER_SIZE + 8 + sizeof(void*) +                             \
+                         HBTREE_MIN_FANOUT * HBTREE_SLOT_BYTES(key_size, value_size) >     \
+                     HLIBC_BTREE_NODE_SIZE                                                 \
+                 ? HBTREE_NODE_HEADER_SIZE + 8 + sizeof(void*) +                           \
+                       HBTREE_MIN_FANOUT * HBTREE_SLOT_BYTES(key_size, value_size)         \
+                 : (size_t)HLIBC_BTREE_NODE_SIZE,                                          \
+                 HLIBC_CACHE_LINE_SIZE)
+
+/* 叶子最多容纳的键值对数、内部节点最多容纳的键数（子节点数再多一个），8 字节留给数组之间的对齐填充 */
+#define HBTREE_LEAF_CAP(key_size, value_size) \
+  ((HBTREE_NODE_BYTES(key_size, value_size) - HBTREE_NODE_HEADER_SIZE - 8) / \
+   ((size_t)(key_size) + (value_size)))
+#define HBTREE_INNER_CAP(key_size, value_size) \
+  ((HBTREE_NODE_BYTES(key_size, value_size) - HBTREE_NODE_HEADER_SIZE - 8 - sizeof(void*)) / \
+   ((size_t)(key_size) + sizeof(void*)))
+
+/*
+ * capacity 个键值对最坏情况下需要的节点数：除根以外每个节点至少半满，
+ * 叶子数不超过 capacity / (LEAF_CAP / 2) + 1，每层内部节点至少 INNER_CAP / 2 + 1 个子节点
+ */
+#define HBTREE_MAX_LEAVES(key_size, value_size, capacity) \
+  ((size_t)(capacity) / (HBTREE_LEAF_CAP(key_size, value_size) / 2) + 1)
+#define HBTREE_MAX_NODES(key_size, value_size, capacity)                 \
+  (HBTREE_MAX_LEAVES(key_size, value_size, capacity) +                   \
+   HBTREE_MAX_LEAVES(key_size, value_size, capacity) /                   \
+       (HBTREE_INNER_CAP(key_size, value_size) / 2) +                    \
+   HBTREE_MAX_HEIGHT)
+
+/*
+ * 静态分配结构体大小（精确值，hbtree.c 中用 _Static_assert 校验）
+ */
+#define HBTREE_STRUCT_SIZE sizeof(hbtree_static_layout_t)
+
+/**
+ * 计算静态 btree 所需的 buffer 大小，保证能容纳 capacity 个键值对
+ * buffer 按 HLIBC_STATIC_ALIGN 对齐时恰好够用（HBTREE_DEFINE_STATIC 会自动对齐）
+ * @param key_type 键类型
+ * @param value_type 值类型
+ * @param capacity 键值对个数上限
+ *
+ * 内存布局: [hbtree结构体][对齐填充][两个键大小的暂存区][对齐填充][节点池]
+ */
+#define HBTREE_CALC_BUFFER_SIZE(key_type, value_type, capacity) \
+  HBTREE_BUFFER_SIZE(sizeof(key_type), sizeof(value_type), capacity)
+
+/* 同上，键、值大小以字节数给出 */
+#define HBTREE_BUFFER_SIZE(key_size, value_size, capacity)                  \
+  (HLIBC_ALIGN_UP(HBTREE_STRUCT_SIZE, HLIBC_STATIC_ALIGN) +                 \
+   HLIBC_ALIGN_UP(2 * (size_t)(key_size), HLIBC_STATIC_ALIGN) +             \
+   HBTREE_MAX_NODES(key_size, value_size, capacity) * HBTREE_NODE_BYTES(key_size, value_size))
+
+/**
+ * 定义一个静态 btree（便捷宏）
+ * @param name 变量名
+ * @param key_type 键类型
+ * @param value_type 值类型
+ * @param capacity 键值对个数上限
+ * @param cmp 键比较函数
+ *
+ * 使用示例:
+ *   HBTREE_DEFINE_STATIC(my_index, uint32_t, struct record, 1024, hbtree_cmp_u32);
+ *   hbtree_put(my_index, &id, &record);
+ */
+#define HBTREE_DEFINE_STATIC(name, key_type, value_type, capacity, cmp)                   \
+  HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static                                                \
+      uint8_t name##_buffer[HBTREE_CALC_BUFFER_SIZE(key_type, value_type, capacity)];     \
+  hbtree_ptr_t name = hbtree_create_static(name##_buffer, sizeof(name##_buffer),          \
+                                           sizeof(key_type), sizeof(value_type), cmp)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct hbtree* hbtree_ptr_t;
+
+/* 键比较函数：a < b 返回负数，相等返回 0，a > b 返回正数 */
+typedef int (*hbtree_cmp_f)(hcdata_ptr_t a, hcdata_ptr_t b);
+
+/* 范围遍历回调，返回 false 时停止 */
+typedef bool (*hbtree_range_f)(hcdata_ptr_t key, hdata_ptr_t value, void* ctx);
+
+/* 迭代器：指向某个叶子中的一个键值对，树被修改后失效 */
+typedef struct {
+    void* node;
+    uint32_t index;
+} hbtree_iter_t;
+
+/*
+ * 静态分配模式下 struct hbtree 的布局镜像，仅用于在编译期得到精确大小，
+ * 字段必须与 hbtree.c 保持一致
+ */
+typedef struct {
+    void* root_;
+    void* first_;
+    hbtree_cmp_f cmp_;
+    void* scratch_;
+    uint32_t size_;
+    uint32_t height_;
+    uint32_t key_size_;
+    uint32_t value_size_;
+    uint32_t leaf_cap_;
+    uint32_t inner_cap_;
+    uint32_t value_offset_;
+    uint32_t child_offset_;
+    uint32_t node_size_;
+    hpool_region_t nodes_;
+} hbtree_static_layout_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/**
+ * 创建一个 btree（动态分配）
+ * @param key_size 键的字节数
+ * @param value_size 值的字节数
+ * @param cmp 键比较函数，NULL 表示按字节比较（memcmp）
+ * @return 返回新创建的 btree，失败返回 NULL
+ */
+extern hbtree_ptr_t hbtree_create(uint32_t key_size, uint32_t value_size, hbtree_cmp_f cmp);
+
+/**
+ * 删除给定的 btree（动态分配版本）
+ * @param tree 一个由 `hbtree_create` 返回的 btree
+ */
+extern void hbtree_destroy(hbtree_ptr_t tree);
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+
+/**
+ * 创建一个静态分配的 btree，节点全部来自 buffer 中的节点池
+ * @param buffer 用户提供的内存缓冲区
+ * @param buffer_size 缓冲区大小（使用 HBTREE_CALC_BUFFER_SIZE 宏计算）
+ * @param key_size 键的字节数
+ * @param value_size 值的字节数
+ * @param cmp 键比较函数，NULL 表示按字节比较（memcmp）
+ * @return 返回 btree 指针，失败返回 NULL
+ */
+extern hbtree_ptr_t hbtree_create_static(void* buffer, uint32_t buffer_size, uint32_t key_size,
+                                         uint32_t value_size, hbtree_cmp_f cmp);
+
+/**
+ * 销毁静态分配的 btree（仅清理内容，不释放内存）
+ * @param tree 一个由 `hbtree_create_static` 返回的 btree
+ */
+extern void hbtree_destroy_static(hbtree_ptr_t tree);
+
+/* 兼容性宏定义 */
+#define hbtree_create(key_size, value_size, cmp) \
+  ((void)(key_size), (void)(value_size), (void)(cmp), (hbtree_ptr_t)NULL) /* 静态模式下禁用 */
+#define hbtree_destroy(tree) hbtree_destroy_static(tree)
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+/* 常用整数键的比较函数 */
+extern int hbtree_cmp_u32(hcdata_ptr_t a, hcdata_ptr_t b);
+extern int hbtree_cmp_u64(hcdata_ptr_t a, hcdata_ptr_t b);
+extern int hbtree_cmp_i32(hcdata_ptr_t a, hcdata_ptr_t b);
+extern int hbtree_cmp_i64(hcdata_ptr_t a, hcdata_ptr_t b);
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+/**
+ * 插入一个键值对，键已存在时覆盖其值
+ * @return HLIB_OK 成功；HLIB_ERROR 内存不足（动态分配）；HLIB_OVERFLOW 节点池已满（静态分配）。失败时树不变
+ */
+extern hlib_status_t hbtree_put(hbtree_ptr_t tree, hcdata_ptr_t key, hcdata_ptr_t value);
+
+/**
+ * 从已排序的数组批量建树，自底向上逐层填满节点，比逐个插入快且节点更满
+ * @param tree 空树
+ * @param keys 严格递增的 count 个键，连续存放
+ * @param values 对应的 count 个值，连续存放
+ * @return HLIB_OK 成功；HLIB_ERROR 树非空、键未严格递增或内存不足；HLIB_OVERFLOW 节点池不足（静态分配）
+ */
+extern hlib_status_t hbtree_bulk_load(hbtree_ptr_t tree, hcdata_ptr_t keys, hcdata_ptr_t values,
+                                      uint32_t count);
+
+/**
+ * 删除一个键值对，节点不足半满时向兄弟节点借用或与之合并
+ * @return 键存在时返回 true
+ */
+extern bool hbtree_remove(hbtree_ptr_t tree, hcdata_ptr_t key);
+
+/**
+ * 清空 btree，节点全部归还节点池
+ */
+extern void hbtree_clear(hbtree_ptr_t tree);
+
+/*=======================
+ * Getter functions
+ *======================*/
+
+/**
+ * 查找
+ * @return 值的地址，可以原地修改，在树被修改前有效；不存在时返回 NULL
+ */
+extern hdata_ptr_t hbtree_get(hbtree_ptr_t tree, hcdata_ptr_t key);
+
+extern uint32_t hbtree_size(hbtree_ptr_t tree);
+extern bool hbtree_empty(hbtree_ptr_t tree);
+
+/* 树的高度：空树为 0，只有一个叶子时为 1 */
+extern uint32_t hbtree_height(hbtree_ptr_t tree);
+
+/*=======================
+ * Other functions
+ *======================*/
+
+/**
+ * 定位到最小的键
+ * @return 树为空时返回 false
+ */
+extern bool hbtree_first(hbtree_ptr_t tree, hbtree_iter_t* iter);
+
+/**
+ * 定位到第一个不小于 key 的键
+ * @return 不存在这样的键时返回 false
+ */
+extern bool hbtree_lower_bound(hbtree_ptr_t tree, hcdata_ptr_t key, hbtree_iter_t* iter);
+
+/**
+ * 前进到下一个键，沿叶子链表移动
+ * @return 已经是最后一个键时返回 false
+ */
+extern bool hbtree_iter_next(hbtree_ptr_t tree, hbtree_iter_t* iter);
+
+extern hcdata_ptr_t hbtree_iter_key(hbtree_ptr_t tree, const hbtree_iter_t* iter);
+extern hdata_ptr_t hbtree_iter_value(hbtree_ptr_t tree, const hbtree_iter_t* iter);
+
+/**
+ * 按键的顺序遍历 [lo, hi) 范围内的键值对，逐个叶子扫描，扫描当前叶子时预取下一个叶子
+ * @param lo 下界（包含），NULL 表示从最小的键开始
+ * @param hi 上界（不包含），NULL 表示到最大的键为止
+ * @return 交给 fn 的键值对个数
+ */
+extern uint32_t hbtree_foreach_range(hbtree_ptr_t tree, hcdata_ptr_t lo, hcdata_ptr_t hi,
+                                     hbtree_range_f fn, void* ctx);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __HLIBC_HBTREE_H__ */
@@ -0,0 +1,246 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/common/harena.c
+ * @Description: 容器内部使用的分块节点池（仅动态分配模式）
+ * @other: None
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "harena.h"
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+
+/*********************
+ *      MACROS
+ *********************/
+#define HARENA_MIN_CHUNK_SLOTS      8u
+#define HARENA_MAX_CHUNK_BYTES      (256u * 1024u)
+#define HARENA_VAR_MIN_CHUNK_BYTES  1024u
+
+/* chunk 头部之后的第一个槽位偏移 */
+#define HARENA_CHUNK_HEADER_SIZE    HLIBC_ALIGN_UP(sizeof(struct harena_chunk), HARENA_ALIGN)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+struct harena_chunk {
+    struct harena_chunk* next;
+    size_t bytes;                 /* 整个 chunk 的大小，归还时使用 */
+};
+
+/* 变长节点池中超出分级的空闲槽位 */
+struct harena_large {
+    struct harena_large* next;
+    size_t size;
+};
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void arena_reset(harena_t* arena);
+static bool arena_grow(harena_t* arena, uint32_t slots);
+static void var_reset(harena_var_t* arena);
+static struct harena_chunk* var_chunk(harena_var_t* arena, size_t bytes);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void harena_init(harena_t* arena, uint32_t slot_size,
+                 const hallocator_t* allocator)
+{
+    arena->slot_size = (uint32_t)HLIBC_ALIGN_UP(slot_size, HARENA_ALIGN);
+    if (allocator != NULL) {
+        arena->allocator = *allocator;
+    } else {
+        arena->allocator.alloc = NULL;
+        arena->allocator.free = NULL;
+        arena->allocator.ctx = NULL;
+    }
+#if HLIBC_ENABLE_STATS
+    arena->stats = NULL;
+#endif
+    arena->inline_base = NULL;
+    arena->inline_end = NULL;
+    arena_reset(arena);
+}
+
+void harena_init_inline(harena_t* arena, uint32_t slot_size,
+                        const hallocator_t* allocator,
+                        void* region, size_t region_size)
+{
+    harena_init(arena, slot_size, allocator);
+    arena->inline_base = (uint8_t*)region;
+    arena->inline_end = arena->inline_base +
+                        region_size / arena->slot_size * arena->slot_size;
+    arena_reset(arena);
+}
+
+void harena_release(harena_t* arena)
+{
+    struct harena_chunk* chunk = arena->chunks;
+    while (chunk != NULL) {
+        struct harena_chunk* next = chunk->next;
+#if HLIBC_ENABLE_STATS
+        if (arena->stats != NULL) HSTATS_ON_FREE(arena->stats, chunk->bytes);
+#endif
+        hallocator_free(&arena->allocator, chunk, chunk->bytes);
+        chunk = next;
+    }
+    arena_reset(arena);
+}
+
+void* harena_alloc_slow(harena_t* arena)
+{
+    if (!arena_grow(arena, arena->next_slots)) return NULL;
+    return harena_take(arena);
+}
+
+bool harena_reserve(harena_t* arena, uint32_t count)
+{
+    size_t left = (size_t)(arena->bump_end - arena->bump) / arena->slot_size;
+    if (left >= count) return true;
+
+    uint8_t* bump = arena->bump;
+    uint8_t* bump_end = arena->bump_end;
+    if (!arena_grow(arena, count > arena->next_slots ? count : arena->next_slots))
+        return false;
+    /* 旧 chunk 剩下的槽位不会再被 bump 分配，挂入空闲链表留给单个申请 */
+    for (; bump != bump_end; bump += arena->slot_size) harena_free(arena, bump);
+    return true;
+}
+
+void harena_var_init(harena_var_t* arena, const hallocator_t* allocator)
+{
+    if (allocator != NULL) {
+        arena->allocator = *allocator;
+    } else {
+        arena->allocator.alloc = NULL;
+        arena->allocator.free = NULL;
+        arena->allocator.ctx = NULL;
+    }
+#if HLIBC_ENABLE_STATS
+    arena->stats = NULL;
+#endif
+    var_reset(arena);
+}
+
+void harena_var_release(harena_var_t* arena)
+{
+    struct harena_chunk* chunk = arena->chunks;
+    while (chunk != NULL) {
+        struct harena_chunk* next = chunk->next;
+#if HLIBC_ENABLE_STATS
+        if (arena->stats != NULL) HSTATS_ON_FREE(arena->stats, chunk->bytes);
+#endif
+        hallocator_free(&arena->allocator, chunk, chunk->bytes);
+        chunk = next;
+    }
+    var_reset(arena);
+}
+
+void* harena_var_alloc_slow(harena_var_t* arena, size_t size)
+{
+    /* 先在更大的空闲槽位中首次适配，多出的部分重新挂回空闲链表 */
+    for (struct harena_large** link = (struct harena_large**)&arena->large_free; *link != NULL;
+         link = &(*link)->next) {
+        struct harena_large* slot = *link;
+        if (slot->size < size) continue;
+        *link = slot->next;
+        if (slot->size > size) harena_var_free(arena, (uint8_t*)slot + size, slot->size - size);
+        return slot;
+    }
+
+    /* 比常规 chunk 还大的槽位单独占用一个 chunk，当前 chunk 继续使用 */
+    if (HARENA_CHUNK_HEADER_SIZE + size > arena->next_chunk) {
+        struct harena_chunk* chunk = var_chunk(arena, HARENA_CHUNK_HEADER_SIZE + size);
+        return chunk != NULL ? (uint8_t*)chunk + HARENA_CHUNK_HEADER_SIZE : NULL;
+    }
+
+    struct harena_chunk* chunk = var_chunk(arena, arena->next_chunk);
+    if (chunk == NULL) return NULL;
+    /* 旧 chunk 剩下的部分不会再被 bump 分配，作为一个空闲槽位留给之后的申请 */
+    if (arena->bump != arena->bump_end)
+        harena_var_free(arena, arena->bump, (size_t)(arena->bump_end - arena->bump));
+    if (arena->next_chunk * 2u <= HARENA_MAX_CHUNK_BYTES) arena->next_chunk *= 2u;
+
+    arena->bump = (uint8_t*)chunk + HARENA_CHUNK_HEADER_SIZE + size;
+    arena->bump_end = (uint8_t*)chunk + chunk->bytes;
+    return (uint8_t*)chunk + HARENA_CHUNK_HEADER_SIZE;
+}
+
+void harena_var_free_large(harena_var_t* arena, void* slot, size_t size)
+{
+    struct harena_large* large = (struct harena_large*)slot;
+    large->size = size;
+    large->next = (struct harena_large*)arena->large_free;
+    arena->large_free = large;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* 申请一个含 slots 个槽位的新 chunk，作为当前的 bump 区域 */
+static bool arena_grow(harena_t* arena, uint32_t slots)
+{
+    size_t bytes = HARENA_CHUNK_HEADER_SIZE + (size_t)slots * arena->slot_size;
+    struct harena_chunk* chunk =
+        (struct harena_chunk*)hallocator_alloc(&arena->allocator, bytes);
+    if (chunk == NULL) return false;
+#if HLIBC_ENABLE_STATS
+    if (arena->stats != NULL) HSTATS_ON_ALLOC(arena->stats, bytes);
+#endif
+
+    chunk->bytes = bytes;
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+
+    /* chunk 按几何级数增长，直到达到上限 */
+    if ((size_t)arena->next_slots * 2u * arena->slot_size <= HARENA_MAX_CHUNK_BYTES)
+        arena->next_slots *= 2u;
+
+    arena->bump = (uint8_t*)chunk + HARENA_CHUNK_HEADER_SIZE;
+    arena->bump_end = arena->bump + (size_t)slots * arena->slot_size;
+    return true;
+}
+
+static void arena_reset(harena_t* arena)
+{
+    arena->chunks = NULL;
+    arena->free_list = NULL;
+    /* 内联区域不随 chunk 归还，每次重置后都从它开始分配 */
+    arena->bump = arena->inline_base;
+    arena->bump_end = arena->inline_end;
+    arena->next_slots = HARENA_MIN_CHUNK_SLOTS;
+}
+
+static void var_reset(harena_var_t* arena)
+{
+    arena->chunks = NULL;
+    arena->bump = NULL;
+    arena->bump_end = NULL;
+    for (uint32_t i = 0; i < HLIBC_ARENA_VAR_CLASSES; ++i) arena->free_lists[i] = NULL;
+    arena->large_free = NULL;
+    arena->next_chunk = HARENA_VAR_MIN_CHUNK_BYTES;
+}
+
+/* 申请一个 bytes 字节的 chunk 并挂入链表 */
+static struct harena_chunk* var_chunk(harena_var_t* arena, size_t bytes)
+{
+    struct harena_chunk* chunk =
+        (struct harena_chunk*)hallocator_alloc(&arena->allocator, bytes);
+    if (chunk == NULL) return NULL;
+#if HLIBC_ENABLE_STATS
+    if (arena->stats != NULL) HSTATS_ON_ALLOC(arena->stats, bytes);
+#endif
+    chunk->bytes = bytes;
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    return chunk;
+}
+
+#endif /* HLIBC_USE_STATIC_ALLOC == 0 */
@@ -0,0 +1,254 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/common/harena.h
+ * @Description: 容器内部使用的分块节点池（仅动态分配模式）
+ * @other: None
+ */
+#ifndef __HLIBC_HARENA_H__
+#define __HLIBC_HARENA_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "hcommon.h"
+#include "hlibc_config.h"
+#include "hstats.h"
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+#include <stdlib.h>
+#include "hcache.h"
+
+/*********************
+ *      MACROS
+ *********************/
+
+/* 默认分配器：开启 HLIBC_ENABLE_NODE_CACHE 时经由线程本地缓存 */
+#if HLIBC_ENABLE_NODE_CACHE
+#define HARENA_SYSTEM_ALLOC(size)       hcache_alloc(size)
+#define HARENA_SYSTEM_FREE(ptr, size)   hcache_free((ptr), (size))
+#else
+#define HARENA_SYSTEM_ALLOC(size)       malloc(size)
+#define HARENA_SYSTEM_FREE(ptr, size)   ((void)(size), free(ptr))
+#endif
+
+/* 槽位与负载的对齐粒度，与 malloc 的保证保持一致（是 max_align_t 的对齐要求，不是它的大小） */
+#ifdef __cplusplus
+#define HARENA_ALIGN                alignof(max_align_t)
+#else
+#define HARENA_ALIGN                _Alignof(max_align_t)
+#endif
+
+/* 节点头之后紧跟负载，负载的起始偏移 */
+#define HARENA_PAYLOAD_OFFSET(node_size) \
+    HLIBC_ALIGN_UP((node_size), HARENA_ALIGN)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+struct harena_chunk;
+
+/*
+ * 分块节点池：节点与负载放在同一个槽位中，按 chunk 批量向系统申请。
+ * 释放的槽位挂入空闲链表复用；清空时按 chunk 归还，代价为 O(chunk 数)。
+ */
+typedef struct harena {
+    struct harena_chunk* chunks;  /* 已申请的 chunk 链表 */
+    void* free_list;              /* 已回收的槽位 */
+    uint8_t* bump;                /* 当前 chunk 中下一个未用的槽位 */
+    uint8_t* bump_end;            /* 当前 chunk 的结束位置 */
+    uint8_t* inline_base;         /* 调用者提供的内联区域，不归节点池所有，可为 NULL */
+    uint8_t* inline_end;          /* 内联区域中最后一个完整槽位的结束位置 */
+    uint32_t slot_size;           /* 单个槽位大小（已对齐） */
+    uint32_t next_slots;          /* 下一个 chunk 的槽位数 */
+    hallocator_t allocator;       /* chunk 的来源，alloc 为 NULL 时使用 malloc/free */
+#if HLIBC_ENABLE_STATS
+    hlibc_stats_t* stats;         /* chunk 申请/归还计入的统计块，可为 NULL */
+#endif
+} harena_t;
+
+/*
+ * 变长槽位节点池：槽位大小按 HARENA_ALIGN 取整，同样从 chunk 中顺序切出，相继申请的槽位在内存中相邻。
+ * 释放的槽位按大小挂入对应的空闲链表，只被同样大小的申请复用；更大的槽位共用一条链表，
+ * 按首次适配复用并切分。与 harena_t 一样，清空时按 chunk 整体归还。
+ */
+typedef struct harena_var {
+    struct harena_chunk* chunks;  /* 已申请的 chunk 链表 */
+    uint8_t* bump;                /* 当前 chunk 中下一个未用的字节 */
+    uint8_t* bump_end;            /* 当前 chunk 的结束位置 */
+    void* free_lists[HLIBC_ARENA_VAR_CLASSES]; /* 第 i 条链表中的槽位为 (i + 1) 个粒度 */
+    void* large_free;             /* 更大的空闲槽位，槽位开头记录下一个槽位与本槽位大小 */
+    size_t next_chunk;            /* 下一个 chunk 的字节数 */
+    hallocator_t allocator;       /* chunk 的来源，alloc 为 NULL 时使用 malloc/free */
+#if HLIBC_ENABLE_STATS
+    hlibc_stats_t* stats;         /* chunk 申请/归还计入的统计块，可为 NULL */
+#endif
+} harena_var_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * 初始化节点池，不申请任何内存
+ * @param arena 节点池
+ * @param slot_size 单个槽位大小（节点 + 负载）
+ * @param allocator chunk 的分配器，NULL 表示使用 malloc/free
+ */
+extern void harena_init(harena_t* arena, uint32_t slot_size,
+                        const hallocator_t* allocator);
+
+/**
+ * 初始化节点池，并以调用者提供的内联区域作为最先使用的槽位来源
+ * 内联区域用尽后才向分配器申请 chunk；清空时只归还 chunk，内联区域重新可用
+ * @param arena 节点池
+ * @param slot_size 单个槽位大小（节点 + 负载）
+ * @param allocator chunk 的分配器，NULL 表示使用 malloc/free
+ * @param region 内联区域，须按 HARENA_ALIGN 对齐，生命周期不短于节点池
+ * @param region_size 内联区域的字节数，不足一个槽位的尾部不使用
+ */
+extern void harena_init_inline(harena_t* arena, uint32_t slot_size,
+                               const hallocator_t* allocator,
+                               void* region, size_t region_size);
+
+/**
+ * 归还节点池的全部 chunk，之后节点池可继续使用
+ * @param arena 节点池
+ */
+extern void harena_release(harena_t* arena);
+
+/* 通过分配器申请/释放内存，allocator 为 NULL 或 alloc 为 NULL 时使用默认分配器 */
+static inline hdata_ptr_t hallocator_alloc(const hallocator_t* allocator, size_t size)
+{
+    if (allocator == NULL || allocator->alloc == NULL) return HARENA_SYSTEM_ALLOC(size);
+    return allocator->alloc(allocator->ctx, size);
+}
+
+static inline void hallocator_free(const hallocator_t* allocator, hdata_ptr_t ptr,
+                                   size_t size)
+{
+    if (allocator == NULL || allocator->alloc == NULL) {
+        HARENA_SYSTEM_FREE(ptr, size);
+        return;
+    }
+    allocator->free(allocator->ctx, ptr, size);
+}
+
+/* 慢路径：当前 chunk 用尽时申请新的 chunk */
+extern void* harena_alloc_slow(harena_t* arena);
+
+/**
+ * 申请一个槽位
+ * @return 槽位指针，内存不足时返回 NULL
+ */
+static inline void* harena_alloc(harena_t* arena)
+{
+    void* slot = arena->free_list;
+    if (slot != NULL) {
+        arena->free_list = *(void**)slot;
+        return slot;
+    }
+    if (arena->bump != arena->bump_end) {
+        slot = arena->bump;
+        arena->bump += arena->slot_size;
+        return slot;
+    }
+    return harena_alloc_slow(arena);
+}
+
+/**
+ * 预留 count 个连续槽位，之后的 count 次 harena_take 必定成功
+ * 当前 chunk 剩余的槽位不足时，先把它们挂入空闲链表，再申请一个至少容纳 count 个槽位的 chunk
+ * @return true 成功；false 内存不足，节点池不变
+ */
+extern bool harena_reserve(harena_t* arena, uint32_t count);
+
+/**
+ * 取出一个预留的槽位，连续取出的槽位在内存中相邻（必须先调用 harena_reserve）
+ */
+static inline void* harena_take(harena_t* arena)
+{
+    void* slot = arena->bump;
+    arena->bump += arena->slot_size;
+    return slot;
+}
+
+/**
+ * 归还一个槽位（仅挂入空闲链表，不会归还给系统）
+ */
+static inline void harena_free(harena_t* arena, void* slot)
+{
+    *(void**)slot = arena->free_list;
+    arena->free_list = slot;
+}
+
+/*=====================
+ * 变长槽位节点池
+ *====================*/
+
+/**
+ * 初始化变长槽位节点池，不申请任何内存
+ * @param arena 节点池
+ * @param allocator chunk 的分配器，NULL 表示使用 malloc/free
+ */
+extern void harena_var_init(harena_var_t* arena, const hallocator_t* allocator);
+
+/**
+ * 归还全部 chunk，之后节点池可继续使用
+ */
+extern void harena_var_release(harena_var_t* arena);
+
+/* 慢路径：空闲链表与当前 chunk 都不够时，复用更大的空闲槽位或申请新的 chunk（size 已取整） */
+extern void* harena_var_alloc_slow(harena_var_t* arena, size_t size);
+
+/* 归还一个超出分级的槽位（size 已取整） */
+extern void harena_var_free_large(harena_var_t* arena, void* slot, size_t size);
+
+/**
+ * 申请一个 size 字节（不为 0）的槽位，按 HARENA_ALIGN 对齐
+ * @return 槽位指针，内存不足时返回 NULL
+ */
+static inline void* harena_var_alloc(harena_var_t* arena, size_t size)
+{
+    size = HLIBC_ALIGN_UP(size, HARENA_ALIGN);
+    size_t index = size / HARENA_ALIGN - 1u;
+    if (index < HLIBC_ARENA_VAR_CLASSES && arena->free_lists[index] != NULL) {
+        void* slot = arena->free_lists[index];
+        arena->free_lists[index] = *(void**)slot;
+        return slot;
+    }
+    if ((size_t)(arena->bump_end - arena->bump) >= size) {
+        void* slot = arena->bump;
+        arena->bump += size;
+        return slot;
+    }
+    return harena_var_alloc_slow(arena, size);
+}
+
+/**
+ * 归还一个槽位（仅挂入空闲链表，不会归还给系统）
+ * @param size 申请时给定的字节数
+ */
+static inline void harena_var_free(harena_var_t* arena, void* slot, size_t size)
+{
+    size = HLIBC_ALIGN_UP(size, HARENA_ALIGN);
+    size_t index = size / HARENA_ALIGN - 1u;
+    if (index < HLIBC_ARENA_VAR_CLASSES) {
+        *(void**)slot = arena->free_lists[index];
+        arena->free_lists[index] = slot;
+        return;
+    }
+    harena_var_free_large(arena, slot, size);
+}
+
+#endif /* HLIBC_USE_STATIC_ALLOC == 0 */
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __HLIBC_HARENA_H__ */
@@ -0,0 +1,236 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/common/hcache.c
+ * @Description: 按尺寸分级的线程本地内存块缓存（仅动态分配模式）
+ * @other: None
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "hcache.h"
+
+#if HLIBC_ENABLE_NODE_CACHE && HLIBC_USE_STATIC_ALLOC == 0
+#include <stdlib.h>
+
+#if HLIBC_USE_THREADS
+#include <pthread.h>
+#endif
+
+/*********************
+ *      MACROS
+ *********************/
+
+/* 最小等级 64 字节，之后每个 2 的幂区间分 4 级，最大等级 512KB */
+#define CACHE_MIN_SHIFT         6u
+#define CACHE_MIN_BLOCK         ((size_t)1 << CACHE_MIN_SHIFT)
+#define CACHE_MAX_SHIFT         19u
+#define CACHE_MAX_BLOCK         ((size_t)1 << CACHE_MAX_SHIFT)
+#define CACHE_STEPS_SHIFT       2u
+#define CACHE_CLASS_COUNT       ((CACHE_MAX_SHIFT - CACHE_MIN_SHIFT) * (1u << CACHE_STEPS_SHIFT) + 1u)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    void* head;             /* 空闲块链表，链接指针存放在块的起始位置 */
+    uint32_t count;
+    uint32_t low_water;     /* 上次修剪以来的最小块数 */
+} cache_bin_t;
+
+typedef struct {
+    cache_bin_t bins[CACHE_CLASS_COUNT];
+    size_t bytes;
+    uint32_t ops;           /* 距上次修剪的操作次数 */
+    bool registered;        /* 是否已注册线程退出回调 */
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t releases;
+} cache_t;
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static _Thread_local cache_t s_cache;
+
+#if HLIBC_USE_THREADS
+static pthread_once_t s_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t s_key;
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t floor_log2(size_t x);
+static uint32_t size_class(size_t size, size_t* class_size);
+static void bin_release(cache_t* cache, uint32_t index, uint32_t n);
+static void cache_tick(cache_t* cache);
+static void cache_register(cache_t* cache);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void* hcache_alloc(size_t size)
+{
+    if (size > CACHE_MAX_BLOCK) return malloc(size);
+
+    cache_t* cache = &s_cache;
+    size_t class_size;
+    uint32_t index = size_class(size, &class_size);
+    cache_bin_t* bin = &cache->bins[index];
+    cache_tick(cache);
+
+    void* block = bin->head;
+    if (block == NULL) {
+        ++cache->misses;
+        /* 按等级大小申请，块才能被同级的其他申请复用 */
+        return malloc(class_size);
+    }
+    bin->head = *(void**)block;
+    if (--bin->count < bin->low_water) bin->low_water = bin->count;
+    cache->bytes -= class_size;
+    ++cache->hits;
+    return block;
+}
+
+void hcache_free(void* ptr, size_t size)
+{
+    if (ptr == NULL) return;
+    if (size > CACHE_MAX_BLOCK) {
+        free(ptr);
+        return;
+    }
+
+    cache_t* cache = &s_cache;
+    size_t class_size;
+    uint32_t index = size_class(size, &class_size);
+    cache_bin_t* bin = &cache->bins[index];
+    cache_tick(cache);
+
+    if (bin->count >= HLIBC_NODE_CACHE_CLASS_LIMIT ||
+        cache->bytes + class_size > HLIBC_NODE_CACHE_MAX_BYTES) {
+        ++cache->releases;
+        free(ptr);
+        return;
+    }
+    if (!cache->registered) cache_register(cache);
+    *(void**)ptr = bin->head;
+    bin->head = ptr;
+    ++bin->count;
+    cache->bytes += class_size;
+}
+
+void hcache_trim(void)
+{
+    cache_t* cache = &s_cache;
+    for (uint32_t i = 0; i < CACHE_CLASS_COUNT; ++i) {
+        cache_bin_t* bin = &cache->bins[i];
+        /* 整个周期都没被取走的块说明用不上，归还一半，避免一次清空后又立刻重新申请 */
+        bin_release(cache, i, (bin->low_water + 1u) / 2u);
+        bin->low_water = bin->count;
+    }
+    cache->ops = 0;
+}
+
+void hcache_flush(void)
+{
+    cache_t* cache = &s_cache;
+    for (uint32_t i = 0; i < CACHE_CLASS_COUNT; ++i) {
+        bin_release(cache, i, cache->bins[i].count);
+        cache->bins[i].low_water = 0;
+    }
+    cache->ops = 0;
+}
+
+void hcache_get_info(hcache_info_t* info)
+{
+    info->hits = s_cache.hits;
+    info->misses = s_cache.misses;
+    info->releases = s_cache.releases;
+    info->cached_bytes = s_cache.bytes;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint32_t floor_log2(size_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)(sizeof(unsigned long long) * 8u - 1u) - (uint32_t)__builtin_clzll(x);
+#else
+    uint32_t n = 0;
+    while (x >>= 1) ++n;
+    return n;
+#endif
+}
+
+/* 尺寸 -> 等级下标，同时给出该等级的块大小 */
+static uint32_t size_class(size_t size, size_t* class_size)
+{
+    if (size <= CACHE_MIN_BLOCK) {
+        *class_size = CACHE_MIN_BLOCK;
+        return 0;
+    }
+    uint32_t shift = floor_log2(size - 1u);          /* size 落在 (2^shift, 2^(shift+1)] */
+    uint32_t step_shift = shift - CACHE_STEPS_SHIFT;
+    size_t rounded = HLIBC_ALIGN_UP(size, (size_t)1 << step_shift);
+    *class_size = rounded;
+    return (shift - CACHE_MIN_SHIFT) * (1u << CACHE_STEPS_SHIFT) +
+           (uint32_t)(rounded >> step_shift) - (1u << CACHE_STEPS_SHIFT);
+}
+
+static void bin_release(cache_t* cache, uint32_t index, uint32_t n)
+{
+    cache_bin_t* bin = &cache->bins[index];
+    size_t class_size;
+    if (n == 0) return;
+    /* 由下标反推等级大小 */
+    if (index == 0) {
+        class_size = CACHE_MIN_BLOCK;
+    } else {
+        uint32_t shift = CACHE_MIN_SHIFT + (index - 1u) / (1u << CACHE_STEPS_SHIFT);
+        uint32_t step = (index - 1u) % (1u << CACHE_STEPS_SHIFT) + 1u;
+        class_size = ((size_t)1 << shift) + ((size_t)step << (shift - CACHE_STEPS_SHIFT));
+    }
+    while (n-- > 0 && bin->head != NULL) {
+        void* block = bin->head;
+        bin->head = *(void**)block;
+        --bin->count;
+        cache->bytes -= class_size;
+        ++cache->releases;
+        free(block);
+    }
+}
+
+static void cache_tick(cache_t* cache)
+{
+    if (++cache->ops >= HLIBC_NODE_CACHE_TRIM_INTERVAL) hcache_trim();
+}
+
+#if HLIBC_USE_THREADS
+static void cache_thread_exit(void* arg)
+{
+    (void)arg;
+    hcache_flush();
+}
+
+static void cache_key_create(void)
+{
+    pthread_key_create(&s_key, cache_thread_exit);
+}
+#endif
+
+/* 第一次缓存内存块时注册线程退出回调，线程结束时归还缓存 */
+static void cache_register(cache_t* cache)
+{
+#if HLIBC_USE_THREADS
+    pthread_once(&s_key_once, cache_key_create);
+    pthread_setspecific(s_key, cache);
+#endif
+    cache->registered = true;
+}
+
+#endif /* HLIBC_ENABLE_NODE_CACHE && HLIBC_USE_STATIC_ALLOC == 0 */
@@ -0,0 +1,84 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/common/hcache.h
+ * @Description: 按尺寸分级的线程本地内存块缓存（仅动态分配模式）
+ * @other: None
+ */
+#ifndef __HLIBC_HCACHE_H__
+#define __HLIBC_HCACHE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stddef.h>
+#include "hcommon.h"
+#include "hlibc_config.h"
+
+#if HLIBC_ENABLE_NODE_CACHE && HLIBC_USE_STATIC_ALLOC == 0
+
+/*
+ * 容器使用默认分配器时，harena 的 chunk 与容器头部都经由本缓存申请/释放。
+ * 每个线程按尺寸等级（每个 2 的幂区间 4 级）保存释放的内存块，下次同级申请直接复用，
+ * 反复创建/清空/销毁容器的稳态负载因此不会进入 malloc。
+ *
+ * 缓存有界：每级最多 HLIBC_NODE_CACHE_CLASS_LIMIT 块，每个线程合计不超过
+ * HLIBC_NODE_CACHE_MAX_BYTES；每 HLIBC_NODE_CACHE_TRIM_INTERVAL 次操作修剪一次，
+ * 把整个周期内都没被用到的块归还一半。超过最大等级的块直接使用 malloc/free。
+ *
+ * 内存块可以在一个线程申请、在另一个线程释放，它会进入释放线程的缓存。
+ */
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint64_t hits;          /* 命中缓存的申请次数 */
+    uint64_t misses;        /* 进入 malloc 的申请次数 */
+    uint64_t releases;      /* 归还给 free 的块数（超限、修剪、flush） */
+    size_t cached_bytes;    /* 当前缓存的字节数 */
+} hcache_info_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * 申请 size 字节，优先从当前线程的缓存中取
+ * @return 内存块（按 malloc 的要求对齐），内存不足时返回 NULL
+ */
+extern void* hcache_alloc(size_t size);
+
+/**
+ * 释放 hcache_alloc 申请的内存块
+ * @param size 必须与申请时相同
+ */
+extern void hcache_free(void* ptr, size_t size);
+
+/**
+ * 立即执行一次修剪
+ */
+extern void hcache_trim(void);
+
+/**
+ * 把当前线程缓存的全部内存块归还给系统
+ * 启用 HLIBC_USE_THREADS 时线程退出会自动调用；否则需要线程在退出前自行调用。
+ */
+extern void hcache_flush(void);
+
+/**
+ * 获取当前线程的缓存信息
+ */
+extern void hcache_get_info(hcache_info_t* info);
+
+#endif /* HLIBC_ENABLE_NODE_CACHE && HLIBC_USE_STATIC_ALLOC == 0 */
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __HLIBC_HCACHE_H__ */
@@ -24,19 +24,58 @@ extern "C" {
  *********************/
 #define DATA_CAST(data_type)        *(data_type*)
 
+/* 将 x 向上对齐到 a（a 必须是 2 的幂） */
+#define HLIBC_ALIGN_UP(x, a)        (((x) + ((a) - 1)) & ~((size_t)(a) - 1))
+
+/* 变量对齐声明，C 与 C++ 通用 */
+#ifdef __cplusplus
+#define HLIBC_ALIGNAS(a)            alignas(a)
+#else
+#define HLIBC_ALIGNAS(a)            _Alignas(a)
+#endif
+
+/* 预取只读数据，不支持的编译器上为空操作 */
+#if defined(__GNUC__) || defined(__clang__)
+#define HLIBC_PREFETCH(addr)        __builtin_prefetch((addr), 0, 3)
+#else
+#define HLIBC_PREFETCH(addr)        ((void)(addr))
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
 typedef enum {
     HLIB_OK          =  1,
     HLIB_ERROR       =  0,
-    HLIB_OVERFLOW    = -2
+    HLIB_OVERFLOW    = -2,
+    HLIB_TIMEOUT     = -3,
+    HLIB_BUSY        = -4
 } hlib_status_t;
 
 typedef void* hdata_ptr_t;
 typedef const void * hcdata_ptr_t;
 typedef void (*copy_data_f)(hdata_ptr_t, hcdata_ptr_t);
 
+/*
+ * 遍历回调，返回 false 时提前结束遍历
+ * hforeach_f       逐个元素调用
+ * hforeach_batch_f 一次传入一组元素指针
+ * hforeach_span_f  一次传入一段连续存放的元素（仅静态模式的数组/环形缓冲区）
+ */
+typedef bool (*hforeach_f)(hdata_ptr_t data, void* ctx);
+typedef bool (*hforeach_batch_f)(hdata_ptr_t const* items, uint32_t count, void* ctx);
+typedef bool (*hforeach_span_f)(hdata_ptr_t base, uint32_t count, void* ctx);
+
+/*
+ * 自定义内存分配器（仅动态分配模式使用）
+ * 容器只在申请结构体和节点池 chunk 时调用，不会逐元素调用
+ */
+typedef struct {
+    hdata_ptr_t (*alloc)(void* ctx, size_t size);
+    void (*free)(void* ctx, hdata_ptr_t ptr, size_t size);
+    void* ctx;
+} hallocator_t;
+
 #ifdef __cplusplus
 } /*extern "C"*/
 #endif
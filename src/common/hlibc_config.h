@@ -27,6 +27,113 @@ extern "C" {
 #define HLIBC_USE_STATIC_ALLOC 0
 #endif
 
+/**
+ * 容器运行统计（push/pop 次数、溢出次数、分配器调用、高水位）：
+ * 0 - 关闭，统计代码全部编译为空，不占用结构体空间
+ * 1 - 开启，提供 hlist/hqueue/hstack 的 get_stats/reset_stats 接口
+ *
+ * 可以在编译时通过 -DHLIBC_ENABLE_STATS=1 来定义
+ */
+#ifndef HLIBC_ENABLE_STATS
+#define HLIBC_ENABLE_STATS 0
+#endif
+
+/**
+ * 线程安全容器（hcqueue 等，依赖 pthread）：
+ * 0 - 不编译
+ * 1 - 编译
+ *
+ * 可以在编译时通过 -DHLIBC_USE_THREADS=1 来定义
+ */
+#ifndef HLIBC_USE_THREADS
+#define HLIBC_USE_THREADS 0
+#endif
+
+/**
+ * 静态分配 buffer 的对齐粒度（2 的幂，不小于指针与 uint64_t 的对齐要求）：
+ * 容器结构体之后的节点区、数据区都从该粒度的边界开始。
+ * 设为 HLIBC_CACHE_LINE_SIZE 可让数据区独占缓存行，设为 16/32 便于 SIMD 访问。
+ *
+ * 可以在编译时通过 -DHLIBC_STATIC_ALIGN=64 来定义
+ */
+#ifndef HLIBC_STATIC_ALIGN
+#define HLIBC_STATIC_ALIGN 8
+#endif
+
+/**
+ * 线程本地内存块缓存（仅动态分配模式）：
+ * 0 - 关闭，容器的默认分配器直接使用 malloc/free
+ * 1 - 开启，harena chunk 与容器头部按尺寸等级缓存在线程本地，见 hcache.h
+ *
+ * 可以在编译时通过 -DHLIBC_ENABLE_NODE_CACHE=1 来定义
+ */
+#ifndef HLIBC_ENABLE_NODE_CACHE
+#define HLIBC_ENABLE_NODE_CACHE 0
+#endif
+
+/* 每个尺寸等级最多缓存的块数 */
+#ifndef HLIBC_NODE_CACHE_CLASS_LIMIT
+#define HLIBC_NODE_CACHE_CLASS_LIMIT 32
+#endif
+
+/* 每个线程最多缓存的字节数 */
+#ifndef HLIBC_NODE_CACHE_MAX_BYTES
+#define HLIBC_NODE_CACHE_MAX_BYTES (2u * 1024u * 1024u)
+#endif
+
+/* 每多少次申请/释放修剪一次缓存 */
+#ifndef HLIBC_NODE_CACHE_TRIM_INTERVAL
+#define HLIBC_NODE_CACHE_TRIM_INTERVAL 4096
+#endif
+
+/**
+ * *_foreach_batch 每次回调最多传入的元素个数，也是遍历时在栈上收集元素指针的数组长度
+ */
+#ifndef HLIBC_FOREACH_BATCH
+#define HLIBC_FOREACH_BATCH 32
+#endif
+
+/**
+ * 缓存行大小，并发容器据此隔离被不同线程频繁写入的字段，避免伪共享
+ */
+#ifndef HLIBC_CACHE_LINE_SIZE
+#define HLIBC_CACHE_LINE_SIZE 64
+#endif
+
+/**
+ * hbtree 节点的目标大小（字节），取缓存行的整数倍；键值较大时会自动放大以保证最小扇出
+ */
+#ifndef HLIBC_BTREE_NODE_SIZE
+#define HLIBC_BTREE_NODE_SIZE (4 * HLIBC_CACHE_LINE_SIZE)
+#endif
+
+/**
+ * htimer_wheel 的层数与每层槽位数的位数，可定时的范围为 2^(LEVELS * SLOT_BITS) 个 tick，
+ * 更远的定时器先挂在最高层，到期前自动重新放置
+ */
+#ifndef HLIBC_TIMER_WHEEL_LEVELS
+#define HLIBC_TIMER_WHEEL_LEVELS 4
+#endif
+
+#ifndef HLIBC_TIMER_WHEEL_SLOT_BITS
+#define HLIBC_TIMER_WHEEL_SLOT_BITS 6
+#endif
+
+/**
+ * hpool 每线程弹匣的容量（块数），弹匣空或满时一次与池交换一半
+ */
+#ifndef HLIBC_POOL_MAGAZINE_SIZE
+#define HLIBC_POOL_MAGAZINE_SIZE 32
+#endif
+
+/**
+ * 变长槽位节点池（hlist 变长模式）按大小分开的空闲链表条数：
+ * 不超过 HLIBC_ARENA_VAR_CLASSES 个 HARENA_ALIGN 粒度（x86-64 上默认为 32 x 16 字节）的槽位按大小精确复用，更大的槽位首次适配
+ */
+#ifndef HLIBC_ARENA_VAR_CLASSES
+#define HLIBC_ARENA_VAR_CLASSES 32
+#endif
+
 #ifdef __cplusplus
 } /*extern "C"*/
 #endif
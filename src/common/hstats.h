@@ -0,0 +1,102 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/common/hstats.h
+ * @Description: 容器运行统计（可在编译期关闭）
+ * @other: None
+ */
+#ifndef __HLIBC_HSTATS_H__
+#define __HLIBC_HSTATS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "hcommon.h"
+#include "hlibc_config.h"
+
+/*********************
+ *      MACROS
+ *********************/
+
+#if HLIBC_ENABLE_STATS
+/* 统计块占用的结构体空间，静态分配计算 buffer 大小时使用 */
+#define HLIBC_STATS_SIZE            64
+
+/* 以下宏仅供容器内部使用，关闭统计时全部展开为空 */
+#define HSTATS_ON_PUSH(stats, size)                                            \
+    do {                                                                       \
+        ++(stats)->pushes;                                                     \
+        if ((size) > (stats)->high_water) (stats)->high_water = (size);        \
+    } while (0)
+#define HSTATS_ON_PUSH_N(stats, n, size)                                       \
+    do {                                                                       \
+        (stats)->pushes += (n);                                                \
+        if ((size) > (stats)->high_water) (stats)->high_water = (size);        \
+    } while (0)
+#define HSTATS_ON_POP(stats)        (++(stats)->pops)
+#define HSTATS_ON_POP_N(stats, n)   ((stats)->pops += (n))
+#define HSTATS_ON_OVERFLOW(stats)   (++(stats)->overflows)
+#define HSTATS_ON_ALLOC(stats, bytes)                                          \
+    do {                                                                       \
+        ++(stats)->alloc_calls;                                                \
+        (stats)->alloc_bytes += (bytes);                                       \
+    } while (0)
+#define HSTATS_ON_FREE(stats, bytes)                                           \
+    do {                                                                       \
+        ++(stats)->free_calls;                                                 \
+        (stats)->free_bytes += (bytes);                                        \
+    } while (0)
+#else
+#define HLIBC_STATS_SIZE            0
+
+#define HSTATS_ON_PUSH(stats, size)     ((void)0)
+#define HSTATS_ON_PUSH_N(stats, n, size) ((void)0)
+#define HSTATS_ON_POP(stats)            ((void)0)
+#define HSTATS_ON_POP_N(stats, n)       ((void)0)
+#define HSTATS_ON_OVERFLOW(stats)       ((void)0)
+#define HSTATS_ON_ALLOC(stats, bytes)   ((void)0)
+#define HSTATS_ON_FREE(stats, bytes)    ((void)0)
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*
+ * 容器运行统计。计数器为普通整数，与容器本身一样不是线程安全的。
+ * 已占用的堆内存 = alloc_bytes - free_bytes
+ */
+typedef struct {
+    uint64_t pushes;        /* 成功放入的元素数（push/emplace/insert） */
+    uint64_t pops;          /* 成功取出或删除的元素数 */
+    uint64_t overflows;     /* 因容量已满被拒绝的次数（静态分配） */
+    uint64_t alloc_calls;   /* 调用分配器申请内存的次数（动态分配） */
+    uint64_t free_calls;    /* 调用分配器归还内存的次数（动态分配） */
+    uint64_t alloc_bytes;   /* 累计申请的字节数 */
+    uint64_t free_bytes;    /* 累计归还的字节数 */
+    uint32_t high_water;    /* 元素个数的历史最大值 */
+} hlibc_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+#if HLIBC_ENABLE_STATS
+/* 清零统计，高水位从当前元素个数重新开始 */
+static inline void hstats_reset(hlibc_stats_t* stats, uint32_t size)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->high_water = size;
+}
+#endif
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __HLIBC_HSTATS_H__ */
@@ -0,0 +1,142 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/common/hwait.c
+ * @Description: 线程等待/唤醒原语（Linux 使用 futex，其他平台使用条件变量）
+ * @other: None
+ */
+
+/* syscall()/SYS_futex 在 -std=c11 下需要显式打开 GNU 扩展，必须先于任何头文件 */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <time.h>
+#include "hwait.h"
+
+#if HLIBC_USE_THREADS
+
+#if HWAIT_USE_FUTEX
+#include <errno.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint64_t now_ns(void);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void hwait_init(hwait_t* wait)
+{
+    atomic_init(&wait->seq, 0);
+    atomic_init(&wait->waiters, 0);
+#if !HWAIT_USE_FUTEX
+    pthread_mutex_init(&wait->lock, NULL);
+    pthread_cond_init(&wait->cond, NULL);
+#endif
+}
+
+void hwait_destroy(hwait_t* wait)
+{
+#if !HWAIT_USE_FUTEX
+    pthread_mutex_destroy(&wait->lock);
+    pthread_cond_destroy(&wait->cond);
+#else
+    (void)wait;
+#endif
+}
+
+uint64_t hwait_deadline(int32_t timeout_ms)
+{
+    if (timeout_ms < 0) return HWAIT_FOREVER;
+    return now_ns() + (uint64_t)timeout_ms * 1000000ull;
+}
+
+#if HWAIT_USE_FUTEX
+
+hlib_status_t hwait_wait(hwait_t* wait, unsigned seq, uint64_t deadline)
+{
+    struct timespec rel, *timeout = NULL;
+    if (deadline != HWAIT_FOREVER) {
+        uint64_t now = now_ns();
+        if (now >= deadline) return HLIB_TIMEOUT;
+        uint64_t left = deadline - now;
+        rel.tv_sec = (time_t)(left / 1000000000ull);
+        rel.tv_nsec = (long)(left % 1000000000ull);
+        timeout = &rel;
+    }
+    /* 序号已变化时内核立即返回 EAGAIN，不会丢失唤醒 */
+    long ret = syscall(SYS_futex, &wait->seq, FUTEX_WAIT_PRIVATE, seq, timeout, NULL, 0);
+    if (ret != 0 && errno == ETIMEDOUT) return HLIB_TIMEOUT;
+    return HLIB_OK;
+}
+
+void hwait_notify(hwait_t* wait, bool all)
+{
+    atomic_fetch_add(&wait->seq, 1);
+    syscall(SYS_futex, &wait->seq, FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, NULL, NULL, 0);
+}
+
+#else /* HWAIT_USE_FUTEX == 0 */
+
+hlib_status_t hwait_wait(hwait_t* wait, unsigned seq, uint64_t deadline)
+{
+    hlib_status_t ret = HLIB_OK;
+    pthread_mutex_lock(&wait->lock);
+    while (atomic_load(&wait->seq) == seq) {
+        if (deadline == HWAIT_FOREVER) {
+            pthread_cond_wait(&wait->cond, &wait->lock);
+            continue;
+        }
+        /* 条件变量使用 CLOCK_REALTIME，把单调时钟的剩余时间换算过去 */
+        uint64_t now = now_ns();
+        if (now >= deadline) {
+            ret = HLIB_TIMEOUT;
+            break;
+        }
+        struct timespec abs;
+        clock_gettime(CLOCK_REALTIME, &abs);
+        uint64_t ns = (uint64_t)abs.tv_nsec + (deadline - now);
+        abs.tv_sec += (time_t)(ns / 1000000000ull);
+        abs.tv_nsec = (long)(ns % 1000000000ull);
+        pthread_cond_timedwait(&wait->cond, &wait->lock, &abs);
+    }
+    pthread_mutex_unlock(&wait->lock);
+    return ret;
+}
+
+void hwait_notify(hwait_t* wait, bool all)
+{
+    pthread_mutex_lock(&wait->lock);
+    atomic_fetch_add(&wait->seq, 1);
+    if (all)
+        pthread_cond_broadcast(&wait->cond);
+    else
+        pthread_cond_signal(&wait->cond);
+    pthread_mutex_unlock(&wait->lock);
+}
+
+#endif /* HWAIT_USE_FUTEX */
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#endif /* HLIBC_USE_THREADS */
@@ -0,0 +1,109 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/common/hwait.h
+ * @Description: 线程等待/唤醒原语（Linux 使用 futex，其他平台使用条件变量）
+ * @other: None
+ */
+#ifndef __HLIBC_HWAIT_H__
+#define __HLIBC_HWAIT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "hcommon.h"
+#include "hlibc_config.h"
+
+#if HLIBC_USE_THREADS
+#include <stdatomic.h>
+
+/*********************
+ *      MACROS
+ *********************/
+#if defined(__linux__) && !defined(HWAIT_USE_CONDVAR)
+#define HWAIT_USE_FUTEX     1
+#else
+#define HWAIT_USE_FUTEX     0
+#include <pthread.h>
+#endif
+
+/* 永不超时 */
+#define HWAIT_FOREVER       UINT64_MAX
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*
+ * 事件计数器：等待者先登记并记下序号，再检查一次条件，条件仍不满足才睡眠；
+ * 通知者改变条件后只在有等待者时递增序号并唤醒，无人等待时不产生系统调用。
+ */
+typedef struct {
+    atomic_uint seq;
+    atomic_uint waiters;
+#if !HWAIT_USE_FUTEX
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+#endif
+} hwait_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+extern void hwait_init(hwait_t* wait);
+extern void hwait_destroy(hwait_t* wait);
+
+/**
+ * 由相对超时计算截止时间
+ * @param timeout_ms 超时毫秒数，小于 0 表示永久等待
+ * @return 单调时钟的截止时间（纳秒），或 HWAIT_FOREVER
+ */
+extern uint64_t hwait_deadline(int32_t timeout_ms);
+
+/**
+ * 睡眠直到序号不再等于 seq、被唤醒或到达截止时间（可能虚假唤醒，调用者需重新检查条件）
+ * @return HLIB_OK 被唤醒或序号已变化；HLIB_TIMEOUT 已到截止时间
+ */
+extern hlib_status_t hwait_wait(hwait_t* wait, unsigned seq, uint64_t deadline);
+
+/**
+ * 递增序号并唤醒等待者
+ * @param all true 唤醒全部，false 唤醒一个
+ */
+extern void hwait_notify(hwait_t* wait, bool all);
+
+/* 登记为等待者并返回当前序号，之后必须再检查一次条件 */
+static inline unsigned hwait_prepare(hwait_t* wait)
+{
+    atomic_fetch_add(&wait->waiters, 1);
+    unsigned seq = atomic_load(&wait->seq);
+    /* 与 hwait_has_waiters 中的栅栏配对：通知方要么看到登记，要么条件检查能看到它的修改 */
+    atomic_thread_fence(memory_order_seq_cst);
+    return seq;
+}
+
+/* 取消登记 */
+static inline void hwait_cancel(hwait_t* wait)
+{
+    atomic_fetch_sub(&wait->waiters, 1);
+}
+
+/* 通知方在改变条件之后调用，判断是否需要唤醒；之后读取的状态也不早于栅栏 */
+static inline bool hwait_has_waiters(hwait_t* wait)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    return atomic_load_explicit(&wait->waiters, memory_order_relaxed) != 0;
+}
+
+#endif /* HLIBC_USE_THREADS */
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __HLIBC_HWAIT_H__ */
@@ -0,0 +1,420 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/executor/hexecutor.c
+ * @Description: 工作窃取线程池
+ * @other: None
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "hexecutor.h"
+
+#if HLIBC_USE_THREADS
+#include "../common/hwait.h"
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+/*********************
+ *      MACROS
+ *********************/
+
+/* 窃取时与其他窃取者竞争失败后的重试次数 */
+#define EXECUTOR_STEAL_RETRY    4
+
+/* 任务池空闲链表头：高 32 位为版本号（防 ABA），低 32 位为下标 + 1，0 表示空 */
+#define FREE_HEAD(tag, index)   (((uint64_t)(tag) << 32) | ((uint64_t)(index) + 1u))
+#define FREE_HEAD_TAG(head)     ((uint32_t)((head) >> 32))
+#define FREE_HEAD_INDEX(head)   ((uint32_t)(head) - 1u)
+#define FREE_HEAD_EMPTY(head)   ((uint32_t)(head) == 0)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    htask_f fn;
+    void* arg;
+    _Atomic uint32_t next;      /* 空闲链表中的下一个下标 + 1 */
+} executor_task_t;
+
+typedef struct {
+    _Alignas(HLIBC_CACHE_LINE_SIZE) hexecutor_ptr_t owner;
+    hwsdeque_ptr_t deque;       /* 本线程的任务队列，元素为 executor_task_t* */
+    pthread_t thread;
+    uint32_t index;
+    uint32_t rng;               /* 选择窃取对象的随机数状态 */
+} executor_worker_t;
+
+struct hexecutor {
+    uint32_t worker_count;
+    uint32_t task_capacity;
+    uint32_t thread_count;      /* 已启动的工作线程数 */
+    executor_worker_t* workers;
+    executor_task_t* tasks;
+    hcqueue_ptr_t injection;    /* 外部线程提交的任务 */
+    atomic_bool stop;
+
+    _Alignas(HLIBC_CACHE_LINE_SIZE) _Atomic uint64_t free_head;
+    _Alignas(HLIBC_CACHE_LINE_SIZE) atomic_uint pending;
+    _Alignas(HLIBC_CACHE_LINE_SIZE) hwait_t work;   /* 空闲工作线程在此睡眠 */
+    _Alignas(HLIBC_CACHE_LINE_SIZE) hwait_t done;   /* wait_all 在此睡眠 */
+};
+
+/* 头文件中的布局镜像必须与实际结构体一致 */
+_Static_assert(sizeof(struct hexecutor) == HEXECUTOR_STRUCT_SIZE &&
+               _Alignof(struct hexecutor) == _Alignof(hexecutor_static_layout_t),
+               "hexecutor_static_layout_t does not match struct hexecutor");
+_Static_assert(sizeof(executor_worker_t) == HEXECUTOR_WORKER_SIZE &&
+               _Alignof(executor_worker_t) == _Alignof(hexecutor_worker_layout_t),
+               "hexecutor_worker_layout_t does not match executor_worker_t");
+_Static_assert(sizeof(executor_task_t) == HEXECUTOR_TASK_SIZE &&
+               _Alignof(executor_task_t) == _Alignof(hexecutor_task_layout_t),
+               "hexecutor_task_layout_t does not match executor_task_t");
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/* 当前线程所属的工作线程，非工作线程为 NULL */
+static _Thread_local executor_worker_t* s_current_worker;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void executor_init(hexecutor_ptr_t executor);
+static bool executor_start(hexecutor_ptr_t executor);
+static void executor_stop(hexecutor_ptr_t executor);
+static executor_task_t* task_alloc(hexecutor_ptr_t executor);
+static void task_free(hexecutor_ptr_t executor, executor_task_t* task);
+static bool task_publish(hexecutor_ptr_t executor, executor_task_t* task);
+static executor_task_t* find_task(hexecutor_ptr_t executor, executor_worker_t* worker);
+static void* worker_main(void* arg);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/* ==================== 动态分配实现 ==================== */
+
+hexecutor_ptr_t hexecutor_create(uint32_t worker_count, uint32_t task_capacity)
+{
+    if (task_capacity == 0) return NULL;
+    if (worker_count == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        worker_count = cpus > 0 ? (uint32_t)cpus : 1u;
+    }
+
+    hexecutor_ptr_t executor = (hexecutor_ptr_t)aligned_alloc(HLIBC_CACHE_LINE_SIZE, sizeof(struct hexecutor));
+    if (executor == NULL) return NULL;
+    memset(executor, 0, sizeof(struct hexecutor));
+    executor->worker_count = worker_count;
+    executor->task_capacity = task_capacity;
+    executor->workers = (executor_worker_t*)aligned_alloc(HLIBC_CACHE_LINE_SIZE,
+                                                          worker_count * sizeof(executor_worker_t));
+    executor->tasks = (executor_task_t*)malloc(task_capacity * sizeof(executor_task_t));
+    if (executor->workers == NULL || executor->tasks == NULL) {
+        hexecutor_destroy(executor);
+        return NULL;
+    }
+    memset(executor->workers, 0, worker_count * sizeof(executor_worker_t));
+    executor_init(executor);
+
+    executor->injection = hcqueue_create(sizeof(executor_task_t*));
+    bool ok = executor->injection != NULL;
+    for (uint32_t i = 0; ok && i < worker_count; ++i) {
+        /* 未完成的任务不会超过任务池大小，队列因此不会增长 */
+        executor->workers[i].deque = hwsdeque_create(sizeof(executor_task_t*), task_capacity);
+        ok = executor->workers[i].deque != NULL;
+    }
+    if (!ok || !executor_start(executor)) {
+        hexecutor_destroy(executor);
+        return NULL;
+    }
+    return executor;
+}
+
+void hexecutor_destroy(hexecutor_ptr_t executor)
+{
+    executor_stop(executor);
+    if (executor->workers != NULL) {
+        for (uint32_t i = 0; i < executor->worker_count; ++i) {
+            if (executor->workers[i].deque != NULL)
+                hwsdeque_destroy(executor->workers[i].deque);
+        }
+    }
+    if (executor->injection != NULL) hcqueue_destroy(executor->injection);
+    free(executor->tasks);
+    free(executor->workers);
+    free(executor);
+}
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+/* ==================== 静态分配实现 ==================== */
+
+hexecutor_ptr_t hexecutor_create_static(void* buffer, uint32_t buffer_size,
+                                        uint32_t worker_count, uint32_t task_capacity)
+{
+    if (buffer == NULL || worker_count == 0 || task_capacity == 0) return NULL;
+    if (buffer_size < HEXECUTOR_CALC_BUFFER_SIZE(worker_count, task_capacity)) return NULL;
+
+    /* 按 HEXECUTOR_CALC_BUFFER_SIZE 的布局依次切分 */
+    uint8_t* ptr = (uint8_t*)HLIBC_ALIGN_UP((uintptr_t)buffer, HLIBC_CACHE_LINE_SIZE);
+    hexecutor_ptr_t executor = (hexecutor_ptr_t)ptr;
+    memset(executor, 0, sizeof(struct hexecutor));
+    ptr += HEXECUTOR_STRUCT_SIZE;
+    executor->worker_count = worker_count;
+    executor->task_capacity = task_capacity;
+    executor->workers = (executor_worker_t*)ptr;
+    memset(executor->workers, 0, worker_count * sizeof(executor_worker_t));
+    ptr += worker_count * HEXECUTOR_WORKER_SIZE;
+    executor->tasks = (executor_task_t*)ptr;
+    ptr += HLIBC_ALIGN_UP(task_capacity * HEXECUTOR_TASK_SIZE, HLIBC_CACHE_LINE_SIZE);
+
+    uint32_t size = HCQUEUE_CALC_BUFFER_SIZE(void*, task_capacity);
+    executor->injection = hcqueue_create_static(ptr, size, sizeof(executor_task_t*));
+    bool ok = executor->injection != NULL;
+    ptr += size;
+    size = HWSDEQUE_CALC_BUFFER_SIZE(void*, task_capacity);
+    for (uint32_t i = 0; ok && i < worker_count; ++i, ptr += size) {
+        executor->workers[i].deque = hwsdeque_create_static(ptr, size, sizeof(executor_task_t*));
+        ok = executor->workers[i].deque != NULL;
+    }
+    if (!ok) {
+        /* 尚未启动任何线程，只需清理已创建的队列 */
+        for (uint32_t i = 0; i < worker_count; ++i)
+            if (executor->workers[i].deque != NULL) hwsdeque_destroy_static(executor->workers[i].deque);
+        if (executor->injection != NULL) hcqueue_destroy_static(executor->injection);
+        return NULL;
+    }
+
+    executor_init(executor);
+    if (!executor_start(executor)) {
+        hexecutor_destroy_static(executor);
+        return NULL;
+    }
+    return executor;
+}
+
+void hexecutor_destroy_static(hexecutor_ptr_t executor)
+{
+    if (executor == NULL) return;
+    executor_stop(executor);
+    for (uint32_t i = 0; i < executor->worker_count; ++i)
+        hwsdeque_destroy_static(executor->workers[i].deque);
+    hcqueue_destroy_static(executor->injection);
+}
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+hlib_status_t hexecutor_submit(hexecutor_ptr_t executor, htask_f fn, void* arg)
+{
+    htask_t task = { fn, arg };
+    return hexecutor_submit_batch(executor, &task, 1) == 1 ? HLIB_OK : HLIB_OVERFLOW;
+}
+
+uint32_t hexecutor_submit_batch(hexecutor_ptr_t executor, const htask_t* tasks,
+                                uint32_t count)
+{
+    uint32_t n = 0;
+    for (; n < count; ++n) {
+        executor_task_t* task = task_alloc(executor);
+        if (task == NULL) break;
+        task->fn = tasks[n].fn;
+        task->arg = tasks[n].arg;
+        /* 先计数再发布，任务不可能在计数之前完成 */
+        atomic_fetch_add_explicit(&executor->pending, 1, memory_order_relaxed);
+        if (!task_publish(executor, task)) {
+            atomic_fetch_sub_explicit(&executor->pending, 1, memory_order_relaxed);
+            task_free(executor, task);
+            break;
+        }
+    }
+    /* 整批只唤醒一次 */
+    if (n > 0 && hwait_has_waiters(&executor->work))
+        hwait_notify(&executor->work, n > 1);
+    return n;
+}
+
+void hexecutor_wait_all(hexecutor_ptr_t executor)
+{
+    while (atomic_load(&executor->pending) != 0) {
+        unsigned seq = hwait_prepare(&executor->done);
+        if (atomic_load(&executor->pending) == 0) {
+            hwait_cancel(&executor->done);
+            break;
+        }
+        hwait_wait(&executor->done, seq, HWAIT_FOREVER);
+        hwait_cancel(&executor->done);
+    }
+}
+
+/*=======================
+ * Getter functions
+ *======================*/
+
+uint32_t hexecutor_worker_count(hexecutor_ptr_t executor)
+{
+    return executor->worker_count;
+}
+
+uint32_t hexecutor_pending(hexecutor_ptr_t executor)
+{
+    return atomic_load_explicit(&executor->pending, memory_order_relaxed);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void executor_init(hexecutor_ptr_t executor)
+{
+    /* 任务池串成空闲链表 */
+    for (uint32_t i = 0; i < executor->task_capacity; ++i)
+        atomic_init(&executor->tasks[i].next, i + 1 < executor->task_capacity ? i + 2 : 0);
+    atomic_init(&executor->free_head, FREE_HEAD(0, 0));
+    atomic_init(&executor->pending, 0);
+    hwait_init(&executor->work);
+    hwait_init(&executor->done);
+    atomic_init(&executor->stop, false);
+    for (uint32_t i = 0; i < executor->worker_count; ++i) {
+        executor->workers[i].owner = executor;
+        executor->workers[i].index = i;
+        executor->workers[i].rng = 0x9e3779b9u * (i + 1);
+    }
+}
+
+static bool executor_start(hexecutor_ptr_t executor)
+{
+    for (uint32_t i = 0; i < executor->worker_count; ++i) {
+        if (pthread_create(&executor->workers[i].thread, NULL, worker_main,
+                           &executor->workers[i]) != 0)
+            return false;
+        ++executor->thread_count;
+    }
+    return true;
+}
+
+static void executor_stop(hexecutor_ptr_t executor)
+{
+    if (executor->tasks == NULL || executor->workers == NULL) return;
+    hexecutor_wait_all(executor);
+    /* notify 会推进序号，已登记但尚未睡眠的线程也不会错过 */
+    atomic_store(&executor->stop, true);
+    hwait_notify(&executor->work, true);
+    for (uint32_t i = 0; i < executor->thread_count; ++i)
+        pthread_join(executor->workers[i].thread, NULL);
+    hwait_destroy(&executor->work);
+    hwait_destroy(&executor->done);
+}
+
+/* 从任务池的无锁空闲链表中取出一个记录 */
+static executor_task_t* task_alloc(hexecutor_ptr_t executor)
+{
+    uint64_t head = atomic_load_explicit(&executor->free_head, memory_order_acquire);
+    for (;;) {
+        if (FREE_HEAD_EMPTY(head)) return NULL;
+        executor_task_t* task = &executor->tasks[FREE_HEAD_INDEX(head)];
+        uint32_t next = atomic_load_explicit(&task->next, memory_order_relaxed);
+        uint64_t desired = ((uint64_t)(FREE_HEAD_TAG(head) + 1u) << 32) | next;
+        if (atomic_compare_exchange_weak_explicit(&executor->free_head, &head, desired,
+                                                  memory_order_acquire, memory_order_acquire))
+            return task;
+    }
+}
+
+static void task_free(hexecutor_ptr_t executor, executor_task_t* task)
+{
+    uint32_t index = (uint32_t)(task - executor->tasks);
+    uint64_t head = atomic_load_explicit(&executor->free_head, memory_order_relaxed);
+    for (;;) {
+        atomic_store_explicit(&task->next, (uint32_t)head, memory_order_relaxed);
+        uint64_t desired = FREE_HEAD(FREE_HEAD_TAG(head) + 1u, index);
+        if (atomic_compare_exchange_weak_explicit(&executor->free_head, &head, desired,
+                                                  memory_order_release, memory_order_relaxed))
+            return;
+    }
+}
+
+/* 工作线程提交到自己的队列，其他线程提交到全局注入队列 */
+static bool task_publish(hexecutor_ptr_t executor, executor_task_t* task)
+{
+    executor_worker_t* worker = s_current_worker;
+    if (worker != NULL && worker->owner == executor &&
+        hwsdeque_push(worker->deque, &task, sizeof(task)) == HLIB_OK)
+        return true;
+    return hcqueue_push(executor->injection, &task, sizeof(task), NULL) == HLIB_OK;
+}
+
+/* 依次查找：自己的队列 -> 全局注入队列 -> 随机选一个起点轮流窃取其他线程 */
+static executor_task_t* find_task(hexecutor_ptr_t executor, executor_worker_t* worker)
+{
+    executor_task_t* task;
+    if (hwsdeque_pop(worker->deque, &task) == HLIB_OK) return task;
+    if (hcqueue_pop(executor->injection, &task) == HLIB_OK) return task;
+
+    uint32_t n = executor->worker_count;
+    if (n < 2) return NULL;
+    worker->rng ^= worker->rng << 13;
+    worker->rng ^= worker->rng >> 17;
+    worker->rng ^= worker->rng << 5;
+    uint32_t start = worker->rng % n;
+    for (uint32_t k = 0; k < n; ++k) {
+        executor_worker_t* victim = &executor->workers[(start + k) % n];
+        if (victim == worker) continue;
+        for (int retry = 0; retry < EXECUTOR_STEAL_RETRY; ++retry) {
+            hlib_status_t ret = hwsdeque_steal(victim->deque, &task);
+            if (ret == HLIB_OK) return task;
+            if (ret != HLIB_BUSY) break;
+        }
+    }
+    return NULL;
+}
+
+static void* worker_main(void* arg)
+{
+    executor_worker_t* worker = (executor_worker_t*)arg;
+    hexecutor_ptr_t executor = worker->owner;
+    s_current_worker = worker;
+
+    for (;;) {
+        executor_task_t* task = find_task(executor, worker);
+        if (task == NULL) {
+            /* 登记后再找一次，提交者要么看到登记，要么任务在这次查找中被找到 */
+            unsigned seq = hwait_prepare(&executor->work);
+            task = find_task(executor, worker);
+            if (task == NULL) {
+                if (atomic_load(&executor->stop)) {
+                    hwait_cancel(&executor->work);
+                    break;
+                }
+                hwait_wait(&executor->work, seq, HWAIT_FOREVER);
+                hwait_cancel(&executor->work);
+                continue;
+            }
+            hwait_cancel(&executor->work);
+        }
+
+        htask_f fn = task->fn;
+        void* task_arg = task->arg;
+        task_free(executor, task);
+        fn(task_arg);
+        if (atomic_fetch_sub(&executor->pending, 1) == 1 && hwait_has_waiters(&executor->done))
+            hwait_notify(&executor->done, true);
+    }
+    s_current_worker = NULL;
+    return NULL;
+}
+
+#endif /* HLIBC_USE_THREADS */
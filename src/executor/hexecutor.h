@@ -0,0 +1,185 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/executor/hexecutor.h
+ * @Description: 工作窃取线程池
+ * @other: None
+ */
+#ifndef __HLIBC_HEXECUTOR_H__
+#define __HLIBC_HEXECUTOR_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../common/hcommon.h"
+#include "../common/hlibc_config.h"
+#include "../queue/hcqueue.h"
+#include "../stack/hwsdeque.h"
+
+/*********************
+ *      MACROS
+ *********************/
+
+/*
+ * 静态分配各部分的大小（精确值，由下方的布局镜像得出，hexecutor.c 中用 _Static_assert 校验）
+ */
+#define HEXECUTOR_STRUCT_SIZE sizeof(hexecutor_static_layout_t)
+#define HEXECUTOR_WORKER_SIZE sizeof(hexecutor_worker_layout_t)
+#define HEXECUTOR_TASK_SIZE   sizeof(hexecutor_task_layout_t)
+
+/**
+ * 计算静态 hexecutor 所需的 buffer 大小
+ * @param workers 工作线程数
+ * @param capacity 同时未完成的任务数上限
+ *
+ * 内存布局: [结构体][工作线程数组][任务池][全局注入队列][每个工作线程的窃取队列]
+ */
+#define HEXECUTOR_CALC_BUFFER_SIZE(workers, capacity)                    \
+  (HLIBC_CACHE_LINE_SIZE + HEXECUTOR_STRUCT_SIZE +                       \
+   (workers) * HEXECUTOR_WORKER_SIZE +                                   \
+   HLIBC_ALIGN_UP((capacity) * HEXECUTOR_TASK_SIZE, HLIBC_CACHE_LINE_SIZE) + \
+   HCQUEUE_CALC_BUFFER_SIZE(void*, capacity) +                           \
+   (workers) * HWSDEQUE_CALC_BUFFER_SIZE(void*, capacity))
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct hexecutor* hexecutor_ptr_t;
+
+typedef void (*htask_f)(void* arg);
+
+/* 一个待执行的任务：fn(arg) */
+typedef struct {
+    htask_f fn;
+    void* arg;
+} htask_t;
+
+#if HLIBC_USE_THREADS
+/*
+ * 静态分配模式下各部分的布局镜像，字段必须与 hexecutor.c 保持一致
+ */
+typedef struct {
+    htask_f fn_;
+    void* arg_;
+    uint32_t next_;
+} hexecutor_task_layout_t;
+
+typedef struct {
+    HLIBC_ALIGNAS(HLIBC_CACHE_LINE_SIZE) void* owner_;
+    void* deque_;
+    pthread_t thread_;
+    uint32_t index_;
+    uint32_t rng_;
+} hexecutor_worker_layout_t;
+
+typedef struct {
+    uint32_t worker_count_;
+    uint32_t task_capacity_;
+    uint32_t thread_count_;
+    void* workers_;
+    void* tasks_;
+    void* injection_;
+    bool stop_;
+    HLIBC_ALIGNAS(HLIBC_CACHE_LINE_SIZE) uint64_t free_head_;
+    HLIBC_ALIGNAS(HLIBC_CACHE_LINE_SIZE) unsigned pending_;
+    HLIBC_ALIGNAS(HLIBC_CACHE_LINE_SIZE) hcqueue_wait_layout_t work_;
+    HLIBC_ALIGNAS(HLIBC_CACHE_LINE_SIZE) hcqueue_wait_layout_t done_;
+} hexecutor_static_layout_t;
+#endif
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+#if HLIBC_USE_THREADS
+
+/*
+ * 固定大小的线程池。每个工作线程有自己的 hwsdeque，外部线程提交的任务进入全局注入队列（hcqueue），
+ * 任务内部提交的子任务进入当前工作线程自己的队列；空闲的工作线程从其他线程的队列中窃取。
+ * 任务记录来自创建时预先分配的任务池，提交时不调用 malloc；任务池用尽时提交失败。
+ */
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/**
+ * 创建线程池并启动工作线程（动态分配）
+ * @param worker_count 工作线程数，0 表示使用在线 CPU 数
+ * @param task_capacity 同时未完成的任务数上限
+ * @return 返回线程池，失败返回 NULL
+ */
+extern hexecutor_ptr_t hexecutor_create(uint32_t worker_count, uint32_t task_capacity);
+
+/**
+ * 等待所有任务完成后停止并回收工作线程，释放线程池
+ */
+extern void hexecutor_destroy(hexecutor_ptr_t executor);
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+
+/**
+ * 在用户提供的 buffer 上创建线程池并启动工作线程
+ * @param buffer 用户提供的内存缓冲区，无需对齐
+ * @param buffer_size 缓冲区大小（使用 HEXECUTOR_CALC_BUFFER_SIZE 宏计算）
+ * @param worker_count 工作线程数，必须大于 0
+ * @param task_capacity 同时未完成的任务数上限
+ * @return 返回线程池，失败返回 NULL
+ */
+extern hexecutor_ptr_t hexecutor_create_static(void* buffer, uint32_t buffer_size,
+                                               uint32_t worker_count, uint32_t task_capacity);
+
+/**
+ * 等待所有任务完成后停止并回收工作线程（不释放内存）
+ */
+extern void hexecutor_destroy_static(hexecutor_ptr_t executor);
+
+/* 兼容性宏定义 */
+#define hexecutor_create(worker_count, task_capacity) \
+  ((void)(worker_count), (void)(task_capacity), (hexecutor_ptr_t)NULL)
+#define hexecutor_destroy(executor) hexecutor_destroy_static(executor)
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+/**
+ * 提交一个任务，可在任意线程（包括任务内部）调用
+ * @return HLIB_OK 成功；HLIB_OVERFLOW 任务池已满
+ */
+extern hlib_status_t hexecutor_submit(hexecutor_ptr_t executor, htask_f fn, void* arg);
+
+/**
+ * 批量提交任务，只唤醒一次空闲线程
+ * @return 成功提交的任务数，任务池不足时只提交前面的一部分
+ */
+extern uint32_t hexecutor_submit_batch(hexecutor_ptr_t executor, const htask_t* tasks,
+                                       uint32_t count);
+
+/**
+ * 阻塞直到已提交的任务（包括它们提交的子任务）全部执行完毕
+ * 不能在任务内部调用。
+ */
+extern void hexecutor_wait_all(hexecutor_ptr_t executor);
+
+/*=======================
+ * Getter functions
+ *======================*/
+
+extern uint32_t hexecutor_worker_count(hexecutor_ptr_t executor);
+
+/**
+ * 已提交但尚未执行完的任务数
+ */
+extern uint32_t hexecutor_pending(hexecutor_ptr_t executor);
+
+#endif /* HLIBC_USE_THREADS */
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __HLIBC_HEXECUTOR_H__ */
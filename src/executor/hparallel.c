@@ -0,0 +1,314 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/executor/hparallel.c
+ * @Description: 基于 hexecutor 的并行遍历与归约
+ * @other: None
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "hparallel.h"
+
+#if HLIBC_USE_THREADS
+#include "../common/hwait.h"
+
+/*********************
+ *      MACROS
+ *********************/
+
+/* 每个线程平均分到的块数，块多一些可以让先完成的线程接手剩余的工作 */
+#define PARALLEL_CHUNKS_PER_THREAD  4u
+
+/* 部分结果按缓存行隔开，不同线程写入时互不干扰 */
+#define PARALLEL_PARTIAL_STRIDE     HLIBC_ALIGN_UP(HPARALLEL_MAX_ACC_SIZE, HLIBC_CACHE_LINE_SIZE)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    JOB_FOR_EACH,
+    JOB_REDUCE,
+    JOB_COUNT_IF
+} job_kind_t;
+
+/* 一次并行调用，位于调用线程的栈上，所有辅助任务退出后调用才返回 */
+typedef struct {
+    _Alignas(HLIBC_CACHE_LINE_SIZE) atomic_uint next;   /* 下一个待领取的块 */
+    _Alignas(HLIBC_CACHE_LINE_SIZE) atomic_uint helpers; /* 尚未退出的辅助任务数 */
+    atomic_uint visited;            /* for_each：已交给回调的元素数 */
+    atomic_uint matched;            /* count_if：满足条件的元素数 */
+    atomic_bool cancel;             /* for_each：回调要求停止 */
+    const hparallel_range_t* range;
+    uint32_t chunk_size;
+    uint32_t chunks0;               /* 第一段的块数 */
+    uint32_t chunk_count;
+    job_kind_t kind;
+    hforeach_span_f for_each;
+    hparallel_pred_f pred;
+    hparallel_fold_f fold;
+    void* ctx;
+    hcdata_ptr_t identity;          /* reduce：单位元 */
+    uint32_t acc_size;
+    uint8_t* partials;              /* reduce：每块一个部分结果 */
+} parallel_job_t;
+
+#if HLIBC_USE_STATIC_ALLOC
+/* 由 foreach_span 回调逐段填充 range，超过两段时置 overflow 并停止遍历 */
+typedef struct {
+    hparallel_range_t* range;
+    uint32_t spans;
+    bool overflow;
+} range_builder_t;
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/*
+ * 调用线程在此等待辅助任务退出。等待对象不能放在 job 里：
+ * 最后一个辅助任务递减计数后调用线程随时可能返回，job 所在的栈随之失效
+ */
+static hwait_t s_done;
+static pthread_once_t s_done_once = PTHREAD_ONCE_INIT;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void job_setup(parallel_job_t* job, hexecutor_ptr_t executor,
+                      const hparallel_range_t* range);
+static void job_execute(parallel_job_t* job, hexecutor_ptr_t executor);
+static void job_work(parallel_job_t* job);
+static void job_run_chunk(parallel_job_t* job, uint32_t chunk);
+static void job_helper(void* arg);
+static void done_init(void);
+#if HLIBC_USE_STATIC_ALLOC
+static bool range_add_span(hdata_ptr_t base, uint32_t count, void* ctx);
+#endif
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+hlib_status_t hparallel_range_init(hparallel_range_t* range, hdata_ptr_t base, uint32_t count,
+                                   uint32_t type_size)
+{
+    range->base[0] = base;
+    range->count[0] = type_size != 0 ? count : 0;
+    range->base[1] = NULL;
+    range->count[1] = 0;
+    range->type_size = type_size;
+    return type_size != 0 ? HLIB_OK : HLIB_ERROR;
+}
+
+#if HLIBC_USE_STATIC_ALLOC
+hlib_status_t hparallel_range_hqueue(hparallel_range_t* range, hqueue_ptr_t queue)
+{
+    uint32_t type_size = hqueue_type_size(queue);
+    range_builder_t builder = { range, 0, false };
+    hparallel_range_init(range, NULL, 0, type_size);
+    hqueue_foreach_span(queue, range_add_span, &builder);
+    if (!builder.overflow) return HLIB_OK;
+    /* 元素已溢出到追加缓冲区，无法用两段连续内存描述 */
+    hparallel_range_init(range, NULL, 0, type_size);
+    return HLIB_ERROR;
+}
+
+void hparallel_range_hstack(hparallel_range_t* range, hstack_ptr_t stack)
+{
+    range_builder_t builder = { range, 0, false };
+    hparallel_range_init(range, NULL, 0, hstack_type_size(stack));
+    hstack_foreach_span(stack, range_add_span, &builder);
+}
+#endif
+
+uint32_t hparallel_for_each(hexecutor_ptr_t executor, const hparallel_range_t* range,
+                            hforeach_span_f fn, void* ctx)
+{
+    parallel_job_t job;
+    job_setup(&job, executor, range);
+    job.kind = JOB_FOR_EACH;
+    job.for_each = fn;
+    job.ctx = ctx;
+    job_execute(&job, executor);
+    return atomic_load_explicit(&job.visited, memory_order_relaxed);
+}
+
+hlib_status_t hparallel_reduce(hexecutor_ptr_t executor, const hparallel_range_t* range,
+                               hdata_ptr_t acc, uint32_t acc_size,
+                               hparallel_fold_f fold, hparallel_combine_f combine,
+                               void* ctx)
+{
+    HLIBC_ALIGNAS(HLIBC_CACHE_LINE_SIZE) uint8_t partials[HPARALLEL_MAX_CHUNKS * PARALLEL_PARTIAL_STRIDE];
+    if (acc_size == 0 || acc_size > HPARALLEL_MAX_ACC_SIZE) return HLIB_ERROR;
+
+    parallel_job_t job;
+    job_setup(&job, executor, range);
+    job.kind = JOB_REDUCE;
+    job.fold = fold;
+    job.ctx = ctx;
+    job.identity = acc;
+    job.acc_size = acc_size;
+    job.partials = partials;
+    job_execute(&job, executor);
+
+    /* 按块的顺序合并，不要求 combine 满足交换律 */
+    for (uint32_t i = 0; i < job.chunk_count; ++i)
+        combine(acc, partials + i * PARALLEL_PARTIAL_STRIDE, ctx);
+    return HLIB_OK;
+}
+
+uint32_t hparallel_count_if(hexecutor_ptr_t executor, const hparallel_range_t* range,
+                            hparallel_pred_f pred, void* ctx)
+{
+    parallel_job_t job;
+    job_setup(&job, executor, range);
+    job.kind = JOB_COUNT_IF;
+    job.pred = pred;
+    job.ctx = ctx;
+    job_execute(&job, executor);
+    return atomic_load_explicit(&job.matched, memory_order_relaxed);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* 按线程数与最小块大小切分，块不跨越两段的边界 */
+static void job_setup(parallel_job_t* job, hexecutor_ptr_t executor,
+                      const hparallel_range_t* range)
+{
+    uint32_t total = range->count[0] + range->count[1];
+    uint32_t threads = (executor != NULL ? hexecutor_worker_count(executor) : 0) + 1;
+    uint32_t target = threads * PARALLEL_CHUNKS_PER_THREAD;
+    /* 每段最后一块可能不满，两段最多各多出一块 */
+    if (target > HPARALLEL_MAX_CHUNKS - 2) target = HPARALLEL_MAX_CHUNKS - 2;
+
+    uint32_t chunk_size = total / target + (total % target != 0);
+    /* type_size 为 0 的 range 由 hparallel_range_init 置为空，这里只防止除零 */
+    uint32_t min_size = range->type_size != 0 ? HPARALLEL_MIN_CHUNK_BYTES / range->type_size : 1;
+    if (chunk_size < min_size) chunk_size = min_size;
+    if (chunk_size == 0) chunk_size = 1;
+
+    atomic_init(&job->next, 0);
+    atomic_init(&job->helpers, 0);
+    atomic_init(&job->visited, 0);
+    atomic_init(&job->matched, 0);
+    atomic_init(&job->cancel, false);
+    job->range = range;
+    job->chunk_size = chunk_size;
+    job->chunks0 = range->count[0] / chunk_size + (range->count[0] % chunk_size != 0);
+    job->chunk_count = job->chunks0 +
+                       range->count[1] / chunk_size + (range->count[1] % chunk_size != 0);
+}
+
+static void job_execute(parallel_job_t* job, hexecutor_ptr_t executor)
+{
+    uint32_t helpers = 0;
+    if (executor != NULL && job->chunk_count > 1) {
+        htask_t tasks[HPARALLEL_MAX_CHUNKS];
+        pthread_once(&s_done_once, done_init);
+        helpers = hexecutor_worker_count(executor);
+        if (helpers > job->chunk_count - 1) helpers = job->chunk_count - 1;
+        for (uint32_t i = 0; i < helpers; ++i) {
+            tasks[i].fn = job_helper;
+            tasks[i].arg = job;
+        }
+        atomic_store_explicit(&job->helpers, helpers, memory_order_relaxed);
+        /* 任务池不足时少提交几个，剩下的块由调用线程处理 */
+        uint32_t submitted = hexecutor_submit_batch(executor, tasks, helpers);
+        if (submitted < helpers)
+            atomic_fetch_sub(&job->helpers, helpers - submitted);
+        helpers = submitted;
+    }
+
+    job_work(job);
+    if (helpers == 0) return;
+
+    while (atomic_load(&job->helpers) != 0) {
+        unsigned seq = hwait_prepare(&s_done);
+        if (atomic_load(&job->helpers) == 0) {
+            hwait_cancel(&s_done);
+            break;
+        }
+        hwait_wait(&s_done, seq, HWAIT_FOREVER);
+        hwait_cancel(&s_done);
+    }
+}
+
+/* 不断领取下一个块，直到全部领完 */
+static void job_work(parallel_job_t* job)
+{
+    while (!atomic_load_explicit(&job->cancel, memory_order_relaxed)) {
+        uint32_t chunk = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed);
+        if (chunk >= job->chunk_count) break;
+        job_run_chunk(job, chunk);
+    }
+}
+
+static void job_run_chunk(parallel_job_t* job, uint32_t chunk)
+{
+    const hparallel_range_t* range = job->range;
+    uint32_t span = chunk < job->chunks0 ? 0 : 1;
+    uint32_t begin = (span == 0 ? chunk : chunk - job->chunks0) * job->chunk_size;
+    uint32_t count = range->count[span] - begin;
+    if (count > job->chunk_size) count = job->chunk_size;
+    uint8_t* base = (uint8_t*)range->base[span] + (size_t)begin * range->type_size;
+
+    switch (job->kind) {
+    case JOB_FOR_EACH:
+        atomic_fetch_add_explicit(&job->visited, count, memory_order_relaxed);
+        if (!job->for_each(base, count, job->ctx))
+            atomic_store_explicit(&job->cancel, true, memory_order_relaxed);
+        break;
+    case JOB_REDUCE: {
+        uint8_t* partial = job->partials + chunk * PARALLEL_PARTIAL_STRIDE;
+        memcpy(partial, job->identity, job->acc_size);
+        job->fold(partial, base, count, job->ctx);
+        break;
+    }
+    case JOB_COUNT_IF: {
+        uint32_t matched = 0;
+        for (uint32_t i = 0; i < count; ++i)
+            matched += job->pred(base + (size_t)i * range->type_size, job->ctx) ? 1u : 0u;
+        atomic_fetch_add_explicit(&job->matched, matched, memory_order_relaxed);
+        break;
+    }
+    }
+}
+
+static void job_helper(void* arg)
+{
+    parallel_job_t* job = (parallel_job_t*)arg;
+    job_work(job);
+    /* 递减之后不再访问 job */
+    if (atomic_fetch_sub(&job->helpers, 1) == 1 && hwait_has_waiters(&s_done))
+        hwait_notify(&s_done, true);
+}
+
+static void done_init(void)
+{
+    hwait_init(&s_done);
+}
+
+#if HLIBC_USE_STATIC_ALLOC
+static bool range_add_span(hdata_ptr_t base, uint32_t count, void* ctx)
+{
+    range_builder_t* builder = (range_builder_t*)ctx;
+    if (builder->spans == 2) {
+        builder->overflow = true;
+        return false;
+    }
+    builder->range->base[builder->spans] = base;
+    builder->range->count[builder->spans] = count;
+    ++builder->spans;
+    return true;
+}
+#endif
+
+#endif /* HLIBC_USE_THREADS */
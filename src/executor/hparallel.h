@@ -0,0 +1,130 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/executor/hparallel.h
+ * @Description: 基于 hexecutor 的并行遍历与归约
+ * @other: None
+ */
+#ifndef __HLIBC_HPARALLEL_H__
+#define __HLIBC_HPARALLEL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../common/hcommon.h"
+#include "../common/hlibc_config.h"
+#include "hexecutor.h"
+#if HLIBC_USE_STATIC_ALLOC
+#include "../queue/hqueue.h"
+#include "../stack/hstack.h"
+#endif
+
+/*********************
+ *      MACROS
+ *********************/
+
+/* 一次调用最多切分的块数，也是 hparallel_reduce 的部分结果个数 */
+#define HPARALLEL_MAX_CHUNKS        64
+
+/* 每个块至少包含的字节数，过小的块调度开销会超过计算本身 */
+#define HPARALLEL_MIN_CHUNK_BYTES   (32u * 1024u)
+
+/* hparallel_reduce 累加器的最大字节数 */
+#define HPARALLEL_MAX_ACC_SIZE      HLIBC_CACHE_LINE_SIZE
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*
+ * 待处理的元素：最多两段连续内存（环形缓冲区回绕时为两段），按 span[0]、span[1] 的顺序排列
+ */
+typedef struct {
+    hdata_ptr_t base[2];
+    uint32_t count[2];
+    uint32_t type_size;
+} hparallel_range_t;
+
+/* 判断一个元素是否满足条件 */
+typedef bool (*hparallel_pred_f)(hcdata_ptr_t data, void* ctx);
+
+/* 把 base 开始的 count 个连续元素累加进 acc */
+typedef void (*hparallel_fold_f)(hdata_ptr_t acc, hcdata_ptr_t base, uint32_t count, void* ctx);
+
+/* 把另一个部分结果 other 合并进 acc */
+typedef void (*hparallel_combine_f)(hdata_ptr_t acc, hcdata_ptr_t other, void* ctx);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+#if HLIBC_USE_THREADS
+
+/*
+ * 把一段或两段连续存储切成若干块，由线程池的工作线程与调用线程一起处理，全部完成后返回。
+ * 块的大小不小于 HPARALLEL_MIN_CHUNK_BYTES，块数不超过 HPARALLEL_MAX_CHUNKS；
+ * 只有一个块或 executor 为 NULL 时直接在调用线程执行。
+ * 回调可能在多个线程中同时执行，彼此处理的元素互不重叠。
+ * 与 hexecutor_wait_all 一样，不能在同一线程池的任务内部调用。
+ */
+
+/**
+ * 描述一个连续数组
+ * @return HLIB_OK；type_size 为 0 时返回 HLIB_ERROR，range 置为空
+ */
+extern hlib_status_t hparallel_range_init(hparallel_range_t* range, hdata_ptr_t base,
+                                          uint32_t count, uint32_t type_size);
+
+#if HLIBC_USE_STATIC_ALLOC
+/**
+ * 描述静态 hqueue 中的全部元素（从队头到队尾，回绕时为两段），元素大小取自 queue
+ * 处理期间不能 push/pop
+ * @return HLIB_OK；元素已溢出到 hqueue_add_buffer 追加的缓冲区时返回 HLIB_ERROR，range 置为空
+ */
+extern hlib_status_t hparallel_range_hqueue(hparallel_range_t* range, hqueue_ptr_t queue);
+
+/**
+ * 描述静态 hstack 中的全部元素（从栈底到栈顶），元素大小取自 stack
+ * 处理期间不能 push/pop
+ */
+extern void hparallel_range_hstack(hparallel_range_t* range, hstack_ptr_t stack);
+#endif
+
+/**
+ * 并行遍历：对每个块调用一次 fn(base, count, ctx)
+ * fn 返回 false 时尚未开始的块不再处理，已经在其他线程执行的块不受影响
+ * @return 已交给 fn 的元素个数
+ */
+extern uint32_t hparallel_for_each(hexecutor_ptr_t executor, const hparallel_range_t* range,
+                                   hforeach_span_f fn, void* ctx);
+
+/**
+ * 并行归约
+ * 每个块从 acc 的初始值（单位元）的副本开始调用 fold，最后按块的顺序用 combine 合并进 acc，
+ * 因此 combine 只需满足结合律，结果与串行归约一致（浮点累加的舍入除外）
+ * @param acc 输入单位元，输出归约结果
+ * @param acc_size 累加器字节数，不超过 HPARALLEL_MAX_ACC_SIZE
+ * @return HLIB_OK 成功；HLIB_ERROR acc_size 超出上限
+ */
+extern hlib_status_t hparallel_reduce(hexecutor_ptr_t executor, const hparallel_range_t* range,
+                                      hdata_ptr_t acc, uint32_t acc_size,
+                                      hparallel_fold_f fold, hparallel_combine_f combine,
+                                      void* ctx);
+
+/**
+ * 并行计数：统计满足 pred 的元素个数
+ */
+extern uint32_t hparallel_count_if(hexecutor_ptr_t executor, const hparallel_range_t* range,
+                                   hparallel_pred_f pred, void* ctx);
+
+#endif /* HLIBC_USE_THREADS */
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __HLIBC_HPARALLEL_H__ */
@@ -0,0 +1,722 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/hlibc.hpp
+ * @Description: hlibc 容器的 C++ 模板封装（header-only）
+ * @other: None
+ */
+#ifndef __HLIBC_HPP__
+#define __HLIBC_HPP__
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "common/hcommon.h"
+#include "common/hlibc_config.h"
+#include "common/hlibc_type.h"
+#include "list/hlist.h"
+#include "queue/hqueue.h"
+#include "stack/hstack.h"
+
+/*
+ * 元素直接在 C 容器分配的槽位中原地构造（placement new），
+ * push/emplace/pop 都是对 C 接口的直接调用，不经过 copy_data_f 回调，
+ * 因此支持只能移动的类型以及非平凡析构的类型。
+ *
+ * 动态分配模式：模板参数 Alloc 通过 hallocator_t 接管结构体与节点池 chunk 的分配
+ * 静态分配模式：构造函数接收用户缓冲区，Alloc 不参与分配
+ *
+ * 失败处理：容量不足或内存不足时 push/emplace 抛出 std::bad_alloc
+ * （未启用异常时调用 std::abort）；不希望抛出时使用 try_emplace 系列接口。
+ * 被移动后的容器只能被销毁或重新赋值。
+ */
+namespace hlibc {
+
+namespace detail {
+
+[[noreturn]] inline void throw_bad_alloc()
+{
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+    throw std::bad_alloc();
+#else
+    std::abort();
+#endif
+}
+
+/*
+ * 动态分配时槽位按 max_align_t 对齐；静态分配时节点区与数据区只保证 HLIBC_STATIC_ALIGN 对齐，
+ * 对齐要求更高的类型需要用 -DHLIBC_STATIC_ALIGN=N 提高对齐粒度
+ */
+template <class T>
+struct element_check {
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "hlibc containers do not support over-aligned types");
+#if HLIBC_USE_STATIC_ALLOC
+    static_assert(alignof(T) <= HLIBC_STATIC_ALIGN,
+                  "alignof(T) exceeds HLIBC_STATIC_ALIGN; define HLIBC_STATIC_ALIGN to a larger value");
+#endif
+};
+
+/*
+ * 在 reserve() 返回的槽位上构造元素，用于无法撤销预留槽位的位置（队尾、链表中间）：
+ * 可能抛出的构造先在临时对象上完成，再以不抛出的移动构造放入槽位
+ */
+template <class T, class Reserve, class... Args>
+inline T* emplace_unwindable(std::true_type /* nothrow */, Reserve reserve, Args&&... args)
+{
+    void* slot = reserve();
+    if (slot == nullptr) return nullptr;
+    return ::new (slot) T(std::forward<Args>(args)...);
+}
+
+template <class T, class Reserve, class... Args>
+inline T* emplace_unwindable(std::false_type /* nothrow */, Reserve reserve, Args&&... args)
+{
+    static_assert(std::is_nothrow_move_constructible<T>::value,
+                  "T must be nothrow move constructible when its constructor may throw");
+    T value(std::forward<Args>(args)...);
+    void* slot = reserve();
+    if (slot == nullptr) return nullptr;
+    return ::new (slot) T(std::move(value));
+}
+
+template <class T, class Reserve, class... Args>
+inline T* emplace_unwindable(Reserve reserve, Args&&... args)
+{
+    return emplace_unwindable<T>(
+        std::integral_constant<bool, std::is_nothrow_constructible<T, Args&&...>::value>(),
+        reserve, std::forward<Args>(args)...);
+}
+
+/* 依次析构 [first, last) 中的元素，平凡析构类型什么也不做 */
+template <class T, class Iterator>
+inline void destroy_range(Iterator first, Iterator last)
+{
+    if (std::is_trivially_destructible<T>::value) return;
+    for (; first != last; ++first) (*first).~T();
+}
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+
+/*
+ * 把 C++ 分配器桥接为 hallocator_t
+ * 有状态的分配器会被复制到一块由它自己申请的内存中，保证容器移动后 ctx 仍然有效
+ */
+template <class Alloc>
+class allocator_bridge {
+public:
+    using byte_alloc =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<unsigned char>;
+    using byte_traits = std::allocator_traits<byte_alloc>;
+
+    static_assert(std::is_pointer<typename byte_traits::pointer>::value,
+                  "hlibc allocators must use raw pointers");
+
+    explicit allocator_bridge(const Alloc& alloc) : state_(nullptr)
+    {
+        if (!stateless) {
+            box_alloc box(alloc);
+            state_ = box_traits::allocate(box, 1);
+            box_traits::construct(box, state_, byte_alloc(alloc));
+        }
+        hook_.alloc = &do_alloc;
+        hook_.free = &do_free;
+        hook_.ctx = state_;
+    }
+
+    allocator_bridge(allocator_bridge&& other) noexcept
+        : state_(other.state_), hook_(other.hook_)
+    {
+        other.state_ = nullptr;
+    }
+
+    allocator_bridge(const allocator_bridge&) = delete;
+    allocator_bridge& operator=(const allocator_bridge&) = delete;
+    allocator_bridge& operator=(allocator_bridge&&) = delete;
+
+    ~allocator_bridge()
+    {
+        if (state_ != nullptr) {
+            box_alloc box(*state_);
+            box_traits::destroy(box, state_);
+            box_traits::deallocate(box, state_, 1);
+        }
+    }
+
+    const hallocator_t* hook() const { return &hook_; }
+
+    Alloc get() const
+    {
+        return with_alloc(
+            state_, [](byte_alloc& a) { return Alloc(a); },
+            std::integral_constant<bool, stateless>());
+    }
+
+    void swap(allocator_bridge& other) noexcept
+    {
+        std::swap(state_, other.state_);
+        std::swap(hook_, other.hook_);
+    }
+
+private:
+    using box_alloc =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<byte_alloc>;
+    using box_traits = std::allocator_traits<box_alloc>;
+
+    static constexpr bool stateless = std::is_empty<byte_alloc>::value &&
+                                      std::is_default_constructible<byte_alloc>::value;
+
+    /* 无状态分配器不保存副本，每次调用时临时构造 */
+    template <class F>
+    static auto with_alloc(void* ctx, F f, std::true_type /* stateless */)
+        -> decltype(f(std::declval<byte_alloc&>()))
+    {
+        (void)ctx;
+        byte_alloc alloc;
+        return f(alloc);
+    }
+
+    template <class F>
+    static auto with_alloc(void* ctx, F f, std::false_type /* stateless */)
+        -> decltype(f(std::declval<byte_alloc&>()))
+    {
+        return f(*static_cast<byte_alloc*>(ctx));
+    }
+
+    static hdata_ptr_t do_alloc(void* ctx, size_t size) noexcept
+    {
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+        try {
+#endif
+            return with_alloc(
+                ctx, [size](byte_alloc& a) { return byte_traits::allocate(a, size); },
+                std::integral_constant<bool, stateless>());
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+        } catch (...) {
+            return nullptr;
+        }
+#endif
+    }
+
+    static void do_free(void* ctx, hdata_ptr_t ptr, size_t size) noexcept
+    {
+        with_alloc(
+            ctx,
+            [ptr, size](byte_alloc& a) {
+                byte_traits::deallocate(a, static_cast<unsigned char*>(ptr), size);
+            },
+            std::integral_constant<bool, stateless>());
+    }
+
+    byte_alloc* state_;
+    hallocator_t hook_;
+};
+
+#endif /* HLIBC_USE_STATIC_ALLOC == 0 */
+
+} /* namespace detail */
+
+/*=====================
+ *        list
+ *====================*/
+
+template <class T, class Alloc = std::allocator<T>>
+class list : detail::element_check<T> {
+    template <bool Const>
+    class basic_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = typename std::conditional<Const, const T*, T*>::type;
+        using reference = typename std::conditional<Const, const T&, T&>::type;
+
+        basic_iterator() : node_(nullptr) {}
+        explicit basic_iterator(hlist_iterator_ptr_t node) : node_(node) {}
+        /* iterator 可以隐式转换为 const_iterator */
+        template <bool C = Const, class = typename std::enable_if<C>::type>
+        basic_iterator(const basic_iterator<false>& other) : node_(other.node()) {}
+
+        reference operator*() const { return *static_cast<pointer>(node_->data_ptr); }
+        pointer operator->() const { return static_cast<pointer>(node_->data_ptr); }
+
+        basic_iterator& operator++() { node_ = node_->next; return *this; }
+        basic_iterator operator++(int) { basic_iterator t(*this); node_ = node_->next; return t; }
+        basic_iterator& operator--() { node_ = node_->prev; return *this; }
+        basic_iterator operator--(int) { basic_iterator t(*this); node_ = node_->prev; return t; }
+
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b)
+        {
+            return a.node_ == b.node_;
+        }
+        friend bool operator!=(const basic_iterator& a, const basic_iterator& b)
+        {
+            return a.node_ != b.node_;
+        }
+
+        hlist_iterator_ptr_t node() const { return node_; }
+
+    private:
+        hlist_iterator_ptr_t node_;
+    };
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = uint32_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+    explicit list(const Alloc& alloc = Alloc())
+        : alloc_(alloc), handle_(hlist_create_with_allocator(sizeof(T), alloc_.hook()))
+    {
+        if (handle_ == nullptr) detail::throw_bad_alloc();
+    }
+
+    list(const list& other) : list(other.get_allocator())
+    {
+        for (const T& value : other) push_back(value);
+    }
+
+    allocator_type get_allocator() const { return alloc_.get(); }
+#else
+    /* buffer 大小可用 HLIST_CALC_BUFFER_SIZE(T, capacity) 计算 */
+    list(void* buffer, uint32_t buffer_size)
+        : handle_(hlist_create_static(buffer, buffer_size, sizeof(T)))
+    {
+        if (handle_ == nullptr) detail::throw_bad_alloc();
+    }
+
+    uint32_t capacity() const { return hlist_capacity(handle_); }
+    bool full() const { return hlist_full(handle_); }
+#endif
+
+    list(list&& other) noexcept :
+#if HLIBC_USE_STATIC_ALLOC == 0
+        alloc_(std::move(other.alloc_)),
+#endif
+        handle_(other.handle_)
+    {
+        other.handle_ = nullptr;
+    }
+
+    list& operator=(list&& other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    list& operator=(const list&) = delete;
+
+    ~list()
+    {
+        if (handle_ == nullptr) return;
+        clear();
+        hlist_destroy(handle_);
+    }
+
+    void swap(list& other) noexcept
+    {
+#if HLIBC_USE_STATIC_ALLOC == 0
+        alloc_.swap(other.alloc_);
+#endif
+        std::swap(handle_, other.handle_);
+    }
+
+    /* 元素访问 */
+    T& front() { return *static_cast<T*>(hlist_front(handle_)); }
+    const T& front() const { return *static_cast<const T*>(hlist_front(handle_)); }
+    T& back() { return *static_cast<T*>(hlist_back(handle_)); }
+    const T& back() const { return *static_cast<const T*>(hlist_back(handle_)); }
+
+    /* 迭代器：end() 为头节点（越过尾元素的位置） */
+    iterator begin() noexcept { return iterator(hlist_begin(handle_)); }
+    iterator end() noexcept { return iterator(sentinel()); }
+    const_iterator begin() const noexcept { return const_iterator(hlist_begin(handle_)); }
+    const_iterator end() const noexcept { return const_iterator(sentinel()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    /* 容量 */
+    bool empty() const noexcept { return hlist_empty(handle_); }
+    size_type size() const noexcept { return hlist_size(handle_); }
+
+    /* 修改 */
+    template <class... Args>
+    T* try_emplace_back(Args&&... args)
+    {
+        return construct(hlist_emplace_back(handle_), &hlist_pop_back,
+                         std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    T* try_emplace_front(Args&&... args)
+    {
+        return construct(hlist_emplace_front(handle_), &hlist_pop_front,
+                         std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    T& emplace_back(Args&&... args)
+    {
+        T* p = try_emplace_back(std::forward<Args>(args)...);
+        if (p == nullptr) detail::throw_bad_alloc();
+        return *p;
+    }
+
+    template <class... Args>
+    T& emplace_front(Args&&... args)
+    {
+        T* p = try_emplace_front(std::forward<Args>(args)...);
+        if (p == nullptr) detail::throw_bad_alloc();
+        return *p;
+    }
+
+    /* 在 position 之前原地构造，返回指向新元素的迭代器 */
+    template <class... Args>
+    iterator emplace(const_iterator position, Args&&... args)
+    {
+        hlist_ptr_t handle = handle_;
+        hlist_iterator_ptr_t node = position.node();
+        T* p = detail::emplace_unwindable<T>(
+            [handle, node]() { return hlist_emplace(handle, node); },
+            std::forward<Args>(args)...);
+        if (p == nullptr) detail::throw_bad_alloc();
+        return iterator(node->prev);
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+    void push_front(const T& value) { emplace_front(value); }
+    void push_front(T&& value) { emplace_front(std::move(value)); }
+    iterator insert(const_iterator position, const T& value) { return emplace(position, value); }
+    iterator insert(const_iterator position, T&& value)
+    {
+        return emplace(position, std::move(value));
+    }
+
+    void pop_back()
+    {
+        back().~T();
+        hlist_pop_back(handle_);
+    }
+
+    void pop_front()
+    {
+        front().~T();
+        hlist_pop_front(handle_);
+    }
+
+    /* 删除 position 处的元素，返回其后继 */
+    iterator erase(const_iterator position)
+    {
+        hlist_iterator_ptr_t node = position.node();
+        static_cast<T*>(node->data_ptr)->~T();
+        return iterator(hlist_erase(handle_, node));
+    }
+
+    /* 删除 [first, last)，返回 last */
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        detail::destroy_range<T>(iterator(first.node()), iterator(last.node()));
+        return iterator(hlist_erase_range(handle_, first.node(), last.node()));
+    }
+
+    /* 先逐个析构（平凡析构类型跳过），再由节点池整体回收 */
+    void clear() noexcept
+    {
+        detail::destroy_range<T>(begin(), end());
+        hlist_clear(handle_);
+    }
+
+    hlist_ptr_t native_handle() const noexcept { return handle_; }
+
+private:
+    /* 头节点：第一个元素的前驱；空链表时 begin 即头节点，其前驱仍是自身 */
+    hlist_iterator_ptr_t sentinel() const noexcept { return hlist_begin(handle_)->prev; }
+
+    template <class... Args>
+    T* construct(void* slot, void (*undo)(hlist_ptr_t), Args&&... args)
+    {
+        if (slot == nullptr) return nullptr;
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+        try {
+            return ::new (slot) T(std::forward<Args>(args)...);
+        } catch (...) {
+            undo(handle_);
+            throw;
+        }
+#else
+        (void)undo;
+        return ::new (slot) T(std::forward<Args>(args)...);
+#endif
+    }
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+    detail::allocator_bridge<Alloc> alloc_;
+#endif
+    hlist_ptr_t handle_;
+};
+
+/*=====================
+ *        queue
+ *====================*/
+
+template <class T, class Alloc = std::allocator<T>>
+class queue : detail::element_check<T> {
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = uint32_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+    explicit queue(const Alloc& alloc = Alloc())
+        : alloc_(alloc), handle_(hqueue_create_with_allocator(sizeof(T), alloc_.hook()))
+    {
+        if (handle_ == nullptr) detail::throw_bad_alloc();
+    }
+
+    allocator_type get_allocator() const { return alloc_.get(); }
+#else
+    /* buffer 大小可用 HQUEUE_CALC_BUFFER_SIZE(T, capacity) 计算 */
+    queue(void* buffer, uint32_t buffer_size)
+        : handle_(hqueue_create_static(buffer, buffer_size, sizeof(T)))
+    {
+        if (handle_ == nullptr) detail::throw_bad_alloc();
+    }
+
+    uint32_t capacity() const { return hqueue_capacity(handle_); }
+    bool full() const { return hqueue_full(handle_); }
+#endif
+
+    queue(queue&& other) noexcept :
+#if HLIBC_USE_STATIC_ALLOC == 0
+        alloc_(std::move(other.alloc_)),
+#endif
+        handle_(other.handle_)
+    {
+        other.handle_ = nullptr;
+    }
+
+    queue& operator=(queue&& other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    queue(const queue&) = delete;
+    queue& operator=(const queue&) = delete;
+
+    ~queue()
+    {
+        if (handle_ == nullptr) return;
+        clear();
+        hqueue_destroy(handle_);
+    }
+
+    void swap(queue& other) noexcept
+    {
+#if HLIBC_USE_STATIC_ALLOC == 0
+        alloc_.swap(other.alloc_);
+#endif
+        std::swap(handle_, other.handle_);
+    }
+
+    T& front() { return *static_cast<T*>(hqueue_front(handle_)); }
+    const T& front() const { return *static_cast<const T*>(hqueue_front(handle_)); }
+    T& back() { return *static_cast<T*>(hqueue_rear(handle_)); }
+    const T& back() const { return *static_cast<const T*>(hqueue_rear(handle_)); }
+
+    bool empty() const noexcept { return hqueue_empty(handle_); }
+    size_type size() const noexcept { return hqueue_size(handle_); }
+
+    /* 队尾的槽位无法撤销，构造可能抛出时先构造临时对象 */
+    template <class... Args>
+    T* try_emplace(Args&&... args)
+    {
+        hqueue_ptr_t handle = handle_;
+        return detail::emplace_unwindable<T>([handle]() { return hqueue_emplace(handle); },
+                                             std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    T& emplace(Args&&... args)
+    {
+        T* p = try_emplace(std::forward<Args>(args)...);
+        if (p == nullptr) detail::throw_bad_alloc();
+        return *p;
+    }
+
+    void push(const T& value) { emplace(value); }
+    void push(T&& value) { emplace(std::move(value)); }
+
+    void pop()
+    {
+        front().~T();
+        hqueue_pop(handle_);
+    }
+
+    void clear() noexcept
+    {
+        if (!std::is_trivially_destructible<T>::value) {
+            while (!empty()) pop();
+        }
+        hqueue_clear(handle_);
+    }
+
+    hqueue_ptr_t native_handle() const noexcept { return handle_; }
+
+private:
+#if HLIBC_USE_STATIC_ALLOC == 0
+    detail::allocator_bridge<Alloc> alloc_;
+#endif
+    hqueue_ptr_t handle_;
+};
+
+/*=====================
+ *        stack
+ *====================*/
+
+template <class T, class Alloc = std::allocator<T>>
+class stack : detail::element_check<T> {
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = uint32_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+    explicit stack(const Alloc& alloc = Alloc())
+        : alloc_(alloc), handle_(hstack_create_with_allocator(sizeof(T), alloc_.hook()))
+    {
+        if (handle_ == nullptr) detail::throw_bad_alloc();
+    }
+
+    allocator_type get_allocator() const { return alloc_.get(); }
+#else
+    /* buffer 大小可用 HSTACK_CALC_BUFFER_SIZE(T, capacity) 计算 */
+    stack(void* buffer, uint32_t buffer_size)
+        : handle_(hstack_create_static(buffer, buffer_size, sizeof(T)))
+    {
+        if (handle_ == nullptr) detail::throw_bad_alloc();
+    }
+
+    uint32_t capacity() const { return hstack_capacity(handle_); }
+    bool full() const { return hstack_full(handle_); }
+#endif
+
+    stack(stack&& other) noexcept :
+#if HLIBC_USE_STATIC_ALLOC == 0
+        alloc_(std::move(other.alloc_)),
+#endif
+        handle_(other.handle_)
+    {
+        other.handle_ = nullptr;
+    }
+
+    stack& operator=(stack&& other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    stack(const stack&) = delete;
+    stack& operator=(const stack&) = delete;
+
+    ~stack()
+    {
+        if (handle_ == nullptr) return;
+        clear();
+        hstack_destroy(handle_);
+    }
+
+    void swap(stack& other) noexcept
+    {
+#if HLIBC_USE_STATIC_ALLOC == 0
+        alloc_.swap(other.alloc_);
+#endif
+        std::swap(handle_, other.handle_);
+    }
+
+    T& top() { return *static_cast<T*>(hstack_top(handle_)); }
+    const T& top() const { return *static_cast<const T*>(hstack_top(handle_)); }
+
+    bool empty() const noexcept { return hstack_empty(handle_); }
+    size_type size() const noexcept { return hstack_size(handle_); }
+
+    template <class... Args>
+    T* try_emplace(Args&&... args)
+    {
+        void* slot = hstack_emplace(handle_);
+        if (slot == nullptr) return nullptr;
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+        try {
+            return ::new (slot) T(std::forward<Args>(args)...);
+        } catch (...) {
+            hstack_pop(handle_);
+            throw;
+        }
+#else
+        return ::new (slot) T(std::forward<Args>(args)...);
+#endif
+    }
+
+    template <class... Args>
+    T& emplace(Args&&... args)
+    {
+        T* p = try_emplace(std::forward<Args>(args)...);
+        if (p == nullptr) detail::throw_bad_alloc();
+        return *p;
+    }
+
+    void push(const T& value) { emplace(value); }
+    void push(T&& value) { emplace(std::move(value)); }
+
+    void pop()
+    {
+        top().~T();
+        hstack_pop(handle_);
+    }
+
+    void clear() noexcept
+    {
+        if (!std::is_trivially_destructible<T>::value) {
+            while (!empty()) pop();
+        }
+        hstack_clear(handle_);
+    }
+
+    hstack_ptr_t native_handle() const noexcept { return handle_; }
+
+private:
+#if HLIBC_USE_STATIC_ALLOC == 0
+    detail::allocator_bridge<Alloc> alloc_;
+#endif
+    hstack_ptr_t handle_;
+};
+
+} /* namespace hlibc */
+
+#endif /* __HLIBC_HPP__ */
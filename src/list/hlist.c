@@ -15,29 +15,84 @@
 
 #if HLIBC_USE_STATIC_ALLOC == 0
 #include <stdlib.h>
+#include "../common/harena.h"
 #endif
 
 /*********************
  *      MACROS
  *********************/
 
+#if HLIBC_USE_STATIC_ALLOC == 0
+/* 变长模式：负载在槽位中的起始偏移，以及结构体之后紧跟的变长节点池的偏移 */
+#define VAR_PAYLOAD_OFFSET      HARENA_PAYLOAD_OFFSET(sizeof(list_var_node_t))
+#define VAR_ARENA_OFFSET        HLIBC_ALIGN_UP(sizeof(struct hlist), _Alignof(harena_var_t))
+#define VAR_MAX_DATA_SIZE       (UINT32_MAX - VAR_PAYLOAD_OFFSET - HARENA_ALIGN)
+/* 变长节点遍历时按地址向前预取的距离（字节） */
+#define VAR_PREFETCH_AHEAD      512u
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
 typedef struct hdnode list_dnode_t;
 
+#if HLIBC_USE_STATIC_ALLOC == 0
+/* 变长模式的节点：链表节点之后记录负载的字节数，负载紧随其后，三者位于同一个槽位 */
+typedef struct {
+    list_dnode_t node;
+    uint32_t size;
+} list_var_node_t;
+#endif
+
 struct hlist {
     uint32_t list_size;
     uint32_t type_size;
     list_dnode_t head;
-#if HLIBC_USE_STATIC_ALLOC
+#if HLIBC_USE_STATIC_ALLOC == 0
+    harena_t arena;          /* 节点与数据共用的分块节点池 */
+    harena_var_t* var;       /* 变长模式的节点池（紧跟在结构体之后），定长模式为 NULL */
+#else
     uint32_t capacity;       /* 最大容量 */
+    uint32_t node_bump;      /* 从未使用过的第一个节点下标 */
     list_dnode_t* node_pool; /* 节点池指针 */
     uint8_t* data_pool;      /* 数据池指针 */
-    uint8_t* node_used;      /* 节点使用标记数组 */
+    list_dnode_t* free_list; /* 已释放节点的双向链表，空闲节点的 data_ptr 为 NULL */
+    list_dnode_t* compact_cursor; /* 链表第 compact_index 个节点，compact_index == list_size 时为头节点 */
+    uint32_t compact_index;  /* 链表前 compact_index 个节点恰好依次是 node_pool[0 .. compact_index) */
+    uint32_t extra_capacity; /* 追加缓冲区的总容量 */
+    struct hlist_segment* segments; /* 追加的缓冲区，按追加顺序排列 */
+#endif
+#if HLIBC_ENABLE_STATS
+    hlibc_stats_t stats;
 #endif
 };
 
+#if HLIBC_USE_STATIC_ALLOC == 1
+/* 追加缓冲区的头部，位于调用者提供的 buffer 开头，其后的布局与 node_pool/data_pool 相同 */
+struct hlist_segment {
+    struct hlist_segment* next;
+    void* buffer;            /* 追加时传入的地址，取回时比对 */
+    list_dnode_t* node_pool;
+    uint8_t* data_pool;
+    list_dnode_t* free_list; /* 已释放节点的单链表 */
+    uint32_t capacity;
+    uint32_t node_bump;      /* 从未使用过的第一个节点下标 */
+    uint32_t used;           /* 正在使用的节点数，为 0 时才能取回 */
+};
+
+/* 头文件中的布局镜像必须与实际结构体一致，HLIBC_STATIC_ALIGN 必须满足结构体的对齐要求 */
+_Static_assert(sizeof(struct hlist) == HLIST_STRUCT_SIZE &&
+               _Alignof(struct hlist) == _Alignof(hlist_static_layout_t),
+               "hlist_static_layout_t does not match struct hlist");
+_Static_assert(sizeof(list_dnode_t) == HLIST_NODE_SIZE, "HLIST_NODE_SIZE does not match struct hdnode");
+_Static_assert(sizeof(struct hlist_segment) == HLIST_SEGMENT_HEADER_SIZE &&
+               _Alignof(struct hlist_segment) == _Alignof(hlist_segment_layout_t),
+               "hlist_segment_layout_t does not match struct hlist_segment");
+_Static_assert((HLIBC_STATIC_ALIGN & (HLIBC_STATIC_ALIGN - 1)) == 0 &&
+               HLIBC_STATIC_ALIGN >= _Alignof(struct hlist),
+               "HLIBC_STATIC_ALIGN must be a power of two no less than the struct alignment");
+#endif
+
 /**********************
  *   GLOBAL VARIABLES
  **********************/
@@ -49,13 +104,20 @@ struct hlist {
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static list_dnode_t* create_dnode(hlist_ptr_t list, const hdata_ptr_t data_ptr,
-                                  uint32_t data_size);
+static list_dnode_t* create_dnode(hlist_ptr_t list, uint32_t data_size);
+static list_dnode_t* _link(hlist_ptr_t list, list_dnode_t* position, uint32_t data_size);
+static hdata_ptr_t _emplace(hlist_ptr_t list, list_dnode_t* position);
+static bool size_fits(hlist_ptr_t list, uint32_t data_size);
 static hlib_status_t _insert(hlist_ptr_t list, list_dnode_t* position, const hdata_ptr_t data_ptr, uint32_t data_size);
 static void _delete(hlist_ptr_t list, list_dnode_t* position);
-#if HLIBC_USE_STATIC_ALLOC
 static void free_dnode(hlist_ptr_t list, list_dnode_t* node);
-static int32_t get_node_index(hlist_ptr_t list, list_dnode_t* node);
+#if HLIBC_USE_STATIC_ALLOC
+static void compact_on_link(hlist_ptr_t list, list_dnode_t* position, list_dnode_t* node);
+static void compact_on_unlink(hlist_ptr_t list, list_dnode_t* node);
+static void compact_swap_data(uint8_t* a, uint8_t* b, uint32_t size);
+static void relink(list_dnode_t* from, list_dnode_t* to);
+static uint32_t pool_index(hlist_ptr_t list, list_dnode_t* node);
+static uint32_t fit_capacity(uint32_t size, uint32_t type_size);
 #endif
 
 /**********************
@@ -67,20 +129,67 @@ static int32_t get_node_index(hlist_ptr_t list, list_dnode_t* node);
 
 hlist_ptr_t hlist_create(uint32_t type_size)
 {
-    hlist_ptr_t list = (hlist_ptr_t)malloc(sizeof(struct hlist));
+    return hlist_create_with_allocator(type_size, NULL);
+}
+
+hlist_ptr_t hlist_create_with_allocator(uint32_t type_size,
+                                        const hallocator_t* allocator)
+{
+    hlist_ptr_t list = (hlist_ptr_t)hallocator_alloc(allocator, sizeof(struct hlist));
     if (list == NULL) return NULL;
     list->head.data_ptr = NULL;
     list->head.prev = &list->head;
     list->head.next = &list->head;
     list->list_size = 0;
     list->type_size = type_size;
+    list->var = NULL;
+    harena_init(&list->arena,
+                HARENA_PAYLOAD_OFFSET(sizeof(list_dnode_t)) + type_size, allocator);
+#if HLIBC_ENABLE_STATS
+    hstats_reset(&list->stats, 0);
+    HSTATS_ON_ALLOC(&list->stats, sizeof(struct hlist));
+    list->arena.stats = &list->stats;
+#endif
+    return list;
+}
+
+hlist_ptr_t hlist_create_var(void)
+{
+    return hlist_create_var_with_allocator(NULL);
+}
+
+hlist_ptr_t hlist_create_var_with_allocator(const hallocator_t* allocator)
+{
+    /* 结构体与变长节点池一次分配；定长节点池不会被使用，只保存分配器 */
+    hlist_ptr_t list = (hlist_ptr_t)hallocator_alloc(allocator,
+                                                     VAR_ARENA_OFFSET + sizeof(harena_var_t));
+    if (list == NULL) return NULL;
+    list->head.data_ptr = NULL;
+    list->head.prev = &list->head;
+    list->head.next = &list->head;
+    list->list_size = 0;
+    list->type_size = 0;
+    list->var = (harena_var_t*)((uint8_t*)list + VAR_ARENA_OFFSET);
+    harena_init(&list->arena, sizeof(list_dnode_t), allocator);
+    harena_var_init(list->var, allocator);
+#if HLIBC_ENABLE_STATS
+    hstats_reset(&list->stats, 0);
+    HSTATS_ON_ALLOC(&list->stats, VAR_ARENA_OFFSET + sizeof(harena_var_t));
+    list->var->stats = &list->stats;
+#endif
     return list;
 }
 
 void hlist_destroy(hlist_ptr_t list)
 {
-    hlist_clear(list);
-    free(list);
+    hallocator_t allocator = list->arena.allocator;
+    size_t size = sizeof(struct hlist);
+    if (list->var != NULL) {
+        harena_var_release(list->var);
+        size = VAR_ARENA_OFFSET + sizeof(harena_var_t);
+    }
+    harena_release(&list->arena);
+    hallocator_free(&allocator, list, size);
 }
 
 #else /* HLIBC_USE_STATIC_ALLOC == 1 */
@@ -90,49 +199,88 @@ hlist_ptr_t hlist_create_static(void* buffer, uint32_t buffer_size,
                                 uint32_t type_size) {
   if (buffer == NULL || type_size == 0) return NULL;
 
-  /* 计算可用容量 */
-  uint32_t header_size = sizeof(struct hlist);
-  if (buffer_size <= header_size) return NULL;
-
-  uint32_t remaining = buffer_size - header_size;
-  uint32_t per_node_size = sizeof(list_dnode_t) + type_size + sizeof(uint8_t);
-  uint32_t capacity = remaining / per_node_size;
+  /* 未对齐的 buffer 先跳过开头的若干字节 */
+  uint8_t* base = (uint8_t*)HLIBC_ALIGN_UP((uintptr_t)buffer, HLIBC_STATIC_ALIGN);
+  uint32_t skip = (uint32_t)(base - (uint8_t*)buffer);
+  uint32_t header_size = HLIBC_ALIGN_UP(sizeof(struct hlist), HLIBC_STATIC_ALIGN);
+  if (buffer_size <= skip + header_size) return NULL;
 
+  uint32_t capacity = fit_capacity(buffer_size - skip - header_size, type_size);
   if (capacity == 0) return NULL;
 
   /* 初始化 list 结构 */
-  hlist_ptr_t list = (hlist_ptr_t)buffer;
-  uint8_t* ptr = (uint8_t*)buffer + header_size;
+  hlist_ptr_t list = (hlist_ptr_t)base;
+  uint8_t* ptr = base + header_size;
 
   list->list_size = 0;
   list->type_size = type_size;
   list->capacity = capacity;
+  list->extra_capacity = 0;
+  list->segments = NULL;
 
   /* 分配节点池 */
   list->node_pool = (list_dnode_t*)ptr;
-  ptr += capacity * sizeof(list_dnode_t);
+  ptr += HLIBC_ALIGN_UP(capacity * sizeof(list_dnode_t), HLIBC_STATIC_ALIGN);
 
-  /* 分配数据池 */
+  /* 分配数据池，起始位置按 HLIBC_STATIC_ALIGN 对齐 */
   list->data_pool = ptr;
-  ptr += capacity * type_size;
-
-  /* 分配使用标记数组 */
-  list->node_used = ptr;
-  memset(list->node_used, 0, capacity);
 
-  /* 初始化头节点 */
-  list->head.data_ptr = NULL;
-  list->head.prev = &list->head;
-  list->head.next = &list->head;
+  /* 初始化头节点与节点池状态 */
+  hlist_clear(list);
+#if HLIBC_ENABLE_STATS
+  hstats_reset(&list->stats, 0);
+#endif
 
   return list;
 }
 
 void hlist_destroy_static(hlist_ptr_t list) {
   if (list == NULL) return;
-  hlist_clear(list);
   /* 静态分配不释放内存，只重置状态 */
-  memset(list->node_used, 0, list->capacity);
+  hlist_clear(list);
+}
+
+hlib_status_t hlist_add_buffer(hlist_ptr_t list, void* buffer, uint32_t buffer_size) {
+  if (buffer == NULL) return HLIB_ERROR;
+
+  /* 未对齐的 buffer 先跳过开头的若干字节 */
+  uint8_t* base = (uint8_t*)HLIBC_ALIGN_UP((uintptr_t)buffer, HLIBC_STATIC_ALIGN);
+  uint32_t skip = (uint32_t)(base - (uint8_t*)buffer);
+  uint32_t header_size = HLIBC_ALIGN_UP(sizeof(struct hlist_segment), HLIBC_STATIC_ALIGN);
+  if (buffer_size <= skip + header_size) return HLIB_ERROR;
+
+  uint32_t capacity = fit_capacity(buffer_size - skip - header_size, list->type_size);
+  if (capacity == 0) return HLIB_ERROR;
+
+  struct hlist_segment* segment = (struct hlist_segment*)base;
+  segment->next = NULL;
+  segment->buffer = buffer;
+  segment->node_pool = (list_dnode_t*)(base + header_size);
+  segment->data_pool = (uint8_t*)segment->node_pool +
+                       HLIBC_ALIGN_UP(capacity * sizeof(list_dnode_t), HLIBC_STATIC_ALIGN);
+  segment->free_list = NULL;
+  segment->capacity = capacity;
+  segment->node_bump = 0;
+  segment->used = 0;
+
+  /* 接在末尾：新节点优先取自先追加的缓冲区，后追加的更容易排空取回 */
+  struct hlist_segment** link = &list->segments;
+  while (*link != NULL) link = &(*link)->next;
+  *link = segment;
+  list->extra_capacity += capacity;
+  return HLIB_OK;
+}
+
+hlib_status_t hlist_remove_buffer(hlist_ptr_t list, void* buffer) {
+  for (struct hlist_segment** link = &list->segments; *link != NULL; link = &(*link)->next) {
+    struct hlist_segment* segment = *link;
+    if (segment->buffer != buffer) continue;
+    if (segment->used != 0) return HLIB_BUSY;
+    *link = segment->next;
+    list->extra_capacity -= segment->capacity;
+    return HLIB_OK;
+  }
+  return HLIB_ERROR;
 }
 
 #endif /* HLIBC_USE_STATIC_ALLOC */
@@ -156,6 +304,125 @@ hlib_status_t hlist_push_front(hlist_ptr_t list, const hdata_ptr_t data_ptr, uin
     return _insert(list, &list->head, data_ptr, data_size);
 }
 
+hdata_ptr_t hlist_emplace(hlist_ptr_t list, hlist_iterator_ptr_t position)
+{
+    return _emplace(list, position->prev);
+}
+
+hdata_ptr_t hlist_emplace_back(hlist_ptr_t list)
+{
+    return _emplace(list, list->head.prev);
+}
+
+hdata_ptr_t hlist_emplace_front(hlist_ptr_t list)
+{
+    return _emplace(list, &list->head);
+}
+
+hdata_ptr_t hlist_emplace_sized(hlist_ptr_t list, hlist_iterator_ptr_t position, uint32_t data_size)
+{
+    if (!size_fits(list, data_size)) return NULL;
+    list_dnode_t* node = _link(list, position->prev, data_size);
+    return node != NULL ? node->data_ptr : NULL;
+}
+
+hlib_status_t hlist_insert_range(hlist_ptr_t list, hlist_iterator_ptr_t position,
+                                 const hdata_ptr_t array, uint32_t count)
+{
+    if (count == 0) return HLIB_OK;
+    /* 先确认节点足够，失败时链表保持不变 */
+#if HLIBC_USE_STATIC_ALLOC == 0
+    if (list->var != NULL) return HLIB_ERROR; /* 数组中的元素没有各自的长度 */
+    if (!harena_reserve(&list->arena, count)) return HLIB_ERROR;
+#else
+    if (list->capacity + list->extra_capacity - list->list_size < count) {
+        HSTATS_ON_OVERFLOW(&list->stats);
+        return HLIB_OVERFLOW;
+    }
+#endif
+
+    /* 新节点依次接在 prev 之后，最后一次性接回 position */
+    list_dnode_t* first = position->prev;
+    list_dnode_t* prev = first;
+    const uint8_t* src = (const uint8_t*)array;
+    for (uint32_t i = 0; i < count; ++i) {
+#if HLIBC_USE_STATIC_ALLOC == 0
+        list_dnode_t* node = (list_dnode_t*)harena_take(&list->arena);
+        node->data_ptr = (uint8_t*)node + HARENA_PAYLOAD_OFFSET(sizeof(list_dnode_t));
+#else
+        list_dnode_t* node = create_dnode(list, list->type_size);
+#endif
+        memcpy(node->data_ptr, src, list->type_size);
+        src += list->type_size;
+        node->prev = prev;
+        prev->next = node;
+        prev = node;
+    }
+    prev->next = position;
+    position->prev = prev;
+    list->list_size += count;
+#if HLIBC_USE_STATIC_ALLOC
+    compact_on_link(list, first, first->next);
+#endif
+    HSTATS_ON_PUSH_N(&list->stats, count, list->list_size);
+    return HLIB_OK;
+}
+
+hlist_iterator_ptr_t hlist_erase(hlist_ptr_t list, hlist_iterator_ptr_t position)
+{
+    list_dnode_t* next = position->next;
+    if (position == &list->head) return position;
+    _delete(list, position);
+    return next;
+}
+
+hlist_iterator_ptr_t hlist_erase_range(hlist_ptr_t list, hlist_iterator_ptr_t first,
+                                       hlist_iterator_ptr_t last)
+{
+    /* 与 hlist_erase 相同，头节点不能被删除：范围从头节点开始或越过头节点时不做任何修改 */
+    for (list_dnode_t* node = first; node != last; node = node->next) {
+        if (node == &list->head) return last;
+    }
+
+    /* 整段一次摘链，逐个归还节点 */
+    list_dnode_t* prev = first->prev;
+    uint32_t count = 0;
+    while (first != last) {
+        list_dnode_t* next = first->next;
+#if HLIBC_USE_STATIC_ALLOC
+        compact_on_unlink(list, first);
+#endif
+        free_dnode(list, first);
+        first = next;
+        ++count;
+    }
+    prev->next = last;
+    last->prev = prev;
+    list->list_size -= count;
+    HSTATS_ON_POP_N(&list->stats, count);
+    return last;
+}
+
+void hlist_move(hlist_ptr_t list, hlist_iterator_ptr_t position, hlist_iterator_ptr_t node)
+{
+    if (node == position || node->next == position) return;
+#if HLIBC_USE_STATIC_ALLOC
+    compact_on_unlink(list, node);
+#else
+    (void)list;
+#endif
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    list_dnode_t* prev = position->prev;
+    node->prev = prev;
+    node->next = position;
+    prev->next = node;
+    position->prev = node;
+#if HLIBC_USE_STATIC_ALLOC
+    compact_on_link(list, prev, node);
+#endif
+}
+
 void hlist_pop_back(hlist_ptr_t list)
 {
     _delete(list, list->head.prev);
@@ -168,9 +435,25 @@ void hlist_pop_front(hlist_ptr_t list)
 
 void hlist_clear(hlist_ptr_t list)
 {
-    while(!hlist_empty(list)) {
-        _delete(list, list->head.next);
+    /* 节点全部归属于容器自己的节点池，整体回收即可，无需逐个摘链 */
+#if HLIBC_USE_STATIC_ALLOC == 0
+    if (list->var != NULL) harena_var_release(list->var);
+    else harena_release(&list->arena);
+#else
+    list->node_bump = 0;
+    list->free_list = NULL;
+    list->compact_cursor = &list->head;
+    list->compact_index = 0;
+    for (struct hlist_segment* segment = list->segments; segment != NULL; segment = segment->next) {
+        segment->free_list = NULL;
+        segment->node_bump = 0;
+        segment->used = 0;
     }
+#endif
+    list->head.data_ptr = NULL;
+    list->head.prev = &list->head;
+    list->head.next = &list->head;
+    list->list_size = 0;
 }
 
 /*=======================
@@ -208,10 +491,68 @@ uint32_t hlist_size(hlist_ptr_t list)
 }
 
 #if HLIBC_USE_STATIC_ALLOC
-uint32_t hlist_capacity(hlist_ptr_t list) { return list->capacity; }
+uint32_t hlist_capacity(hlist_ptr_t list) { return list->capacity + list->extra_capacity; }
 
 bool hlist_full(hlist_ptr_t list) {
-  return (list->list_size >= list->capacity);
+  return (list->list_size >= list->capacity + list->extra_capacity);
+}
+
+uint32_t hlist_compact(hlist_ptr_t list, uint32_t max_nodes) {
+  uint32_t k = list->compact_index;
+  list_dnode_t* node = list->compact_cursor;
+  uint32_t budget = max_nodes;
+
+  /*
+   * 把链表第 k 个节点换到 node_pool[k]，前 k 个节点已就位，因此 node_pool[k] 只可能在后面或空闲；
+   * 元素多于 node_pool 时，超出的部分留在追加的缓冲区中
+   */
+  while (node != &list->head && k < list->capacity && (max_nodes == 0 || budget-- > 0)) {
+    list_dnode_t* target = &list->node_pool[k];
+    if (node != target) {
+      if (target->data_ptr != NULL) {
+        /* 目标槽位被后面的节点占用：交换两个节点在链表中的位置及其数据 */
+        compact_swap_data(node->data_ptr, target->data_ptr, list->type_size);
+        if (node->next == target) {
+          target->prev = node->prev;
+          node->prev->next = target;
+          node->next = target->next;
+          target->next->prev = node;
+          target->next = node;
+          node->prev = target;
+        } else {
+          list_dnode_t* node_prev = node->prev;
+          list_dnode_t* target_prev = target->prev;
+          list_dnode_t* node_next = node->next;
+          list_dnode_t* target_next = target->next;
+          relink(node_prev, target);
+          target->next = node_next;
+          node_next->prev = target;
+          relink(target_prev, node);
+          node->next = target_next;
+          target_next->prev = node;
+        }
+      } else {
+        /* 目标槽位空闲：把节点搬过去，原节点进入空闲链表 */
+        if (target->prev != NULL) target->prev->next = target->next;
+        else list->free_list = target->next;
+        if (target->next != NULL) target->next->prev = target->prev;
+        target->data_ptr = list->data_pool + k * list->type_size;
+        memcpy(target->data_ptr, node->data_ptr, list->type_size);
+        relink(node->prev, target);
+        target->next = node->next;
+        node->next->prev = target;
+        free_dnode(list, node);
+      }
+    }
+    node = target->next;
+    ++k;
+  }
+
+  list->compact_index = k;
+  list->compact_cursor = node;
+  /* 超出 node_pool 的节点只能留在追加的缓冲区，不计入尚未就位的节点 */
+  uint32_t placeable = list->list_size < list->capacity ? list->list_size : list->capacity;
+  return placeable - k;
 }
 #endif
 
@@ -251,104 +592,302 @@ void hlist_iter_backward_to(hlist_iterator_ptr_t *iter, int step)
     }
 }
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
+/* 遍历 */
+uint32_t hlist_foreach(hlist_ptr_t list, hforeach_f fn, void* ctx)
+{
+    list_dnode_t* end = &list->head;
+    list_dnode_t* node = list->head.next;
+    uint32_t visited = 0;
+    while (node != end) {
+        /* 回调执行期间，下一个节点与其数据、再下一个节点已在加载中 */
+        list_dnode_t* next = node->next;
+        HLIBC_PREFETCH(next->next);
+        HLIBC_PREFETCH(next->data_ptr);
+        ++visited;
+        if (!fn(node->data_ptr, ctx)) break;
+        node = next;
+    }
+    return visited;
+}
 
+uint32_t hlist_iter_size(hlist_ptr_t list, hlist_iterator_ptr_t iter)
+{
+    if (iter == &list->head) return 0;
 #if HLIBC_USE_STATIC_ALLOC == 0
-/* ==================== 动态分配内部函数 ==================== */
+    if (list->var != NULL) return ((const list_var_node_t*)iter)->size;
+#endif
+    return list->type_size;
+}
 
-static list_dnode_t *create_dnode(hlist_ptr_t list, const hdata_ptr_t data_ptr, uint32_t data_size)
+uint32_t hlist_foreach_sized(hlist_ptr_t list, hlist_foreach_sized_f fn, void* ctx)
 {
-  (void)list; /* 动态模式不需要 list 参数 */
-  list_dnode_t* node = (list_dnode_t*)malloc(sizeof(list_dnode_t));
-  if (node == NULL) return NULL;
-  node->data_ptr = (hdata_ptr_t)malloc(data_size);
-  if (node->data_ptr == NULL) {
-    free(node);
-    return NULL;
-  }
-    memcpy(node->data_ptr, data_ptr, data_size);
-    return node;
+    list_dnode_t* end = &list->head;
+    list_dnode_t* node = list->head.next;
+    uint32_t visited = 0;
+    while (node != end) {
+        list_dnode_t* next = node->next;
+        HLIBC_PREFETCH(next->next);
+        HLIBC_PREFETCH(next->data_ptr);
+#if HLIBC_USE_STATIC_ALLOC == 0
+        /* 变长节点按插入顺序紧密排列但间距不固定，硬件的步长预取跟不上，按地址向前多取几个节点 */
+        if (list->var != NULL) HLIBC_PREFETCH((const uint8_t*)node + VAR_PREFETCH_AHEAD);
+#endif
+        ++visited;
+        if (!fn(node->data_ptr, hlist_iter_size(list, node), ctx)) break;
+        node = next;
+    }
+    return visited;
 }
 
-static hlib_status_t _insert(hlist_ptr_t list, list_dnode_t* position, const hdata_ptr_t data_ptr, uint32_t data_size)
+uint32_t hlist_foreach_batch(hlist_ptr_t list, hforeach_batch_f fn, void* ctx)
 {
-    if(data_size != list->type_size) return HLIB_ERROR;
-    list_dnode_t* node = create_dnode(list, data_ptr, data_size);
-    if (node == NULL) return HLIB_ERROR;
+    hdata_ptr_t items[HLIBC_FOREACH_BATCH];
+    list_dnode_t* end = &list->head;
+    list_dnode_t* node = list->head.next;
+    uint32_t visited = 0;
+    while (node != end) {
+        uint32_t n = 0;
+        do {
+            /* 收集阶段只沿链表前进，数据的加载与之重叠，回调时已在缓存中 */
+            HLIBC_PREFETCH(node->data_ptr);
+            items[n++] = node->data_ptr;
+            node = node->next;
+        } while (n < HLIBC_FOREACH_BATCH && node != end);
+        visited += n;
+        if (!fn(items, n, ctx)) break;
+    }
+    return visited;
+}
+
+#if HLIBC_ENABLE_STATS
+/*=======================
+ * Statistics functions
+ *======================*/
+
+void hlist_get_stats(hlist_ptr_t list, hlibc_stats_t* stats)
+{
+    *stats = list->stats;
+}
+
+void hlist_reset_stats(hlist_ptr_t list)
+{
+    hstats_reset(&list->stats, list->list_size);
+}
+#endif /* HLIBC_ENABLE_STATS */
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* 申请一个负载为 data_size 字节的节点并链接到 position 之后，数据未初始化 */
+static list_dnode_t* _link(hlist_ptr_t list, list_dnode_t* position, uint32_t data_size)
+{
+    list_dnode_t* node = create_dnode(list, data_size);
+    if (node == NULL) {
+#if HLIBC_USE_STATIC_ALLOC
+        HSTATS_ON_OVERFLOW(&list->stats);
+#endif
+        return NULL;
+    }
     node->next = position->next;
     position->next->prev = node;
     node->prev = position;
     position->next = node;
     ++list->list_size;
+#if HLIBC_USE_STATIC_ALLOC
+    compact_on_link(list, position, node);
+#endif
+    HSTATS_ON_PUSH(&list->stats, list->list_size);
+    return node;
+}
+
+static hlib_status_t _insert(hlist_ptr_t list, list_dnode_t* position, const hdata_ptr_t data_ptr, uint32_t data_size)
+{
+    if (!size_fits(list, data_size)) return HLIB_ERROR;
+    list_dnode_t* node = _link(list, position, data_size);
+#if HLIBC_USE_STATIC_ALLOC == 0
+    if (node == NULL) return HLIB_ERROR;
+#else
+    if (node == NULL) return HLIB_OVERFLOW;
+#endif
+    memcpy(node->data_ptr, data_ptr, data_size);
     return HLIB_OK;
 }
 
+/* 不带长度的原地构造，变长容器中不可用 */
+static hdata_ptr_t _emplace(hlist_ptr_t list, list_dnode_t* position)
+{
+#if HLIBC_USE_STATIC_ALLOC == 0
+    if (list->var != NULL) return NULL;
+#endif
+    list_dnode_t* node = _link(list, position, list->type_size);
+    return node != NULL ? node->data_ptr : NULL;
+}
+
+/* 定长容器只接受 type_size 字节的元素，变长容器接受任意长度 */
+static bool size_fits(hlist_ptr_t list, uint32_t data_size)
+{
+#if HLIBC_USE_STATIC_ALLOC == 0
+    if (list->var != NULL) return data_size <= VAR_MAX_DATA_SIZE;
+#endif
+    return data_size == list->type_size;
+}
+
 static void _delete(hlist_ptr_t list, list_dnode_t* position)
 {
     if (hlist_empty(list)) return;
+#if HLIBC_USE_STATIC_ALLOC
+    compact_on_unlink(list, position);
+#endif
     position->prev->next = position->next;
     position->next->prev = position->prev;
-    free(position->data_ptr);
-    free(position);
+    free_dnode(list, position);
     --list->list_size;
+    HSTATS_ON_POP(&list->stats);
+}
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/* ==================== 动态分配内部函数 ==================== */
+
+static list_dnode_t *create_dnode(hlist_ptr_t list, uint32_t data_size)
+{
+    if (list->var != NULL) {
+        /* 变长模式：槽位按负载长度申请，相继插入的元素在 chunk 中紧密排列 */
+        list_var_node_t* var = (list_var_node_t*)harena_var_alloc(list->var,
+                                                                  VAR_PAYLOAD_OFFSET + data_size);
+        if (var == NULL) return NULL;
+        var->size = data_size;
+        var->node.data_ptr = (uint8_t*)var + VAR_PAYLOAD_OFFSET;
+        return &var->node;
+    }
+    /* 节点与数据位于同一个槽位，一次分配 */
+    list_dnode_t* node = (list_dnode_t*)harena_alloc(&list->arena);
+    if (node == NULL) return NULL;
+    node->data_ptr = (uint8_t*)node + HARENA_PAYLOAD_OFFSET(sizeof(list_dnode_t));
+    return node;
+}
+
+static void free_dnode(hlist_ptr_t list, list_dnode_t* node)
+{
+    if (list->var != NULL) {
+        harena_var_free(list->var, node, VAR_PAYLOAD_OFFSET + ((list_var_node_t*)node)->size);
+        return;
+    }
+    harena_free(&list->arena, node);
 }
 
 #else /* HLIBC_USE_STATIC_ALLOC == 1 */
 /* ==================== 静态分配内部函数 ==================== */
 
-static int32_t get_node_index(hlist_ptr_t list, list_dnode_t* node) {
-  if (node < list->node_pool) return -1;
-  int32_t index = (int32_t)(node - list->node_pool);
-  if (index >= (int32_t)list->capacity) return -1;
-  return index;
-}
-
-static list_dnode_t* create_dnode(hlist_ptr_t list, const hdata_ptr_t data_ptr,
-                                  uint32_t data_size) {
-  /* 查找空闲节点 */
-  for (uint32_t i = 0; i < list->capacity; i++) {
-    if (!list->node_used[i]) {
-      list->node_used[i] = 1;
-      list_dnode_t* node = &list->node_pool[i];
-      node->data_ptr = list->data_pool + i * list->type_size;
-      memcpy(node->data_ptr, data_ptr, data_size);
-      return node;
-    }
+static list_dnode_t* create_dnode(hlist_ptr_t list, uint32_t data_size) {
+  (void)data_size; /* 静态分配只有定长模式 */
+  list_dnode_t* node = list->free_list;
+  if (node != NULL) {
+    /* 优先复用已释放的节点 */
+    list->free_list = node->next;
+    if (node->next != NULL) node->next->prev = NULL;
+    node->data_ptr = list->data_pool + (uint32_t)(node - list->node_pool) * list->type_size;
+  } else if (list->node_bump < list->capacity) {
+    uint32_t i = list->node_bump++;
+    node = &list->node_pool[i];
+    node->data_ptr = list->data_pool + i * list->type_size;
+  } else {
+    /* node_pool 用完后依次取自追加的缓冲区 */
+    struct hlist_segment* segment = list->segments;
+    while (segment != NULL && segment->free_list == NULL && segment->node_bump == segment->capacity)
+      segment = segment->next;
+    if (segment == NULL) return NULL; /* 内存池已满 */
+    node = segment->free_list;
+    if (node != NULL) segment->free_list = node->next;
+    else node = &segment->node_pool[segment->node_bump++];
+    node->data_ptr = segment->data_pool + (uint32_t)(node - segment->node_pool) * list->type_size;
+    ++segment->used;
   }
-  return NULL; /* 内存池已满 */
+  return node;
 }
 
 static void free_dnode(hlist_ptr_t list, list_dnode_t* node) {
-  int32_t index = get_node_index(list, node);
-  if (index >= 0) {
-    list->node_used[index] = 0;
+  if (pool_index(list, node) == UINT32_MAX) {
+    /* 追加缓冲区中的节点归还给所在的缓冲区 */
+    struct hlist_segment* segment = list->segments;
+    while ((uintptr_t)node - (uintptr_t)segment->node_pool >=
+           (uintptr_t)segment->capacity * sizeof(list_dnode_t))
+      segment = segment->next;
+    node->next = segment->free_list;
+    segment->free_list = node;
+    --segment->used;
+    return;
   }
+  /* data_ptr 置空标记为空闲，压缩时据此区分占用与空闲的槽位 */
+  node->data_ptr = NULL;
+  node->prev = NULL;
+  node->next = list->free_list;
+  if (list->free_list != NULL) list->free_list->prev = node;
+  list->free_list = node;
 }
 
-static hlib_status_t _insert(hlist_ptr_t list, list_dnode_t* position,
-                             const hdata_ptr_t data_ptr, uint32_t data_size) {
-  if (data_size != list->type_size) return HLIB_ERROR;
-  if (list->list_size >= list->capacity) return HLIB_OVERFLOW;
+/*
+ * 维护已就位前缀：前缀由 node_pool[0 .. compact_index) 组成，
+ * 链表变动只可能截短前缀或移动游标，不需要重新扫描
+ */
+static void compact_on_link(hlist_ptr_t list, list_dnode_t* position, list_dnode_t* node) {
+  if (position == &list->head) {
+    list->compact_index = 0;
+    list->compact_cursor = node;
+    return;
+  }
+  uint32_t index = pool_index(list, position);
+  if (index < list->compact_index) {
+    /* 插在前缀中间或末尾：前缀截至 position，新节点成为游标 */
+    list->compact_index = index + 1;
+    list->compact_cursor = node;
+  }
+}
 
-  list_dnode_t* node = create_dnode(list, data_ptr, data_size);
-  if (node == NULL) return HLIB_OVERFLOW;
+static void compact_on_unlink(hlist_ptr_t list, list_dnode_t* node) {
+  uint32_t index = pool_index(list, node);
+  if (index < list->compact_index) {
+    list->compact_index = index;
+    list->compact_cursor = node->next;
+  } else if (node == list->compact_cursor) {
+    list->compact_cursor = node->next;
+  }
+}
 
-  node->next = position->next;
-  position->next->prev = node;
-  node->prev = position;
-  position->next = node;
-  ++list->list_size;
-  return HLIB_OK;
+static void compact_swap_data(uint8_t* a, uint8_t* b, uint32_t size) {
+  uint8_t tmp[64];
+  while (size > 0) {
+    uint32_t n = size < sizeof(tmp) ? size : (uint32_t)sizeof(tmp);
+    memcpy(tmp, a, n);
+    memcpy(a, b, n);
+    memcpy(b, tmp, n);
+    a += n;
+    b += n;
+    size -= n;
+  }
+}
+
+/* 让 to 接在 from 之后（只设置这一对指针） */
+static void relink(list_dnode_t* from, list_dnode_t* to) {
+  from->next = to;
+  to->prev = from;
+}
+
+/* 节点在 node_pool 中的下标，追加缓冲区中的节点返回 UINT32_MAX */
+static uint32_t pool_index(hlist_ptr_t list, list_dnode_t* node) {
+  uintptr_t index = (uintptr_t)node - (uintptr_t)list->node_pool;
+  if (index >= (uintptr_t)list->capacity * sizeof(list_dnode_t)) return UINT32_MAX;
+  return (uint32_t)(index / sizeof(list_dnode_t));
 }
 
-static void _delete(hlist_ptr_t list, list_dnode_t* position) {
-  if (hlist_empty(list)) return;
-  position->prev->next = position->next;
-  position->next->prev = position->prev;
-  free_dnode(list, position);
-  --list->list_size;
+/* size 字节能放下的节点数：先按无填充估算，再扣除节点区末尾的对齐填充 */
+static uint32_t fit_capacity(uint32_t size, uint32_t type_size) {
+  uint32_t capacity = size / (uint32_t)(sizeof(list_dnode_t) + type_size);
+  while (capacity > 0 &&
+         HLIBC_ALIGN_UP(capacity * sizeof(list_dnode_t), HLIBC_STATIC_ALIGN) +
+         (size_t)capacity * type_size > size)
+    --capacity;
+  return capacity;
 }
 
 #endif /* HLIBC_USE_STATIC_ALLOC */
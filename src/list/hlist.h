@@ -17,30 +17,56 @@ extern "C" {
  *********************/
 #include "../common/hcommon.h"
 #include "../common/hlibc_config.h"
+#include "../common/hstats.h"
 
 /*********************
  *      MACROS
  *********************/
 
 /*
- * 静态分配结构体大小常量（用于计算 buffer 大小）
- * 注意：这些值必须与 .c 文件中的结构体大小匹配
+ * 静态分配结构体与节点大小（精确值，hlist.c 中用 _Static_assert 校验）
  */
-#define HLIST_STRUCT_SIZE \
-  (4 + 4 +                \
-   24) /* list_size + type_size + head + capacity + pools (约32字节对齐) */
-#define HLIST_NODE_SIZE \
-  24 /* hdnode: data_ptr + prev + next (指针大小按8字节算) */
+#define HLIST_STRUCT_SIZE sizeof(hlist_static_layout_t)
+#define HLIST_NODE_SIZE   (3 * sizeof(void*)) /* hdnode: data_ptr + prev + next */
 
 /**
  * 计算静态 list 所需的 buffer 大小
+ * buffer 按 HLIBC_STATIC_ALIGN 对齐时恰好容纳 capacity 个元素（HLIST_DEFINE_STATIC 会自动对齐）
  * @param type 数据类型
  * @param capacity 容器最大容量
  *
- * 内存布局: [hlist结构体][节点数组][数据数组][使用标记]
+ * 内存布局: [hlist结构体][对齐填充][节点数组][对齐填充][数据数组]
  */
 #define HLIST_CALC_BUFFER_SIZE(type, capacity) \
-  (64 + (capacity) * (HLIST_NODE_SIZE + sizeof(type) + 1))
+  HLIST_BUFFER_SIZE(sizeof(type), capacity)
+
+/* 同上，元素大小以字节数给出 */
+#define HLIST_BUFFER_SIZE(type_size, capacity)                                  \
+  (HLIBC_ALIGN_UP(HLIST_STRUCT_SIZE, HLIBC_STATIC_ALIGN) +                      \
+   HLIBC_ALIGN_UP((size_t)(capacity) * HLIST_NODE_SIZE, HLIBC_STATIC_ALIGN) +   \
+   (size_t)(capacity) * (type_size))
+
+/*
+ * 追加缓冲区（扩展段）的头部大小（精确值，hlist.c 中用 _Static_assert 校验）
+ */
+#define HLIST_SEGMENT_HEADER_SIZE sizeof(hlist_segment_layout_t)
+
+/**
+ * 计算 hlist_add_buffer 追加 count 个元素的容量所需的 buffer 大小
+ * buffer 按 HLIBC_STATIC_ALIGN 对齐时恰好够用
+ * @param type 数据类型
+ * @param count 追加的容量
+ *
+ * 内存布局: [扩展段头部][对齐填充][节点数组][对齐填充][数据数组]
+ */
+#define HLIST_CALC_SEGMENT_SIZE(type, count) \
+  HLIST_SEGMENT_SIZE(sizeof(type), count)
+
+/* 同上，元素大小以字节数给出 */
+#define HLIST_SEGMENT_SIZE(type_size, count)                                 \
+  (HLIBC_ALIGN_UP(HLIST_SEGMENT_HEADER_SIZE, HLIBC_STATIC_ALIGN) +           \
+   HLIBC_ALIGN_UP((size_t)(count) * HLIST_NODE_SIZE, HLIBC_STATIC_ALIGN) +   \
+   (size_t)(count) * (type_size))
 
 /**
  * 定义一个静态 list（便捷宏）
@@ -53,7 +79,8 @@ extern "C" {
  *   hlist_push_back(my_list, &value, sizeof(int));
  */
 #define HLIST_DEFINE_STATIC(name, type, capacity)                       \
-  static uint8_t name##_buffer[HLIST_CALC_BUFFER_SIZE(type, capacity)]; \
+  HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static                              \
+      uint8_t name##_buffer[HLIST_CALC_BUFFER_SIZE(type, capacity)];    \
   hlist_ptr_t name =                                                    \
       hlist_create_static(name##_buffer, sizeof(name##_buffer), sizeof(type))
 
@@ -63,6 +90,45 @@ extern "C" {
 typedef struct hlist* hlist_ptr_t;
 typedef struct hdnode* hlist_iterator_ptr_t;
 
+/* hlist_foreach_sized 的回调，额外传入元素的字节数，返回 false 时停止遍历 */
+typedef bool (*hlist_foreach_sized_f)(hdata_ptr_t data, uint32_t size, void* ctx);
+
+/*
+ * 静态分配模式下 struct hlist 的布局镜像，仅用于在编译期得到精确大小，
+ * 字段必须与 hlist.c 保持一致
+ */
+typedef struct {
+  uint32_t list_size_;
+  uint32_t type_size_;
+  void* head_[3];
+  uint32_t capacity_;
+  uint32_t node_bump_;
+  void* node_pool_;
+  void* data_pool_;
+  void* free_list_;
+  void* compact_cursor_;
+  uint32_t compact_index_;
+  uint32_t extra_capacity_;
+  void* segments_;
+#if HLIBC_ENABLE_STATS
+  hlibc_stats_t stats_;
+#endif
+} hlist_static_layout_t;
+
+/*
+ * 静态分配模式下追加缓冲区头部的布局镜像，字段必须与 hlist.c 保持一致
+ */
+typedef struct {
+  void* next_;
+  void* buffer_;
+  void* node_pool_;
+  void* data_pool_;
+  void* free_list_;
+  uint32_t capacity_;
+  uint32_t node_bump_;
+  uint32_t used_;
+} hlist_segment_layout_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -75,9 +141,35 @@ typedef struct hdnode* hlist_iterator_ptr_t;
  */
 extern hlist_ptr_t hlist_create(uint32_t type_size);
 
+/**
+ * 创建一个 list 容器，结构体与节点池 chunk 由指定的分配器提供（动态分配）
+ * @param type_size 装入容器的数据类型的大小
+ * @param allocator 分配器，NULL 等同于 `hlist_create`；内容会被复制，无需长期保存
+ * @return 返回新创建的容器
+ */
+extern hlist_ptr_t hlist_create_with_allocator(uint32_t type_size,
+                                               const hallocator_t* allocator);
+
+/**
+ * 创建一个变长元素的 list 容器（动态分配）
+ * 每个元素的字节数在插入时给定，负载与其长度紧跟在节点之后、位于同一个槽位中，
+ * 遍历时直接读取，不需要再经过一次指针；槽位从容器自己的变长节点池中顺序切出，相继插入的元素在内存中相邻。
+ * hlist_push_back/push_front/insert 接受任意 data_size，hlist_emplace_sized 原地构造，
+ * 不带长度的 hlist_emplace 系列返回 NULL，hlist_insert_range 返回 HLIB_ERROR。
+ * @return 返回新创建的容器
+ */
+extern hlist_ptr_t hlist_create_var(void);
+
+/**
+ * 创建一个变长元素的 list 容器，结构体与节点池 chunk 由指定的分配器提供（动态分配）
+ * @param allocator 分配器，NULL 等同于 `hlist_create_var`；内容会被复制，无需长期保存
+ * @return 返回新创建的容器
+ */
+extern hlist_ptr_t hlist_create_var_with_allocator(const hallocator_t* allocator);
+
 /**
  * 删除给定的 list 容器（动态分配版本）
- * @param list 一个由 `hlist_create` 返回的容器
+ * @param list 一个由 `hlist_create` 或 `hlist_create_var` 返回的容器
  */
 extern void hlist_destroy(hlist_ptr_t list);
 
@@ -106,6 +198,7 @@ extern void hlist_destroy_static(hlist_ptr_t list);
 /* 兼容性宏定义 */
 #define hlist_create(type_size) \
   ((void)(type_size), (hlist_ptr_t)NULL) /* 静态模式下禁用 */
+#define hlist_create_var() ((hlist_ptr_t)NULL) /* 静态模式下禁用 */
 #define hlist_destroy(list) hlist_destroy_static(list)
 
 #endif /* HLIBC_USE_STATIC_ALLOC */
@@ -124,13 +217,71 @@ extern hlib_status_t hlist_push_back(hlist_ptr_t list,
 extern hlib_status_t hlist_push_front(hlist_ptr_t list,
                                       const hdata_ptr_t data_ptr,
                                       uint32_t data_size);
+
+/**
+ * 原地构造：在指定位置插入一个未初始化的元素，由调用者直接写入数据
+ * @param list 容器
+ * @param position 插入到该迭代器之前（hlist_emplace）
+ * @return 新元素的数据指针，内存不足或容器已满时返回 NULL
+ */
+extern hdata_ptr_t hlist_emplace(hlist_ptr_t list, hlist_iterator_ptr_t position);
+extern hdata_ptr_t hlist_emplace_back(hlist_ptr_t list);
+extern hdata_ptr_t hlist_emplace_front(hlist_ptr_t list);
+
+/**
+ * 原地构造一个 data_size 字节的元素，用于变长容器（定长容器中 data_size 须等于 type_size）
+ * @param position 插入到该迭代器之前；传入头节点（hlist_end 的下一个位置）时追加到末尾
+ * @return 新元素的数据指针（变长容器中按 max_align_t 对齐），长度不符、内存不足或容器已满时返回 NULL
+ */
+extern hdata_ptr_t hlist_emplace_sized(hlist_ptr_t list, hlist_iterator_ptr_t position,
+                                       uint32_t data_size);
+
+/**
+ * 在指定位置之前批量插入 count 个元素
+ * 先一次性准备好全部节点（动态模式从节点池预留一段连续槽位），再一趟链接进链表
+ * @param list 容器
+ * @param position 插入到该迭代器之前；传入头节点（hlist_end 的下一个位置）时追加到末尾
+ * @param array 连续存放的 count 个元素，每个元素 type_size 字节
+ * @param count 元素个数
+ * @return HLIB_OK 成功；HLIB_ERROR 内存不足；HLIB_OVERFLOW 剩余容量不足（静态分配）。失败时 list 不变
+ */
+extern hlib_status_t hlist_insert_range(hlist_ptr_t list, hlist_iterator_ptr_t position,
+                                        const hdata_ptr_t array, uint32_t count);
+
 extern void hlist_pop_back(hlist_ptr_t list);
 extern void hlist_pop_front(hlist_ptr_t list);
+
+/**
+ * 删除迭代器指向的元素
+ * @param list 容器
+ * @param position 要删除的元素
+ * @return 被删除元素的下一个迭代器，删除最后一个元素时为头节点；position 为头节点时原样返回
+ */
+extern hlist_iterator_ptr_t hlist_erase(hlist_ptr_t list, hlist_iterator_ptr_t position);
+
+/**
+ * 删除 [first, last) 范围内的元素
+ * @param first 第一个要删除的元素
+ * @param last 范围之后的第一个元素，不会被删除；传入头节点（hlist_end 的下一个位置）时删除到末尾
+ * @return last；first 为头节点或范围越过头节点时不删除任何元素
+ */
+extern hlist_iterator_ptr_t hlist_erase_range(hlist_ptr_t list, hlist_iterator_ptr_t first,
+                                              hlist_iterator_ptr_t last);
+
+/**
+ * 把 node 移动到 position 之前，只改动链接，不分配也不复制数据，迭代器与数据指针保持有效
+ * @param list 容器
+ * @param position 目标位置；传入头节点（hlist_end 的下一个位置）时移到末尾
+ * @param node 要移动的元素，不能是头节点
+ */
+extern void hlist_move(hlist_ptr_t list, hlist_iterator_ptr_t position, hlist_iterator_ptr_t node);
+
 /**
  * 清理 list 容器的所有内容
  * @param list 一个由 `hlist_create` 或 `hlist_create_static` 返回的容器
  * ！！！慎用：调用此函数将会清理掉队列内容，对于普通数据而言并无影响；
  * 但是对于指针数据来说，一旦清空之后便无法找到其指针，故而会造成内存泄漏，除非使用者有其他记录。
+ * 节点由容器的节点池整体回收：动态模式为 O(chunk 数)，静态模式为 O(1)。
  */
 extern void hlist_clear(hlist_ptr_t list);
 
@@ -147,7 +298,7 @@ extern uint32_t hlist_size(hlist_ptr_t list);
 
 #if HLIBC_USE_STATIC_ALLOC
 /**
- * 获取 list 容器的最大容量（仅静态分配模式）
+ * 获取 list 容器的最大容量（仅静态分配模式），包含追加的缓冲区
  * @param list 一个由 `hlist_create_static` 返回的容器
  * @return 容器最大容量
  */
@@ -159,6 +310,38 @@ extern uint32_t hlist_capacity(hlist_ptr_t list);
  * @return true 表示已满，false 表示未满
  */
 extern bool hlist_full(hlist_ptr_t list);
+
+/**
+ * 压缩节点池（仅静态分配模式）：移动节点与数据，使链表顺序与 node_pool/data_pool 中的存储顺序一致，
+ * 之后的顺序遍历是对两个数组的线性扫描，硬件预取可以充分发挥作用。
+ * 可以分多次完成：每次最多处理 max_nodes 个节点，进度保存在容器中，
+ * 两次调用之间照常增删元素不影响正确性，只会使已就位的部分变短。
+ * ！！！被移动的元素其迭代器与数据指针失效
+ * @param list 一个由 `hlist_create_static` 返回的容器
+ * 位于追加缓冲区中的节点也会被搬回 node_pool，元素个数不超过最初的容量时，压缩完成后追加的缓冲区全部排空
+ * @param max_nodes 本次最多处理的节点数，0 表示一次完成
+ * @return 尚未就位的节点数，0 表示已完全压缩（元素多于最初的容量时，超出的节点留在追加的缓冲区，不计入）
+ */
+extern uint32_t hlist_compact(hlist_ptr_t list, uint32_t max_nodes);
+
+/**
+ * 追加一块缓冲区，扩大容量（仅静态分配模式）
+ * 新节点优先取自最初的 buffer，用完后才依次取自追加的缓冲区，全程不调用 malloc。
+ * @param list 一个由 `hlist_create_static` 返回的容器
+ * @param buffer 缓冲区，在取回之前须保持有效
+ * @param buffer_size 缓冲区大小（使用 HLIST_CALC_SEGMENT_SIZE 宏计算）
+ * @return HLIB_OK 成功；HLIB_ERROR buffer 为 NULL 或放不下一个元素
+ */
+extern hlib_status_t hlist_add_buffer(hlist_ptr_t list, void* buffer, uint32_t buffer_size);
+
+/**
+ * 取回一块由 hlist_add_buffer 追加的缓冲区，容量相应减少（仅静态分配模式）
+ * 缓冲区中还有元素时可先调用 hlist_compact 把它们搬回最初的 buffer
+ * @param list 一个由 `hlist_create_static` 返回的容器
+ * @param buffer 追加时传入的地址
+ * @return HLIB_OK 已取回；HLIB_BUSY 缓冲区中还有元素；HLIB_ERROR 不是追加的缓冲区
+ */
+extern hlib_status_t hlist_remove_buffer(hlist_ptr_t list, void* buffer);
 #endif
 
 /*=======================
@@ -172,6 +355,52 @@ extern void hlist_iter_backward(hlist_iterator_ptr_t *iter);
 extern void hlist_iter_forward_to(hlist_iterator_ptr_t *iter, int step);
 extern void hlist_iter_backward_to(hlist_iterator_ptr_t *iter, int step);
 
+/**
+ * 迭代器指向的元素的字节数：变长容器为插入时给定的长度，定长容器为 type_size，头节点为 0
+ */
+extern uint32_t hlist_iter_size(hlist_ptr_t list, hlist_iterator_ptr_t iter);
+
+/**
+ * 从头到尾对每个元素调用 fn，遍历时提前预取后续节点与数据
+ * @param list 容器
+ * @param fn 回调，返回 false 时停止遍历；回调中不能增删 list 的元素
+ * @param ctx 原样传给 fn
+ * @return 已调用 fn 的元素个数
+ */
+extern uint32_t hlist_foreach(hlist_ptr_t list, hforeach_f fn, void* ctx);
+
+/**
+ * 同 hlist_foreach，回调同时得到元素的字节数，用于遍历变长容器
+ */
+extern uint32_t hlist_foreach_sized(hlist_ptr_t list, hlist_foreach_sized_f fn, void* ctx);
+
+/**
+ * 从头到尾按批遍历：每次收集最多 HLIBC_FOREACH_BATCH 个元素的数据指针后调用一次 fn，
+ * 收集的同时预取各元素的数据，回调中的访问大多已在缓存中
+ * @param fn 回调，items 仅在本次回调内有效，返回 false 时停止遍历
+ * @return 已传给 fn 的元素个数
+ */
+extern uint32_t hlist_foreach_batch(hlist_ptr_t list, hforeach_batch_f fn, void* ctx);
+
+#if HLIBC_ENABLE_STATS
+/*=======================
+ * Statistics functions
+ *======================*/
+
+/**
+ * 读取 hlist 容器的运行统计（仅在 HLIBC_ENABLE_STATS 为 1 时提供）
+ * @param list 一个由 `hlist_create` 或 `hlist_create_static` 返回的容器
+ * @param stats 输出统计快照
+ */
+extern void hlist_get_stats(hlist_ptr_t list, hlibc_stats_t* stats);
+
+/**
+ * 清零 hlist 容器的运行统计，高水位从当前元素个数重新开始
+ * @param list 一个由 `hlist_create` 或 `hlist_create_static` 返回的容器
+ */
+extern void hlist_reset_stats(hlist_ptr_t list);
+#endif
+
 #ifdef __cplusplus
 } /*extern "C"*/
 #endif
@@ -0,0 +1,253 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/list/hlist_typed.h
+ * @Description: 宏生成的类型特化双向链表（全部 static inline，可完全内联）
+ * @other: None
+ */
+#ifndef __HLIBC_HLIST_TYPED_H__
+#define __HLIBC_HLIST_TYPED_H__
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../common/hcommon.h"
+#include "../common/hlibc_config.h"
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+#include "../common/harena.h"
+#endif
+
+/*********************
+ *      MACROS
+ *********************/
+
+/**
+ * 生成一个元素类型为 T 的双向链表，类型名为 `name_t`，函数前缀为 `name_`
+ * 元素直接内嵌在节点中，按值传递与拷贝，编译器可以直接内联。
+ *
+ * 动态分配模式：节点来自容器自己的分块节点池，clear/destroy 按 chunk 回收
+ *   name_init(l) / name_destroy(l)
+ * 静态分配模式：使用用户提供的节点数组，满时返回 HLIB_OVERFLOW
+ *   name_init_static(l, pool, capacity) / name_capacity(l) / name_full(l)
+ *   节点数组类型为 `name_node_t`，例：`static int_list_node_t pool[32];`
+ *
+ * 通用操作：
+ *   name_push_back / name_push_front / name_insert / name_pop_back / name_pop_front
+ *   name_front / name_back / name_size / name_empty / name_clear
+ * 迭代器（`name_iter_t`）：
+ *   name_begin / name_end / name_iter_next / name_iter_prev / name_iter_data
+ *   注意：name_end 返回越过尾元素的位置（头节点），与 hlist_end 不同
+ *
+ * 使用示例:
+ *   HLIST_DECLARE(int_list, int)
+ *   int_list_t l;
+ *   int_list_init(&l);
+ *   int_list_push_back(&l, 10);
+ *   for (int_list_iter_t it = int_list_begin(&l); it != int_list_end(&l);
+ *        it = int_list_iter_next(it)) {
+ *       printf("%d ", *int_list_iter_data(it));
+ *   }
+ */
+#define HLIST_DECLARE(name, T)                                                 \
+    typedef struct name##_link {                                               \
+        struct name##_link *prev, *next;                                       \
+    } name##_link_t;                                                           \
+                                                                               \
+    typedef struct name##_node {                                               \
+        name##_link_t link; /* 必须是第一个成员 */                             \
+        T data;                                                                \
+    } name##_node_t;                                                           \
+                                                                               \
+    typedef name##_link_t* name##_iter_t;                                      \
+                                                                               \
+    typedef struct name {                                                      \
+        name##_link_t head;                                                    \
+        uint32_t size;                                                         \
+        HLIST_DECLARE_POOL_FIELDS_(name)                                       \
+    } name##_t;                                                                \
+                                                                               \
+    HLIST_DECLARE_ALLOC_(name, T)                                              \
+                                                                               \
+    static inline void name##_reset_(name##_t* l)                              \
+    {                                                                          \
+        l->head.prev = &l->head;                                               \
+        l->head.next = &l->head;                                               \
+        l->size = 0;                                                           \
+    }                                                                          \
+                                                                               \
+    /* 在 position 之后插入 */                                                 \
+    static inline hlib_status_t name##_link_after_(name##_t* l,                \
+                                                   name##_link_t* position,    \
+                                                   T value)                    \
+    {                                                                          \
+        name##_node_t* node = name##_alloc_node_(l);                           \
+        if (node == NULL) return name##_alloc_failure_();                      \
+        node->data = value;                                                    \
+        node->link.next = position->next;                                      \
+        position->next->prev = &node->link;                                    \
+        node->link.prev = position;                                            \
+        position->next = &node->link;                                          \
+        ++l->size;                                                             \
+        return HLIB_OK;                                                        \
+    }                                                                          \
+                                                                               \
+    static inline void name##_unlink_(name##_t* l, name##_link_t* position)    \
+    {                                                                          \
+        if (l->size == 0) return;                                              \
+        position->prev->next = position->next;                                 \
+        position->next->prev = position->prev;                                 \
+        name##_free_node_(l, (name##_node_t*)position);                        \
+        --l->size;                                                             \
+    }                                                                          \
+                                                                               \
+    static inline hlib_status_t name##_push_back(name##_t* l, T value)         \
+    {                                                                          \
+        return name##_link_after_(l, l->head.prev, value);                     \
+    }                                                                          \
+    static inline hlib_status_t name##_push_front(name##_t* l, T value)        \
+    {                                                                          \
+        return name##_link_after_(l, &l->head, value);                         \
+    }                                                                          \
+    /* 在迭代器 position 之前插入 */                                           \
+    static inline hlib_status_t name##_insert(name##_t* l,                     \
+                                              name##_iter_t position, T value) \
+    {                                                                          \
+        return name##_link_after_(l, position->prev, value);                   \
+    }                                                                          \
+    static inline void name##_pop_back(name##_t* l)                            \
+    {                                                                          \
+        name##_unlink_(l, l->head.prev);                                       \
+    }                                                                          \
+    static inline void name##_pop_front(name##_t* l)                           \
+    {                                                                          \
+        name##_unlink_(l, l->head.next);                                       \
+    }                                                                          \
+                                                                               \
+    static inline T* name##_front(name##_t* l)                                 \
+    {                                                                          \
+        return l->size ? &((name##_node_t*)l->head.next)->data : NULL;         \
+    }                                                                          \
+    static inline T* name##_back(name##_t* l)                                  \
+    {                                                                          \
+        return l->size ? &((name##_node_t*)l->head.prev)->data : NULL;         \
+    }                                                                          \
+    static inline uint32_t name##_size(const name##_t* l) { return l->size; }  \
+    static inline bool name##_empty(const name##_t* l) { return l->size == 0; } \
+                                                                               \
+    static inline name##_iter_t name##_begin(name##_t* l)                      \
+    {                                                                          \
+        return l->head.next;                                                   \
+    }                                                                          \
+    static inline name##_iter_t name##_end(name##_t* l) { return &l->head; }   \
+    static inline name##_iter_t name##_iter_next(name##_iter_t it)             \
+    {                                                                          \
+        return it->next;                                                       \
+    }                                                                          \
+    static inline name##_iter_t name##_iter_prev(name##_iter_t it)             \
+    {                                                                          \
+        return it->prev;                                                       \
+    }                                                                          \
+    static inline T* name##_iter_data(name##_iter_t it)                        \
+    {                                                                          \
+        return &((name##_node_t*)it)->data;                                    \
+    }
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+
+#define HLIST_DECLARE_POOL_FIELDS_(name)                                       \
+    harena_t arena; /* 节点的分块节点池 */
+
+#define HLIST_DECLARE_ALLOC_(name, T)                                          \
+    static inline void name##_reset_(name##_t* l);                             \
+                                                                               \
+    static inline void name##_init(name##_t* l)                                \
+    {                                                                          \
+        harena_init(&l->arena, sizeof(name##_node_t), NULL);                   \
+        name##_reset_(l);                                                      \
+    }                                                                          \
+                                                                               \
+    /* 节点整体归还给节点池，O(chunk 数) */                                    \
+    static inline void name##_clear(name##_t* l)                               \
+    {                                                                          \
+        harena_release(&l->arena);                                             \
+        name##_reset_(l);                                                      \
+    }                                                                          \
+                                                                               \
+    static inline void name##_destroy(name##_t* l) { name##_clear(l); }        \
+                                                                               \
+    static inline name##_node_t* name##_alloc_node_(name##_t* l)               \
+    {                                                                          \
+        return (name##_node_t*)harena_alloc(&l->arena);                        \
+    }                                                                          \
+    static inline void name##_free_node_(name##_t* l, name##_node_t* node)     \
+    {                                                                          \
+        harena_free(&l->arena, node);                                          \
+    }                                                                          \
+    static inline hlib_status_t name##_alloc_failure_(void)                    \
+    {                                                                          \
+        return HLIB_ERROR;                                                     \
+    }
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+
+#define HLIST_DECLARE_POOL_FIELDS_(name)                                       \
+    uint32_t capacity;          /* 最大容量 */                                 \
+    uint32_t node_bump;         /* 从未使用过的第一个节点下标 */               \
+    struct name##_node* pool;   /* 节点池 */                                   \
+    name##_link_t* free_list;   /* 已释放节点链表（经 next 串联） */
+
+#define HLIST_DECLARE_ALLOC_(name, T)                                          \
+    static inline void name##_reset_(name##_t* l);                             \
+                                                                               \
+    static inline void name##_init_static(name##_t* l, name##_node_t* pool,    \
+                                          uint32_t capacity)                   \
+    {                                                                          \
+        l->capacity = capacity;                                                \
+        l->pool = pool;                                                        \
+        l->node_bump = 0;                                                      \
+        l->free_list = NULL;                                                   \
+        name##_reset_(l);                                                      \
+    }                                                                          \
+                                                                               \
+    /* 节点池整体重置，O(1) */                                                 \
+    static inline void name##_clear(name##_t* l)                               \
+    {                                                                          \
+        l->node_bump = 0;                                                      \
+        l->free_list = NULL;                                                   \
+        name##_reset_(l);                                                      \
+    }                                                                          \
+                                                                               \
+    static inline void name##_destroy_static(name##_t* l) { name##_clear(l); } \
+    static inline uint32_t name##_capacity(const name##_t* l)                  \
+    {                                                                          \
+        return l->capacity;                                                    \
+    }                                                                          \
+    static inline bool name##_full(const name##_t* l)                          \
+    {                                                                          \
+        return l->size >= l->capacity;                                         \
+    }                                                                          \
+                                                                               \
+    static inline name##_node_t* name##_alloc_node_(name##_t* l)               \
+    {                                                                          \
+        name##_link_t* link = l->free_list;                                    \
+        if (link != NULL) {                                                    \
+            l->free_list = link->next;                                         \
+            return (name##_node_t*)link;                                       \
+        }                                                                      \
+        if (l->node_bump < l->capacity) return &l->pool[l->node_bump++];       \
+        return NULL;                                                           \
+    }                                                                          \
+    static inline void name##_free_node_(name##_t* l, name##_node_t* node)     \
+    {                                                                          \
+        node->link.next = l->free_list;                                        \
+        l->free_list = &node->link;                                            \
+    }                                                                          \
+    static inline hlib_status_t name##_alloc_failure_(void)                    \
+    {                                                                          \
+        return HLIB_OVERFLOW;                                                  \
+    }
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+#endif /* __HLIBC_HLIST_TYPED_H__ */
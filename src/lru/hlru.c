@@ -0,0 +1,325 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/lru/hlru.c
+ * @Description: 定长键值的 LRU 缓存：开放寻址索引 + hlist 维护的访问顺序
+ * @other: None
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "hlru.h"
+#include "../common/hlibc_type.h"
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+#include <stdlib.h>
+#endif
+
+/*********************
+ *      MACROS
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct hdnode list_dnode_t;
+
+/* 索引槽位：node 为 NULL 表示空槽；保存哈希值，探测时先比哈希再比键，删除时据此计算起始槽位 */
+typedef struct {
+    list_dnode_t* node;
+    uint32_t hash;
+} lru_slot_t;
+
+struct hlru {
+    hlist_ptr_t list;        /* 条目链表，表头最新、表尾最旧 */
+    lru_slot_t* table;       /* 线性探测索引 */
+    uint32_t table_size;
+    uint32_t capacity;
+    uint32_t key_size;
+    uint32_t value_size;
+    uint32_t value_offset;   /* 值在条目中的偏移 */
+    hlru_evict_f evict_cb;
+    void* evict_ctx;
+};
+
+#if HLIBC_USE_STATIC_ALLOC == 1
+/* 头文件中的布局镜像必须与实际结构体一致 */
+_Static_assert(sizeof(struct hlru) == HLRU_STRUCT_SIZE &&
+               _Alignof(struct hlru) == _Alignof(hlru_static_layout_t),
+               "hlru_static_layout_t does not match struct hlru");
+_Static_assert(sizeof(lru_slot_t) == HLRU_SLOT_SIZE, "HLRU_SLOT_SIZE does not match lru_slot_t");
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void lru_init(hlru_ptr_t lru, uint32_t key_size, uint32_t value_size, uint32_t capacity);
+static uint32_t lru_hash(const uint8_t* key, uint32_t size);
+static uint32_t lru_home(hlru_ptr_t lru, uint32_t hash);
+static uint32_t lru_find(hlru_ptr_t lru, hcdata_ptr_t key, uint32_t hash);
+static void lru_unindex(hlru_ptr_t lru, list_dnode_t* node);
+static void lru_erase_slot(hlru_ptr_t lru, uint32_t index);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/* ==================== 动态分配实现 ==================== */
+
+hlru_ptr_t hlru_create(uint32_t key_size, uint32_t value_size, uint32_t capacity)
+{
+    if (key_size == 0 || value_size == 0 || capacity == 0 || capacity > UINT32_MAX / 2)
+        return NULL;
+    hlru_ptr_t lru = (hlru_ptr_t)malloc(sizeof(struct hlru));
+    if (lru == NULL) return NULL;
+    lru->table = (lru_slot_t*)calloc(HLRU_TABLE_SIZE(capacity), sizeof(lru_slot_t));
+    lru->list = hlist_create((uint32_t)HLRU_ENTRY_SIZE(key_size, value_size));
+    if (lru->table == NULL || lru->list == NULL) {
+        if (lru->list != NULL) hlist_destroy(lru->list);
+        free(lru->table);
+        free(lru);
+        return NULL;
+    }
+    lru_init(lru, key_size, value_size, capacity);
+    return lru;
+}
+
+void hlru_destroy(hlru_ptr_t lru)
+{
+    hlist_destroy(lru->list);
+    free(lru->table);
+    free(lru);
+}
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+/* ==================== 静态分配实现 ==================== */
+
+hlru_ptr_t hlru_create_static(void* buffer, uint32_t buffer_size, uint32_t key_size,
+                              uint32_t value_size, uint32_t capacity)
+{
+    if (buffer == NULL || key_size == 0 || value_size == 0 || capacity == 0) return NULL;
+
+    /* 未对齐的 buffer 先跳过开头的若干字节 */
+    uint8_t* base = (uint8_t*)HLIBC_ALIGN_UP((uintptr_t)buffer, HLIBC_STATIC_ALIGN);
+    size_t skip = (size_t)(base - (uint8_t*)buffer);
+    if (buffer_size < skip + HLRU_BUFFER_SIZE(key_size, value_size, capacity)) return NULL;
+
+    /* 按 HLRU_BUFFER_SIZE 的布局依次切分 */
+    hlru_ptr_t lru = (hlru_ptr_t)base;
+    uint8_t* ptr = base + HLIBC_ALIGN_UP(sizeof(struct hlru), HLIBC_STATIC_ALIGN);
+    lru->table = (lru_slot_t*)ptr;
+    memset(lru->table, 0, HLRU_TABLE_SIZE(capacity) * sizeof(lru_slot_t));
+    ptr += HLIBC_ALIGN_UP(HLRU_TABLE_SIZE(capacity) * sizeof(lru_slot_t), HLIBC_STATIC_ALIGN);
+
+    uint32_t entry_size = (uint32_t)HLRU_ENTRY_SIZE(key_size, value_size);
+    lru->list = hlist_create_static(ptr, (uint32_t)HLIST_BUFFER_SIZE(entry_size, capacity),
+                                    entry_size);
+    if (lru->list == NULL || hlist_capacity(lru->list) < capacity) return NULL;
+    lru_init(lru, key_size, value_size, capacity);
+    return lru;
+}
+
+void hlru_destroy_static(hlru_ptr_t lru)
+{
+    if (lru == NULL) return;
+    /* 静态分配不释放内存，只重置状态 */
+    hlru_clear(lru);
+}
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+void hlru_set_evict_cb(hlru_ptr_t lru, hlru_evict_f fn, void* ctx)
+{
+    lru->evict_cb = fn;
+    lru->evict_ctx = ctx;
+}
+
+hlib_status_t hlru_put(hlru_ptr_t lru, hcdata_ptr_t key, hcdata_ptr_t value)
+{
+    uint32_t hash = lru_hash((const uint8_t*)key, lru->key_size);
+    uint32_t index = lru_find(lru, key, hash);
+    list_dnode_t* node = lru->table[index].node;
+
+    if (node == NULL) {
+        if (hlist_size(lru->list) >= lru->capacity) {
+            /* 已满：淘汰表尾条目并直接复用它的节点，删除索引会移动槽位，需要重新定位 */
+            node = hlist_end(lru->list);
+            if (lru->evict_cb != NULL)
+                lru->evict_cb(node->data_ptr, (uint8_t*)node->data_ptr + lru->value_offset,
+                              lru->evict_ctx);
+            lru_unindex(lru, node);
+            index = lru_find(lru, key, hash);
+        } else {
+            if (hlist_emplace_front(lru->list) == NULL) return HLIB_ERROR;
+            node = hlist_begin(lru->list);
+        }
+        memcpy(node->data_ptr, key, lru->key_size);
+        lru->table[index].node = node;
+        lru->table[index].hash = hash;
+    }
+
+    memcpy((uint8_t*)node->data_ptr + lru->value_offset, value, lru->value_size);
+    hlist_move(lru->list, hlist_begin(lru->list), node);
+    return HLIB_OK;
+}
+
+bool hlru_remove(hlru_ptr_t lru, hcdata_ptr_t key)
+{
+    uint32_t index = lru_find(lru, key, lru_hash((const uint8_t*)key, lru->key_size));
+    list_dnode_t* node = lru->table[index].node;
+    if (node == NULL) return false;
+    lru_erase_slot(lru, index);
+    hlist_erase(lru->list, node);
+    return true;
+}
+
+bool hlru_evict(hlru_ptr_t lru)
+{
+    if (hlist_empty(lru->list)) return false;
+    list_dnode_t* node = hlist_end(lru->list);
+    if (lru->evict_cb != NULL)
+        lru->evict_cb(node->data_ptr, (uint8_t*)node->data_ptr + lru->value_offset,
+                      lru->evict_ctx);
+    lru_unindex(lru, node);
+    hlist_erase(lru->list, node);
+    return true;
+}
+
+void hlru_clear(hlru_ptr_t lru)
+{
+    memset(lru->table, 0, (size_t)lru->table_size * sizeof(lru_slot_t));
+    hlist_clear(lru->list);
+}
+
+/*=======================
+ * Getter functions
+ *======================*/
+
+hdata_ptr_t hlru_get(hlru_ptr_t lru, hcdata_ptr_t key)
+{
+    uint32_t index = lru_find(lru, key, lru_hash((const uint8_t*)key, lru->key_size));
+    list_dnode_t* node = lru->table[index].node;
+    if (node == NULL) return NULL;
+    hlist_move(lru->list, hlist_begin(lru->list), node);
+    return (uint8_t*)node->data_ptr + lru->value_offset;
+}
+
+hdata_ptr_t hlru_peek(hlru_ptr_t lru, hcdata_ptr_t key)
+{
+    uint32_t index = lru_find(lru, key, lru_hash((const uint8_t*)key, lru->key_size));
+    list_dnode_t* node = lru->table[index].node;
+    return node != NULL ? (uint8_t*)node->data_ptr + lru->value_offset : NULL;
+}
+
+uint32_t hlru_size(hlru_ptr_t lru)
+{
+    return hlist_size(lru->list);
+}
+
+uint32_t hlru_capacity(hlru_ptr_t lru)
+{
+    return lru->capacity;
+}
+
+bool hlru_empty(hlru_ptr_t lru)
+{
+    return hlist_empty(lru->list);
+}
+
+bool hlru_full(hlru_ptr_t lru)
+{
+    return hlist_size(lru->list) >= lru->capacity;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void lru_init(hlru_ptr_t lru, uint32_t key_size, uint32_t value_size, uint32_t capacity)
+{
+    lru->table_size = HLRU_TABLE_SIZE(capacity);
+    lru->capacity = capacity;
+    lru->key_size = key_size;
+    lru->value_size = value_size;
+    lru->value_offset = (uint32_t)HLRU_VALUE_OFFSET(key_size, value_size);
+    lru->evict_cb = NULL;
+    lru->evict_ctx = NULL;
+}
+
+/* 每次吸收 8 字节，最后做一次 64 位雪崩混合 */
+static uint32_t lru_hash(const uint8_t* key, uint32_t size)
+{
+    uint64_t h = 0x9e3779b97f4a7c15ull ^ size;
+    uint64_t word;
+    while (size >= 8) {
+        memcpy(&word, key, 8);
+        h = (h ^ word) * 0xff51afd7ed558ccdull;
+        h ^= h >> 32;
+        key += 8;
+        size -= 8;
+    }
+    if (size > 0) {
+        word = 0;
+        memcpy(&word, key, size);
+        h = (h ^ word) * 0xff51afd7ed558ccdull;
+    }
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return (uint32_t)h;
+}
+
+/* 哈希值映射到 [0, table_size)，用乘法代替取模 */
+static uint32_t lru_home(hlru_ptr_t lru, uint32_t hash)
+{
+    return (uint32_t)(((uint64_t)hash * lru->table_size) >> 32);
+}
+
+/* 返回键所在的槽位；不存在时返回插入位置（空槽）。负载因子不超过 0.5，一定能找到空槽 */
+static uint32_t lru_find(hlru_ptr_t lru, hcdata_ptr_t key, uint32_t hash)
+{
+    uint32_t index = lru_home(lru, hash);
+    for (;;) {
+        lru_slot_t* slot = &lru->table[index];
+        if (slot->node == NULL) return index;
+        if (slot->hash == hash && memcmp(slot->node->data_ptr, key, lru->key_size) == 0)
+            return index;
+        if (++index == lru->table_size) index = 0;
+    }
+}
+
+/* 删除指向 node 的索引项，按节点指针比较，不需要比较键 */
+static void lru_unindex(hlru_ptr_t lru, list_dnode_t* node)
+{
+    uint32_t index = lru_home(lru, lru_hash((const uint8_t*)node->data_ptr, lru->key_size));
+    while (lru->table[index].node != node) {
+        if (++index == lru->table_size) index = 0;
+    }
+    lru_erase_slot(lru, index);
+}
+
+/* 向后移位删除：把后面探测链上的项前移填补空位，不留墓碑，查找长度不会随删除增长 */
+static void lru_erase_slot(hlru_ptr_t lru, uint32_t index)
+{
+    uint32_t next = index;
+    for (;;) {
+        if (++next == lru->table_size) next = 0;
+        if (lru->table[next].node == NULL) break;
+        uint32_t home = lru_home(lru, lru->table[next].hash);
+        /* home 不在循环区间 (index, next] 内时，该项可以前移到 index */
+        bool movable = index <= next ? (home <= index || home > next)
+                                     : (home <= index && home > next);
+        if (movable) {
+            lru->table[index] = lru->table[next];
+            index = next;
+        }
+    }
+    lru->table[index].node = NULL;
+}
@@ -0,0 +1,218 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/lru/hlru.h
+ * @Description: 定长键值的 LRU 缓存：开放寻址索引 + hlist 维护的访问顺序
+ * @other: None
+ */
+#ifndef __HLIBC_HLRU_H__
+#define __HLIBC_HLRU_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../common/hcommon.h"
+#include "../common/hlibc_config.h"
+#include "../list/hlist.h"
+
+/*********************
+ *      MACROS
+ *********************/
+
+/* 按大小推断键、值的对齐：大小的最低位 2 的幂，不超过 8 字节 */
+#define HLRU_SIZE_ALIGN(size) \
+  (((size_t)(size) & (~(size_t)(size) + 1)) < 8u ? ((size_t)(size) & (~(size_t)(size) + 1)) : 8u)
+
+/* 条目在链表中的布局: [键][对齐填充][值][对齐填充] */
+#define HLRU_VALUE_OFFSET(key_size, value_size) \
+  HLIBC_ALIGN_UP((size_t)(key_size), HLRU_SIZE_ALIGN(value_size))
+
+#define HLRU_ENTRY_SIZE(key_size, value_size)                             \
+  HLIBC_ALIGN_UP(HLRU_VALUE_OFFSET(key_size, value_size) + (value_size),  \
+                 HLRU_SIZE_ALIGN(key_size) > HLRU_SIZE_ALIGN(value_size)  \
+                     ? HLRU_SIZE_ALIGN(key_size) : HLRU_SIZE_ALIGN(value_size))
+
+/* 索引槽位数为容量的 2 倍，负载因子不超过 0.5 */
+#define HLRU_TABLE_SIZE(capacity) (2u * (uint32_t)(capacity))
+
+/*
+ * 静态分配结构体与索引槽位大小（精确值，hlru.c 中用 _Static_assert 校验）
+ */
+#define HLRU_STRUCT_SIZE sizeof(hlru_static_layout_t)
+#define HLRU_SLOT_SIZE   (2 * sizeof(void*)) /* 节点指针 + 32 位哈希 */
+
+/**
+ * 计算静态 lru 所需的 buffer 大小
+ * buffer 按 HLIBC_STATIC_ALIGN 对齐时恰好够用（HLRU_DEFINE_STATIC 会自动对齐）
+ * @param key_type 键类型
+ * @param value_type 值类型
+ * @param capacity 最多缓存的条目数
+ *
+ * 内存布局: [hlru结构体][对齐填充][索引][对齐填充][hlist（节点数组 + 条目数组）]
+ */
+#define HLRU_CALC_BUFFER_SIZE(key_type, value_type, capacity) \
+  HLRU_BUFFER_SIZE(sizeof(key_type), sizeof(value_type), capacity)
+
+/* 同上，键、值大小以字节数给出 */
+#define HLRU_BUFFER_SIZE(key_size, value_size, capacity)                               \
+  (HLIBC_ALIGN_UP(HLRU_STRUCT_SIZE, HLIBC_STATIC_ALIGN) +                              \
+   HLIBC_ALIGN_UP((size_t)HLRU_TABLE_SIZE(capacity) * HLRU_SLOT_SIZE, HLIBC_STATIC_ALIGN) + \
+   HLIST_BUFFER_SIZE(HLRU_ENTRY_SIZE(key_size, value_size), capacity))
+
+/**
+ * 定义一个静态 lru（便捷宏）
+ * @param name 变量名
+ * @param key_type 键类型
+ * @param value_type 值类型
+ * @param capacity 最多缓存的条目数
+ *
+ * 使用示例:
+ *   HLRU_DEFINE_STATIC(my_cache, uint32_t, struct item, 64);
+ *   hlru_put(my_cache, &id, &item);
+ */
+#define HLRU_DEFINE_STATIC(name, key_type, value_type, capacity)                       \
+  HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static                                             \
+      uint8_t name##_buffer[HLRU_CALC_BUFFER_SIZE(key_type, value_type, capacity)];    \
+  hlru_ptr_t name = hlru_create_static(name##_buffer, sizeof(name##_buffer),           \
+                                       sizeof(key_type), sizeof(value_type), capacity)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct hlru* hlru_ptr_t;
+
+/* 条目因容量不足被淘汰时调用，返回后条目即被复用 */
+typedef void (*hlru_evict_f)(hcdata_ptr_t key, hdata_ptr_t value, void* ctx);
+
+/*
+ * 静态分配模式下 struct hlru 的布局镜像，仅用于在编译期得到精确大小，
+ * 字段必须与 hlru.c 保持一致
+ */
+typedef struct {
+    void* list_;
+    void* table_;
+    uint32_t table_size_;
+    uint32_t capacity_;
+    uint32_t key_size_;
+    uint32_t value_size_;
+    uint32_t value_offset_;
+    hlru_evict_f evict_cb_;
+    void* evict_ctx_;
+} hlru_static_layout_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/*
+ * 条目按访问顺序保存在内部的 hlist 中（表头最新、表尾最旧），
+ * 开放寻址（线性探测）索引保存指向链表节点的指针，get/put/remove/淘汰都是 O(1)。
+ * 键按字节比较，含填充字节的结构体键需要先清零。
+ */
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/**
+ * 创建一个 lru 缓存（动态分配）
+ * 索引一次分配好，条目节点按需从内部 hlist 的节点池中取得
+ * @param key_size 键的字节数
+ * @param value_size 值的字节数
+ * @param capacity 最多缓存的条目数
+ * @return 返回新创建的缓存，失败返回 NULL
+ */
+extern hlru_ptr_t hlru_create(uint32_t key_size, uint32_t value_size, uint32_t capacity);
+
+/**
+ * 删除给定的 lru 缓存（动态分配版本），不调用淘汰回调
+ * @param lru 一个由 `hlru_create` 返回的缓存
+ */
+extern void hlru_destroy(hlru_ptr_t lru);
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+
+/**
+ * 创建一个静态分配的 lru 缓存
+ * @param buffer 用户提供的内存缓冲区
+ * @param buffer_size 缓冲区大小（使用 HLRU_CALC_BUFFER_SIZE 宏计算）
+ * @param key_size 键的字节数
+ * @param value_size 值的字节数
+ * @param capacity 最多缓存的条目数
+ * @return 返回缓存指针，失败返回 NULL
+ */
+extern hlru_ptr_t hlru_create_static(void* buffer, uint32_t buffer_size, uint32_t key_size,
+                                     uint32_t value_size, uint32_t capacity);
+
+/**
+ * 销毁静态分配的 lru 缓存（仅清理内容，不释放内存），不调用淘汰回调
+ * @param lru 一个由 `hlru_create_static` 返回的缓存
+ */
+extern void hlru_destroy_static(hlru_ptr_t lru);
+
+/* 兼容性宏定义 */
+#define hlru_create(key_size, value_size, capacity) \
+  ((void)(key_size), (void)(value_size), (void)(capacity), (hlru_ptr_t)NULL) /* 静态模式下禁用 */
+#define hlru_destroy(lru) hlru_destroy_static(lru)
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+/**
+ * 设置淘汰回调，put 因容量不足淘汰最旧条目、以及 hlru_evict 时调用
+ */
+extern void hlru_set_evict_cb(hlru_ptr_t lru, hlru_evict_f fn, void* ctx);
+
+/**
+ * 写入一个条目并标记为最新；键已存在时覆盖其值，缓存已满时先淘汰最旧的条目
+ * @return HLIB_OK 成功；HLIB_ERROR 内存不足（动态分配）
+ */
+extern hlib_status_t hlru_put(hlru_ptr_t lru, hcdata_ptr_t key, hcdata_ptr_t value);
+
+/**
+ * 删除一个条目，不调用淘汰回调
+ * @return 键存在时返回 true
+ */
+extern bool hlru_remove(hlru_ptr_t lru, hcdata_ptr_t key);
+
+/**
+ * 淘汰最旧的条目（调用淘汰回调）
+ * @return 缓存为空时返回 false
+ */
+extern bool hlru_evict(hlru_ptr_t lru);
+
+/**
+ * 清空缓存，不调用淘汰回调
+ */
+extern void hlru_clear(hlru_ptr_t lru);
+
+/*=======================
+ * Getter functions
+ *======================*/
+
+/**
+ * 查找并标记为最新
+ * @return 值的地址，可以原地修改，在该条目被删除或淘汰前有效；未命中返回 NULL
+ */
+extern hdata_ptr_t hlru_get(hlru_ptr_t lru, hcdata_ptr_t key);
+
+/**
+ * 查找但不改变访问顺序
+ * @return 同 hlru_get
+ */
+extern hdata_ptr_t hlru_peek(hlru_ptr_t lru, hcdata_ptr_t key);
+
+extern uint32_t hlru_size(hlru_ptr_t lru);
+extern uint32_t hlru_capacity(hlru_ptr_t lru);
+extern bool hlru_empty(hlru_ptr_t lru);
+extern bool hlru_full(hlru_ptr_t lru);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __HLIBC_HLRU_H__ */
@@ -0,0 +1,248 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/pool/hpool.c
+ * @Description: 定长对象池：O(1) 申请/释放固定大小的内存块，可选每线程弹匣
+ * @other: None
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "hpool.h"
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+#include "../common/harena.h"
+#endif
+
+/*********************
+ *      MACROS
+ *********************/
+
+#if HLIBC_USE_THREADS
+/* 弹匣空或满时与池交换的块数 */
+#define MAGAZINE_BATCH      ((HLIBC_POOL_MAGAZINE_SIZE + 1u) / 2u)
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+struct hpool {
+#if HLIBC_USE_STATIC_ALLOC == 0
+    harena_t arena;             /* slab 池，每个槽位一个块 */
+    uint32_t used;              /* 已申请未归还的块数 */
+#else
+    hpool_region_t region;      /* buffer 中的块区域 */
+#endif
+    uint32_t block_size;
+#if HLIBC_USE_THREADS
+    pthread_mutex_t lock;       /* 只在弹匣补充/归还时持有 */
+#endif
+};
+
+#if HLIBC_USE_STATIC_ALLOC == 1
+/* 头文件中的布局镜像必须与实际结构体一致 */
+_Static_assert(sizeof(struct hpool) == HPOOL_STRUCT_SIZE &&
+               _Alignof(struct hpool) == _Alignof(hpool_static_layout_t),
+               "hpool_static_layout_t does not match struct hpool");
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void* pool_take(hpool_ptr_t pool);
+static void pool_give(hpool_ptr_t pool, void* block);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/* ==================== 动态分配实现 ==================== */
+
+hpool_ptr_t hpool_create(uint32_t block_size)
+{
+    return hpool_create_with_allocator(block_size, NULL);
+}
+
+hpool_ptr_t hpool_create_with_allocator(uint32_t block_size, const hallocator_t* allocator)
+{
+    if (block_size == 0) return NULL;
+    hpool_ptr_t pool = (hpool_ptr_t)hallocator_alloc(allocator, sizeof(struct hpool));
+    if (pool == NULL) return NULL;
+    /* 空闲槽位的第一个字存放空闲链表指针 */
+    harena_init(&pool->arena,
+                block_size < sizeof(void*) ? (uint32_t)sizeof(void*) : block_size, allocator);
+    pool->used = 0;
+    pool->block_size = block_size;
+#if HLIBC_USE_THREADS
+    pthread_mutex_init(&pool->lock, NULL);
+#endif
+    return pool;
+}
+
+void hpool_destroy(hpool_ptr_t pool)
+{
+    hallocator_t allocator = pool->arena.allocator;
+#if HLIBC_USE_THREADS
+    pthread_mutex_destroy(&pool->lock);
+#endif
+    harena_release(&pool->arena);
+    hallocator_free(&allocator, pool, sizeof(struct hpool));
+}
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+/* ==================== 静态分配实现 ==================== */
+
+hpool_ptr_t hpool_create_static(void* buffer, uint32_t buffer_size, uint32_t block_size)
+{
+    if (buffer == NULL || block_size == 0) return NULL;
+
+    /* 未对齐的 buffer 先跳过开头的若干字节 */
+    uint8_t* base = (uint8_t*)HLIBC_ALIGN_UP((uintptr_t)buffer, HLIBC_STATIC_ALIGN);
+    uint32_t skip = (uint32_t)(base - (uint8_t*)buffer);
+    uint32_t header_size = HLIBC_ALIGN_UP(sizeof(struct hpool), HLIBC_STATIC_ALIGN);
+    uint32_t stride = (uint32_t)HPOOL_BLOCK_STRIDE(block_size);
+    if (buffer_size < skip + header_size + stride) return NULL;
+
+    hpool_ptr_t pool = (hpool_ptr_t)base;
+    hpool_region_init(&pool->region, base + header_size, stride,
+                      (buffer_size - skip - header_size) / stride);
+    pool->block_size = block_size;
+#if HLIBC_USE_THREADS
+    pthread_mutex_init(&pool->lock, NULL);
+#endif
+    return pool;
+}
+
+void hpool_destroy_static(hpool_ptr_t pool)
+{
+    if (pool == NULL) return;
+    /* 静态分配不释放内存，只重置状态 */
+    hpool_clear(pool);
+#if HLIBC_USE_THREADS
+    pthread_mutex_destroy(&pool->lock);
+#endif
+}
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+void* hpool_alloc(hpool_ptr_t pool)
+{
+    return pool_take(pool);
+}
+
+void hpool_free(hpool_ptr_t pool, void* block)
+{
+    if (block == NULL) return;
+    pool_give(pool, block);
+}
+
+void hpool_clear(hpool_ptr_t pool)
+{
+#if HLIBC_USE_STATIC_ALLOC == 0
+    harena_release(&pool->arena);
+    pool->used = 0;
+#else
+    hpool_region_reset(&pool->region);
+#endif
+}
+
+uint32_t hpool_block_size(hpool_ptr_t pool)
+{
+    return pool->block_size;
+}
+
+uint32_t hpool_used(hpool_ptr_t pool)
+{
+#if HLIBC_USE_STATIC_ALLOC == 0
+    return pool->used;
+#else
+    return pool->region.used;
+#endif
+}
+
+#if HLIBC_USE_STATIC_ALLOC
+uint32_t hpool_capacity(hpool_ptr_t pool)
+{
+    return pool->region.capacity;
+}
+
+bool hpool_owns(hpool_ptr_t pool, const void* block)
+{
+    return hpool_region_owns(&pool->region, block);
+}
+#endif
+
+#if HLIBC_USE_THREADS
+/*=====================
+ * 每线程弹匣
+ *====================*/
+
+void hpool_magazine_init(hpool_magazine_t* mag, hpool_ptr_t pool)
+{
+    mag->pool = pool;
+    mag->count = 0;
+}
+
+void* hpool_magazine_refill(hpool_magazine_t* mag)
+{
+    hpool_ptr_t pool = mag->pool;
+    pthread_mutex_lock(&pool->lock);
+    /* 一次取半个弹匣，其中一块直接返回 */
+    void* block = pool_take(pool);
+    while (block != NULL && mag->count < MAGAZINE_BATCH - 1u) {
+        void* extra = pool_take(pool);
+        if (extra == NULL) break;
+        mag->blocks[mag->count++] = extra;
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return block;
+}
+
+void hpool_magazine_spill(hpool_magazine_t* mag, void* block)
+{
+    hpool_ptr_t pool = mag->pool;
+    pthread_mutex_lock(&pool->lock);
+    /* 归还最早放入的一半，最近释放的块仍留在弹匣中 */
+    for (uint32_t i = 0; i < MAGAZINE_BATCH; ++i) pool_give(pool, mag->blocks[i]);
+    pthread_mutex_unlock(&pool->lock);
+    mag->count -= MAGAZINE_BATCH;
+    for (uint32_t i = 0; i < mag->count; ++i) mag->blocks[i] = mag->blocks[i + MAGAZINE_BATCH];
+    mag->blocks[mag->count++] = block;
+}
+
+void hpool_magazine_flush(hpool_magazine_t* mag)
+{
+    if (mag->count == 0) return;
+    hpool_ptr_t pool = mag->pool;
+    pthread_mutex_lock(&pool->lock);
+    while (mag->count != 0) pool_give(pool, mag->blocks[--mag->count]);
+    pthread_mutex_unlock(&pool->lock);
+}
+#endif /* HLIBC_USE_THREADS */
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void* pool_take(hpool_ptr_t pool)
+{
+#if HLIBC_USE_STATIC_ALLOC == 0
+    void* block = harena_alloc(&pool->arena);
+    if (block != NULL) ++pool->used;
+    return block;
+#else
+    return hpool_region_alloc(&pool->region);
+#endif
+}
+
+static void pool_give(hpool_ptr_t pool, void* block)
+{
+#if HLIBC_USE_STATIC_ALLOC == 0
+    harena_free(&pool->arena, block);
+    --pool->used;
+#else
+    hpool_region_free(&pool->region, block);
+#endif
+}
@@ -0,0 +1,329 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/pool/hpool.h
+ * @Description: 定长对象池：O(1) 申请/释放固定大小的内存块，可选每线程弹匣
+ * @other: None
+ */
+#ifndef __HLIBC_HPOOL_H__
+#define __HLIBC_HPOOL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../common/hcommon.h"
+#include "../common/hlibc_config.h"
+
+#if HLIBC_USE_THREADS
+#include <pthread.h>
+#endif
+
+/*********************
+ *      MACROS
+ *********************/
+
+/*
+ * 块的步长：至少放得下空闲链表指针，并按 HLIBC_STATIC_ALIGN 对齐，
+ * 静态分配时每个块都从该粒度的边界开始
+ */
+#define HPOOL_BLOCK_STRIDE(block_size)                                    \
+  HLIBC_ALIGN_UP((size_t)(block_size) < sizeof(void*) ? sizeof(void*)    \
+                                                      : (size_t)(block_size), \
+                 HLIBC_STATIC_ALIGN)
+
+/*
+ * 静态分配结构体大小（精确值，hpool.c 中用 _Static_assert 校验）
+ */
+#define HPOOL_STRUCT_SIZE sizeof(hpool_static_layout_t)
+
+/**
+ * 计算静态对象池所需的 buffer 大小
+ * buffer 按 HLIBC_STATIC_ALIGN 对齐时恰好容纳 count 个块（HPOOL_DEFINE_STATIC 会自动对齐）
+ * @param type 块中存放的数据类型
+ * @param count 块的个数
+ *
+ * 内存布局: [hpool结构体][对齐填充][块数组]
+ */
+#define HPOOL_CALC_BUFFER_SIZE(type, count) HPOOL_BUFFER_SIZE(sizeof(type), count)
+
+/* 同上，块大小以字节数给出 */
+#define HPOOL_BUFFER_SIZE(block_size, count)                    \
+  (HLIBC_ALIGN_UP(HPOOL_STRUCT_SIZE, HLIBC_STATIC_ALIGN) +      \
+   (size_t)(count) * HPOOL_BLOCK_STRIDE(block_size))
+
+/**
+ * 定义一个静态对象池（便捷宏）
+ * @param name 变量名
+ * @param type 块中存放的数据类型
+ * @param count 块的个数
+ *
+ * 使用示例:
+ *   HPOOL_DEFINE_STATIC(msg_pool, struct message, 32);
+ *   struct message* msg = hpool_alloc(msg_pool);
+ */
+#define HPOOL_DEFINE_STATIC(name, type, count)                                  \
+  HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static                                      \
+      uint8_t name##_buffer[HPOOL_CALC_BUFFER_SIZE(type, count)];               \
+  hpool_ptr_t name = hpool_create_static(name##_buffer, sizeof(name##_buffer), sizeof(type))
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct hpool* hpool_ptr_t;
+
+/*
+ * 定长块区域：一段连续内存中的 capacity 个块，未用过的块按顺序切出（bump），
+ * 释放的块挂入单向空闲链表，链接指针存放在块的起始位置。
+ * hpool 的静态模式以及 hbtree/htimer_wheel 的静态节点池都嵌入它；
+ * 本身不加锁，不检查重复释放。
+ */
+typedef struct hpool_region {
+    uint8_t* base;            /* 第一个块 */
+    void* free_list;          /* 已释放的块 */
+    uint32_t stride;          /* 相邻两个块的间距 */
+    uint32_t capacity;        /* 块的总数 */
+    uint32_t bump;            /* 从未使用过的第一个块的下标 */
+    uint32_t used;            /* 已申请未释放的块数 */
+} hpool_region_t;
+
+/*
+ * 静态分配模式下 struct hpool 的布局镜像，仅用于在编译期得到精确大小，
+ * 字段必须与 hpool.c 保持一致
+ */
+typedef struct {
+    hpool_region_t region_;
+    uint32_t block_size_;
+#if HLIBC_USE_THREADS
+    pthread_mutex_t lock_;
+#endif
+} hpool_static_layout_t;
+
+#if HLIBC_USE_THREADS
+/*
+ * 每线程弹匣：线程私有的一小组空闲块。申请与释放先在弹匣内完成，不加锁；
+ * 弹匣空了一次从池中取半个弹匣，满了一次归还半个弹匣，只有这两步持有池的锁。
+ * 弹匣由调用者存放（线程本地变量或线程的上下文结构），只能由一个线程使用。
+ */
+typedef struct {
+    hpool_ptr_t pool;
+    uint32_t count;
+    void* blocks[HLIBC_POOL_MAGAZINE_SIZE];
+} hpool_magazine_t;
+#endif
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/*=====================
+ * 定长块区域
+ *====================*/
+
+/**
+ * 初始化区域
+ * @param region 区域
+ * @param base 第一个块的地址，调用者保证对齐
+ * @param stride 相邻两个块的间距，不小于 sizeof(void*)
+ * @param capacity 块的总数
+ */
+static inline void hpool_region_init(hpool_region_t* region, void* base, uint32_t stride,
+                                     uint32_t capacity)
+{
+    region->base = (uint8_t*)base;
+    region->free_list = NULL;
+    region->stride = stride;
+    region->capacity = capacity;
+    region->bump = 0;
+    region->used = 0;
+}
+
+/* 回收全部块，之前申请的块全部失效 */
+static inline void hpool_region_reset(hpool_region_t* region)
+{
+    region->free_list = NULL;
+    region->bump = 0;
+    region->used = 0;
+}
+
+/**
+ * 申请一个块
+ * @return 块指针，区域已满时返回 NULL
+ */
+static inline void* hpool_region_alloc(hpool_region_t* region)
+{
+    void* block = region->free_list;
+    if (block != NULL) {
+        region->free_list = *(void**)block;
+    } else if (region->bump < region->capacity) {
+        block = region->base + (size_t)region->bump++ * region->stride;
+    } else {
+        return NULL;
+    }
+    ++region->used;
+    return block;
+}
+
+/* 归还一个块（会覆盖块的第一个指针大小的字节） */
+static inline void hpool_region_free(hpool_region_t* region, void* block)
+{
+    *(void**)block = region->free_list;
+    region->free_list = block;
+    --region->used;
+}
+
+/* 剩余可申请的块数 */
+static inline uint32_t hpool_region_available(const hpool_region_t* region)
+{
+    return region->capacity - region->used;
+}
+
+/* 块是否位于区域内（不区分已申请与空闲） */
+static inline bool hpool_region_owns(const hpool_region_t* region, const void* block)
+{
+    uintptr_t offset = (uintptr_t)block - (uintptr_t)region->base;
+    return offset < (uintptr_t)region->capacity * region->stride && offset % region->stride == 0;
+}
+
+/*=====================
+ * 对象池
+ *====================*/
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/**
+ * 创建一个对象池（动态分配），块按需从逐步增大的 slab 中切出，slab 在 clear/destroy 时整体归还
+ * @param block_size 块的字节数
+ * @return 返回新创建的对象池，失败返回 NULL
+ */
+extern hpool_ptr_t hpool_create(uint32_t block_size);
+
+/**
+ * 创建一个对象池（动态分配），slab 通过给定的分配器申请与归还
+ * @param block_size 块的字节数
+ * @param allocator 分配器，NULL 表示使用 malloc/free
+ * @return 返回新创建的对象池，失败返回 NULL
+ */
+extern hpool_ptr_t hpool_create_with_allocator(uint32_t block_size,
+                                               const hallocator_t* allocator);
+
+/**
+ * 删除给定的对象池（动态分配版本），尚未归还的块一并失效
+ * @param pool 一个由 `hpool_create` 返回的对象池
+ */
+extern void hpool_destroy(hpool_ptr_t pool);
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+
+/**
+ * 在调用者提供的 buffer 上创建对象池，块全部取自 buffer
+ * @param buffer 用户提供的内存缓冲区
+ * @param buffer_size 缓冲区大小（使用 HPOOL_BUFFER_SIZE 宏计算）
+ * @param block_size 块的字节数
+ * @return 返回对象池指针，失败返回 NULL
+ */
+extern hpool_ptr_t hpool_create_static(void* buffer, uint32_t buffer_size, uint32_t block_size);
+
+/**
+ * 销毁静态分配的对象池（仅清理内容，不释放内存）
+ * @param pool 一个由 `hpool_create_static` 返回的对象池
+ */
+extern void hpool_destroy_static(hpool_ptr_t pool);
+
+/* 兼容性宏定义 */
+#define hpool_create(block_size) ((void)(block_size), (hpool_ptr_t)NULL) /* 静态模式下禁用 */
+#define hpool_create_with_allocator(block_size, allocator) \
+  ((void)(block_size), (void)(allocator), (hpool_ptr_t)NULL) /* 静态模式下禁用 */
+#define hpool_destroy(pool) hpool_destroy_static(pool)
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+/**
+ * 申请一个块，内容未初始化
+ * @return 块指针（按 HLIBC_STATIC_ALIGN 对齐；动态分配时按 max_align_t 对齐），
+ *         池已满（静态分配）或内存不足（动态分配）时返回 NULL
+ */
+extern void* hpool_alloc(hpool_ptr_t pool);
+
+/**
+ * 归还一个由本池申请的块
+ */
+extern void hpool_free(hpool_ptr_t pool, void* block);
+
+/**
+ * 回收全部块，之前申请的块全部失效；动态分配时归还全部 slab
+ */
+extern void hpool_clear(hpool_ptr_t pool);
+
+/* 块的字节数（创建时给定的值） */
+extern uint32_t hpool_block_size(hpool_ptr_t pool);
+
+/* 已申请未归还的块数，弹匣中缓存的块也计算在内 */
+extern uint32_t hpool_used(hpool_ptr_t pool);
+
+#if HLIBC_USE_STATIC_ALLOC
+/**
+ * 获取块的总数（仅静态分配模式）
+ */
+extern uint32_t hpool_capacity(hpool_ptr_t pool);
+
+/**
+ * 块是否属于本池（仅静态分配模式）
+ */
+extern bool hpool_owns(hpool_ptr_t pool, const void* block);
+#endif
+
+#if HLIBC_USE_THREADS
+/*=====================
+ * 每线程弹匣
+ *====================*/
+
+/*
+ * hpool_alloc/hpool_free 与其他容器一样不加锁；多个线程共用一个池时，每个线程各持有一个弹匣，
+ * 全部申请与释放都经由弹匣完成。一个线程申请的块可以由另一个线程的弹匣归还。
+ */
+
+/**
+ * 初始化弹匣，初始为空
+ */
+extern void hpool_magazine_init(hpool_magazine_t* mag, hpool_ptr_t pool);
+
+/* 慢路径：弹匣空时从池中补充 / 弹匣满时归还一半 */
+extern void* hpool_magazine_refill(hpool_magazine_t* mag);
+extern void hpool_magazine_spill(hpool_magazine_t* mag, void* block);
+
+/**
+ * 经由弹匣申请一个块
+ * @return 块指针，池中也没有可用的块时返回 NULL
+ */
+static inline void* hpool_magazine_alloc(hpool_magazine_t* mag)
+{
+    if (mag->count != 0) return mag->blocks[--mag->count];
+    return hpool_magazine_refill(mag);
+}
+
+/**
+ * 经由弹匣归还一个块
+ */
+static inline void hpool_magazine_free(hpool_magazine_t* mag, void* block)
+{
+    if (mag->count < HLIBC_POOL_MAGAZINE_SIZE) {
+        mag->blocks[mag->count++] = block;
+        return;
+    }
+    hpool_magazine_spill(mag, block);
+}
+
+/**
+ * 把弹匣中的块全部归还给池，线程退出或不再使用弹匣前调用
+ */
+extern void hpool_magazine_flush(hpool_magazine_t* mag);
+#endif /* HLIBC_USE_THREADS */
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __HLIBC_HPOOL_H__ */
@@ -0,0 +1,432 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/queue/hcqueue.c
+ * @Description: 线程安全队列（双锁 Michael-Scott 队列 / 双锁环形队列）
+ * @other: None
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "hcqueue.h"
+
+#if HLIBC_USE_THREADS
+#include "../common/hwait.h"
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+#include <stdlib.h>
+#include "../common/harena.h"
+#endif
+
+/*********************
+ *      MACROS
+ *********************/
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/* 节点数据在槽位中的偏移 */
+#define CQUEUE_PAYLOAD_OFFSET   HARENA_PAYLOAD_OFFSET(sizeof(cqueue_node_t))
+#define CQUEUE_DATA(node)       ((uint8_t*)(node) + CQUEUE_PAYLOAD_OFFSET)
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+#if HLIBC_USE_STATIC_ALLOC == 0
+/*
+ * next 会在队列为空时被生产者写、消费者读（两者持有不同的锁），因此必须是原子的。
+ * 节点在回收链表与空闲链表中时同样用 next 串联。
+ */
+typedef struct cqueue_node {
+    _Atomic(struct cqueue_node*) next;
+} cqueue_node_t;
+
+struct hcqueue {
+    uint32_t type_size;
+
+    /* 消费者侧，只在 consumer.lock 内修改（recycled 除外） */
+    _Alignas(HLIBC_CACHE_LINE_SIZE) struct {
+        pthread_mutex_t lock;
+        _Atomic(cqueue_node_t*) head;   /* 哨兵节点，生产者会读取它判断队列是否由空变为非空 */
+        /* 已出队、等待生产者取走的节点：消费者用 CAS 压入，生产者用 exchange 整体取走，不加锁 */
+        _Atomic(cqueue_node_t*) recycled;
+    } consumer;
+
+    /* 生产者侧，只在 producer.lock 内访问 */
+    _Alignas(HLIBC_CACHE_LINE_SIZE) struct {
+        pthread_mutex_t lock;
+        cqueue_node_t* tail;
+        cqueue_node_t* free_list;       /* 生产者私有的空闲节点 */
+        harena_t arena;                 /* 所有节点的来源 */
+    } producer;
+
+    _Alignas(HLIBC_CACHE_LINE_SIZE) hwait_t not_empty;
+};
+#else
+/*
+ * 有界环形队列。head/tail 是 [0, 2*capacity) 内循环递增的位置，
+ * 这样 head == tail 表示空、相差 capacity 表示满，且任意 capacity 下都不会在回绕时打乱顺序。
+ * 槽位下标 = 位置 < capacity ? 位置 : 位置 - capacity。
+ */
+struct hcqueue {
+    uint32_t type_size;
+    uint32_t capacity;
+    uint8_t* data_pool;
+
+    _Alignas(HLIBC_CACHE_LINE_SIZE) struct {
+        pthread_mutex_t lock;
+        atomic_uint head;
+    } consumer;
+
+    _Alignas(HLIBC_CACHE_LINE_SIZE) struct {
+        pthread_mutex_t lock;
+        atomic_uint tail;
+    } producer;
+
+    _Alignas(HLIBC_CACHE_LINE_SIZE) hwait_t not_empty;
+    _Alignas(HLIBC_CACHE_LINE_SIZE) hwait_t not_full;
+};
+
+/* 头文件中的布局镜像必须与实际结构体一致 */
+_Static_assert(sizeof(struct hcqueue) == HCQUEUE_STRUCT_SIZE &&
+               _Alignof(struct hcqueue) == _Alignof(hcqueue_static_layout_t),
+               "hcqueue_static_layout_t does not match struct hcqueue");
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if HLIBC_USE_STATIC_ALLOC == 0
+static cqueue_node_t* acquire_node(hcqueue_ptr_t queue);
+#else
+static unsigned ring_next(hcqueue_ptr_t queue, unsigned pos);
+static unsigned ring_count(hcqueue_ptr_t queue, unsigned head, unsigned tail);
+static unsigned ring_slot(hcqueue_ptr_t queue, unsigned pos);
+#endif
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/* ==================== 动态分配实现 ==================== */
+
+hcqueue_ptr_t hcqueue_create(uint32_t type_size)
+{
+    if (type_size == 0) return NULL;
+    hcqueue_ptr_t queue = (hcqueue_ptr_t)aligned_alloc(HLIBC_CACHE_LINE_SIZE, sizeof(struct hcqueue));
+    if (queue == NULL) return NULL;
+    queue->type_size = type_size;
+    harena_init(&queue->producer.arena, CQUEUE_PAYLOAD_OFFSET + type_size, NULL);
+
+    cqueue_node_t* sentinel = (cqueue_node_t*)harena_alloc(&queue->producer.arena);
+    if (sentinel == NULL) {
+        free(queue);
+        return NULL;
+    }
+    atomic_init(&sentinel->next, NULL);
+    atomic_init(&queue->consumer.head, sentinel);
+    atomic_init(&queue->consumer.recycled, NULL);
+    queue->producer.tail = sentinel;
+    queue->producer.free_list = NULL;
+    pthread_mutex_init(&queue->consumer.lock, NULL);
+    pthread_mutex_init(&queue->producer.lock, NULL);
+    hwait_init(&queue->not_empty);
+    return queue;
+}
+
+void hcqueue_destroy(hcqueue_ptr_t queue)
+{
+    hwait_destroy(&queue->not_empty);
+    pthread_mutex_destroy(&queue->consumer.lock);
+    pthread_mutex_destroy(&queue->producer.lock);
+    harena_release(&queue->producer.arena);
+    free(queue);
+}
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+hlib_status_t hcqueue_push(hcqueue_ptr_t queue, hdata_ptr_t data_ptr,
+                           uint32_t data_size, copy_data_f copy_data)
+{
+    if (data_size != queue->type_size) return HLIB_ERROR;
+
+    pthread_mutex_lock(&queue->producer.lock);
+    cqueue_node_t* node = acquire_node(queue);
+    if (node == NULL) {
+        pthread_mutex_unlock(&queue->producer.lock);
+        return HLIB_ERROR;
+    }
+    if (copy_data != NULL)
+        copy_data(CQUEUE_DATA(node), data_ptr);
+    else
+        memcpy(CQUEUE_DATA(node), data_ptr, data_size);
+    atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+    /* release：消费者看到 next 时，数据一定已经写完 */
+    cqueue_node_t* prev = queue->producer.tail;
+    atomic_store_explicit(&prev->next, node, memory_order_release);
+    queue->producer.tail = node;
+    pthread_mutex_unlock(&queue->producer.lock);
+
+    /* 前驱仍是哨兵说明队列刚由空变为非空，只有这时才可能有消费者在睡眠 */
+    if (hwait_has_waiters(&queue->not_empty) &&
+        atomic_load_explicit(&queue->consumer.head, memory_order_relaxed) == prev)
+        hwait_notify(&queue->not_empty, false);
+    return HLIB_OK;
+}
+
+hlib_status_t hcqueue_pop(hcqueue_ptr_t queue, hdata_ptr_t out)
+{
+    pthread_mutex_lock(&queue->consumer.lock);
+    cqueue_node_t* sentinel = atomic_load_explicit(&queue->consumer.head, memory_order_relaxed);
+    cqueue_node_t* first = atomic_load_explicit(&sentinel->next, memory_order_acquire);
+    if (first == NULL) {
+        pthread_mutex_unlock(&queue->consumer.lock);
+        return HLIB_ERROR;
+    }
+    if (out != NULL) memcpy(out, CQUEUE_DATA(first), queue->type_size);
+    /* 出队的元素成为新的哨兵，旧哨兵进入回收链表 */
+    atomic_store_explicit(&queue->consumer.head, first, memory_order_relaxed);
+    /*
+     * 压入回收链表。压入者只有持有 consumer.lock 的消费者，生产者只会整体取走，
+     * 链表头不会在 CAS 期间变回原值，因此没有 ABA 问题
+     */
+    cqueue_node_t* recycled = atomic_load_explicit(&queue->consumer.recycled, memory_order_relaxed);
+    do {
+        atomic_store_explicit(&sentinel->next, recycled, memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(&queue->consumer.recycled, &recycled, sentinel,
+                                                    memory_order_release, memory_order_relaxed));
+    bool more = atomic_load_explicit(&first->next, memory_order_relaxed) != NULL;
+    pthread_mutex_unlock(&queue->consumer.lock);
+
+    /* 生产者每次空->非空只唤醒一个消费者，队列仍有数据时由它接力唤醒下一个 */
+    if (more && hwait_has_waiters(&queue->not_empty))
+        hwait_notify(&queue->not_empty, false);
+    return HLIB_OK;
+}
+
+hlib_status_t hcqueue_push_wait(hcqueue_ptr_t queue, hdata_ptr_t data_ptr,
+                                uint32_t data_size, copy_data_f copy_data,
+                                int32_t timeout_ms)
+{
+    (void)timeout_ms;
+    return hcqueue_push(queue, data_ptr, data_size, copy_data);
+}
+
+/*=======================
+ * Getter functions
+ *======================*/
+
+bool hcqueue_empty(hcqueue_ptr_t queue)
+{
+    pthread_mutex_lock(&queue->consumer.lock);
+    cqueue_node_t* sentinel = atomic_load_explicit(&queue->consumer.head, memory_order_relaxed);
+    bool empty = atomic_load_explicit(&sentinel->next, memory_order_acquire) == NULL;
+    pthread_mutex_unlock(&queue->consumer.lock);
+    return empty;
+}
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+/* ==================== 静态分配实现（双锁环形队列） ==================== */
+
+hcqueue_ptr_t hcqueue_create_static(void* buffer, uint32_t buffer_size,
+                                    uint32_t type_size)
+{
+    if (buffer == NULL || type_size == 0) return NULL;
+
+    /* 结构体按缓存行对齐，buffer 本身不要求对齐 */
+    uintptr_t start = (uintptr_t)HLIBC_ALIGN_UP((uintptr_t)buffer, HLIBC_CACHE_LINE_SIZE);
+    uint32_t header_size = (uint32_t)(start - (uintptr_t)buffer) + sizeof(struct hcqueue);
+    if (buffer_size <= header_size) return NULL;
+
+    uint32_t capacity = (buffer_size - header_size) / type_size;
+    if (capacity == 0 || capacity > (UINT32_MAX >> 1)) return NULL;
+
+    hcqueue_ptr_t queue = (hcqueue_ptr_t)start;
+    queue->type_size = type_size;
+    queue->capacity = capacity;
+    queue->data_pool = (uint8_t*)buffer + header_size;
+    pthread_mutex_init(&queue->consumer.lock, NULL);
+    pthread_mutex_init(&queue->producer.lock, NULL);
+    atomic_init(&queue->consumer.head, 0);
+    atomic_init(&queue->producer.tail, 0);
+    hwait_init(&queue->not_empty);
+    hwait_init(&queue->not_full);
+    return queue;
+}
+
+void hcqueue_destroy_static(hcqueue_ptr_t queue)
+{
+    if (queue == NULL) return;
+    hwait_destroy(&queue->not_empty);
+    hwait_destroy(&queue->not_full);
+    pthread_mutex_destroy(&queue->consumer.lock);
+    pthread_mutex_destroy(&queue->producer.lock);
+}
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+hlib_status_t hcqueue_push(hcqueue_ptr_t queue, hdata_ptr_t data_ptr,
+                           uint32_t data_size, copy_data_f copy_data)
+{
+    if (data_size != queue->type_size) return HLIB_ERROR;
+
+    pthread_mutex_lock(&queue->producer.lock);
+    unsigned tail = atomic_load_explicit(&queue->producer.tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&queue->consumer.head, memory_order_acquire);
+    if (ring_count(queue, head, tail) >= queue->capacity) {
+        pthread_mutex_unlock(&queue->producer.lock);
+        return HLIB_OVERFLOW;
+    }
+    uint8_t* dest = queue->data_pool + (size_t)ring_slot(queue, tail) * queue->type_size;
+    if (copy_data != NULL)
+        copy_data(dest, data_ptr);
+    else
+        memcpy(dest, data_ptr, data_size);
+    unsigned next = ring_next(queue, tail);
+    atomic_store_explicit(&queue->producer.tail, next, memory_order_release);
+    bool room = ring_count(queue, head, next) < queue->capacity;
+    pthread_mutex_unlock(&queue->producer.lock);
+
+    /* 写入前队列为空（消费者尚未越过 tail）才唤醒消费者 */
+    if (hwait_has_waiters(&queue->not_empty) &&
+        atomic_load_explicit(&queue->consumer.head, memory_order_relaxed) == tail)
+        hwait_notify(&queue->not_empty, false);
+    /* 仍有空位时接力唤醒下一个等待的生产者 */
+    if (room && hwait_has_waiters(&queue->not_full))
+        hwait_notify(&queue->not_full, false);
+    return HLIB_OK;
+}
+
+hlib_status_t hcqueue_pop(hcqueue_ptr_t queue, hdata_ptr_t out)
+{
+    pthread_mutex_lock(&queue->consumer.lock);
+    unsigned head = atomic_load_explicit(&queue->consumer.head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&queue->producer.tail, memory_order_acquire);
+    if (tail == head) {
+        pthread_mutex_unlock(&queue->consumer.lock);
+        return HLIB_ERROR;
+    }
+    if (out != NULL)
+        memcpy(out, queue->data_pool + (size_t)ring_slot(queue, head) * queue->type_size,
+               queue->type_size);
+    unsigned next = ring_next(queue, head);
+    atomic_store_explicit(&queue->consumer.head, next, memory_order_release);
+    bool more = tail != next;
+    pthread_mutex_unlock(&queue->consumer.lock);
+
+    /* 取出前队列已满才唤醒生产者 */
+    if (hwait_has_waiters(&queue->not_full) &&
+        ring_count(queue, head, atomic_load_explicit(&queue->producer.tail,
+                                                     memory_order_relaxed)) >= queue->capacity)
+        hwait_notify(&queue->not_full, false);
+    if (more && hwait_has_waiters(&queue->not_empty))
+        hwait_notify(&queue->not_empty, false);
+    return HLIB_OK;
+}
+
+hlib_status_t hcqueue_push_wait(hcqueue_ptr_t queue, hdata_ptr_t data_ptr,
+                                uint32_t data_size, copy_data_f copy_data,
+                                int32_t timeout_ms)
+{
+    hlib_status_t ret = hcqueue_push(queue, data_ptr, data_size, copy_data);
+    if (ret != HLIB_OVERFLOW || timeout_ms == 0) return ret == HLIB_OVERFLOW ? HLIB_TIMEOUT : ret;
+
+    uint64_t deadline = hwait_deadline(timeout_ms);
+    for (;;) {
+        unsigned seq = hwait_prepare(&queue->not_full);
+        ret = hcqueue_push(queue, data_ptr, data_size, copy_data);
+        if (ret != HLIB_OVERFLOW) {
+            hwait_cancel(&queue->not_full);
+            return ret;
+        }
+        hlib_status_t waited = hwait_wait(&queue->not_full, seq, deadline);
+        hwait_cancel(&queue->not_full);
+        if (waited == HLIB_TIMEOUT) {
+            ret = hcqueue_push(queue, data_ptr, data_size, copy_data);
+            return ret == HLIB_OVERFLOW ? HLIB_TIMEOUT : ret;
+        }
+    }
+}
+
+/*=======================
+ * Getter functions
+ *======================*/
+
+bool hcqueue_empty(hcqueue_ptr_t queue)
+{
+    return atomic_load(&queue->producer.tail) == atomic_load(&queue->consumer.head);
+}
+
+uint32_t hcqueue_capacity(hcqueue_ptr_t queue)
+{
+    return queue->capacity;
+}
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+hlib_status_t hcqueue_pop_wait(hcqueue_ptr_t queue, hdata_ptr_t out, int32_t timeout_ms)
+{
+    if (hcqueue_pop(queue, out) == HLIB_OK) return HLIB_OK;
+    if (timeout_ms == 0) return HLIB_TIMEOUT;
+
+    uint64_t deadline = hwait_deadline(timeout_ms);
+    for (;;) {
+        /* 先登记再检查，生产者要么看到登记，要么它的数据被这次检查取到 */
+        unsigned seq = hwait_prepare(&queue->not_empty);
+        if (hcqueue_pop(queue, out) == HLIB_OK) {
+            hwait_cancel(&queue->not_empty);
+            return HLIB_OK;
+        }
+        hlib_status_t waited = hwait_wait(&queue->not_empty, seq, deadline);
+        hwait_cancel(&queue->not_empty);
+        if (waited == HLIB_TIMEOUT)
+            return hcqueue_pop(queue, out) == HLIB_OK ? HLIB_OK : HLIB_TIMEOUT;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/*
+ * 在 producer.lock 内取得一个空闲节点：先用私有空闲链表，
+ * 用尽时用一次 exchange 取走全部回收节点（不获取 consumer.lock），最后才向节点池申请。
+ */
+static cqueue_node_t* acquire_node(hcqueue_ptr_t queue)
+{
+    cqueue_node_t* node = queue->producer.free_list;
+    if (node == NULL) {
+        /* acquire：与消费者压入时的 release 配对，之后读取的 next 是完整的链表 */
+        node = atomic_exchange_explicit(&queue->consumer.recycled, NULL, memory_order_acquire);
+        if (node == NULL) return (cqueue_node_t*)harena_alloc(&queue->producer.arena);
+    }
+    queue->producer.free_list = atomic_load_explicit(&node->next, memory_order_relaxed);
+    return node;
+}
+#else
+static unsigned ring_next(hcqueue_ptr_t queue, unsigned pos)
+{
+    return pos + 1 == 2 * queue->capacity ? 0 : pos + 1;
+}
+
+static unsigned ring_count(hcqueue_ptr_t queue, unsigned head, unsigned tail)
+{
+    return tail >= head ? tail - head : tail + 2 * queue->capacity - head;
+}
+
+static unsigned ring_slot(hcqueue_ptr_t queue, unsigned pos)
+{
+    return pos < queue->capacity ? pos : pos - queue->capacity;
+}
+#endif
+
+#endif /* HLIBC_USE_THREADS */
@@ -0,0 +1,193 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/queue/hcqueue.h
+ * @Description: 线程安全队列（双锁 Michael-Scott 队列 / 双锁环形队列）
+ * @other: None
+ */
+#ifndef __HLIBC_HCQUEUE_H__
+#define __HLIBC_HCQUEUE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../common/hcommon.h"
+#include "../common/hlibc_config.h"
+
+#if HLIBC_USE_THREADS
+#include <pthread.h>
+#endif
+
+/*********************
+ *      MACROS
+ *********************/
+
+/*
+ * 静态分配结构体大小（精确值，由 hcqueue_static_layout_t 得出，hcqueue.c 中用 _Static_assert 校验）
+ */
+#define HCQUEUE_STRUCT_SIZE sizeof(hcqueue_static_layout_t)
+
+/**
+ * 计算静态 hcqueue 所需的 buffer 大小
+ * buffer 按缓存行对齐时恰好容纳 capacity 个元素，未对齐时容量相应减少
+ * @param type 数据类型
+ * @param capacity 容器最大容量
+ */
+#define HCQUEUE_CALC_BUFFER_SIZE(type, capacity) \
+  (HCQUEUE_STRUCT_SIZE + (capacity) * sizeof(type))
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct hcqueue* hcqueue_ptr_t;
+
+#if HLIBC_USE_THREADS
+/*
+ * hwait_t 的布局镜像（不包含 hwait.h，使本头文件在 C++ 中也可用），字段必须与 hwait.h 保持一致
+ */
+typedef struct {
+  unsigned seq_;
+  unsigned waiters_;
+#if !defined(__linux__) || defined(HWAIT_USE_CONDVAR)
+  pthread_mutex_t lock_;
+  pthread_cond_t cond_;
+#endif
+} hcqueue_wait_layout_t;
+
+/*
+ * 静态分配模式下 hcqueue 结构体的布局镜像，字段必须与 hcqueue.c 保持一致
+ */
+typedef struct {
+  uint32_t type_size_;
+  uint32_t capacity_;
+  void* data_pool_;
+  HLIBC_ALIGNAS(HLIBC_CACHE_LINE_SIZE) struct {
+    pthread_mutex_t lock_;
+    unsigned head_;
+  } consumer_;
+  HLIBC_ALIGNAS(HLIBC_CACHE_LINE_SIZE) struct {
+    pthread_mutex_t lock_;
+    unsigned tail_;
+  } producer_;
+  HLIBC_ALIGNAS(HLIBC_CACHE_LINE_SIZE) hcqueue_wait_layout_t not_empty_;
+  HLIBC_ALIGNAS(HLIBC_CACHE_LINE_SIZE) hcqueue_wait_layout_t not_full_;
+} hcqueue_static_layout_t;
+#endif
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+#if HLIBC_USE_THREADS
+
+/*
+ * 队头、队尾各有一把锁，且位于不同的缓存行：生产者之间、消费者之间互斥，生产者从不获取消费者的锁，反之亦然。
+ * 动态分配：与 hqueue 相同，队头始终是一个哨兵节点，无容量上限。出队的节点由消费者挂入回收链表，
+ * 生产者在自己的空闲链表用尽时一次性取走，因此稳定运行时不会调用 malloc/free。
+ * 静态分配：有界环形队列，满时 push 返回 HLIB_OVERFLOW。
+ * 阻塞接口只在 空->非空、满->非满 时唤醒等待者，没有等待者时不产生系统调用。
+ */
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/**
+ * 创建一个线程安全队列（动态分配，无容量上限）
+ * @param type_size 装入容器的数据类型的大小
+ * @return 返回新创建的容器，内存不足时返回 NULL
+ */
+extern hcqueue_ptr_t hcqueue_create(uint32_t type_size);
+
+/**
+ * 删除线程安全队列，调用时不能有其他线程仍在访问
+ * @param queue 一个由 `hcqueue_create` 返回的容器
+ */
+extern void hcqueue_destroy(hcqueue_ptr_t queue);
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+
+/**
+ * 创建一个静态分配的线程安全队列（有界环形队列）
+ * @param buffer 用户提供的内存缓冲区，无需对齐（按缓存行对齐时没有浪费）
+ * @param buffer_size 缓冲区大小（使用 HCQUEUE_CALC_BUFFER_SIZE 宏计算）
+ * @param type_size 装入容器的数据类型的大小
+ * @return 返回容器指针（位于 buffer 内部，按缓存行对齐），失败返回 NULL
+ */
+extern hcqueue_ptr_t hcqueue_create_static(void* buffer, uint32_t buffer_size,
+                                           uint32_t type_size);
+
+/**
+ * 销毁静态分配的线程安全队列，调用时不能有其他线程仍在访问
+ * @param queue 一个由 `hcqueue_create_static` 返回的容器
+ */
+extern void hcqueue_destroy_static(hcqueue_ptr_t queue);
+
+/**
+ * 获取队列的最大容量（仅静态分配模式）
+ */
+extern uint32_t hcqueue_capacity(hcqueue_ptr_t queue);
+
+/* 兼容性宏定义 */
+#define hcqueue_create(type_size) ((void)(type_size), (hcqueue_ptr_t)NULL)
+#define hcqueue_destroy(queue) hcqueue_destroy_static(queue)
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+/**
+ * 入队，可被多个生产者并发调用
+ * @param queue 容器
+ * @param data_ptr 数据指针
+ * @param data_size 数据大小，必须等于创建时的 type_size
+ * @param copy_data 自定义复制函数，NULL 时使用 memcpy；在队尾锁内调用，应尽量轻量
+ * @return HLIB_OK 成功；HLIB_ERROR 数据大小不符或内存不足；HLIB_OVERFLOW 队列已满（静态分配）
+ */
+extern hlib_status_t hcqueue_push(hcqueue_ptr_t queue, hdata_ptr_t data_ptr,
+                                  uint32_t data_size, copy_data_f copy_data);
+
+/**
+ * 阻塞入队：队列已满时等待消费者取走数据。动态分配的队列没有容量上限，等同于 `hcqueue_push`
+ * @param timeout_ms 最长等待毫秒数，0 表示不等待，小于 0 表示一直等待
+ * @return HLIB_OK 成功；HLIB_TIMEOUT 超时仍然已满；HLIB_ERROR 数据大小不符或内存不足
+ */
+extern hlib_status_t hcqueue_push_wait(hcqueue_ptr_t queue, hdata_ptr_t data_ptr,
+                                       uint32_t data_size, copy_data_f copy_data,
+                                       int32_t timeout_ms);
+
+/**
+ * 出队，可被多个消费者并发调用
+ * 队列中的数据按字节复制到 out，指针数据的所有权随之转移给调用者。
+ * @param queue 容器
+ * @param out 接收数据的缓冲区（type_size 字节），为 NULL 时直接丢弃
+ * @return HLIB_OK 成功；HLIB_ERROR 队列为空
+ */
+extern hlib_status_t hcqueue_pop(hcqueue_ptr_t queue, hdata_ptr_t out);
+
+/**
+ * 阻塞出队：队列为空时睡眠等待生产者（Linux 上为 futex，其他平台为条件变量）
+ * @param timeout_ms 最长等待毫秒数，0 表示不等待，小于 0 表示一直等待
+ * @return HLIB_OK 成功；HLIB_TIMEOUT 超时仍然为空
+ */
+extern hlib_status_t hcqueue_pop_wait(hcqueue_ptr_t queue, hdata_ptr_t out, int32_t timeout_ms);
+
+/*=======================
+ * Getter functions
+ *======================*/
+
+/**
+ * 队列是否为空。并发场景下结果仅代表调用瞬间的状态
+ */
+extern bool hcqueue_empty(hcqueue_ptr_t queue);
+
+#endif /* HLIBC_USE_THREADS */
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __HLIBC_HCQUEUE_H__ */
@@ -15,6 +15,9 @@
 
 #if HLIBC_USE_STATIC_ALLOC == 0
 #include <stdlib.h>
+#include "../common/harena.h"
+#else
+#include <stdatomic.h>
 #endif
 
 /*********************
@@ -28,8 +31,28 @@
 typedef struct hnode queue_node_t;
 struct hqueue {
     uint32_t size;
+    uint32_t type_size;
     queue_node_t *front, *rear;
+    harena_t arena;          /* 节点与数据共用的分块节点池 */
+#if HLIBC_ENABLE_STATS
+    hlibc_stats_t stats;
+#endif
+    bool external;           /* 结构体位于调用者提供的 buffer 中，destroy 时不释放 */
+    queue_node_t sentinel;   /* 哨兵节点，其数据紧跟在结构体之后 */
 };
+
+/* 节点数据在槽位中的偏移 */
+#define QUEUE_PAYLOAD_OFFSET    HARENA_PAYLOAD_OFFSET(sizeof(queue_node_t))
+/* 哨兵数据在结构体之后的偏移 */
+#define QUEUE_HEADER_SIZE       HLIBC_ALIGN_UP(sizeof(struct hqueue), HARENA_ALIGN)
+
+/* 头文件中的布局镜像与槽位大小必须与实际一致 */
+_Static_assert(sizeof(struct hqueue) == HQUEUE_INLINE_STRUCT_SIZE &&
+               _Alignof(struct hqueue) == _Alignof(hqueue_inline_layout_t),
+               "hqueue_inline_layout_t does not match struct hqueue");
+_Static_assert(HQUEUE_INLINE_SLOT_SIZE(1) ==
+                   HLIBC_ALIGN_UP(QUEUE_PAYLOAD_OFFSET + 1, HARENA_ALIGN),
+               "HQUEUE_INLINE_SLOT_SIZE does not match the arena slot size");
 #else
 /* 静态分配使用环形队列实现 */
 struct hqueue {
@@ -38,8 +61,51 @@ struct hqueue {
   uint32_t type_size;
   uint32_t head;      /* 队头索引 */
   uint32_t tail;      /* 队尾索引 */
+  uint32_t dropped;   /* 覆盖模式下丢弃的元素数 */
+  bool overwrite;     /* 满时覆盖最旧的元素 */
+  atomic_uint seq;      /* 已发布的 push 序号，供快照读取 */
+  atomic_uint seq_base; /* 上次 clear 时的序号 */
+  uint32_t seq_limit;   /* 序号回绕点，capacity 的整数倍，保证 seq % capacity 与 tail 一致 */
   uint8_t* data_pool; /* 数据存储池 */
+  struct hqueue_segment* segments; /* 追加的缓冲区，按追加顺序排列 */
+  struct hqueue_slot* spill_head;  /* 暂存元素中最旧的一个 */
+  struct hqueue_slot* spill_tail;  /* 暂存元素中最新的一个 */
+  uint32_t spill_size;      /* 暂存元素个数，非 0 时环形缓冲区一定是满的 */
+  uint32_t extra_capacity;  /* 追加缓冲区的总容量 */
+#if HLIBC_ENABLE_STATS
+  hlibc_stats_t stats;
+#endif
 };
+
+/* 追加缓冲区中的槽位：链接指针之后紧跟数据，暂存元素按 push 顺序串成单链表 */
+struct hqueue_slot {
+  struct hqueue_slot* next;
+};
+
+/* 追加缓冲区的头部，位于调用者提供的 buffer 开头 */
+struct hqueue_segment {
+  struct hqueue_segment* next;
+  void* buffer;             /* 追加时传入的地址，取回时比对 */
+  uint8_t* slots;           /* 槽位数组 */
+  struct hqueue_slot* free_list; /* 已释放的槽位 */
+  uint32_t capacity;
+  uint32_t slot_bump;       /* 从未使用过的第一个槽位下标 */
+  uint32_t used;            /* 正在暂存元素的槽位数，为 0 时才能取回 */
+};
+
+/* 槽位中数据的偏移 */
+#define QUEUE_SLOT_DATA(slot) ((uint8_t*)(slot) + sizeof(struct hqueue_slot))
+
+/* 头文件中的布局镜像必须与实际结构体一致，HLIBC_STATIC_ALIGN 必须满足结构体的对齐要求 */
+_Static_assert(sizeof(struct hqueue) == HQUEUE_STRUCT_SIZE &&
+               _Alignof(struct hqueue) == _Alignof(hqueue_static_layout_t),
+               "hqueue_static_layout_t does not match struct hqueue");
+_Static_assert(sizeof(struct hqueue_segment) == HQUEUE_SEGMENT_HEADER_SIZE &&
+               _Alignof(struct hqueue_segment) == _Alignof(hqueue_segment_layout_t),
+               "hqueue_segment_layout_t does not match struct hqueue_segment");
+_Static_assert((HLIBC_STATIC_ALIGN & (HLIBC_STATIC_ALIGN - 1)) == 0 &&
+               HLIBC_STATIC_ALIGN >= _Alignof(struct hqueue),
+               "HLIBC_STATIC_ALIGN must be a power of two no less than the struct alignment");
 #endif
 
 /**********************
@@ -53,6 +119,13 @@ struct hqueue {
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+#if HLIBC_USE_STATIC_ALLOC == 1
+static uint8_t* ring_reserve(hqueue_ptr_t queue);
+static void ring_publish(hqueue_ptr_t queue);
+static void ring_drop_front(hqueue_ptr_t queue);
+static uint8_t* spill_reserve(hqueue_ptr_t queue);
+static void spill_migrate(hqueue_ptr_t queue);
+#endif
 
 /**********************
  *   GLOBAL FUNCTIONS
@@ -63,55 +136,92 @@ struct hqueue {
 
 hqueue_ptr_t hqueue_create(uint32_t type_size)
 {
-    hqueue_ptr_t queue = (hqueue_ptr_t) malloc(sizeof (struct hqueue));
+    return hqueue_create_with_allocator(type_size, NULL);
+}
+
+hqueue_ptr_t hqueue_create_with_allocator(uint32_t type_size,
+                                          const hallocator_t* allocator)
+{
+    /* 结构体、哨兵节点及其数据一次分配 */
+    hqueue_ptr_t queue = (hqueue_ptr_t) hallocator_alloc(allocator, QUEUE_HEADER_SIZE + type_size);
     if (queue == NULL) return NULL;
-    queue_node_t *head = (queue_node_t *) malloc(sizeof (queue_node_t));
-    if (head == NULL) {
-      free(queue);
-      return NULL;
-    }
-    head->data_ptr = (hdata_ptr_t)malloc(type_size);
-    if (head->data_ptr == NULL) {
-      free(head);
-      free(queue);
-      return NULL;
-    }
-    memset(head->data_ptr, '\0', type_size);
-    head->next = NULL;
-    queue->front = queue->rear = head;
-    queue->size = 0;
+    queue->sentinel.data_ptr = (uint8_t*)queue + QUEUE_HEADER_SIZE;
+    memset(queue->sentinel.data_ptr, '\0', type_size);
+    queue->type_size = type_size;
+    queue->external = false;
+    harena_init(&queue->arena, QUEUE_PAYLOAD_OFFSET + type_size, allocator);
+#if HLIBC_ENABLE_STATS
+    hstats_reset(&queue->stats, 0);
+    HSTATS_ON_ALLOC(&queue->stats, QUEUE_HEADER_SIZE + type_size);
+    queue->arena.stats = &queue->stats;
+#endif
+    queue->front = &queue->sentinel;
+    hqueue_clear(queue);
     return queue;
 }
 
-void hqueue_destroy(hqueue_ptr_t queue)
+hqueue_ptr_t hqueue_create_inline(void* buffer, uint32_t buffer_size, uint32_t type_size,
+                                  const hallocator_t* allocator)
 {
+    if (buffer == NULL) return NULL;
+
+    /* 未对齐的 buffer 先跳过开头的若干字节 */
+    uint8_t* base = (uint8_t*)HLIBC_ALIGN_UP((uintptr_t)buffer, HARENA_ALIGN);
+    uint32_t skip = (uint32_t)(base - (uint8_t*)buffer);
+    uint32_t header_size = QUEUE_HEADER_SIZE + HLIBC_ALIGN_UP(type_size, HARENA_ALIGN);
+    if (buffer_size < skip + header_size) return NULL;
+
+    /* 结构体与哨兵数据的布局同 hqueue_create_with_allocator，其后的空间作为节点池最先使用的槽位 */
+    hqueue_ptr_t queue = (hqueue_ptr_t)base;
+    queue->sentinel.data_ptr = base + QUEUE_HEADER_SIZE;
+    memset(queue->sentinel.data_ptr, '\0', type_size);
+    queue->type_size = type_size;
+    queue->external = true;
+    harena_init_inline(&queue->arena, QUEUE_PAYLOAD_OFFSET + type_size, allocator,
+                       base + header_size, buffer_size - skip - header_size);
+#if HLIBC_ENABLE_STATS
+    hstats_reset(&queue->stats, 0);
+    queue->arena.stats = &queue->stats;
+#endif
+    queue->front = &queue->sentinel;
     hqueue_clear(queue);
-    free(queue->front->data_ptr);
-    free(queue->front);
-    free(queue);
+    return queue;
+}
+
+void hqueue_destroy(hqueue_ptr_t queue)
+{
+    hallocator_t allocator = queue->arena.allocator;
+    harena_release(&queue->arena);
+    if (!queue->external)
+        hallocator_free(&allocator, queue, QUEUE_HEADER_SIZE + queue->type_size);
 }
 
 /*=====================
  * Setter functions
  *====================*/
 
-hlib_status_t hqueue_push(hqueue_ptr_t queue, hdata_ptr_t data_ptr, uint32_t data_size, copy_data_f copy_data)
+hdata_ptr_t hqueue_emplace(hqueue_ptr_t queue)
 {
-    queue_node_t *node = (queue_node_t*) malloc(sizeof (queue_node_t));
-    if (node == NULL) return HLIB_ERROR;
-    node->data_ptr = (hdata_ptr_t) malloc(data_size);
-    if (node->data_ptr == NULL) {
-      free(node);
-      return HLIB_ERROR;
-    }
-    if (copy_data != NULL)
-        copy_data(node->data_ptr, data_ptr);
-    else
-        memcpy(node->data_ptr, data_ptr, data_size);
+    queue_node_t *node = (queue_node_t*) harena_alloc(&queue->arena);
+    if (node == NULL) return NULL;
+    node->data_ptr = (uint8_t*)node + QUEUE_PAYLOAD_OFFSET;
     node->next = NULL;
     queue->rear->next = node;
     queue->rear = node;
     ++queue->size;
+    HSTATS_ON_PUSH(&queue->stats, queue->size);
+    return node->data_ptr;
+}
+
+hlib_status_t hqueue_push(hqueue_ptr_t queue, hdata_ptr_t data_ptr, uint32_t data_size, copy_data_f copy_data)
+{
+    if (data_size != queue->type_size) return HLIB_ERROR;
+    hdata_ptr_t dest = hqueue_emplace(queue);
+    if (dest == NULL) return HLIB_ERROR;
+    if (copy_data != NULL)
+        copy_data(dest, data_ptr);
+    else
+        memcpy(dest, data_ptr, data_size);
     return HLIB_OK;
 }
 
@@ -121,17 +231,19 @@ hlib_status_t hqueue_pop(hqueue_ptr_t queue)
     queue_node_t *p = queue->front->next;
     queue->front->next = p->next;
     if (queue->rear == p) queue->rear = queue->front;
-    free(p->data_ptr);
-    free(p);
+    harena_free(&queue->arena, p);
     --queue->size;
+    HSTATS_ON_POP(&queue->stats);
     return HLIB_OK;
 }
 
 void hqueue_clear(hqueue_ptr_t queue)
 {
-    while(!hqueue_empty(queue)) {
-        hqueue_pop(queue);
-    }
+    /* 节点全部归属于容器自己的节点池，整体回收即可 */
+    harena_release(&queue->arena);
+    queue->front->next = NULL;
+    queue->rear = queue->front;
+    queue->size = 0;
 }
 
 /*=======================
@@ -158,6 +270,46 @@ uint32_t hqueue_size(hqueue_ptr_t queue)
     return queue->size;
 }
 
+uint32_t hqueue_type_size(hqueue_ptr_t queue)
+{
+    return queue->type_size;
+}
+
+/*=======================
+ * Other functions
+ *======================*/
+
+uint32_t hqueue_foreach(hqueue_ptr_t queue, hforeach_f fn, void* ctx)
+{
+    uint32_t visited = 0;
+    for (queue_node_t* node = queue->front->next; node != NULL; ) {
+        /* 节点与数据位于同一槽位，预取下一个节点即可 */
+        queue_node_t* next = node->next;
+        if (next != NULL) HLIBC_PREFETCH(next->next);
+        ++visited;
+        if (!fn(node->data_ptr, ctx)) break;
+        node = next;
+    }
+    return visited;
+}
+
+uint32_t hqueue_foreach_batch(hqueue_ptr_t queue, hforeach_batch_f fn, void* ctx)
+{
+    hdata_ptr_t items[HLIBC_FOREACH_BATCH];
+    uint32_t visited = 0;
+    queue_node_t* node = queue->front->next;
+    while (node != NULL) {
+        uint32_t n = 0;
+        do {
+            items[n++] = node->data_ptr;
+            node = node->next;
+        } while (n < HLIBC_FOREACH_BATCH && node != NULL);
+        visited += n;
+        if (!fn(items, n, ctx)) break;
+    }
+    return visited;
+}
+
 #else /* HLIBC_USE_STATIC_ALLOC == 1 */
 /* ==================== 静态分配实现（环形队列） ==================== */
 
@@ -165,63 +317,142 @@ hqueue_ptr_t hqueue_create_static(void* buffer, uint32_t buffer_size,
                                   uint32_t type_size) {
   if (buffer == NULL || type_size == 0) return NULL;
 
-  uint32_t header_size = sizeof(struct hqueue);
-  if (buffer_size <= header_size) return NULL;
+  /* 未对齐的 buffer 先跳过开头的若干字节 */
+  uint8_t* base = (uint8_t*)HLIBC_ALIGN_UP((uintptr_t)buffer, HLIBC_STATIC_ALIGN);
+  uint32_t skip = (uint32_t)(base - (uint8_t*)buffer);
+  uint32_t header_size = HLIBC_ALIGN_UP(sizeof(struct hqueue), HLIBC_STATIC_ALIGN);
+  if (buffer_size <= skip + header_size) return NULL;
 
-  uint32_t remaining = buffer_size - header_size;
+  uint32_t remaining = buffer_size - skip - header_size;
   uint32_t capacity = remaining / type_size;
 
   if (capacity == 0) return NULL;
 
-  hqueue_ptr_t queue = (hqueue_ptr_t)buffer;
+  hqueue_ptr_t queue = (hqueue_ptr_t)base;
   queue->size = 0;
   queue->capacity = capacity;
   queue->type_size = type_size;
   queue->head = 0;
   queue->tail = 0;
-  queue->data_pool = (uint8_t*)buffer + header_size;
+  queue->dropped = 0;
+  queue->overwrite = false;
+  atomic_init(&queue->seq, 0);
+  atomic_init(&queue->seq_base, 0);
+  queue->seq_limit = (0x80000000u / capacity) * capacity;
+  queue->data_pool = base + header_size;
+  queue->segments = NULL;
+  queue->spill_head = NULL;
+  queue->spill_tail = NULL;
+  queue->spill_size = 0;
+  queue->extra_capacity = 0;
+#if HLIBC_ENABLE_STATS
+  hstats_reset(&queue->stats, 0);
+#endif
 
   return queue;
 }
 
 void hqueue_destroy_static(hqueue_ptr_t queue) {
   if (queue == NULL) return;
-  queue->size = 0;
-  queue->head = 0;
-  queue->tail = 0;
+  hqueue_clear(queue);
 }
 
 /*=====================
  * Setter functions
  *====================*/
 
+hdata_ptr_t hqueue_emplace(hqueue_ptr_t queue) {
+  uint8_t* dest = ring_reserve(queue);
+  /* 暂存的元素等搬进环形缓冲区时再发布 */
+  if (dest != NULL && queue->spill_size == 0) ring_publish(queue);
+  return dest;
+}
+
 hlib_status_t hqueue_push(hqueue_ptr_t queue, hdata_ptr_t data_ptr,
                           uint32_t data_size, copy_data_f copy_data) {
-  if (queue->size >= queue->capacity) return HLIB_OVERFLOW;
+  if (queue->size >= queue->capacity + queue->extra_capacity && !queue->overwrite) {
+    HSTATS_ON_OVERFLOW(&queue->stats);
+    return HLIB_OVERFLOW;
+  }
   if (data_size != queue->type_size) return HLIB_ERROR;
 
-  uint8_t* dest = queue->data_pool + queue->tail * queue->type_size;
+  hdata_ptr_t dest = ring_reserve(queue);
+  /* 先让快照读者看到旧序号已经失效，再改写槽位 */
+  atomic_thread_fence(memory_order_release);
   if (copy_data != NULL)
     copy_data(dest, data_ptr);
   else
     memcpy(dest, data_ptr, data_size);
-
-  queue->tail = (queue->tail + 1) % queue->capacity;
-  ++queue->size;
+  if (queue->spill_size == 0) ring_publish(queue);
   return HLIB_OK;
 }
 
 hlib_status_t hqueue_pop(hqueue_ptr_t queue) {
   if (queue->size == 0) return HLIB_ERROR;
-  queue->head = (queue->head + 1) % queue->capacity;
-  --queue->size;
+  ring_drop_front(queue);
+  HSTATS_ON_POP(&queue->stats);
   return HLIB_OK;
 }
 
+hlib_status_t hqueue_add_buffer(hqueue_ptr_t queue, void* buffer, uint32_t buffer_size) {
+  if (buffer == NULL) return HLIB_ERROR;
+
+  /* 未对齐的 buffer 先跳过开头的若干字节 */
+  uint8_t* base = (uint8_t*)HLIBC_ALIGN_UP((uintptr_t)buffer, HLIBC_STATIC_ALIGN);
+  uint32_t skip = (uint32_t)(base - (uint8_t*)buffer);
+  uint32_t header_size = HLIBC_ALIGN_UP(sizeof(struct hqueue_segment), HLIBC_STATIC_ALIGN);
+  if (buffer_size <= skip + header_size) return HLIB_ERROR;
+
+  uint32_t capacity = (buffer_size - skip - header_size) /
+                      (uint32_t)HQUEUE_SEGMENT_SLOT_SIZE(queue->type_size);
+  if (capacity == 0) return HLIB_ERROR;
+
+  struct hqueue_segment* segment = (struct hqueue_segment*)base;
+  segment->next = NULL;
+  segment->buffer = buffer;
+  segment->slots = base + header_size;
+  segment->free_list = NULL;
+  segment->capacity = capacity;
+  segment->slot_bump = 0;
+  segment->used = 0;
+
+  /* 接在末尾：暂存时优先使用先追加的缓冲区，后追加的更容易排空取回 */
+  struct hqueue_segment** link = &queue->segments;
+  while (*link != NULL) link = &(*link)->next;
+  *link = segment;
+  queue->extra_capacity += capacity;
+  return HLIB_OK;
+}
+
+hlib_status_t hqueue_remove_buffer(hqueue_ptr_t queue, void* buffer) {
+  for (struct hqueue_segment** link = &queue->segments; *link != NULL; link = &(*link)->next) {
+    struct hqueue_segment* segment = *link;
+    if (segment->buffer != buffer) continue;
+    if (segment->used != 0) return HLIB_BUSY;
+    *link = segment->next;
+    queue->extra_capacity -= segment->capacity;
+    return HLIB_OK;
+  }
+  return HLIB_ERROR;
+}
+
 void hqueue_clear(hqueue_ptr_t queue) {
+  /* 不回到 0：tail 必须与快照使用的 seq 保持同步 */
   queue->size = 0;
-  queue->head = 0;
-  queue->tail = 0;
+  queue->head = queue->tail;
+  queue->dropped = 0;
+  /* 追加缓冲区整体回收 */
+  for (struct hqueue_segment* segment = queue->segments; segment != NULL; segment = segment->next) {
+    segment->free_list = NULL;
+    segment->slot_bump = 0;
+    segment->used = 0;
+  }
+  queue->spill_head = NULL;
+  queue->spill_tail = NULL;
+  queue->spill_size = 0;
+  atomic_store_explicit(&queue->seq_base,
+                        atomic_load_explicit(&queue->seq, memory_order_relaxed),
+                        memory_order_release);
 }
 
 /*=======================
@@ -235,6 +466,7 @@ hdata_ptr_t hqueue_front(hqueue_ptr_t queue) {
 
 hdata_ptr_t hqueue_rear(hqueue_ptr_t queue) {
   if (queue->size == 0) return NULL;
+  if (queue->spill_size != 0) return QUEUE_SLOT_DATA(queue->spill_tail);
   uint32_t rear_idx = (queue->tail + queue->capacity - 1) % queue->capacity;
   return queue->data_pool + rear_idx * queue->type_size;
 }
@@ -243,10 +475,212 @@ bool hqueue_empty(hqueue_ptr_t queue) { return (queue->size == 0); }
 
 uint32_t hqueue_size(hqueue_ptr_t queue) { return queue->size; }
 
-uint32_t hqueue_capacity(hqueue_ptr_t queue) { return queue->capacity; }
+uint32_t hqueue_type_size(hqueue_ptr_t queue) { return queue->type_size; }
+
+uint32_t hqueue_capacity(hqueue_ptr_t queue) {
+  return queue->capacity + queue->extra_capacity;
+}
 
 bool hqueue_full(hqueue_ptr_t queue) {
-  return (queue->size >= queue->capacity);
+  return (queue->size >= queue->capacity + queue->extra_capacity);
+}
+
+void hqueue_set_overwrite(hqueue_ptr_t queue, bool enable) {
+  queue->overwrite = enable;
+}
+
+uint32_t hqueue_dropped(hqueue_ptr_t queue) { return queue->dropped; }
+
+uint32_t hqueue_snapshot(hqueue_ptr_t queue, hdata_ptr_t out, uint32_t max_count) {
+  uint32_t capacity = queue->capacity;
+  uint32_t limit = queue->seq_limit;
+  uint32_t type_size = queue->type_size;
+  uint8_t* dest = (uint8_t*)out;
+
+  uint32_t end = atomic_load_explicit(&queue->seq, memory_order_acquire);
+  uint32_t base = atomic_load_explicit(&queue->seq_base, memory_order_acquire);
+  uint32_t n = (end + limit - base) % limit;
+  if (n > capacity) n = capacity;
+  if (n > max_count) n = max_count;
+  uint32_t first = (end + limit - n) % limit;
+  for (uint32_t i = 0; i < n; ++i)
+    memcpy(dest + i * type_size,
+           queue->data_pool + ((first + i) % capacity) * type_size, type_size);
+
+  /*
+   * 与写线程的 release 栅栏配对：复制期间写线程已经开始写序号 now 的元素，
+   * 它与序号 now - capacity 共用槽位，因此距 now 不小于 capacity 的元素都可能已被改写
+   */
+  atomic_thread_fence(memory_order_acquire);
+  uint32_t now = atomic_load_explicit(&queue->seq, memory_order_relaxed);
+  uint32_t span = n + (now + limit - end) % limit;
+  uint32_t stale = span >= capacity ? span - capacity + 1 : 0;
+  if (stale >= n) return 0;
+  if (stale > 0) memmove(dest, dest + stale * type_size, (n - stale) * type_size);
+  return n - stale;
+}
+
+/*=======================
+ * Other functions
+ *======================*/
+
+uint32_t hqueue_foreach(hqueue_ptr_t queue, hforeach_f fn, void* ctx) {
+  uint32_t ring_size = queue->size - queue->spill_size;
+  uint32_t index = queue->head;
+  for (uint32_t i = 0; i < ring_size; ++i) {
+    if (!fn(queue->data_pool + index * queue->type_size, ctx)) return i + 1;
+    if (++index == queue->capacity) index = 0;
+  }
+  /* 环形缓冲区之后是按顺序暂存在追加缓冲区中的元素 */
+  uint32_t visited = ring_size;
+  for (struct hqueue_slot* slot = queue->spill_head; visited < queue->size; slot = slot->next) {
+    ++visited;
+    if (!fn(QUEUE_SLOT_DATA(slot), ctx)) break;
+  }
+  return visited;
+}
+
+uint32_t hqueue_foreach_batch(hqueue_ptr_t queue, hforeach_batch_f fn, void* ctx) {
+  hdata_ptr_t items[HLIBC_FOREACH_BATCH];
+  uint32_t ring_size = queue->size - queue->spill_size;
+  uint32_t index = queue->head;
+  struct hqueue_slot* slot = queue->spill_head;
+  uint32_t visited = 0;
+  while (visited < queue->size) {
+    uint32_t n = 0;
+    do {
+      if (visited + n < ring_size) {
+        items[n++] = queue->data_pool + index * queue->type_size;
+        if (++index == queue->capacity) index = 0;
+      } else {
+        items[n++] = QUEUE_SLOT_DATA(slot);
+        slot = slot->next;
+      }
+    } while (n < HLIBC_FOREACH_BATCH && visited + n < queue->size);
+    visited += n;
+    if (!fn(items, n, ctx)) break;
+  }
+  return visited;
+}
+
+uint32_t hqueue_foreach_span(hqueue_ptr_t queue, hforeach_span_f fn, void* ctx) {
+  uint32_t size = queue->size - queue->spill_size;
+  if (size == 0) return 0;
+  /* 第一段：队头到数组末尾（或队尾），第二段：回绕后数组开头到队尾 */
+  uint32_t first = queue->capacity - queue->head;
+  if (first > size) first = size;
+  if (!fn(queue->data_pool + queue->head * queue->type_size, first, ctx)) return first;
+  if (first < size && !fn(queue->data_pool, size - first, ctx)) return size;
+  /* 暂存的元素不连续，逐个传入 */
+  for (struct hqueue_slot* slot = queue->spill_head; size < queue->size; slot = slot->next) {
+    ++size;
+    if (!fn(QUEUE_SLOT_DATA(slot), 1, ctx)) break;
+  }
+  return size;
 }
 
 #endif /* HLIBC_USE_STATIC_ALLOC */
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if HLIBC_USE_STATIC_ALLOC == 1
+/* 在队尾占用一个槽位；覆盖模式下队列已满时先丢弃最旧的元素 */
+static uint8_t* ring_reserve(hqueue_ptr_t queue) {
+  if (queue->size >= queue->capacity) {
+    if (queue->size >= queue->capacity + queue->extra_capacity) {
+      HSTATS_ON_OVERFLOW(&queue->stats);
+      if (!queue->overwrite) return NULL;
+      ring_drop_front(queue);
+      ++queue->dropped;
+    }
+    /* 环形缓冲区仍然是满的：暂存到追加的缓冲区 */
+    if (queue->size >= queue->capacity) return spill_reserve(queue);
+  }
+  uint8_t* dest = queue->data_pool + queue->tail * queue->type_size;
+  queue->tail = (queue->tail + 1) % queue->capacity;
+  ++queue->size;
+  HSTATS_ON_PUSH(&queue->stats, queue->size);
+  return dest;
+}
+
+/* 新元素写完，推进快照序号 */
+static void ring_publish(hqueue_ptr_t queue) {
+  uint32_t seq = atomic_load_explicit(&queue->seq, memory_order_relaxed) + 1;
+  if (seq == queue->seq_limit) seq = 0;
+  atomic_store_explicit(&queue->seq, seq, memory_order_release);
+}
+
+/* 出队最旧的元素，空出的槽位由最旧的暂存元素补上 */
+static void ring_drop_front(hqueue_ptr_t queue) {
+  queue->head = (queue->head + 1) % queue->capacity;
+  --queue->size;
+  if (queue->spill_size != 0) spill_migrate(queue);
+}
+
+/* 从追加的缓冲区中取一个槽位接到暂存链表末尾，先追加的缓冲区优先 */
+static uint8_t* spill_reserve(hqueue_ptr_t queue) {
+  struct hqueue_segment* segment = queue->segments;
+  struct hqueue_slot* slot;
+  uint32_t slot_size = (uint32_t)HQUEUE_SEGMENT_SLOT_SIZE(queue->type_size);
+  while (segment->free_list == NULL && segment->slot_bump == segment->capacity)
+    segment = segment->next;
+  if (segment->free_list != NULL) {
+    slot = segment->free_list;
+    segment->free_list = slot->next;
+  } else {
+    slot = (struct hqueue_slot*)(segment->slots + segment->slot_bump++ * slot_size);
+  }
+  ++segment->used;
+
+  slot->next = NULL;
+  if (queue->spill_size == 0) queue->spill_head = slot;
+  else queue->spill_tail->next = slot;
+  queue->spill_tail = slot;
+  ++queue->spill_size;
+  ++queue->size;
+  HSTATS_ON_PUSH(&queue->stats, queue->size);
+  return QUEUE_SLOT_DATA(slot);
+}
+
+/* 把最旧的暂存元素搬到环形缓冲区的队尾（调用前队尾恰好空出一个槽位） */
+static void spill_migrate(hqueue_ptr_t queue) {
+  struct hqueue_slot* slot = queue->spill_head;
+  uint8_t* dest = queue->data_pool + queue->tail * queue->type_size;
+  queue->tail = (queue->tail + 1) % queue->capacity;
+  /* 与 push 相同：先让快照读者看到旧序号已经失效，再改写槽位 */
+  atomic_thread_fence(memory_order_release);
+  memcpy(dest, QUEUE_SLOT_DATA(slot), queue->type_size);
+
+  queue->spill_head = slot->next;
+  --queue->spill_size;
+  ring_publish(queue);
+
+  /* 槽位归还给所在的缓冲区 */
+  uint32_t slot_size = (uint32_t)HQUEUE_SEGMENT_SLOT_SIZE(queue->type_size);
+  struct hqueue_segment* segment = queue->segments;
+  while ((uint8_t*)slot < segment->slots ||
+         (uint8_t*)slot >= segment->slots + segment->capacity * slot_size)
+    segment = segment->next;
+  slot->next = segment->free_list;
+  segment->free_list = slot;
+  --segment->used;
+}
+#endif
+
+#if HLIBC_ENABLE_STATS
+/*=======================
+ * Statistics functions
+ *======================*/
+
+void hqueue_get_stats(hqueue_ptr_t queue, hlibc_stats_t* stats)
+{
+    *stats = queue->stats;
+}
+
+void hqueue_reset_stats(hqueue_ptr_t queue)
+{
+    hstats_reset(&queue->stats, queue->size);
+}
+#endif /* HLIBC_ENABLE_STATS */
@@ -17,24 +17,56 @@ extern "C" {
  *********************/
 #include "../common/hcommon.h"
 #include "../common/hlibc_config.h"
+#include "../common/hstats.h"
+#include "../common/harena.h"
 
 /*********************
  *      MACROS
  *********************/
 
 /*
- * 静态分配结构体大小常量
+ * 静态分配结构体大小（精确值，由 hqueue_static_layout_t 得出，hqueue.c 中用 _Static_assert 校验）
  */
-#define HQUEUE_STRUCT_SIZE \
-  32 /* size + capacity + type_size + head + tail + data_pool 指针 */
+#define HQUEUE_STRUCT_SIZE sizeof(hqueue_static_layout_t)
 
 /**
  * 计算静态 queue 所需的 buffer 大小
+ * buffer 按 HLIBC_STATIC_ALIGN 对齐时恰好容纳 capacity 个元素（HQUEUE_DEFINE_STATIC 会自动对齐）
  * @param type 数据类型
  * @param capacity 容器最大容量
+ *
+ * 内存布局: [hqueue结构体][对齐填充][环形数据数组]
  */
 #define HQUEUE_CALC_BUFFER_SIZE(type, capacity) \
-  (HQUEUE_STRUCT_SIZE + (capacity) * sizeof(type))
+  HQUEUE_BUFFER_SIZE(sizeof(type), capacity)
+
+/* 同上，元素大小以字节数给出 */
+#define HQUEUE_BUFFER_SIZE(type_size, capacity)                     \
+  (HLIBC_ALIGN_UP(HQUEUE_STRUCT_SIZE, HLIBC_STATIC_ALIGN) +         \
+   (size_t)(capacity) * (type_size))
+
+/*
+ * 追加缓冲区（溢出段）的头部与单个槽位大小（精确值，hqueue.c 中用 _Static_assert 校验）
+ */
+#define HQUEUE_SEGMENT_HEADER_SIZE sizeof(hqueue_segment_layout_t)
+#define HQUEUE_SEGMENT_SLOT_SIZE(type_size) \
+  HLIBC_ALIGN_UP(sizeof(void*) + (size_t)(type_size), sizeof(void*))
+
+/**
+ * 计算 hqueue_add_buffer 追加 count 个元素的容量所需的 buffer 大小
+ * buffer 按 HLIBC_STATIC_ALIGN 对齐时恰好够用
+ * @param type 数据类型
+ * @param count 追加的容量
+ *
+ * 内存布局: [溢出段头部][对齐填充][槽位数组（链接指针 + 数据）]
+ */
+#define HQUEUE_CALC_SEGMENT_SIZE(type, count) \
+  HQUEUE_SEGMENT_SIZE(sizeof(type), count)
+
+/* 同上，元素大小以字节数给出 */
+#define HQUEUE_SEGMENT_SIZE(type_size, count)                          \
+  (HLIBC_ALIGN_UP(HQUEUE_SEGMENT_HEADER_SIZE, HLIBC_STATIC_ALIGN) +    \
+   (size_t)(count) * HQUEUE_SEGMENT_SLOT_SIZE(type_size))
 
 /**
  * 定义一个静态 queue（便捷宏）
@@ -43,15 +75,111 @@ extern "C" {
  * @param capacity 容器最大容量
  */
 #define HQUEUE_DEFINE_STATIC(name, type, capacity)                       \
-  static uint8_t name##_buffer[HQUEUE_CALC_BUFFER_SIZE(type, capacity)]; \
+  HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static                               \
+      uint8_t name##_buffer[HQUEUE_CALC_BUFFER_SIZE(type, capacity)];    \
   hqueue_ptr_t name =                                                    \
       hqueue_create_static(name##_buffer, sizeof(name##_buffer), sizeof(type))
 
+#if HLIBC_USE_STATIC_ALLOC == 0
+/*
+ * 内联 queue 结构体大小（精确值，由 hqueue_inline_layout_t 得出，hqueue.c 中用 _Static_assert 校验）
+ */
+#define HQUEUE_INLINE_STRUCT_SIZE sizeof(hqueue_inline_layout_t)
+
+/* 内联区域中单个元素占用的槽位大小（节点 + 数据） */
+#define HQUEUE_INLINE_SLOT_SIZE(type_size) \
+  HLIBC_ALIGN_UP(HARENA_PAYLOAD_OFFSET(2 * sizeof(void*)) + (size_t)(type_size), HARENA_ALIGN)
+
+/**
+ * 计算内联 queue 所需的 buffer 大小
+ * buffer 按 HARENA_ALIGN 对齐时恰好内联 count 个元素（HQUEUE_DEFINE_INLINE 会自动对齐）
+ * @param type_size 元素的字节数
+ * @param count 内联的元素个数，超出后才向分配器申请
+ *
+ * 内存布局: [hqueue结构体][对齐填充][哨兵数据][对齐填充][count 个槽位]
+ */
+#define HQUEUE_INLINE_BUFFER_SIZE(type_size, count)                  \
+  (HLIBC_ALIGN_UP(HQUEUE_INLINE_STRUCT_SIZE, HARENA_ALIGN) +         \
+   HLIBC_ALIGN_UP((size_t)(type_size), HARENA_ALIGN) +               \
+   (size_t)(count) * HQUEUE_INLINE_SLOT_SIZE(type_size))
+
+/**
+ * 在当前作用域（通常是栈帧）定义一个内联 queue（便捷宏）
+ * 前 count 个元素不调用分配器，离开作用域前仍需 hqueue_destroy 归还溢出的部分
+ * @param name 变量名
+ * @param type 数据类型
+ * @param count 内联的元素个数
+ */
+#define HQUEUE_DEFINE_INLINE(name, type, count)                                    \
+  HLIBC_ALIGNAS(HARENA_ALIGN)                                                      \
+      uint8_t name##_buffer[HQUEUE_INLINE_BUFFER_SIZE(sizeof(type), count)];       \
+  hqueue_ptr_t name =                                                              \
+      hqueue_create_inline(name##_buffer, sizeof(name##_buffer), sizeof(type), NULL)
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
 typedef struct hqueue* hqueue_ptr_t;
 
+/*
+ * 静态分配模式下 struct hqueue 的布局镜像，仅用于在编译期得到精确大小，
+ * 字段必须与 hqueue.c 保持一致
+ */
+typedef struct {
+  uint32_t size_;
+  uint32_t capacity_;
+  uint32_t type_size_;
+  uint32_t head_;
+  uint32_t tail_;
+  uint32_t dropped_;
+  bool overwrite_;
+  uint32_t seq_;
+  uint32_t seq_base_;
+  uint32_t seq_limit_;
+  void* data_pool_;
+  void* segments_;
+  void* spill_head_;
+  void* spill_tail_;
+  uint32_t spill_size_;
+  uint32_t extra_capacity_;
+#if HLIBC_ENABLE_STATS
+  hlibc_stats_t stats_;
+#endif
+} hqueue_static_layout_t;
+
+/*
+ * 静态分配模式下追加缓冲区头部的布局镜像，字段必须与 hqueue.c 保持一致
+ */
+typedef struct {
+  void* next_;
+  void* buffer_;
+  void* slots_;
+  void* free_list_;
+  uint32_t capacity_;
+  uint32_t slot_bump_;
+  uint32_t used_;
+} hqueue_segment_layout_t;
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/*
+ * 动态分配模式下 struct hqueue 的布局镜像，仅用于计算内联 buffer 的大小，
+ * 字段必须与 hqueue.c 保持一致
+ */
+typedef struct {
+  uint32_t size_;
+  uint32_t type_size_;
+  void* front_;
+  void* rear_;
+  harena_t arena_;
+#if HLIBC_ENABLE_STATS
+  hlibc_stats_t stats_;
+#endif
+  bool external_;
+  void* sentinel_[2];
+} hqueue_inline_layout_t;
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -64,9 +192,31 @@ typedef struct hqueue* hqueue_ptr_t;
  */
 extern hqueue_ptr_t hqueue_create(uint32_t type_size);
 
+/**
+ * 创建一个 queue 容器，结构体与节点池 chunk 由指定的分配器提供（动态分配）
+ * @param type_size 装入容器的数据类型的大小
+ * @param allocator 分配器，NULL 等同于 `hqueue_create`；内容会被复制，无需长期保存
+ * @return 返回新创建的 queue 容器
+ */
+extern hqueue_ptr_t hqueue_create_with_allocator(uint32_t type_size,
+                                                 const hallocator_t* allocator);
+
+/**
+ * 在调用者提供的 buffer 中创建一个 queue 容器（动态分配）
+ * 结构体、哨兵与前若干个元素都放在 buffer 中，超出后才向分配器申请，短生命周期的容器可以完全不调用分配器
+ * @param buffer 内存缓冲区，通常位于调用者的栈帧中，生命周期须覆盖容器的使用期
+ * @param buffer_size 缓冲区大小（使用 HQUEUE_INLINE_BUFFER_SIZE 宏计算）
+ * @param type_size 装入容器的数据类型的大小
+ * @param allocator 溢出部分的分配器，NULL 表示使用 malloc/free
+ * @return 返回容器指针，buffer 放不下结构体与哨兵时返回 NULL
+ */
+extern hqueue_ptr_t hqueue_create_inline(void* buffer, uint32_t buffer_size, uint32_t type_size,
+                                         const hallocator_t* allocator);
+
 /**
  * 删除给定的 queue 容器（动态分配版本）
- * @param queue 一个由 `hqueue_create` 返回的容器
+ * 由 `hqueue_create_inline` 创建的容器只归还溢出的部分，buffer 由调用者管理
+ * @param queue 一个由 `hqueue_create` 或 `hqueue_create_inline` 返回的容器
  */
 extern void hqueue_destroy(hqueue_ptr_t queue);
 
@@ -101,14 +251,44 @@ extern void hqueue_destroy_static(hqueue_ptr_t queue);
 extern hlib_status_t hqueue_push(hqueue_ptr_t queue, hdata_ptr_t data_ptr, uint32_t data_size, copy_data_f copy_data);
 extern hlib_status_t hqueue_pop(hqueue_ptr_t queue);
 
+/**
+ * 原地构造：在队尾追加一个未初始化的元素，由调用者直接写入数据
+ * @param queue 容器
+ * @return 新元素的数据指针，内存不足或容器已满时返回 NULL
+ */
+extern hdata_ptr_t hqueue_emplace(hqueue_ptr_t queue);
+
 /**
  * 清理 queue 容器的所有内容
  * @param queue 一个由 `hqueue_create` 或 `hqueue_create_static` 返回的容器
  * ！！！慎用：调用此函数将会清理掉队列内容，对于普通数据而言并无影响；
  * 但是对于指针数据来说，一旦清空后便无法找到其指针，故而会造成内存泄漏，除非使用者有其他记录。
+ * 节点由容器的节点池整体回收：动态模式为 O(chunk 数)，静态模式为 O(1)。
  */
 extern void hqueue_clear(hqueue_ptr_t queue);
 
+#if HLIBC_USE_STATIC_ALLOC
+/**
+ * 追加一块缓冲区，扩大容量（仅静态分配模式）
+ * 环形缓冲区写满后，新元素按顺序暂存在追加的缓冲区中；每次 pop 把其中最旧的一个搬回环形缓冲区，
+ * 因此突发过后队列自然回落到最初的 buffer，追加的缓冲区排空后即可用 hqueue_remove_buffer 取回。
+ * 全程不调用 malloc。snapshot 只读取已进入环形缓冲区的元素。
+ * @param queue 容器
+ * @param buffer 缓冲区，在取回之前须保持有效
+ * @param buffer_size 缓冲区大小（使用 HQUEUE_CALC_SEGMENT_SIZE 宏计算）
+ * @return HLIB_OK 成功；HLIB_ERROR buffer 为 NULL 或放不下一个元素
+ */
+extern hlib_status_t hqueue_add_buffer(hqueue_ptr_t queue, void* buffer, uint32_t buffer_size);
+
+/**
+ * 取回一块由 hqueue_add_buffer 追加的缓冲区，容量相应减少（仅静态分配模式）
+ * @param queue 容器
+ * @param buffer 追加时传入的地址
+ * @return HLIB_OK 已取回；HLIB_BUSY 缓冲区中还有元素，稍后再试；HLIB_ERROR 不是追加的缓冲区
+ */
+extern hlib_status_t hqueue_remove_buffer(hqueue_ptr_t queue, void* buffer);
+#endif
+
 /*=======================
  * Getter functions
  *======================*/
@@ -118,9 +298,14 @@ extern hdata_ptr_t hqueue_rear(hqueue_ptr_t queue);
 extern bool hqueue_empty(hqueue_ptr_t queue);
 extern uint32_t hqueue_size(hqueue_ptr_t queue);
 
+/**
+ * 获取创建时指定的元素大小
+ */
+extern uint32_t hqueue_type_size(hqueue_ptr_t queue);
+
 #if HLIBC_USE_STATIC_ALLOC
 /**
- * 获取 queue 容器的最大容量（仅静态分配模式）
+ * 获取 queue 容器的最大容量（仅静态分配模式），包含追加的缓冲区
  */
 extern uint32_t hqueue_capacity(hqueue_ptr_t queue);
 
@@ -128,6 +313,82 @@ extern uint32_t hqueue_capacity(hqueue_ptr_t queue);
  * 检查 queue 容器是否已满（仅静态分配模式）
  */
 extern bool hqueue_full(hqueue_ptr_t queue);
+
+/**
+ * 设置覆盖模式（仅静态分配模式，默认关闭）
+ * 开启后队列满时 push/emplace 不再返回失败，而是丢弃最旧的元素，适合遥测、跟踪等环形记录。
+ * @param queue 容器
+ * @param enable true 开启，false 关闭
+ */
+extern void hqueue_set_overwrite(hqueue_ptr_t queue, bool enable);
+
+/**
+ * 覆盖模式下被丢弃的元素个数，clear 时清零（仅静态分配模式）
+ */
+extern uint32_t hqueue_dropped(hqueue_ptr_t queue);
+
+/**
+ * 读取最近放入的元素（仅静态分配模式）
+ * 单写多读：写线程照常 push，其他线程可随时调用本函数，无需加锁，也不会阻塞写线程。
+ * 复制期间被写线程覆盖的最旧元素会被丢弃，因此队列写满时最多返回 capacity - 1 个。
+ * 快照按 push 的顺序计数，与 pop 无关：已经 pop 但尚未被覆盖的元素同样会被读到，clear 之前的不会。
+ * emplace 在返回时即视为已发布，调用者填写数据期间的快照可能读到不完整的元素。
+ * @param queue 容器
+ * @param out 输出数组，至少 max_count 个元素
+ * @param max_count 最多读取的元素个数
+ * @return 实际读取的个数，按从旧到新排列
+ */
+extern uint32_t hqueue_snapshot(hqueue_ptr_t queue, hdata_ptr_t out, uint32_t max_count);
+#endif
+
+/*=======================
+ * Other functions
+ *======================*/
+
+/**
+ * 从队头到队尾对每个元素调用 fn
+ * @param queue 容器
+ * @param fn 回调，返回 false 时停止遍历；回调中不能 push/pop
+ * @param ctx 原样传给 fn
+ * @return 已调用 fn 的元素个数
+ */
+extern uint32_t hqueue_foreach(hqueue_ptr_t queue, hforeach_f fn, void* ctx);
+
+/**
+ * 从队头到队尾按批遍历，每次传入最多 HLIBC_FOREACH_BATCH 个元素的数据指针
+ * @param fn 回调，items 仅在本次回调内有效，返回 false 时停止遍历
+ * @return 已传给 fn 的元素个数
+ */
+extern uint32_t hqueue_foreach_batch(hqueue_ptr_t queue, hforeach_batch_f fn, void* ctx);
+
+#if HLIBC_USE_STATIC_ALLOC
+/**
+ * 按连续内存段遍历（仅静态分配模式）
+ * 环形缓冲区中的元素最多分成两段：队头到数组末尾、数组开头到队尾，
+ * base 指向该段第一个元素，段内元素按 type_size 紧密排列，可直接按数组处理；
+ * 暂存在追加缓冲区中的元素不连续，之后逐个传入（count 为 1）
+ * @return 已传给 fn 的元素个数
+ */
+extern uint32_t hqueue_foreach_span(hqueue_ptr_t queue, hforeach_span_f fn, void* ctx);
+#endif
+
+#if HLIBC_ENABLE_STATS
+/*=======================
+ * Statistics functions
+ *======================*/
+
+/**
+ * 读取 hqueue 容器的运行统计（仅在 HLIBC_ENABLE_STATS 为 1 时提供）
+ * @param queue 一个由 `hqueue_create` 或 `hqueue_create_static` 返回的容器
+ * @param stats 输出统计快照
+ */
+extern void hqueue_get_stats(hqueue_ptr_t queue, hlibc_stats_t* stats);
+
+/**
+ * 清零 hqueue 容器的运行统计，高水位从当前元素个数重新开始
+ * @param queue 一个由 `hqueue_create` 或 `hqueue_create_static` 返回的容器
+ */
+extern void hqueue_reset_stats(hqueue_ptr_t queue);
 #endif
 
 #ifdef __cplusplus
@@ -0,0 +1,166 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/queue/hqueue_typed.h
+ * @Description: 宏生成的类型特化 queue（全部 static inline，可完全内联）
+ * @other: None
+ */
+#ifndef __HLIBC_HQUEUE_TYPED_H__
+#define __HLIBC_HQUEUE_TYPED_H__
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../common/hcommon.h"
+#include "../common/hlibc_config.h"
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+#include <stdlib.h>
+#endif
+
+/*********************
+ *      MACROS
+ *********************/
+
+/**
+ * 生成一个元素类型为 T 的 queue（环形队列），类型名为 `name_t`，函数前缀为 `name_`
+ * 元素按值传递与拷贝，不经过 type_size/memcpy，编译器可以直接内联。
+ *
+ * 动态分配模式：环形数组存储，满时按 2 倍扩容
+ *   name_init(q) / name_destroy(q)
+ * 静态分配模式：使用用户提供的 T 数组，满时返回 HLIB_OVERFLOW
+ *   name_init_static(q, storage, capacity) / name_capacity(q) / name_full(q)
+ *
+ * 通用操作：name_push / name_pop / name_front / name_rear / name_size / name_empty / name_clear
+ *
+ * 使用示例:
+ *   HQUEUE_DECLARE(int_queue, int)
+ *   int_queue_t q;
+ *   int_queue_init(&q);
+ *   int_queue_push(&q, 10);
+ *   int x = *int_queue_front(&q);
+ */
+#define HQUEUE_DECLARE(name, T)                                                \
+    typedef struct name {                                                      \
+        uint32_t size;                                                         \
+        uint32_t capacity;                                                     \
+        uint32_t head;      /* 队头索引 */                                     \
+        uint32_t tail;      /* 队尾索引 */                                     \
+        T* data;                                                               \
+    } name##_t;                                                                \
+                                                                               \
+    HQUEUE_DECLARE_ALLOC_(name, T)                                             \
+                                                                               \
+    static inline hlib_status_t name##_push(name##_t* q, T value)              \
+    {                                                                          \
+        if (q->size == q->capacity) {                                          \
+            hlib_status_t status = name##_grow_(q);                            \
+            if (status != HLIB_OK) return status;                              \
+        }                                                                      \
+        q->data[q->tail] = value;                                              \
+        if (++q->tail == q->capacity) q->tail = 0;                             \
+        ++q->size;                                                             \
+        return HLIB_OK;                                                        \
+    }                                                                          \
+                                                                               \
+    static inline hlib_status_t name##_pop(name##_t* q)                        \
+    {                                                                          \
+        if (q->size == 0) return HLIB_ERROR;                                   \
+        if (++q->head == q->capacity) q->head = 0;                             \
+        --q->size;                                                             \
+        return HLIB_OK;                                                        \
+    }                                                                          \
+                                                                               \
+    static inline T* name##_front(name##_t* q)                                 \
+    {                                                                          \
+        return q->size ? &q->data[q->head] : NULL;                             \
+    }                                                                          \
+                                                                               \
+    static inline T* name##_rear(name##_t* q)                                  \
+    {                                                                          \
+        if (q->size == 0) return NULL;                                         \
+        return &q->data[q->tail ? q->tail - 1 : q->capacity - 1];              \
+    }                                                                          \
+                                                                               \
+    static inline uint32_t name##_size(const name##_t* q) { return q->size; }  \
+    static inline bool name##_empty(const name##_t* q) { return q->size == 0; }\
+    static inline void name##_clear(name##_t* q)                               \
+    {                                                                          \
+        q->size = 0;                                                           \
+        q->head = 0;                                                           \
+        q->tail = 0;                                                           \
+    }
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+
+#define HQUEUE_DECLARE_ALLOC_(name, T)                                         \
+    static inline void name##_init(name##_t* q)                                \
+    {                                                                          \
+        q->size = 0;                                                           \
+        q->capacity = 0;                                                       \
+        q->head = 0;                                                           \
+        q->tail = 0;                                                           \
+        q->data = NULL;                                                        \
+    }                                                                          \
+                                                                               \
+    static inline void name##_destroy(name##_t* q)                             \
+    {                                                                          \
+        free(q->data);                                                         \
+        name##_init(q);                                                        \
+    }                                                                          \
+                                                                               \
+    /* 扩容时把环形数据展开到新数组的开头 */                                   \
+    static inline hlib_status_t name##_grow_(name##_t* q)                      \
+    {                                                                          \
+        uint32_t capacity = q->capacity ? q->capacity * 2u : 8u;               \
+        T* data = (T*)malloc((size_t)capacity * sizeof(T));                    \
+        if (data == NULL) return HLIB_ERROR;                                   \
+        for (uint32_t i = 0, j = q->head; i < q->size; ++i) {                  \
+            data[i] = q->data[j];                                              \
+            if (++j == q->capacity) j = 0;                                     \
+        }                                                                      \
+        free(q->data);                                                         \
+        q->data = data;                                                        \
+        q->capacity = capacity;                                                \
+        q->head = 0;                                                           \
+        q->tail = q->size;                                                     \
+        return HLIB_OK;                                                        \
+    }
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+
+#define HQUEUE_DECLARE_ALLOC_(name, T)                                         \
+    static inline void name##_init_static(name##_t* q, T* storage,             \
+                                          uint32_t capacity)                   \
+    {                                                                          \
+        q->size = 0;                                                           \
+        q->capacity = capacity;                                                \
+        q->head = 0;                                                           \
+        q->tail = 0;                                                           \
+        q->data = storage;                                                     \
+    }                                                                          \
+                                                                               \
+    static inline void name##_destroy_static(name##_t* q)                      \
+    {                                                                          \
+        q->size = 0;                                                           \
+        q->head = 0;                                                           \
+        q->tail = 0;                                                           \
+    }                                                                          \
+    static inline uint32_t name##_capacity(const name##_t* q)                  \
+    {                                                                          \
+        return q->capacity;                                                    \
+    }                                                                          \
+    static inline bool name##_full(const name##_t* q)                          \
+    {                                                                          \
+        return q->size >= q->capacity;                                         \
+    }                                                                          \
+                                                                               \
+    static inline hlib_status_t name##_grow_(name##_t* q)                      \
+    {                                                                          \
+        (void)q;                                                               \
+        return HLIB_OVERFLOW;                                                  \
+    }
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+#endif /* __HLIBC_HQUEUE_TYPED_H__ */
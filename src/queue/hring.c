@@ -0,0 +1,342 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/queue/hring.c
+ * @Description: 变长记录环形缓冲区（bip-buffer）：带长度前缀的记录连续存放，先进先出
+ * @other: None
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "hring.h"
+
+#include <string.h>
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+#include "../common/harena.h"
+#endif
+
+/*********************
+ *      MACROS
+ *********************/
+
+/* 动态分配时的默认初始数据区大小 */
+#define RING_DEFAULT_BYTES      1024u
+
+/* find_space 找不到位置时的返回值 */
+#define RING_NO_SPACE           UINT32_MAX
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*
+ * A 段为 [a_start, a_end)，B 段为 [0, b_end)，b_end 不为 0 时 B 段有效，此时新记录只能写入 B 段。
+ * 每条记录为 [uint32_t 负载长度][填充到 8 字节][负载，填充到 8 字节]。
+ * reserve_size 不为 0 表示有尚未提交的预留，位于 reserve_at，reserve_in_b 指明它属于哪一段。
+ */
+struct hring {
+    uint8_t* data;
+    uint32_t capacity;
+    uint32_t count;
+    uint32_t a_start;
+    uint32_t a_end;
+    uint32_t b_end;
+    uint32_t reserve_at;
+    uint32_t reserve_size;
+    bool reserve_in_b;
+#if HLIBC_USE_STATIC_ALLOC == 0
+    hallocator_t allocator;     /* 结构体与数据区的来源 */
+#endif
+};
+
+#if HLIBC_USE_STATIC_ALLOC == 1
+/* 头文件中的布局镜像必须与实际结构体一致 */
+_Static_assert(sizeof(struct hring) == HRING_STRUCT_SIZE &&
+               _Alignof(struct hring) == _Alignof(hring_static_layout_t),
+               "hring_static_layout_t does not match struct hring");
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t find_space(hring_ptr_t ring, uint32_t need, bool* in_b);
+static uint32_t record_len(hring_ptr_t ring, uint32_t offset);
+#if HLIBC_USE_STATIC_ALLOC == 0
+static bool grow(hring_ptr_t ring, uint32_t need);
+#endif
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/* ==================== 动态分配实现 ==================== */
+
+hring_ptr_t hring_create(uint32_t initial_bytes)
+{
+    return hring_create_with_allocator(initial_bytes, NULL);
+}
+
+hring_ptr_t hring_create_with_allocator(uint32_t initial_bytes, const hallocator_t* allocator)
+{
+    if (initial_bytes == 0) initial_bytes = RING_DEFAULT_BYTES;
+    if (initial_bytes > UINT32_MAX - HRING_ALIGN) return NULL;
+    initial_bytes = HLIBC_ALIGN_UP(initial_bytes, HRING_ALIGN);
+
+    hring_ptr_t ring = (hring_ptr_t)hallocator_alloc(allocator, sizeof(struct hring));
+    if (ring == NULL) return NULL;
+    ring->data = (uint8_t*)hallocator_alloc(allocator, initial_bytes);
+    if (ring->data == NULL) {
+        hallocator_free(allocator, ring, sizeof(struct hring));
+        return NULL;
+    }
+    if (allocator != NULL) {
+        ring->allocator = *allocator;
+    } else {
+        memset(&ring->allocator, 0, sizeof(ring->allocator));
+    }
+    ring->capacity = initial_bytes;
+    hring_clear(ring);
+    return ring;
+}
+
+void hring_destroy(hring_ptr_t ring)
+{
+    hallocator_t allocator = ring->allocator;
+    hallocator_free(&allocator, ring->data, ring->capacity);
+    hallocator_free(&allocator, ring, sizeof(struct hring));
+}
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+/* ==================== 静态分配实现 ==================== */
+
+hring_ptr_t hring_create_static(void* buffer, uint32_t buffer_size)
+{
+    if (buffer == NULL) return NULL;
+
+    /* 未对齐的 buffer 先跳过开头的若干字节 */
+    uint8_t* base = (uint8_t*)HLIBC_ALIGN_UP((uintptr_t)buffer, HLIBC_STATIC_ALIGN);
+    uint32_t skip = (uint32_t)(base - (uint8_t*)buffer);
+    uint32_t header_size = HLIBC_ALIGN_UP(sizeof(struct hring), HLIBC_STATIC_ALIGN);
+    if (buffer_size < skip + header_size + HRING_RECORD_SIZE(0)) return NULL;
+
+    hring_ptr_t ring = (hring_ptr_t)base;
+    ring->data = base + header_size;
+    /* 数据区按记录粒度截断，记录总是从 8 字节边界开始 */
+    ring->capacity = (buffer_size - skip - header_size) & ~(HRING_ALIGN - 1u);
+    hring_clear(ring);
+    return ring;
+}
+
+void hring_destroy_static(hring_ptr_t ring)
+{
+    if (ring == NULL) return;
+    /* 静态分配不释放内存，只重置状态 */
+    hring_clear(ring);
+}
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+void* hring_reserve(hring_ptr_t ring, uint32_t max_len)
+{
+    ring->reserve_size = 0;
+    if (max_len > UINT32_MAX - HRING_HEADER_SIZE - HRING_ALIGN) return NULL;
+    uint32_t need = (uint32_t)HRING_RECORD_SIZE(max_len);
+
+    /* 空 ring 从数据区开头写起，避免无谓地另起 B 段 */
+    if (ring->count == 0) ring->a_start = ring->a_end = ring->b_end = 0;
+
+    bool in_b = false;
+    uint32_t offset = find_space(ring, need, &in_b);
+    if (offset == RING_NO_SPACE) {
+#if HLIBC_USE_STATIC_ALLOC == 0
+        if (!grow(ring, need)) return NULL;
+        offset = find_space(ring, need, &in_b);
+#else
+        return NULL;
+#endif
+    }
+
+    ring->reserve_at = offset;
+    ring->reserve_size = need;
+    ring->reserve_in_b = in_b;
+    return ring->data + offset + HRING_HEADER_SIZE;
+}
+
+hlib_status_t hring_commit(hring_ptr_t ring, uint32_t len)
+{
+    if (ring->reserve_size == 0 || HRING_RECORD_SIZE(len) > ring->reserve_size) return HLIB_ERROR;
+
+    uint32_t size = (uint32_t)HRING_RECORD_SIZE(len);
+    memcpy(ring->data + ring->reserve_at, &len, sizeof(len));
+    if (ring->reserve_in_b) {
+        ring->b_end = ring->reserve_at + size;
+    } else {
+        ring->a_end = ring->reserve_at + size;
+    }
+    ++ring->count;
+    ring->reserve_size = 0;
+    return HLIB_OK;
+}
+
+hlib_status_t hring_push(hring_ptr_t ring, const void* data, uint32_t len)
+{
+    void* dst = hring_reserve(ring, len);
+    if (dst == NULL) {
+#if HLIBC_USE_STATIC_ALLOC == 0
+        return HLIB_ERROR;
+#else
+        return HLIB_OVERFLOW;
+#endif
+    }
+    if (len != 0) memcpy(dst, data, len);
+    return hring_commit(ring, len);
+}
+
+bool hring_pop(hring_ptr_t ring)
+{
+    if (ring->count == 0) return false;
+
+    ring->a_start += (uint32_t)HRING_RECORD_SIZE(record_len(ring, ring->a_start));
+    --ring->count;
+    if (ring->a_start != ring->a_end) return true;
+
+    if (ring->b_end != 0) {
+        /* A 段读完，B 段成为新的 A 段；B 段上的预留随之落在新 A 段的末尾 */
+        ring->a_start = 0;
+        ring->a_end = ring->b_end;
+        ring->b_end = 0;
+        ring->reserve_in_b = false;
+    } else if (ring->reserve_size != 0) {
+        /* ring 已空，但预留仍然有效：以预留位置作为空 A 段的起点 */
+        ring->a_start = ring->a_end = ring->reserve_at;
+        ring->reserve_in_b = false;
+    } else {
+        ring->a_start = ring->a_end = 0;
+    }
+    return true;
+}
+
+void hring_clear(hring_ptr_t ring)
+{
+    ring->count = 0;
+    ring->a_start = 0;
+    ring->a_end = 0;
+    ring->b_end = 0;
+    ring->reserve_at = 0;
+    ring->reserve_size = 0;
+    ring->reserve_in_b = false;
+}
+
+const void* hring_peek(hring_ptr_t ring, uint32_t* len)
+{
+    if (ring->count == 0) return NULL;
+    if (len != NULL) *len = record_len(ring, ring->a_start);
+    return ring->data + ring->a_start + HRING_HEADER_SIZE;
+}
+
+uint32_t hring_foreach(hring_ptr_t ring, hring_foreach_f fn, void* ctx)
+{
+    uint32_t visited = 0;
+    uint32_t offset = ring->a_start;
+    uint32_t end = ring->a_end;
+    bool in_b = false;
+    while (visited < ring->count) {
+        if (offset == end && !in_b) {
+            offset = 0;
+            end = ring->b_end;
+            in_b = true;
+        }
+        uint32_t len = record_len(ring, offset);
+        ++visited;
+        if (!fn(ring->data + offset + HRING_HEADER_SIZE, len, ctx)) break;
+        offset += (uint32_t)HRING_RECORD_SIZE(len);
+    }
+    return visited;
+}
+
+uint32_t hring_count(hring_ptr_t ring)
+{
+    return ring->count;
+}
+
+bool hring_empty(hring_ptr_t ring)
+{
+    return ring->count == 0;
+}
+
+uint32_t hring_bytes(hring_ptr_t ring)
+{
+    return ring->a_end - ring->a_start + ring->b_end;
+}
+
+uint32_t hring_capacity(hring_ptr_t ring)
+{
+    return ring->capacity;
+}
+
+uint32_t hring_free_contiguous(hring_ptr_t ring)
+{
+    if (ring->count == 0) return ring->capacity;
+    if (ring->b_end != 0) return ring->a_start - ring->b_end;
+    uint32_t tail = ring->capacity - ring->a_end;
+    return tail > ring->a_start ? tail : ring->a_start;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* 为 need 字节的记录找位置：B 段有效时只能接在 B 段之后，否则优先接在 A 段之后，其次从开头另起 B 段 */
+static uint32_t find_space(hring_ptr_t ring, uint32_t need, bool* in_b)
+{
+    if (ring->b_end != 0) {
+        *in_b = true;
+        return ring->a_start - ring->b_end >= need ? ring->b_end : RING_NO_SPACE;
+    }
+    if (ring->capacity - ring->a_end >= need) {
+        *in_b = false;
+        return ring->a_end;
+    }
+    if (ring->a_start >= need) {
+        *in_b = true;
+        return 0;
+    }
+    return RING_NO_SPACE;
+}
+
+static uint32_t record_len(hring_ptr_t ring, uint32_t offset)
+{
+    uint32_t len;
+    memcpy(&len, ring->data + offset, sizeof(len));
+    return len;
+}
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/* 数据区至少翻倍，A、B 两段按先后顺序搬到新数据区的开头，B 段随之消失 */
+static bool grow(hring_ptr_t ring, uint32_t need)
+{
+    uint32_t used = hring_bytes(ring);
+    if (need > UINT32_MAX - used) return false;
+    uint32_t capacity = ring->capacity <= UINT32_MAX / 2 ? ring->capacity * 2 : UINT32_MAX;
+    if (capacity < used + need) capacity = used + need;
+    capacity &= ~(HRING_ALIGN - 1u);
+    if (capacity < used + need) return false;
+
+    uint8_t* data = (uint8_t*)hallocator_alloc(&ring->allocator, capacity);
+    if (data == NULL) return false;
+    uint32_t a_len = ring->a_end - ring->a_start;
+    memcpy(data, ring->data + ring->a_start, a_len);
+    memcpy(data + a_len, ring->data, ring->b_end);
+    hallocator_free(&ring->allocator, ring->data, ring->capacity);
+
+    ring->data = data;
+    ring->capacity = capacity;
+    ring->a_start = 0;
+    ring->a_end = used;
+    ring->b_end = 0;
+    return true;
+}
+#endif
@@ -0,0 +1,221 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/queue/hring.h
+ * @Description: 变长记录环形缓冲区（bip-buffer）：带长度前缀的记录连续存放，先进先出
+ * @other: None
+ */
+#ifndef __HLIBC_HRING_H__
+#define __HLIBC_HRING_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../common/hcommon.h"
+#include "../common/hlibc_config.h"
+
+/*********************
+ *      MACROS
+ *********************/
+
+/* 记录头（长度前缀）大小与记录的对齐粒度，负载从 8 字节边界开始 */
+#define HRING_ALIGN             8u
+#define HRING_HEADER_SIZE       8u
+
+/* 负载为 len 字节的记录在缓冲区中占用的字节数 */
+#define HRING_RECORD_SIZE(len) \
+  (HRING_HEADER_SIZE + HLIBC_ALIGN_UP((size_t)(len), HRING_ALIGN))
+
+/*
+ * 静态分配结构体大小（精确值，hring.c 中用 _Static_assert 校验）
+ */
+#define HRING_STRUCT_SIZE sizeof(hring_static_layout_t)
+
+/**
+ * 计算静态 ring 所需的 buffer 大小
+ * buffer 按 HLIBC_STATIC_ALIGN 对齐时数据区恰好为 bytes 字节（HRING_DEFINE_STATIC 会自动对齐）
+ * @param bytes 数据区字节数，可以用 HRING_RECORD_SIZE 估算；
+ *              bip-buffer 的记录不会跨越结尾，能同时存放的最大记录约为数据区的一半
+ *
+ * 内存布局: [hring结构体][对齐填充][数据区]
+ */
+#define HRING_BUFFER_SIZE(bytes)                                \
+  (HLIBC_ALIGN_UP(HRING_STRUCT_SIZE, HLIBC_STATIC_ALIGN) +      \
+   HLIBC_ALIGN_UP((size_t)(bytes), HRING_ALIGN))
+
+/**
+ * 定义一个静态 ring（便捷宏）
+ * @param name 变量名
+ * @param bytes 数据区字节数
+ *
+ * 使用示例:
+ *   HRING_DEFINE_STATIC(log_ring, 4096);
+ *   hring_push(log_ring, line, (uint32_t)strlen(line));
+ */
+#define HRING_DEFINE_STATIC(name, bytes)                                        \
+  HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static                                      \
+      uint8_t name##_buffer[HRING_BUFFER_SIZE(bytes)];                          \
+  hring_ptr_t name = hring_create_static(name##_buffer, sizeof(name##_buffer))
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct hring* hring_ptr_t;
+
+/* 遍历回调，返回 false 时停止遍历 */
+typedef bool (*hring_foreach_f)(const void* data, uint32_t len, void* ctx);
+
+/*
+ * 静态分配模式下 struct hring 的布局镜像，仅用于在编译期得到精确大小，
+ * 字段必须与 hring.c 保持一致
+ */
+typedef struct {
+    uint8_t* data_;
+    uint32_t capacity_;
+    uint32_t count_;
+    uint32_t a_start_;
+    uint32_t a_end_;
+    uint32_t b_end_;
+    uint32_t reserve_at_;
+    uint32_t reserve_size_;
+    bool reserve_in_b_;
+} hring_static_layout_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/*
+ * 数据区分为 A、B 两段：记录追加在 A 的末尾，A 的末尾放不下时从数据区开头另起 B 段，
+ * 读取总是从 A 的开头进行，A 读完后 B 成为新的 A。每条记录都在数据区中连续存放，
+ * 写入方可以直接在 reserve 返回的位置组装消息，读取方拿到的也是一段连续内存。
+ * 与 hqueue 一样不是线程安全的。
+ */
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/**
+ * 创建一个 ring（动态分配），空间不足时数据区按 2 倍增长
+ * @param initial_bytes 初始数据区字节数，0 表示使用默认值
+ * @return 返回新创建的 ring，失败返回 NULL
+ */
+extern hring_ptr_t hring_create(uint32_t initial_bytes);
+
+/**
+ * 创建一个 ring，结构体与数据区由指定的分配器提供（动态分配）
+ * @param initial_bytes 初始数据区字节数，0 表示使用默认值
+ * @param allocator 分配器，NULL 等同于 `hring_create`；内容会被复制，无需长期保存
+ * @return 返回新创建的 ring，失败返回 NULL
+ */
+extern hring_ptr_t hring_create_with_allocator(uint32_t initial_bytes,
+                                               const hallocator_t* allocator);
+
+/**
+ * 删除给定的 ring（动态分配版本）
+ * @param ring 一个由 `hring_create` 返回的 ring
+ */
+extern void hring_destroy(hring_ptr_t ring);
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+
+/**
+ * 在调用者提供的 buffer 上创建 ring，数据区大小固定
+ * @param buffer 用户提供的内存缓冲区
+ * @param buffer_size 缓冲区大小（使用 HRING_BUFFER_SIZE 宏计算）
+ * @return 返回 ring 指针，失败返回 NULL
+ */
+extern hring_ptr_t hring_create_static(void* buffer, uint32_t buffer_size);
+
+/**
+ * 销毁静态分配的 ring（仅清理内容，不释放内存）
+ * @param ring 一个由 `hring_create_static` 返回的 ring
+ */
+extern void hring_destroy_static(hring_ptr_t ring);
+
+/* 兼容性宏定义 */
+#define hring_create(initial_bytes) ((void)(initial_bytes), (hring_ptr_t)NULL) /* 静态模式下禁用 */
+#define hring_create_with_allocator(initial_bytes, allocator) \
+  ((void)(initial_bytes), (void)(allocator), (hring_ptr_t)NULL) /* 静态模式下禁用 */
+#define hring_destroy(ring) hring_destroy_static(ring)
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+/**
+ * 为一条最长 max_len 字节的记录预留连续空间，之后用 hring_commit 提交实际长度
+ * 未提交的预留在下一次 reserve/push 时作废；动态分配时增长数据区会使 peek 返回的指针失效
+ * @param ring ring
+ * @param max_len 记录负载的最大字节数
+ * @return 负载的写入位置（8 字节对齐）；空间不足（静态分配）或内存不足（动态分配）时返回 NULL
+ */
+extern void* hring_reserve(hring_ptr_t ring, uint32_t max_len);
+
+/**
+ * 提交最近一次预留的记录
+ * @param ring ring
+ * @param len 记录负载的实际字节数，不大于预留时的 max_len
+ * @return HLIB_OK 成功；HLIB_ERROR 没有预留或 len 超出预留
+ */
+extern hlib_status_t hring_commit(hring_ptr_t ring, uint32_t len);
+
+/**
+ * 复制一条记录放入 ring（reserve + memcpy + commit）
+ * @return HLIB_OK 成功；HLIB_OVERFLOW 空间不足（静态分配）；HLIB_ERROR 内存不足（动态分配）
+ */
+extern hlib_status_t hring_push(hring_ptr_t ring, const void* data, uint32_t len);
+
+/**
+ * 丢弃最早的一条记录
+ * @return ring 为空时返回 false
+ */
+extern bool hring_pop(hring_ptr_t ring);
+
+/**
+ * 清空 ring（动态分配时保留数据区）
+ */
+extern void hring_clear(hring_ptr_t ring);
+
+/*=======================
+ * Getter functions
+ *======================*/
+
+/**
+ * 最早的一条记录
+ * @param ring ring
+ * @param len 输出记录负载的字节数，不需要时可为 NULL
+ * @return 负载的起始位置（连续，8 字节对齐），ring 为空时返回 NULL
+ */
+extern const void* hring_peek(hring_ptr_t ring, uint32_t* len);
+
+/**
+ * 按先进先出的顺序遍历全部记录（不取出）
+ * @return 遍历的记录数
+ */
+extern uint32_t hring_foreach(hring_ptr_t ring, hring_foreach_f fn, void* ctx);
+
+/* 记录条数 */
+extern uint32_t hring_count(hring_ptr_t ring);
+extern bool hring_empty(hring_ptr_t ring);
+
+/* 已占用的字节数（含记录头与对齐填充） */
+extern uint32_t hring_bytes(hring_ptr_t ring);
+
+/* 数据区字节数（动态分配时会随增长变化） */
+extern uint32_t hring_capacity(hring_ptr_t ring);
+
+/**
+ * 当前能整块写入的最大字节数：负载为 len 的记录可以不增长直接放入，当且仅当 HRING_RECORD_SIZE(len) 不大于它
+ */
+extern uint32_t hring_free_contiguous(hring_ptr_t ring);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __HLIBC_HRING_H__ */
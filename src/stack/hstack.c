@@ -15,6 +15,7 @@
 
 #if HLIBC_USE_STATIC_ALLOC == 0
 #include <stdlib.h>
+#include "../common/harena.h"
 #endif
 
 /*********************
@@ -28,8 +29,27 @@
 typedef struct hnode hstack_node_t;
 struct hstack {
   uint32_t size;
+  uint32_t type_size;
   hstack_node_t* top;
+  harena_t arena; /* 节点与数据共用的分块节点池 */
+#if HLIBC_ENABLE_STATS
+  hlibc_stats_t stats;
+#endif
+  bool external; /* 结构体位于调用者提供的 buffer 中，destroy 时不释放 */
 };
+
+/* 节点数据在槽位中的偏移 */
+#define STACK_PAYLOAD_OFFSET HARENA_PAYLOAD_OFFSET(sizeof(hstack_node_t))
+/* 内联 buffer 中结构体之后的槽位起始偏移 */
+#define STACK_INLINE_HEADER_SIZE HLIBC_ALIGN_UP(sizeof(struct hstack), HARENA_ALIGN)
+
+/* 头文件中的布局镜像与槽位大小必须与实际一致 */
+_Static_assert(sizeof(struct hstack) == HSTACK_INLINE_STRUCT_SIZE &&
+               _Alignof(struct hstack) == _Alignof(hstack_inline_layout_t),
+               "hstack_inline_layout_t does not match struct hstack");
+_Static_assert(HSTACK_INLINE_SLOT_SIZE(1) ==
+                   HLIBC_ALIGN_UP(STACK_PAYLOAD_OFFSET + 1, HARENA_ALIGN),
+               "HSTACK_INLINE_SLOT_SIZE does not match the arena slot size");
 #else
 /* 静态分配使用数组实现栈 */
 struct hstack {
@@ -37,7 +57,18 @@ struct hstack {
   uint32_t capacity;
   uint32_t type_size;
   uint8_t* data_pool; /* 数据存储池 */
+#if HLIBC_ENABLE_STATS
+  hlibc_stats_t stats;
+#endif
 };
+
+/* 头文件中的布局镜像必须与实际结构体一致，HLIBC_STATIC_ALIGN 必须满足结构体的对齐要求 */
+_Static_assert(sizeof(struct hstack) == HSTACK_STRUCT_SIZE &&
+               _Alignof(struct hstack) == _Alignof(hstack_static_layout_t),
+               "hstack_static_layout_t does not match struct hstack");
+_Static_assert((HLIBC_STATIC_ALIGN & (HLIBC_STATIC_ALIGN - 1)) == 0 &&
+               HLIBC_STATIC_ALIGN >= _Alignof(struct hstack),
+               "HLIBC_STATIC_ALIGN must be a power of two no less than the struct alignment");
 #endif
 
 /**********************
@@ -61,40 +92,86 @@ struct hstack {
 
 hstack_ptr_t hstack_create(uint32_t type_size)
 {
-  (void)type_size; /* 动态版本不需要记录 type_size */
-  hstack_ptr_t stack = (hstack_ptr_t)malloc(sizeof(struct hstack));
+  return hstack_create_with_allocator(type_size, NULL);
+}
+
+hstack_ptr_t hstack_create_with_allocator(uint32_t type_size,
+                                          const hallocator_t* allocator)
+{
+  hstack_ptr_t stack = (hstack_ptr_t)hallocator_alloc(allocator, sizeof(struct hstack));
   if (stack == NULL) return NULL;
   stack->top = NULL;
   stack->size = 0;
+  stack->type_size = type_size;
+  stack->external = false;
+  harena_init(&stack->arena, STACK_PAYLOAD_OFFSET + type_size, allocator);
+#if HLIBC_ENABLE_STATS
+  hstats_reset(&stack->stats, 0);
+  HSTATS_ON_ALLOC(&stack->stats, sizeof(struct hstack));
+  stack->arena.stats = &stack->stats;
+#endif
+  return stack;
+}
+
+hstack_ptr_t hstack_create_inline(void* buffer, uint32_t buffer_size, uint32_t type_size,
+                                  const hallocator_t* allocator)
+{
+  if (buffer == NULL) return NULL;
+
+  /* 未对齐的 buffer 先跳过开头的若干字节 */
+  uint8_t* base = (uint8_t*)HLIBC_ALIGN_UP((uintptr_t)buffer, HARENA_ALIGN);
+  uint32_t skip = (uint32_t)(base - (uint8_t*)buffer);
+  if (buffer_size < skip + STACK_INLINE_HEADER_SIZE) return NULL;
+
+  hstack_ptr_t stack = (hstack_ptr_t)base;
+  stack->top = NULL;
+  stack->size = 0;
+  stack->type_size = type_size;
+  stack->external = true;
+  /* 结构体之后的空间作为节点池最先使用的槽位 */
+  harena_init_inline(&stack->arena, STACK_PAYLOAD_OFFSET + type_size, allocator,
+                     base + STACK_INLINE_HEADER_SIZE,
+                     buffer_size - skip - STACK_INLINE_HEADER_SIZE);
+#if HLIBC_ENABLE_STATS
+  hstats_reset(&stack->stats, 0);
+  stack->arena.stats = &stack->stats;
+#endif
   return stack;
 }
 
 void hstack_destroy(hstack_ptr_t stack)
 {
-    hstack_clear(stack);
-    free(stack);
+    hallocator_t allocator = stack->arena.allocator;
+    harena_release(&stack->arena);
+    if (!stack->external)
+        hallocator_free(&allocator, stack, sizeof(struct hstack));
 }
 
 /*=====================
  * Setter functions
  *====================*/
 
-hlib_status_t hstack_push(hstack_ptr_t stack, hdata_ptr_t data_ptr, uint32_t data_size, copy_data_f copy_data)
+hdata_ptr_t hstack_emplace(hstack_ptr_t stack)
 {
-    hstack_node_t *node = (hstack_node_t*) malloc(sizeof (hstack_node_t));
-    if (node == NULL) return HLIB_ERROR;
-    node->data_ptr = (hdata_ptr_t) malloc(data_size);
-    if (node->data_ptr == NULL) {
-      free(node);
-      return HLIB_ERROR;
-    }
-    if (copy_data != NULL)
-        copy_data(node->data_ptr, data_ptr);
-    else
-        memcpy(node->data_ptr, data_ptr, data_size);
+    hstack_node_t *node = (hstack_node_t*) harena_alloc(&stack->arena);
+    if (node == NULL) return NULL;
+    node->data_ptr = (uint8_t*)node + STACK_PAYLOAD_OFFSET;
     node->next = stack->top;
     stack->top = node;
     ++stack->size;
+    HSTATS_ON_PUSH(&stack->stats, stack->size);
+    return node->data_ptr;
+}
+
+hlib_status_t hstack_push(hstack_ptr_t stack, hdata_ptr_t data_ptr, uint32_t data_size, copy_data_f copy_data)
+{
+    if (data_size != stack->type_size) return HLIB_ERROR;
+    hdata_ptr_t dest = hstack_emplace(stack);
+    if (dest == NULL) return HLIB_ERROR;
+    if (copy_data != NULL)
+        copy_data(dest, data_ptr);
+    else
+        memcpy(dest, data_ptr, data_size);
     return HLIB_OK;
 }
 
@@ -103,17 +180,18 @@ hlib_status_t hstack_pop(hstack_ptr_t stack)
     if(stack->top == NULL) return HLIB_ERROR;
     hstack_node_t *p = stack->top;
     stack->top = stack->top->next;
-    free(p->data_ptr);
-    free(p);
+    harena_free(&stack->arena, p);
     --stack->size;
+    HSTATS_ON_POP(&stack->stats);
     return HLIB_OK;
 }
 
 void hstack_clear(hstack_ptr_t stack)
 {
-    while (!hstack_empty(stack)) {
-        hstack_pop(stack);
-    }
+    /* 节点全部归属于容器自己的节点池，整体回收即可 */
+    harena_release(&stack->arena);
+    stack->top = NULL;
+    stack->size = 0;
 }
 
 /*=======================
@@ -135,6 +213,46 @@ uint32_t hstack_size(hstack_ptr_t stack)
     return stack->size;
 }
 
+uint32_t hstack_type_size(hstack_ptr_t stack)
+{
+    return stack->type_size;
+}
+
+/*=======================
+ * Other functions
+ *======================*/
+
+uint32_t hstack_foreach(hstack_ptr_t stack, hforeach_f fn, void* ctx)
+{
+    uint32_t visited = 0;
+    for (hstack_node_t* node = stack->top; node != NULL; ) {
+        /* 节点与数据位于同一槽位，预取下一个节点即可 */
+        hstack_node_t* next = node->next;
+        if (next != NULL) HLIBC_PREFETCH(next->next);
+        ++visited;
+        if (!fn(node->data_ptr, ctx)) break;
+        node = next;
+    }
+    return visited;
+}
+
+uint32_t hstack_foreach_batch(hstack_ptr_t stack, hforeach_batch_f fn, void* ctx)
+{
+    hdata_ptr_t items[HLIBC_FOREACH_BATCH];
+    uint32_t visited = 0;
+    hstack_node_t* node = stack->top;
+    while (node != NULL) {
+        uint32_t n = 0;
+        do {
+            items[n++] = node->data_ptr;
+            node = node->next;
+        } while (n < HLIBC_FOREACH_BATCH && node != NULL);
+        visited += n;
+        if (!fn(items, n, ctx)) break;
+    }
+    return visited;
+}
+
 #else /* HLIBC_USE_STATIC_ALLOC == 1 */
 /* ==================== 静态分配实现 ==================== */
 
@@ -142,19 +260,25 @@ hstack_ptr_t hstack_create_static(void* buffer, uint32_t buffer_size,
                                   uint32_t type_size) {
   if (buffer == NULL || type_size == 0) return NULL;
 
-  uint32_t header_size = sizeof(struct hstack);
-  if (buffer_size <= header_size) return NULL;
+  /* 未对齐的 buffer 先跳过开头的若干字节 */
+  uint8_t* base = (uint8_t*)HLIBC_ALIGN_UP((uintptr_t)buffer, HLIBC_STATIC_ALIGN);
+  uint32_t skip = (uint32_t)(base - (uint8_t*)buffer);
+  uint32_t header_size = HLIBC_ALIGN_UP(sizeof(struct hstack), HLIBC_STATIC_ALIGN);
+  if (buffer_size <= skip + header_size) return NULL;
 
-  uint32_t remaining = buffer_size - header_size;
+  uint32_t remaining = buffer_size - skip - header_size;
   uint32_t capacity = remaining / type_size;
 
   if (capacity == 0) return NULL;
 
-  hstack_ptr_t stack = (hstack_ptr_t)buffer;
+  hstack_ptr_t stack = (hstack_ptr_t)base;
   stack->size = 0;
   stack->capacity = capacity;
   stack->type_size = type_size;
-  stack->data_pool = (uint8_t*)buffer + header_size;
+  stack->data_pool = base + header_size;
+#if HLIBC_ENABLE_STATS
+  hstats_reset(&stack->stats, 0);
+#endif
 
   return stack;
 }
@@ -168,24 +292,36 @@ void hstack_destroy_static(hstack_ptr_t stack) {
  * Setter functions
  *====================*/
 
+hdata_ptr_t hstack_emplace(hstack_ptr_t stack) {
+  if (stack->size >= stack->capacity) {
+    HSTATS_ON_OVERFLOW(&stack->stats);
+    return NULL;
+  }
+  hdata_ptr_t dest = stack->data_pool + stack->size++ * stack->type_size;
+  HSTATS_ON_PUSH(&stack->stats, stack->size);
+  return dest;
+}
+
 hlib_status_t hstack_push(hstack_ptr_t stack, hdata_ptr_t data_ptr,
                           uint32_t data_size, copy_data_f copy_data) {
-  if (stack->size >= stack->capacity) return HLIB_OVERFLOW;
+  if (stack->size >= stack->capacity) {
+    HSTATS_ON_OVERFLOW(&stack->stats);
+    return HLIB_OVERFLOW;
+  }
   if (data_size != stack->type_size) return HLIB_ERROR;
 
-  uint8_t* dest = stack->data_pool + stack->size * stack->type_size;
+  hdata_ptr_t dest = hstack_emplace(stack);
   if (copy_data != NULL)
     copy_data(dest, data_ptr);
   else
     memcpy(dest, data_ptr, data_size);
-
-  ++stack->size;
   return HLIB_OK;
 }
 
 hlib_status_t hstack_pop(hstack_ptr_t stack) {
   if (stack->size == 0) return HLIB_ERROR;
   --stack->size;
+  HSTATS_ON_POP(&stack->stats);
   return HLIB_OK;
 }
 
@@ -204,10 +340,63 @@ bool hstack_empty(hstack_ptr_t stack) { return (stack->size == 0); }
 
 uint32_t hstack_size(hstack_ptr_t stack) { return stack->size; }
 
+uint32_t hstack_type_size(hstack_ptr_t stack) { return stack->type_size; }
+
 uint32_t hstack_capacity(hstack_ptr_t stack) { return stack->capacity; }
 
 bool hstack_full(hstack_ptr_t stack) {
   return (stack->size >= stack->capacity);
 }
 
+/*=======================
+ * Other functions
+ *======================*/
+
+uint32_t hstack_foreach(hstack_ptr_t stack, hforeach_f fn, void* ctx) {
+  uint8_t* data = stack->data_pool + stack->size * stack->type_size;
+  for (uint32_t i = 0; i < stack->size; ++i) {
+    data -= stack->type_size;
+    if (!fn(data, ctx)) return i + 1;
+  }
+  return stack->size;
+}
+
+uint32_t hstack_foreach_batch(hstack_ptr_t stack, hforeach_batch_f fn, void* ctx) {
+  hdata_ptr_t items[HLIBC_FOREACH_BATCH];
+  uint8_t* data = stack->data_pool + stack->size * stack->type_size;
+  uint32_t visited = 0;
+  while (visited < stack->size) {
+    uint32_t n = 0;
+    do {
+      data -= stack->type_size;
+      items[n++] = data;
+    } while (n < HLIBC_FOREACH_BATCH && visited + n < stack->size);
+    visited += n;
+    if (!fn(items, n, ctx)) break;
+  }
+  return visited;
+}
+
+uint32_t hstack_foreach_span(hstack_ptr_t stack, hforeach_span_f fn, void* ctx) {
+  if (stack->size == 0) return 0;
+  fn(stack->data_pool, stack->size, ctx);
+  return stack->size;
+}
+
 #endif /* HLIBC_USE_STATIC_ALLOC */
+
+#if HLIBC_ENABLE_STATS
+/*=======================
+ * Statistics functions
+ *======================*/
+
+void hstack_get_stats(hstack_ptr_t stack, hlibc_stats_t* stats)
+{
+    *stats = stack->stats;
+}
+
+void hstack_reset_stats(hstack_ptr_t stack)
+{
+    hstats_reset(&stack->stats, stack->size);
+}
+#endif /* HLIBC_ENABLE_STATS */
@@ -17,25 +17,33 @@ extern "C" {
  *********************/
 #include "../common/hcommon.h"
 #include "../common/hlibc_config.h"
+#include "../common/hstats.h"
+#include "../common/harena.h"
 
 /*********************
  *      MACROS
  *********************/
 
 /*
- * 静态分配结构体大小常量
+ * 静态分配结构体大小（精确值，由 hstack_static_layout_t 得出，hstack.c 中用 _Static_assert 校验）
  */
-#define HSTACK_STRUCT_SIZE                             \
-  32 /* size + capacity + type_size + data_pool 指针 \
-      */
+#define HSTACK_STRUCT_SIZE sizeof(hstack_static_layout_t)
 
 /**
  * 计算静态 stack 所需的 buffer 大小
+ * buffer 按 HLIBC_STATIC_ALIGN 对齐时恰好容纳 capacity 个元素（HSTACK_DEFINE_STATIC 会自动对齐）
  * @param type 数据类型
  * @param capacity 容器最大容量
+ *
+ * 内存布局: [hstack结构体][对齐填充][数据数组]
  */
 #define HSTACK_CALC_BUFFER_SIZE(type, capacity) \
-  (HSTACK_STRUCT_SIZE + (capacity) * sizeof(type))
+  HSTACK_BUFFER_SIZE(sizeof(type), capacity)
+
+/* 同上，元素大小以字节数给出 */
+#define HSTACK_BUFFER_SIZE(type_size, capacity)                     \
+  (HLIBC_ALIGN_UP(HSTACK_STRUCT_SIZE, HLIBC_STATIC_ALIGN) +         \
+   (size_t)(capacity) * (type_size))
 
 /**
  * 定义一个静态 stack（便捷宏）
@@ -44,15 +52,89 @@ extern "C" {
  * @param capacity 容器最大容量
  */
 #define HSTACK_DEFINE_STATIC(name, type, capacity)                       \
-  static uint8_t name##_buffer[HSTACK_CALC_BUFFER_SIZE(type, capacity)]; \
+  HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static                               \
+      uint8_t name##_buffer[HSTACK_CALC_BUFFER_SIZE(type, capacity)];    \
   hstack_ptr_t name =                                                    \
       hstack_create_static(name##_buffer, sizeof(name##_buffer), sizeof(type))
 
+#if HLIBC_USE_STATIC_ALLOC == 0
+/*
+ * 内联 stack 结构体大小（精确值，由 hstack_inline_layout_t 得出，hstack.c 中用 _Static_assert 校验）
+ */
+#define HSTACK_INLINE_STRUCT_SIZE sizeof(hstack_inline_layout_t)
+
+/* 内联区域中单个元素占用的槽位大小（节点 + 数据） */
+#define HSTACK_INLINE_SLOT_SIZE(type_size) \
+  HLIBC_ALIGN_UP(HARENA_PAYLOAD_OFFSET(2 * sizeof(void*)) + (size_t)(type_size), HARENA_ALIGN)
+
+/**
+ * 计算内联 stack 所需的 buffer 大小
+ * buffer 按 HARENA_ALIGN 对齐时恰好内联 count 个元素（HSTACK_DEFINE_INLINE 会自动对齐）
+ * @param type_size 元素的字节数
+ * @param count 内联的元素个数，超出后才向分配器申请
+ *
+ * 内存布局: [hstack结构体][对齐填充][count 个槽位]
+ */
+#define HSTACK_INLINE_BUFFER_SIZE(type_size, count)                  \
+  (HLIBC_ALIGN_UP(HSTACK_INLINE_STRUCT_SIZE, HARENA_ALIGN) +         \
+   (size_t)(count) * HSTACK_INLINE_SLOT_SIZE(type_size))
+
+/**
+ * 在当前作用域（通常是栈帧）定义一个内联 stack（便捷宏）
+ * 前 count 个元素不调用分配器，离开作用域前仍需 hstack_destroy 归还溢出的部分
+ * @param name 变量名
+ * @param type 数据类型
+ * @param count 内联的元素个数
+ *
+ * 使用示例:
+ *   HSTACK_DEFINE_INLINE(todo, struct job, 16);
+ *   hstack_push(todo, &job, sizeof(job), NULL);
+ *   ...
+ *   hstack_destroy(todo);
+ */
+#define HSTACK_DEFINE_INLINE(name, type, count)                                    \
+  HLIBC_ALIGNAS(HARENA_ALIGN)                                                      \
+      uint8_t name##_buffer[HSTACK_INLINE_BUFFER_SIZE(sizeof(type), count)];       \
+  hstack_ptr_t name =                                                              \
+      hstack_create_inline(name##_buffer, sizeof(name##_buffer), sizeof(type), NULL)
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
 typedef struct hstack* hstack_ptr_t;
 
+/*
+ * 静态分配模式下 struct hstack 的布局镜像，仅用于在编译期得到精确大小，
+ * 字段必须与 hstack.c 保持一致
+ */
+typedef struct {
+  uint32_t size_;
+  uint32_t capacity_;
+  uint32_t type_size_;
+  void* data_pool_;
+#if HLIBC_ENABLE_STATS
+  hlibc_stats_t stats_;
+#endif
+} hstack_static_layout_t;
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/*
+ * 动态分配模式下 struct hstack 的布局镜像，仅用于计算内联 buffer 的大小，
+ * 字段必须与 hstack.c 保持一致
+ */
+typedef struct {
+  uint32_t size_;
+  uint32_t type_size_;
+  void* top_;
+  harena_t arena_;
+#if HLIBC_ENABLE_STATS
+  hlibc_stats_t stats_;
+#endif
+  bool external_;
+} hstack_inline_layout_t;
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -65,9 +147,31 @@ typedef struct hstack* hstack_ptr_t;
  */
 extern hstack_ptr_t hstack_create(uint32_t type_size);
 
+/**
+ * 创建一个 stack 容器，结构体与节点池 chunk 由指定的分配器提供（动态分配）
+ * @param type_size 装入容器的数据类型的大小
+ * @param allocator 分配器，NULL 等同于 `hstack_create`；内容会被复制，无需长期保存
+ * @return 返回新创建的 stack 容器
+ */
+extern hstack_ptr_t hstack_create_with_allocator(uint32_t type_size,
+                                                 const hallocator_t* allocator);
+
+/**
+ * 在调用者提供的 buffer 中创建一个 stack 容器（动态分配）
+ * 结构体与前若干个元素都放在 buffer 中，超出后才向分配器申请，短生命周期的容器可以完全不调用分配器
+ * @param buffer 内存缓冲区，通常位于调用者的栈帧中，生命周期须覆盖容器的使用期
+ * @param buffer_size 缓冲区大小（使用 HSTACK_INLINE_BUFFER_SIZE 宏计算）
+ * @param type_size 装入容器的数据类型的大小
+ * @param allocator 溢出部分的分配器，NULL 表示使用 malloc/free
+ * @return 返回容器指针，buffer 放不下结构体时返回 NULL
+ */
+extern hstack_ptr_t hstack_create_inline(void* buffer, uint32_t buffer_size, uint32_t type_size,
+                                         const hallocator_t* allocator);
+
 /**
  * 删除给定的 stack 容器（动态分配版本）
- * @param stack 一个由 `hstack_create` 返回的容器
+ * 由 `hstack_create_inline` 创建的容器只归还溢出的部分，buffer 由调用者管理
+ * @param stack 一个由 `hstack_create` 或 `hstack_create_inline` 返回的容器
  */
 extern void hstack_destroy(hstack_ptr_t stack);
 
@@ -102,11 +206,19 @@ extern void hstack_destroy_static(hstack_ptr_t stack);
 extern hlib_status_t hstack_push(hstack_ptr_t stack, hdata_ptr_t data_ptr, uint32_t data_size, copy_data_f copy_data);
 extern hlib_status_t hstack_pop(hstack_ptr_t stack);
 
+/**
+ * 原地构造：在栈顶压入一个未初始化的元素，由调用者直接写入数据
+ * @param stack 容器
+ * @return 新元素的数据指针，内存不足或容器已满时返回 NULL
+ */
+extern hdata_ptr_t hstack_emplace(hstack_ptr_t stack);
+
 /**
  * 清理 stack 容器的所有内容
  * @param stack 一个由 `hstack_create` 或 `hstack_create_static` 返回的容器
  * ！！！慎用：调用此函数将会清理掉栈内容，对于普通数据而言并无影响；
  * 但是对于指针数据来说，一旦清空栈之后便无法找到其指针，故而会造成内存泄漏，除非使用者有其他记录。
+ * 节点由容器的节点池整体回收：动态模式为 O(chunk 数)，静态模式为 O(1)。
  */
 extern void hstack_clear(hstack_ptr_t stack);
 
@@ -118,6 +230,11 @@ extern hdata_ptr_t hstack_top(hstack_ptr_t stack);
 extern bool hstack_empty(hstack_ptr_t stack);
 extern uint32_t hstack_size(hstack_ptr_t stack);
 
+/**
+ * 获取创建时指定的元素大小
+ */
+extern uint32_t hstack_type_size(hstack_ptr_t stack);
+
 #if HLIBC_USE_STATIC_ALLOC
 /**
  * 获取 stack 容器的最大容量（仅静态分配模式）
@@ -130,6 +247,54 @@ extern uint32_t hstack_capacity(hstack_ptr_t stack);
 extern bool hstack_full(hstack_ptr_t stack);
 #endif
 
+/*=======================
+ * Other functions
+ *======================*/
+
+/**
+ * 从栈顶到栈底对每个元素调用 fn
+ * @param stack 容器
+ * @param fn 回调，返回 false 时停止遍历；回调中不能 push/pop
+ * @param ctx 原样传给 fn
+ * @return 已调用 fn 的元素个数
+ */
+extern uint32_t hstack_foreach(hstack_ptr_t stack, hforeach_f fn, void* ctx);
+
+/**
+ * 从栈顶到栈底按批遍历，每次传入最多 HLIBC_FOREACH_BATCH 个元素的数据指针
+ * @param fn 回调，items 仅在本次回调内有效，返回 false 时停止遍历
+ * @return 已传给 fn 的元素个数
+ */
+extern uint32_t hstack_foreach_batch(hstack_ptr_t stack, hforeach_batch_f fn, void* ctx);
+
+#if HLIBC_USE_STATIC_ALLOC
+/**
+ * 以一段连续内存遍历全部元素（仅静态分配模式）
+ * 注意顺序与 hstack_foreach 相反：base 指向栈底，栈顶是第 count - 1 个元素
+ * @return 已传给 fn 的元素个数
+ */
+extern uint32_t hstack_foreach_span(hstack_ptr_t stack, hforeach_span_f fn, void* ctx);
+#endif
+
+#if HLIBC_ENABLE_STATS
+/*=======================
+ * Statistics functions
+ *======================*/
+
+/**
+ * 读取 hstack 容器的运行统计（仅在 HLIBC_ENABLE_STATS 为 1 时提供）
+ * @param stack 一个由 `hstack_create` 或 `hstack_create_static` 返回的容器
+ * @param stats 输出统计快照
+ */
+extern void hstack_get_stats(hstack_ptr_t stack, hlibc_stats_t* stats);
+
+/**
+ * 清零 hstack 容器的运行统计，高水位从当前元素个数重新开始
+ * @param stack 一个由 `hstack_create` 或 `hstack_create_static` 返回的容器
+ */
+extern void hstack_reset_stats(hstack_ptr_t stack);
+#endif
+
 #ifdef __cplusplus
 } /*extern "C"*/
 #endif
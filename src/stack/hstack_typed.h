@@ -0,0 +1,133 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/stack/hstack_typed.h
+ * @Description: 宏生成的类型特化 stack（全部 static inline，可完全内联）
+ * @other: None
+ */
+#ifndef __HLIBC_HSTACK_TYPED_H__
+#define __HLIBC_HSTACK_TYPED_H__
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../common/hcommon.h"
+#include "../common/hlibc_config.h"
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+#include <stdlib.h>
+#endif
+
+/*********************
+ *      MACROS
+ *********************/
+
+/**
+ * 生成一个元素类型为 T 的 stack，类型名为 `name_t`，函数前缀为 `name_`
+ * 元素按值传递与拷贝，不经过 type_size/memcpy，编译器可以直接内联。
+ *
+ * 动态分配模式：连续数组存储，容量不足时按 2 倍扩容
+ *   name_init(s) / name_destroy(s)
+ * 静态分配模式：使用用户提供的 T 数组，满时返回 HLIB_OVERFLOW
+ *   name_init_static(s, storage, capacity) / name_capacity(s) / name_full(s)
+ *
+ * 通用操作：name_push / name_pop / name_top / name_size / name_empty / name_clear
+ *
+ * 使用示例:
+ *   HSTACK_DECLARE(int_stack, int)
+ *   int_stack_t s;
+ *   int_stack_init(&s);
+ *   int_stack_push(&s, 10);
+ *   int x = *int_stack_top(&s);
+ */
+#define HSTACK_DECLARE(name, T)                                                \
+    typedef struct name {                                                      \
+        uint32_t size;                                                         \
+        uint32_t capacity;                                                     \
+        T* data;                                                               \
+    } name##_t;                                                                \
+                                                                               \
+    HSTACK_DECLARE_ALLOC_(name, T)                                             \
+                                                                               \
+    static inline hlib_status_t name##_push(name##_t* s, T value)              \
+    {                                                                          \
+        if (s->size == s->capacity) {                                          \
+            hlib_status_t status = name##_grow_(s);                            \
+            if (status != HLIB_OK) return status;                              \
+        }                                                                      \
+        s->data[s->size++] = value;                                            \
+        return HLIB_OK;                                                        \
+    }                                                                          \
+                                                                               \
+    static inline hlib_status_t name##_pop(name##_t* s)                        \
+    {                                                                          \
+        if (s->size == 0) return HLIB_ERROR;                                   \
+        --s->size;                                                             \
+        return HLIB_OK;                                                        \
+    }                                                                          \
+                                                                               \
+    static inline T* name##_top(name##_t* s)                                   \
+    {                                                                          \
+        return s->size ? &s->data[s->size - 1] : NULL;                         \
+    }                                                                          \
+                                                                               \
+    static inline uint32_t name##_size(const name##_t* s) { return s->size; }  \
+    static inline bool name##_empty(const name##_t* s) { return s->size == 0; }\
+    static inline void name##_clear(name##_t* s) { s->size = 0; }
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+
+#define HSTACK_DECLARE_ALLOC_(name, T)                                         \
+    static inline void name##_init(name##_t* s)                                \
+    {                                                                          \
+        s->size = 0;                                                           \
+        s->capacity = 0;                                                       \
+        s->data = NULL;                                                        \
+    }                                                                          \
+                                                                               \
+    static inline void name##_destroy(name##_t* s)                             \
+    {                                                                          \
+        free(s->data);                                                         \
+        name##_init(s);                                                        \
+    }                                                                          \
+                                                                               \
+    static inline hlib_status_t name##_grow_(name##_t* s)                      \
+    {                                                                          \
+        uint32_t capacity = s->capacity ? s->capacity * 2u : 8u;               \
+        T* data = (T*)realloc(s->data, (size_t)capacity * sizeof(T));          \
+        if (data == NULL) return HLIB_ERROR;                                   \
+        s->data = data;                                                        \
+        s->capacity = capacity;                                                \
+        return HLIB_OK;                                                        \
+    }
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+
+#define HSTACK_DECLARE_ALLOC_(name, T)                                         \
+    static inline void name##_init_static(name##_t* s, T* storage,             \
+                                          uint32_t capacity)                   \
+    {                                                                          \
+        s->size = 0;                                                           \
+        s->capacity = capacity;                                                \
+        s->data = storage;                                                     \
+    }                                                                          \
+                                                                               \
+    static inline void name##_destroy_static(name##_t* s) { s->size = 0; }     \
+    static inline uint32_t name##_capacity(const name##_t* s)                  \
+    {                                                                          \
+        return s->capacity;                                                    \
+    }                                                                          \
+    static inline bool name##_full(const name##_t* s)                          \
+    {                                                                          \
+        return s->size >= s->capacity;                                         \
+    }                                                                          \
+                                                                               \
+    static inline hlib_status_t name##_grow_(name##_t* s)                      \
+    {                                                                          \
+        (void)s;                                                               \
+        return HLIB_OVERFLOW;                                                  \
+    }
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+#endif /* __HLIBC_HSTACK_TYPED_H__ */
@@ -0,0 +1,309 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/stack/hwsdeque.c
+ * @Description: 工作窃取双端队列（Chase-Lev）
+ * @other: None
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "hwsdeque.h"
+
+#if HLIBC_USE_THREADS
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+#include <stdlib.h>
+#endif
+
+/*********************
+ *      MACROS
+ *********************/
+#define WS_DEFAULT_CAPACITY     64u
+#define WS_MAX_CAPACITY         (1u << 31)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/* 元素数组，容量为 2 的幂，下标对 mask 取与 */
+typedef struct ws_array {
+    struct ws_array* retired;   /* 被替换下来的旧数组（仅动态分配） */
+    uint32_t mask;              /* capacity - 1 */
+    uint32_t words;             /* 每个元素占用的原子字数 */
+    atomic_uintptr_t slots[];
+} ws_array_t;
+
+/*
+ * top 只被窃取者用 CAS 推进，bottom 只被拥有者修改，二者放在不同的缓存行。
+ * Chase-Lev 算法的内存序参照 Lê 等人的 C11 版本
+ * （Correct and Efficient Work-Stealing for Weak Memory Models, PPoPP 2013）。
+ */
+struct hwsdeque {
+    uint32_t type_size;
+    _Atomic(ws_array_t*) array;
+    _Alignas(HLIBC_CACHE_LINE_SIZE) _Atomic int64_t top;
+    _Alignas(HLIBC_CACHE_LINE_SIZE) _Atomic int64_t bottom;
+};
+
+#if HLIBC_USE_STATIC_ALLOC
+/* 头文件中的布局镜像必须与实际结构体一致 */
+_Static_assert(sizeof(struct hwsdeque) == sizeof(hwsdeque_static_layout_t) &&
+               _Alignof(struct hwsdeque) == _Alignof(hwsdeque_static_layout_t),
+               "hwsdeque_static_layout_t does not match struct hwsdeque");
+_Static_assert(sizeof(ws_array_t) == sizeof(hwsdeque_array_layout_t) &&
+               offsetof(ws_array_t, slots) == sizeof(hwsdeque_array_layout_t),
+               "hwsdeque_array_layout_t does not match ws_array_t");
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void slot_store(ws_array_t* array, int64_t index, const uint8_t* src, uint32_t size);
+static void slot_load(ws_array_t* array, int64_t index, uint8_t* dest, uint32_t size);
+#if HLIBC_USE_STATIC_ALLOC == 0
+static ws_array_t* array_create(uint32_t capacity, uint32_t words);
+static ws_array_t* grow(hwsdeque_ptr_t deque, ws_array_t* old, int64_t top, int64_t bottom);
+#endif
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/* ==================== 动态分配实现 ==================== */
+
+hwsdeque_ptr_t hwsdeque_create(uint32_t type_size, uint32_t initial_capacity)
+{
+    if (type_size == 0) return NULL;
+    if (initial_capacity == 0) initial_capacity = WS_DEFAULT_CAPACITY;
+    if (initial_capacity > WS_MAX_CAPACITY) return NULL;
+    uint32_t capacity = 1;
+    while (capacity < initial_capacity) capacity <<= 1;
+
+    hwsdeque_ptr_t deque = (hwsdeque_ptr_t)aligned_alloc(HLIBC_CACHE_LINE_SIZE, sizeof(struct hwsdeque));
+    if (deque == NULL) return NULL;
+    uint32_t words = (uint32_t)(HLIBC_ALIGN_UP(type_size, sizeof(uintptr_t)) / sizeof(uintptr_t));
+    ws_array_t* array = array_create(capacity, words);
+    if (array == NULL) {
+        free(deque);
+        return NULL;
+    }
+    deque->type_size = type_size;
+    atomic_init(&deque->array, array);
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    return deque;
+}
+
+void hwsdeque_destroy(hwsdeque_ptr_t deque)
+{
+    ws_array_t* array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+    while (array != NULL) {
+        ws_array_t* retired = array->retired;
+        free(array);
+        array = retired;
+    }
+    free(deque);
+}
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+/* ==================== 静态分配实现 ==================== */
+
+hwsdeque_ptr_t hwsdeque_create_static(void* buffer, uint32_t buffer_size,
+                                      uint32_t type_size)
+{
+    if (buffer == NULL || type_size == 0) return NULL;
+
+    /* 结构体按缓存行对齐，数组头紧随其后 */
+    uintptr_t start = (uintptr_t)HLIBC_ALIGN_UP((uintptr_t)buffer, HLIBC_CACHE_LINE_SIZE);
+    uint32_t header_size = (uint32_t)(start - (uintptr_t)buffer) +
+                           sizeof(struct hwsdeque) + sizeof(ws_array_t);
+    if (buffer_size <= header_size) return NULL;
+
+    uint32_t words = (uint32_t)(HLIBC_ALIGN_UP(type_size, sizeof(uintptr_t)) / sizeof(uintptr_t));
+    uint32_t fit = (buffer_size - header_size) / (words * (uint32_t)sizeof(uintptr_t));
+    if (fit == 0) return NULL;
+    uint32_t capacity = 1;
+    while (capacity <= fit / 2 && capacity < WS_MAX_CAPACITY) capacity <<= 1;
+
+    hwsdeque_ptr_t deque = (hwsdeque_ptr_t)start;
+    ws_array_t* array = (ws_array_t*)(start + sizeof(struct hwsdeque));
+    array->retired = NULL;
+    array->mask = capacity - 1;
+    array->words = words;
+    deque->type_size = type_size;
+    atomic_init(&deque->array, array);
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    return deque;
+}
+
+void hwsdeque_destroy_static(hwsdeque_ptr_t deque)
+{
+    if (deque == NULL) return;
+    atomic_store(&deque->top, 0);
+    atomic_store(&deque->bottom, 0);
+}
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+hlib_status_t hwsdeque_push(hwsdeque_ptr_t deque, hcdata_ptr_t data_ptr,
+                            uint32_t data_size)
+{
+    if (data_size != deque->type_size) return HLIB_ERROR;
+
+    int64_t b = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    int64_t t = atomic_load_explicit(&deque->top, memory_order_acquire);
+    ws_array_t* array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+    if (b - t > (int64_t)array->mask) {
+#if HLIBC_USE_STATIC_ALLOC == 0
+        array = grow(deque, array, t, b);
+        if (array == NULL) return HLIB_ERROR;
+#else
+        return HLIB_OVERFLOW;
+#endif
+    }
+    slot_store(array, b, (const uint8_t*)data_ptr, data_size);
+    /* 元素写完之后才让窃取者看到新的 bottom */
+    atomic_store_explicit(&deque->bottom, b + 1, memory_order_release);
+    return HLIB_OK;
+}
+
+hlib_status_t hwsdeque_pop(hwsdeque_ptr_t deque, hdata_ptr_t out)
+{
+    int64_t b = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    ws_array_t* array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, b, memory_order_relaxed);
+    /* 先占住 bottom 再读 top，与 steal 中的栅栏配对 */
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (t > b) {
+        /* 已经为空 */
+        atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+        return HLIB_ERROR;
+    }
+    slot_load(array, b, (uint8_t*)out, deque->type_size);
+    if (t < b) return HLIB_OK;
+
+    /* 只剩最后一个元素，与窃取者竞争 */
+    bool won = atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1,
+                                                       memory_order_seq_cst,
+                                                       memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+    return won ? HLIB_OK : HLIB_ERROR;
+}
+
+hlib_status_t hwsdeque_steal(hwsdeque_ptr_t deque, hdata_ptr_t out)
+{
+    int64_t t = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t b = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (t >= b) return HLIB_ERROR;
+
+    /* 数组可能刚被替换，旧数组中 t 位置的元素仍然有效 */
+    ws_array_t* array = atomic_load_explicit(&deque->array, memory_order_acquire);
+    slot_load(array, t, (uint8_t*)out, deque->type_size);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1,
+                                                 memory_order_seq_cst,
+                                                 memory_order_relaxed))
+        return HLIB_BUSY;
+    return HLIB_OK;
+}
+
+/*=======================
+ * Getter functions
+ *======================*/
+
+uint32_t hwsdeque_size(hwsdeque_ptr_t deque)
+{
+    int64_t b = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    int64_t t = atomic_load_explicit(&deque->top, memory_order_relaxed);
+    return b > t ? (uint32_t)(b - t) : 0;
+}
+
+bool hwsdeque_empty(hwsdeque_ptr_t deque)
+{
+    return hwsdeque_size(deque) == 0;
+}
+
+uint32_t hwsdeque_capacity(hwsdeque_ptr_t deque)
+{
+    return atomic_load_explicit(&deque->array, memory_order_relaxed)->mask + 1;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* 元素按原子字逐个读写，窃取者读到正在被覆盖的槽位时 CAS 必然失败，结果会被丢弃 */
+static void slot_store(ws_array_t* array, int64_t index, const uint8_t* src, uint32_t size)
+{
+    atomic_uintptr_t* slot = &array->slots[(size_t)((uint64_t)index & array->mask) * array->words];
+    for (; size >= sizeof(uintptr_t); size -= sizeof(uintptr_t), src += sizeof(uintptr_t)) {
+        uintptr_t word;
+        memcpy(&word, src, sizeof(word));
+        atomic_store_explicit(slot++, word, memory_order_relaxed);
+    }
+    if (size != 0) {
+        uintptr_t word = 0;
+        memcpy(&word, src, size);
+        atomic_store_explicit(slot, word, memory_order_relaxed);
+    }
+}
+
+static void slot_load(ws_array_t* array, int64_t index, uint8_t* dest, uint32_t size)
+{
+    if (dest == NULL) return;
+    atomic_uintptr_t* slot = &array->slots[(size_t)((uint64_t)index & array->mask) * array->words];
+    for (; size >= sizeof(uintptr_t); size -= sizeof(uintptr_t), dest += sizeof(uintptr_t)) {
+        uintptr_t word = atomic_load_explicit(slot++, memory_order_relaxed);
+        memcpy(dest, &word, sizeof(word));
+    }
+    if (size != 0) {
+        uintptr_t word = atomic_load_explicit(slot, memory_order_relaxed);
+        memcpy(dest, &word, size);
+    }
+}
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+static ws_array_t* array_create(uint32_t capacity, uint32_t words)
+{
+    ws_array_t* array = (ws_array_t*)malloc(sizeof(ws_array_t) +
+                                            (size_t)capacity * words * sizeof(atomic_uintptr_t));
+    if (array == NULL) return NULL;
+    array->retired = NULL;
+    array->mask = capacity - 1;
+    array->words = words;
+    return array;
+}
+
+/* 容量翻倍，复制 [top, bottom) 的元素；旧数组挂在新数组上，销毁时一并释放 */
+static ws_array_t* grow(hwsdeque_ptr_t deque, ws_array_t* old, int64_t top, int64_t bottom)
+{
+    if (old->mask + 1 >= WS_MAX_CAPACITY) return NULL;
+    ws_array_t* array = array_create((old->mask + 1) * 2, old->words);
+    if (array == NULL) return NULL;
+    for (int64_t i = top; i < bottom; ++i) {
+        atomic_uintptr_t* from = &old->slots[(size_t)((uint64_t)i & old->mask) * old->words];
+        atomic_uintptr_t* to = &array->slots[(size_t)((uint64_t)i & array->mask) * array->words];
+        for (uint32_t w = 0; w < old->words; ++w)
+            atomic_store_explicit(&to[w], atomic_load_explicit(&from[w], memory_order_relaxed),
+                                  memory_order_relaxed);
+    }
+    array->retired = old;
+    atomic_store_explicit(&deque->array, array, memory_order_release);
+    return array;
+}
+#endif
+
+#endif /* HLIBC_USE_THREADS */
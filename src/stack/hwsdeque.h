@@ -0,0 +1,166 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/stack/hwsdeque.h
+ * @Description: 工作窃取双端队列（Chase-Lev）
+ * @other: None
+ */
+#ifndef __HLIBC_HWSDEQUE_H__
+#define __HLIBC_HWSDEQUE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../common/hcommon.h"
+#include "../common/hlibc_config.h"
+
+/*********************
+ *      MACROS
+ *********************/
+
+/*
+ * 静态分配结构体大小（精确值：结构体加紧随其后的数组头，由布局镜像得出，hwsdeque.c 中用 _Static_assert 校验）
+ */
+#define HWSDEQUE_STRUCT_SIZE \
+  (sizeof(hwsdeque_static_layout_t) + sizeof(hwsdeque_array_layout_t))
+
+/* 每个元素按指针大小的整数倍存放 */
+#define HWSDEQUE_SLOT_SIZE(type) \
+  HLIBC_ALIGN_UP(sizeof(type), sizeof(uintptr_t))
+
+/**
+ * 计算静态 hwsdeque 所需的 buffer 大小（含按缓存行对齐的余量）
+ * @param type 数据类型
+ * @param capacity 容器最大容量，必须是 2 的幂
+ */
+#define HWSDEQUE_CALC_BUFFER_SIZE(type, capacity) \
+  (HLIBC_CACHE_LINE_SIZE + HWSDEQUE_STRUCT_SIZE + (capacity) * HWSDEQUE_SLOT_SIZE(type))
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct hwsdeque* hwsdeque_ptr_t;
+
+/*
+ * 静态分配模式下 hwsdeque 结构体的布局镜像，字段必须与 hwsdeque.c 保持一致（top、bottom 各占独立的缓存行）
+ */
+typedef struct {
+  uint32_t type_size_;
+  void* array_;
+  HLIBC_ALIGNAS(HLIBC_CACHE_LINE_SIZE) int64_t top_;
+  HLIBC_ALIGNAS(HLIBC_CACHE_LINE_SIZE) int64_t bottom_;
+} hwsdeque_static_layout_t;
+
+/*
+ * 元素数组头的布局镜像（不含柔性数组成员）
+ */
+typedef struct {
+  void* retired_;
+  uint32_t mask_;
+  uint32_t words_;
+} hwsdeque_array_layout_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+#if HLIBC_USE_THREADS
+
+/*
+ * 数组实现的栈加上一个可被其他线程窃取的栈底：
+ * 拥有者线程在 bottom 端无锁地 push/pop（后进先出），其他线程在 top 端用 CAS 窃取（先进先出）。
+ * 元素按值复制，存放在原子字中，读写不会产生数据竞争。
+ * 动态分配：容量不足时翻倍增长，旧数组保留到销毁时再释放（窃取者可能仍在读取）。
+ * 静态分配：使用用户提供的 buffer，容量固定，满时 push 返回 HLIB_OVERFLOW。
+ */
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/**
+ * 创建一个工作窃取队列（动态分配，自动增长）
+ * @param type_size 装入容器的数据类型的大小
+ * @param initial_capacity 初始容量，向上取整为 2 的幂，0 表示使用默认值
+ * @return 返回新创建的容器，内存不足时返回 NULL
+ */
+extern hwsdeque_ptr_t hwsdeque_create(uint32_t type_size, uint32_t initial_capacity);
+
+/**
+ * 删除工作窃取队列，调用时不能有其他线程仍在访问
+ * @param deque 一个由 `hwsdeque_create` 返回的容器
+ */
+extern void hwsdeque_destroy(hwsdeque_ptr_t deque);
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+
+/**
+ * 在用户提供的 buffer 上创建一个容量固定的工作窃取队列
+ * @param buffer 用户提供的内存缓冲区，无需对齐
+ * @param buffer_size 缓冲区大小（使用 HWSDEQUE_CALC_BUFFER_SIZE 宏计算）
+ * @param type_size 装入容器的数据类型的大小
+ * @return 返回容器指针（位于 buffer 内部，按缓存行对齐），容量为放得下的最大 2 的幂；失败返回 NULL
+ */
+extern hwsdeque_ptr_t hwsdeque_create_static(void* buffer, uint32_t buffer_size,
+                                             uint32_t type_size);
+
+/**
+ * 销毁静态分配的工作窃取队列（仅清理内容，不释放内存）
+ */
+extern void hwsdeque_destroy_static(hwsdeque_ptr_t deque);
+
+/* 兼容性宏定义 */
+#define hwsdeque_create(type_size, initial_capacity) \
+  ((void)(type_size), (void)(initial_capacity), (hwsdeque_ptr_t)NULL)
+#define hwsdeque_destroy(deque) hwsdeque_destroy_static(deque)
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+/**
+ * 在 bottom 端放入一个元素（仅拥有者线程）
+ * @return HLIB_OK 成功；HLIB_ERROR 数据大小不符或内存不足；HLIB_OVERFLOW 已满（静态分配）
+ */
+extern hlib_status_t hwsdeque_push(hwsdeque_ptr_t deque, hcdata_ptr_t data_ptr,
+                                   uint32_t data_size);
+
+/**
+ * 从 bottom 端取出最近放入的元素（仅拥有者线程）
+ * @param out 接收数据的缓冲区（type_size 字节），失败时内容未定义
+ * @return HLIB_OK 成功；HLIB_ERROR 队列为空或最后一个元素被窃取
+ */
+extern hlib_status_t hwsdeque_pop(hwsdeque_ptr_t deque, hdata_ptr_t out);
+
+/**
+ * 从 top 端窃取最早放入的元素（任意线程）
+ * @param out 接收数据的缓冲区（type_size 字节），失败时内容未定义
+ * @return HLIB_OK 成功；HLIB_ERROR 队列为空；HLIB_BUSY 与其他线程竞争失败，可以重试
+ */
+extern hlib_status_t hwsdeque_steal(hwsdeque_ptr_t deque, hdata_ptr_t out);
+
+/*=======================
+ * Getter functions
+ *======================*/
+
+/**
+ * 元素个数。并发场景下结果仅代表调用瞬间的状态
+ */
+extern uint32_t hwsdeque_size(hwsdeque_ptr_t deque);
+extern bool hwsdeque_empty(hwsdeque_ptr_t deque);
+
+/**
+ * 当前数组容量（动态分配时会随增长变化）
+ */
+extern uint32_t hwsdeque_capacity(hwsdeque_ptr_t deque);
+
+#endif /* HLIBC_USE_THREADS */
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __HLIBC_HWSDEQUE_H__ */
@@ -0,0 +1,384 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/timer/htimer_wheel.c
+ * @Description: 分层时间轮：O(1) 添加/取消定时器，每个 tick 均摊 O(1) 处理到期
+ * @other: None
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "htimer_wheel.h"
+#include "../common/hlibc_type.h"
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+#include "../common/harena.h"
+#endif
+
+/*********************
+ *      MACROS
+ *********************/
+#define WHEEL_MASK          (HTIMER_WHEEL_SLOTS - 1u)
+
+/* 可直接定时的最大跨度，更远的定时器先按这个跨度放在最高层 */
+#define WHEEL_MAX_SPAN      (((uint64_t)1 << (HLIBC_TIMER_WHEEL_LEVELS * HLIBC_TIMER_WHEEL_SLOT_BITS)) - 1u)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct hdnode wheel_dnode_t;
+
+/* 定时器条目，link 必须是第一个成员，桶中的节点直接转换为条目 */
+typedef struct timer_entry {
+    wheel_dnode_t link;         /* 桶内的双向链表节点，data_ptr 指向条目自身 */
+    uint64_t expires;           /* 到期时间 */
+    htimer_f fn;
+    void* ctx;
+    uint32_t gen;               /* 条目每次释放加一，使旧句柄失效；不与空闲链表指针重叠 */
+} timer_entry_t;
+
+struct htimer_wheel {
+    uint64_t now;               /* 当前时间，到期时间不晚于它的定时器都已处理 */
+    uint32_t size;              /* 挂起的定时器个数 */
+#if HLIBC_USE_STATIC_ALLOC == 0
+    harena_t arena;             /* 条目池，每个槽位一个条目 */
+#else
+    hpool_region_t entries;     /* buffer 中的条目池 */
+#endif
+    wheel_dnode_t buckets[HTIMER_WHEEL_BUCKETS]; /* 第 level 层第 slot 个槽位的链表头 */
+};
+
+_Static_assert(sizeof(timer_entry_t) == HTIMER_WHEEL_ENTRY_SIZE &&
+               _Alignof(timer_entry_t) == _Alignof(htimer_wheel_entry_layout_t),
+               "htimer_wheel_entry_layout_t does not match timer_entry_t");
+#if HLIBC_USE_STATIC_ALLOC == 1
+/* 头文件中的布局镜像必须与实际结构体一致 */
+_Static_assert(sizeof(struct htimer_wheel) == HTIMER_WHEEL_STRUCT_SIZE &&
+               _Alignof(struct htimer_wheel) == _Alignof(htimer_wheel_static_layout_t),
+               "htimer_wheel_static_layout_t does not match struct htimer_wheel");
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void wheel_init(htimer_wheel_ptr_t wheel, uint64_t now);
+static timer_entry_t* entry_alloc(htimer_wheel_ptr_t wheel);
+static void entry_free(htimer_wheel_ptr_t wheel, timer_entry_t* entry);
+static void entry_place(htimer_wheel_ptr_t wheel, timer_entry_t* entry);
+static void bucket_detach(wheel_dnode_t* bucket, wheel_dnode_t* out);
+static void cascade(htimer_wheel_ptr_t wheel, uint32_t level, uint32_t slot);
+static bool level0_empty_from(htimer_wheel_ptr_t wheel, uint32_t index);
+static uint32_t tick(htimer_wheel_ptr_t wheel);
+
+/* 带哨兵的环形链表，与 hlist 的头节点用法相同 */
+static inline void dnode_init(wheel_dnode_t* head)
+{
+    head->data_ptr = NULL;
+    head->prev = head;
+    head->next = head;
+}
+
+static inline void dnode_link_before(wheel_dnode_t* position, wheel_dnode_t* node)
+{
+    node->prev = position->prev;
+    node->next = position;
+    position->prev->next = node;
+    position->prev = node;
+}
+
+static inline void dnode_unlink(wheel_dnode_t* node)
+{
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/* ==================== 动态分配实现 ==================== */
+
+htimer_wheel_ptr_t htimer_wheel_create(uint64_t now)
+{
+    htimer_wheel_ptr_t wheel =
+        (htimer_wheel_ptr_t)hallocator_alloc(NULL, sizeof(struct htimer_wheel));
+    if (wheel == NULL) return NULL;
+    harena_init(&wheel->arena, sizeof(timer_entry_t), NULL);
+    wheel_init(wheel, now);
+    return wheel;
+}
+
+void htimer_wheel_destroy(htimer_wheel_ptr_t wheel)
+{
+    harena_release(&wheel->arena);
+    hallocator_free(NULL, wheel, sizeof(struct htimer_wheel));
+}
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+/* ==================== 静态分配实现 ==================== */
+
+htimer_wheel_ptr_t htimer_wheel_create_static(void* buffer, uint32_t buffer_size, uint64_t now)
+{
+    if (buffer == NULL) return NULL;
+
+    /* 未对齐的 buffer 先跳过开头的若干字节 */
+    uint8_t* base = (uint8_t*)HLIBC_ALIGN_UP((uintptr_t)buffer, HLIBC_STATIC_ALIGN);
+    uint32_t skip = (uint32_t)(base - (uint8_t*)buffer);
+    uint32_t header_size = HLIBC_ALIGN_UP(sizeof(struct htimer_wheel), HLIBC_STATIC_ALIGN);
+    if (buffer_size < skip + header_size + sizeof(timer_entry_t)) return NULL;
+
+    htimer_wheel_ptr_t wheel = (htimer_wheel_ptr_t)base;
+    hpool_region_init(&wheel->entries, base + header_size, (uint32_t)sizeof(timer_entry_t),
+                      (buffer_size - skip - header_size) / (uint32_t)sizeof(timer_entry_t));
+    wheel_init(wheel, now);
+    return wheel;
+}
+
+void htimer_wheel_destroy_static(htimer_wheel_ptr_t wheel)
+{
+    if (wheel == NULL) return;
+    /* 静态分配不释放内存，只重置状态 */
+    htimer_wheel_clear(wheel);
+}
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+hlib_status_t htimer_wheel_add(htimer_wheel_ptr_t wheel, uint64_t delay, htimer_f fn,
+                               void* ctx, htimer_t* timer)
+{
+    timer_entry_t* entry = entry_alloc(wheel);
+    if (entry == NULL) {
+#if HLIBC_USE_STATIC_ALLOC
+        return HLIB_OVERFLOW;
+#else
+        return HLIB_ERROR;
+#endif
+    }
+    entry->link.data_ptr = entry;
+    entry->expires = wheel->now + (delay != 0 ? delay : 1);
+    entry->fn = fn;
+    entry->ctx = ctx;
+    entry_place(wheel, entry);
+    ++wheel->size;
+    if (timer != NULL) {
+        timer->entry = entry;
+        timer->gen = entry->gen;
+    }
+    return HLIB_OK;
+}
+
+bool htimer_wheel_cancel(htimer_wheel_ptr_t wheel, htimer_t* timer)
+{
+    if (!htimer_wheel_pending(wheel, timer)) return false;
+    timer_entry_t* entry = (timer_entry_t*)timer->entry;
+    dnode_unlink(&entry->link);
+    entry_free(wheel, entry);
+    --wheel->size;
+    timer->entry = NULL;
+    return true;
+}
+
+uint32_t htimer_wheel_advance(htimer_wheel_ptr_t wheel, uint64_t now)
+{
+    uint32_t fired = 0;
+    while (wheel->now < now) {
+        /* 没有挂起的定时器时各层都是空的，直接跳过 */
+        if (wheel->size == 0) {
+            wheel->now = now;
+            break;
+        }
+        /* 第 0 层本圈余下的槽位都为空时跳到本圈最后一个 tick，下一个 tick 照常级联 */
+        uint64_t skip_to = wheel->now | WHEEL_MASK;
+        if (skip_to > wheel->now + 1 &&
+            level0_empty_from(wheel, (uint32_t)(wheel->now + 1) & WHEEL_MASK)) {
+            wheel->now = skip_to < now ? skip_to : now;
+            continue;
+        }
+        fired += tick(wheel);
+    }
+    return fired;
+}
+
+void htimer_wheel_clear(htimer_wheel_ptr_t wheel)
+{
+    /* 逐个释放而不是整体回收，使已有句柄的代数失效 */
+    for (uint32_t i = 0; i < HTIMER_WHEEL_BUCKETS && wheel->size != 0; ++i) {
+        wheel_dnode_t* head = &wheel->buckets[i];
+        while (head->next != head) {
+            timer_entry_t* entry = (timer_entry_t*)head->next;
+            dnode_unlink(&entry->link);
+            entry_free(wheel, entry);
+            --wheel->size;
+        }
+    }
+}
+
+/*=======================
+ * Getter functions
+ *======================*/
+
+bool htimer_wheel_pending(htimer_wheel_ptr_t wheel, const htimer_t* timer)
+{
+    (void)wheel;
+    return timer != NULL && timer->entry != NULL &&
+           ((const timer_entry_t*)timer->entry)->gen == timer->gen;
+}
+
+uint64_t htimer_wheel_now(htimer_wheel_ptr_t wheel)
+{
+    return wheel->now;
+}
+
+uint32_t htimer_wheel_size(htimer_wheel_ptr_t wheel)
+{
+    return wheel->size;
+}
+
+#if HLIBC_USE_STATIC_ALLOC
+uint32_t htimer_wheel_capacity(htimer_wheel_ptr_t wheel)
+{
+    return wheel->entries.capacity;
+}
+#endif
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void wheel_init(htimer_wheel_ptr_t wheel, uint64_t now)
+{
+    wheel->now = now;
+    wheel->size = 0;
+    for (uint32_t i = 0; i < HTIMER_WHEEL_BUCKETS; ++i) dnode_init(&wheel->buckets[i]);
+}
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+static timer_entry_t* entry_alloc(htimer_wheel_ptr_t wheel)
+{
+    /* 复用的槽位保留原来的代数，首次使用的槽位从 0 开始 */
+    void* recycled = wheel->arena.free_list;
+    timer_entry_t* entry = (timer_entry_t*)harena_alloc(&wheel->arena);
+    if (entry != NULL && entry != recycled) entry->gen = 0;
+    return entry;
+}
+
+static void entry_free(htimer_wheel_ptr_t wheel, timer_entry_t* entry)
+{
+    ++entry->gen;
+    harena_free(&wheel->arena, entry);
+}
+#else
+static timer_entry_t* entry_alloc(htimer_wheel_ptr_t wheel)
+{
+    /* 复用的条目保留原来的代数，首次使用的条目从 0 开始 */
+    void* recycled = wheel->entries.free_list;
+    timer_entry_t* entry = (timer_entry_t*)hpool_region_alloc(&wheel->entries);
+    if (entry != NULL && entry != recycled) entry->gen = 0;
+    return entry;
+}
+
+static void entry_free(htimer_wheel_ptr_t wheel, timer_entry_t* entry)
+{
+    ++entry->gen;
+    hpool_region_free(&wheel->entries, entry);
+}
+#endif
+
+/*
+ * 按距下一个 tick 的跨度选层：跨度小于 SLOTS^(level+1) 的放在第 level 层，
+ * 槽位取到期时间在该层对应的位段。超出总跨度的先按总跨度放置，转到时再重新放置
+ */
+static void entry_place(htimer_wheel_ptr_t wheel, timer_entry_t* entry)
+{
+    uint64_t next = wheel->now + 1;
+    uint64_t expires = entry->expires;
+    if (expires - next > WHEEL_MAX_SPAN) expires = next + WHEEL_MAX_SPAN;
+
+    uint64_t delta = expires - next;
+    uint32_t level = 0;
+    while (level + 1 < HLIBC_TIMER_WHEEL_LEVELS &&
+           (delta >> ((level + 1) * HLIBC_TIMER_WHEEL_SLOT_BITS)) != 0)
+        ++level;
+    uint32_t slot = (uint32_t)(expires >> (level * HLIBC_TIMER_WHEEL_SLOT_BITS)) & WHEEL_MASK;
+    dnode_link_before(&wheel->buckets[level * HTIMER_WHEEL_SLOTS + slot], &entry->link);
+}
+
+/* 把整条桶链表转移到 out，之后往原桶中添加的定时器不会混进来 */
+static void bucket_detach(wheel_dnode_t* bucket, wheel_dnode_t* out)
+{
+    if (bucket->next == bucket) {
+        dnode_init(out);
+        return;
+    }
+    out->data_ptr = NULL;
+    out->next = bucket->next;
+    out->prev = bucket->prev;
+    out->next->prev = out;
+    out->prev->next = out;
+    dnode_init(bucket);
+}
+
+/* 高层槽位转到时，其中的定时器按剩余时间重新放到低层 */
+static void cascade(htimer_wheel_ptr_t wheel, uint32_t level, uint32_t slot)
+{
+    wheel_dnode_t list;
+    bucket_detach(&wheel->buckets[level * HTIMER_WHEEL_SLOTS + slot], &list);
+    while (list.next != &list) {
+        timer_entry_t* entry = (timer_entry_t*)list.next;
+        dnode_unlink(&entry->link);
+        entry_place(wheel, entry);
+    }
+}
+
+/* 第 0 层从 index 到本圈末尾的槽位是否都为空 */
+static bool level0_empty_from(htimer_wheel_ptr_t wheel, uint32_t index)
+{
+    for (uint32_t i = index; i < HTIMER_WHEEL_SLOTS; ++i) {
+        if (wheel->buckets[i].next != &wheel->buckets[i]) return false;
+    }
+    return true;
+}
+
+/* 处理下一个 tick，返回调用的回调个数 */
+static uint32_t tick(htimer_wheel_ptr_t wheel)
+{
+    uint64_t t = wheel->now + 1;
+    uint32_t index = (uint32_t)t & WHEEL_MASK;
+
+    /* 第 0 层转完一圈，逐层从上一层取下一个槽位；上一层也恰好转完一圈时继续向上 */
+    if (index == 0) {
+        for (uint32_t level = 1; level < HLIBC_TIMER_WHEEL_LEVELS; ++level) {
+            uint32_t slot = (uint32_t)(t >> (level * HLIBC_TIMER_WHEEL_SLOT_BITS)) & WHEEL_MASK;
+            cascade(wheel, level, slot);
+            if (slot != 0) break;
+        }
+    }
+    wheel->now = t;
+
+    wheel_dnode_t list;
+    uint32_t fired = 0;
+    bucket_detach(&wheel->buckets[index], &list);
+    while (list.next != &list) {
+        timer_entry_t* entry = (timer_entry_t*)list.next;
+        dnode_unlink(&entry->link);
+        if (entry->expires > t) {
+            /* 超出总跨度的定时器，重新放置 */
+            entry_place(wheel, entry);
+            continue;
+        }
+        /* 先释放条目再回调，回调中可以立即复用 */
+        htimer_f fn = entry->fn;
+        void* ctx = entry->ctx;
+        entry_free(wheel, entry);
+        --wheel->size;
+        ++fired;
+        fn(wheel, ctx);
+    }
+    return fired;
+}
@@ -0,0 +1,213 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-18
+ * @FilePath: /hlibc/timer/htimer_wheel.h
+ * @Description: 分层时间轮：O(1) 添加/取消定时器，每个 tick 均摊 O(1) 处理到期
+ * @other: None
+ */
+#ifndef __HLIBC_HTIMER_WHEEL_H__
+#define __HLIBC_HTIMER_WHEEL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../common/hcommon.h"
+#include "../common/hlibc_config.h"
+#include "../pool/hpool.h"
+
+/*********************
+ *      MACROS
+ *********************/
+
+/* 每层的槽位数与槽位总数 */
+#define HTIMER_WHEEL_SLOTS      (1u << HLIBC_TIMER_WHEEL_SLOT_BITS)
+#define HTIMER_WHEEL_BUCKETS    (HLIBC_TIMER_WHEEL_LEVELS * HTIMER_WHEEL_SLOTS)
+
+/*
+ * 静态分配结构体与定时器条目大小（精确值，htimer_wheel.c 中用 _Static_assert 校验）
+ */
+#define HTIMER_WHEEL_STRUCT_SIZE sizeof(htimer_wheel_static_layout_t)
+#define HTIMER_WHEEL_ENTRY_SIZE  sizeof(htimer_wheel_entry_layout_t)
+
+/**
+ * 计算静态时间轮所需的 buffer 大小
+ * buffer 按 HLIBC_STATIC_ALIGN 对齐时恰好容纳 capacity 个同时挂起的定时器（HTIMER_WHEEL_DEFINE_STATIC 会自动对齐）
+ * @param capacity 同时挂起的定时器个数上限
+ *
+ * 内存布局: [htimer_wheel结构体（含全部槽位的链表头）][对齐填充][定时器条目数组]
+ */
+#define HTIMER_WHEEL_BUFFER_SIZE(capacity)                          \
+  (HLIBC_ALIGN_UP(HTIMER_WHEEL_STRUCT_SIZE, HLIBC_STATIC_ALIGN) +   \
+   (size_t)(capacity) * HTIMER_WHEEL_ENTRY_SIZE)
+
+/**
+ * 定义一个静态时间轮（便捷宏）
+ * @param name 变量名
+ * @param capacity 同时挂起的定时器个数上限
+ * @param now 起始时间（tick）
+ *
+ * 使用示例:
+ *   HTIMER_WHEEL_DEFINE_STATIC(timers, 64, 0);
+ *   htimer_wheel_add(timers, 100, on_timeout, conn, &conn->timer);
+ */
+#define HTIMER_WHEEL_DEFINE_STATIC(name, capacity, now)                         \
+  HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static                                      \
+      uint8_t name##_buffer[HTIMER_WHEEL_BUFFER_SIZE(capacity)];                \
+  htimer_wheel_ptr_t name =                                                     \
+      htimer_wheel_create_static(name##_buffer, sizeof(name##_buffer), now)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct htimer_wheel* htimer_wheel_ptr_t;
+
+/* 到期回调，调用时定时器已从时间轮中移除，回调中可以添加或取消其他定时器 */
+typedef void (*htimer_f)(htimer_wheel_ptr_t wheel, void* ctx);
+
+/*
+ * 定时器句柄，由 htimer_wheel_add 填写，用于取消。
+ * 条目带有代数，定时器到期或被取消后旧句柄自动失效，不会误取消复用了同一条目的新定时器
+ */
+typedef struct {
+    void* entry;
+    uint32_t gen;
+} htimer_t;
+
+/*
+ * 定时器条目与静态分配模式下 struct htimer_wheel 的布局镜像，仅用于在编译期得到精确大小，
+ * 字段必须与 htimer_wheel.c 保持一致
+ */
+typedef struct {
+    void* link_[3];
+    uint64_t expires_;
+    htimer_f fn_;
+    void* ctx_;
+    uint32_t gen_;
+} htimer_wheel_entry_layout_t;
+
+typedef struct {
+    uint64_t now_;
+    uint32_t size_;
+    hpool_region_t entries_;
+    void* buckets_[HTIMER_WHEEL_BUCKETS][3];
+} htimer_wheel_static_layout_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/*
+ * 时间以 tick 为单位，由调用者通过 htimer_wheel_advance 推进。
+ * 第 0 层的每个槽位对应 1 个 tick，第 k 层的每个槽位对应 2^(k * HLIBC_TIMER_WHEEL_SLOT_BITS) 个 tick，
+ * 高层槽位转到时把其中的定时器重新放到低层（级联）。每个槽位是一条带哨兵的 hdnode 环形链表，
+ * 与 hlist 的节点相同，添加与取消都只是链表的插入与摘除。
+ */
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/**
+ * 创建一个时间轮（动态分配），定时器条目按需从内部的节点池中取得
+ * @param now 起始时间（tick）
+ * @return 返回新创建的时间轮，失败返回 NULL
+ */
+extern htimer_wheel_ptr_t htimer_wheel_create(uint64_t now);
+
+/**
+ * 删除给定的时间轮（动态分配版本），挂起的定时器不会被调用
+ * @param wheel 一个由 `htimer_wheel_create` 返回的时间轮
+ */
+extern void htimer_wheel_destroy(htimer_wheel_ptr_t wheel);
+
+#else /* HLIBC_USE_STATIC_ALLOC == 1 */
+
+/**
+ * 创建一个静态分配的时间轮，定时器条目取自 buffer 中的条目池，添加定时器不会分配内存
+ * @param buffer 用户提供的内存缓冲区
+ * @param buffer_size 缓冲区大小（使用 HTIMER_WHEEL_BUFFER_SIZE 宏计算）
+ * @param now 起始时间（tick）
+ * @return 返回时间轮指针，失败返回 NULL
+ */
+extern htimer_wheel_ptr_t htimer_wheel_create_static(void* buffer, uint32_t buffer_size,
+                                                     uint64_t now);
+
+/**
+ * 销毁静态分配的时间轮（仅清理内容，不释放内存），挂起的定时器不会被调用
+ * @param wheel 一个由 `htimer_wheel_create_static` 返回的时间轮
+ */
+extern void htimer_wheel_destroy_static(htimer_wheel_ptr_t wheel);
+
+/* 兼容性宏定义 */
+#define htimer_wheel_create(now) \
+  ((void)(now), (htimer_wheel_ptr_t)NULL) /* 静态模式下禁用 */
+#define htimer_wheel_destroy(wheel) htimer_wheel_destroy_static(wheel)
+
+#endif /* HLIBC_USE_STATIC_ALLOC */
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+/**
+ * 添加一个定时器，在 delay 个 tick 之后到期
+ * @param wheel 时间轮
+ * @param delay 延迟的 tick 数，0 按 1 处理（在下一个 tick 到期）
+ * @param fn 到期回调
+ * @param ctx 原样传给 fn
+ * @param timer 输出句柄，用于取消，不需要时可为 NULL
+ * @return HLIB_OK 成功；HLIB_OVERFLOW 条目池已满（静态分配）；HLIB_ERROR 内存不足（动态分配）
+ */
+extern hlib_status_t htimer_wheel_add(htimer_wheel_ptr_t wheel, uint64_t delay, htimer_f fn,
+                                      void* ctx, htimer_t* timer);
+
+/**
+ * 取消一个定时器
+ * @param wheel 时间轮
+ * @param timer htimer_wheel_add 填写的句柄，取消后被置空
+ * @return 定时器尚未到期并被取消时返回 true；已到期、已取消或句柄为空时返回 false
+ */
+extern bool htimer_wheel_cancel(htimer_wheel_ptr_t wheel, htimer_t* timer);
+
+/**
+ * 把时间推进到 now，依次调用期间到期的定时器
+ * 每个 tick 均摊 O(1)；没有挂起的定时器时直接跳到 now
+ * @param wheel 时间轮
+ * @param now 新的当前时间，不大于当前时间时什么也不做
+ * @return 本次调用的回调个数
+ */
+extern uint32_t htimer_wheel_advance(htimer_wheel_ptr_t wheel, uint64_t now);
+
+/**
+ * 取消全部定时器，不调用回调，已有的句柄全部失效
+ */
+extern void htimer_wheel_clear(htimer_wheel_ptr_t wheel);
+
+/*=======================
+ * Getter functions
+ *======================*/
+
+/**
+ * 定时器是否仍在等待到期
+ */
+extern bool htimer_wheel_pending(htimer_wheel_ptr_t wheel, const htimer_t* timer);
+
+/* 当前时间（tick），到期时间不晚于它的定时器都已被调用 */
+extern uint64_t htimer_wheel_now(htimer_wheel_ptr_t wheel);
+
+/* 挂起的定时器个数 */
+extern uint32_t htimer_wheel_size(htimer_wheel_ptr_t wheel);
+
+#if HLIBC_USE_STATIC_ALLOC
+/**
+ * 获取条目池的容量，即同时挂起的定时器个数上限（仅静态分配模式）
+ */
+extern uint32_t htimer_wheel_capacity(htimer_wheel_ptr_t wheel);
+#endif
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __HLIBC_HTIMER_WHEEL_H__ */
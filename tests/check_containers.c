@@ -0,0 +1,1476 @@
+/*
+ * @Author: totoro huangjian921@outlook.com
+ * @Date: 2026-10-19
+ * @FilePath: /hlibc/tests/check_containers.c
+ * @Description: 容器正确性检查：随机操作序列与参考模型逐步比对，两种分配模式各编译一份
+ * @other: None
+ */
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/btree/hbtree.h"
+#include "../src/common/hlibc_type.h"
+#include "../src/list/hlist.h"
+#include "../src/lru/hlru.h"
+#include "../src/pool/hpool.h"
+#include "../src/queue/hqueue.h"
+#include "../src/queue/hring.h"
+#include "../src/stack/hstack.h"
+#include "../src/timer/htimer_wheel.h"
+
+/*
+ * 每项检查用固定种子的伪随机数驱动一串操作，每步之后与简单的参考模型（数组）比对。
+ * 失败时打印不满足的条件与行号，种子可以用 --seed 指定以复现。
+ */
+#define CHECK(cond)                                                          \
+  do {                                                                       \
+    if (!(cond)) {                                                           \
+      printf("FAILED\n  %s:%d: %s (seed %llu)\n", __FILE__, __LINE__, #cond, \
+             (unsigned long long)s_seed);                                    \
+      return 0;                                                              \
+    }                                                                        \
+  } while (0)
+
+static uint64_t s_seed = 0x2545F4914F6CDD1Dull;
+static uint64_t s_rng;
+static uint32_t s_rounds = 200000;
+
+/* xorshift64*，返回 [0, n) */
+static uint32_t rnd(uint32_t n)
+{
+    s_rng ^= s_rng >> 12;
+    s_rng ^= s_rng << 25;
+    s_rng ^= s_rng >> 27;
+    return (uint32_t)((s_rng * 0x2545F4914F6CDD1Dull) >> 32) % n;
+}
+
+static void check_begin(const char* name)
+{
+    s_rng = s_seed;
+    printf("%-16s ", name);
+    fflush(stdout);
+}
+
+/* 由种子生成的负载字节，用于检查变长数据没有被覆盖 */
+static uint8_t payload_byte(uint32_t seed, uint32_t i)
+{
+    return (uint8_t)(seed * 131u + i * 31u + (i >> 8));
+}
+
+static void payload_fill(void* data, uint32_t len, uint32_t seed)
+{
+    for (uint32_t i = 0; i < len; ++i) ((uint8_t*)data)[i] = payload_byte(seed, i);
+}
+
+static int payload_equal(const void* data, uint32_t len, uint32_t seed)
+{
+    for (uint32_t i = 0; i < len; ++i) {
+        if (((const uint8_t*)data)[i] != payload_byte(seed, i)) return 0;
+    }
+    return 1;
+}
+
+/* ==================== hbtree ==================== */
+
+/* 键取自 [0, BTREE_KEYS)，静态模式的容量与之相同，put 永远不会溢出 */
+#define BTREE_KEYS 2048u
+
+#if HLIBC_USE_STATIC_ALLOC
+HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t
+    s_btree_buffer[HBTREE_CALC_BUFFER_SIZE(uint32_t, uint32_t, BTREE_KEYS)];
+#endif
+
+typedef struct {
+    bool present[BTREE_KEYS];
+    uint32_t value[BTREE_KEYS];
+    uint32_t size;
+    uint32_t keys[BTREE_KEYS];  /* foreach_range 收集到的键 */
+    uint32_t collected;
+} btree_model_t;
+
+static btree_model_t s_btree;
+
+static hbtree_ptr_t btree_new(void)
+{
+#if HLIBC_USE_STATIC_ALLOC
+    return hbtree_create_static(s_btree_buffer, sizeof(s_btree_buffer), sizeof(uint32_t),
+                                sizeof(uint32_t), hbtree_cmp_u32);
+#else
+    return hbtree_create(sizeof(uint32_t), sizeof(uint32_t), hbtree_cmp_u32);
+#endif
+}
+
+static bool btree_collect(hcdata_ptr_t key, hdata_ptr_t value, void* ctx)
+{
+    btree_model_t* model = (btree_model_t*)ctx;
+    (void)value;
+    if (model->collected < BTREE_KEYS) model->keys[model->collected] = *(const uint32_t*)key;
+    ++model->collected;
+    return true;
+}
+
+/* 顺序遍历、范围遍历与 lower_bound 都与模型一致 */
+static int btree_verify(hbtree_ptr_t tree)
+{
+    btree_model_t* model = &s_btree;
+    CHECK(hbtree_size(tree) == model->size);
+    CHECK(hbtree_empty(tree) == (model->size == 0));
+    CHECK((hbtree_height(tree) == 0) == (model->size == 0));
+
+    hbtree_iter_t iter;
+    uint32_t key = 0, seen = 0;
+    bool more = hbtree_first(tree, &iter);
+    while (more) {
+        uint32_t k = *(const uint32_t*)hbtree_iter_key(tree, &iter);
+        while (key < BTREE_KEYS && !model->present[key]) ++key;
+        CHECK(k == key);
+        CHECK(*(uint32_t*)hbtree_iter_value(tree, &iter) == model->value[key]);
+        ++key;
+        ++seen;
+        more = hbtree_iter_next(tree, &iter);
+    }
+    CHECK(seen == model->size);
+
+    uint32_t lo = rnd(BTREE_KEYS), hi = rnd(BTREE_KEYS + 1);
+    model->collected = 0;
+    uint32_t n = hbtree_foreach_range(tree, &lo, &hi, btree_collect, model);
+    CHECK(n == model->collected);
+    uint32_t expected = 0;
+    for (uint32_t k = lo; k < hi; ++k) {
+        if (!model->present[k]) continue;
+        CHECK(expected < n && model->keys[expected] == k);
+        ++expected;
+    }
+    CHECK(expected == n);
+
+    uint32_t next = lo;
+    while (next < BTREE_KEYS && !model->present[next]) ++next;
+    bool found = hbtree_lower_bound(tree, &lo, &iter);
+    CHECK(found == (next < BTREE_KEYS));
+    if (found) CHECK(*(const uint32_t*)hbtree_iter_key(tree, &iter) == next);
+    return 1;
+}
+
+static int btree_put(hbtree_ptr_t tree, uint32_t key, uint32_t value)
+{
+    btree_model_t* model = &s_btree;
+    CHECK(hbtree_put(tree, &key, &value) == HLIB_OK);
+    if (!model->present[key]) ++model->size;
+    model->present[key] = true;
+    model->value[key] = value;
+    return 1;
+}
+
+/*
+ * 交替的增长、收缩阶段反复经过分裂、借用与合并；
+ * 其间整棵树用 bulk_load 重建，之后的修改从全满的节点开始
+ */
+static int check_btree(void)
+{
+    btree_model_t* model = &s_btree;
+    check_begin("hbtree");
+    hbtree_ptr_t tree = btree_new();
+    CHECK(tree != NULL);
+    memset(model, 0, sizeof(*model));
+
+    uint32_t phase_len = s_rounds / 8 + 1;
+    for (uint32_t i = 0; i < s_rounds; ++i) {
+        bool growing = (i / phase_len) % 2 == 0;
+        uint32_t key = rnd(BTREE_KEYS);
+        uint32_t op = rnd(100);
+        if (op < (growing ? 60u : 25u)) {
+            if (!btree_put(tree, key, rnd(0xFFFFFFFFu))) return 0;
+        } else if (op < 90) {
+            CHECK(hbtree_remove(tree, &key) == model->present[key]);
+            if (model->present[key]) --model->size;
+            model->present[key] = false;
+        } else {
+            uint32_t* value = (uint32_t*)hbtree_get(tree, &key);
+            CHECK((value != NULL) == model->present[key]);
+            if (value != NULL) CHECK(*value == model->value[key]);
+        }
+
+        if (i % 512 == 0 && !btree_verify(tree)) return 0;
+
+        /* 偶尔整体重建：随机取一个递增的键子集批量建树 */
+        if (i % (phase_len / 2 + 1) == phase_len / 4) {
+            static uint32_t keys[BTREE_KEYS], values[BTREE_KEYS];
+            uint32_t count = 0;
+            uint32_t density = 1 + rnd(100);
+            for (uint32_t k = 0; k < BTREE_KEYS; ++k) {
+                if (rnd(100) < density) {
+                    keys[count] = k;
+                    values[count] = rnd(0xFFFFFFFFu);
+                    ++count;
+                }
+            }
+            if (model->size != 0) CHECK(hbtree_bulk_load(tree, keys, values, count) == HLIB_ERROR);
+            hbtree_clear(tree);
+            memset(model->present, 0, sizeof(model->present));
+            model->size = 0;
+            if (count >= 2) {
+                uint32_t saved = keys[1];
+                keys[1] = keys[0];
+                CHECK(hbtree_bulk_load(tree, keys, values, count) == HLIB_ERROR);
+                CHECK(hbtree_empty(tree));
+                keys[1] = saved;
+            }
+            CHECK(hbtree_bulk_load(tree, keys, values, count) == HLIB_OK);
+            for (uint32_t j = 0; j < count; ++j) {
+                model->present[keys[j]] = true;
+                model->value[keys[j]] = values[j];
+            }
+            model->size = count;
+            if (!btree_verify(tree)) return 0;
+        }
+    }
+    if (!btree_verify(tree)) return 0;
+
+    /* 按随机顺序删空 */
+    for (uint32_t k = 0; k < BTREE_KEYS; ++k) {
+        uint32_t key = (k * 1237u + 11u) % BTREE_KEYS;
+        CHECK(hbtree_remove(tree, &key) == model->present[key]);
+        if (model->present[key]) --model->size;
+        model->present[key] = false;
+        if (k % 128 == 0 && !btree_verify(tree)) return 0;
+    }
+    if (!btree_verify(tree)) return 0;
+    hbtree_destroy(tree);
+    printf("ok\n");
+    return 1;
+}
+
+/* ==================== hlru ==================== */
+
+/* 键空间是容量的 3 倍，索引负载因子 0.5，探测链上频繁出现删除后的回移 */
+#define LRU_CAPACITY 32u
+#define LRU_KEYS     (3u * LRU_CAPACITY)
+
+#if HLIBC_USE_STATIC_ALLOC
+HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t
+    s_lru_buffer[HLRU_CALC_BUFFER_SIZE(uint32_t, uint64_t, LRU_CAPACITY)];
+#endif
+
+typedef struct {
+    uint32_t order[LRU_CAPACITY];   /* 下标 0 最新 */
+    uint64_t value[LRU_KEYS];
+    uint32_t size;
+    uint32_t evicted_key;
+    uint64_t evicted_value;
+    uint32_t evictions;
+} lru_model_t;
+
+static lru_model_t s_lru;
+
+static hlru_ptr_t lru_new(void)
+{
+#if HLIBC_USE_STATIC_ALLOC
+    return hlru_create_static(s_lru_buffer, sizeof(s_lru_buffer), sizeof(uint32_t),
+                              sizeof(uint64_t), LRU_CAPACITY);
+#else
+    return hlru_create(sizeof(uint32_t), sizeof(uint64_t), LRU_CAPACITY);
+#endif
+}
+
+static void lru_on_evict(hcdata_ptr_t key, hdata_ptr_t value, void* ctx)
+{
+    lru_model_t* model = (lru_model_t*)ctx;
+    model->evicted_key = *(const uint32_t*)key;
+    model->evicted_value = *(const uint64_t*)value;
+    ++model->evictions;
+}
+
+/* 模型中 key 的位置，不存在时返回 size */
+static uint32_t lru_find(const lru_model_t* model, uint32_t key)
+{
+    uint32_t i = 0;
+    while (i < model->size && model->order[i] != key) ++i;
+    return i;
+}
+
+static void lru_unlink(lru_model_t* model, uint32_t pos)
+{
+    memmove(&model->order[pos], &model->order[pos + 1], (model->size - pos - 1) * sizeof(uint32_t));
+    --model->size;
+}
+
+static void lru_push_front(lru_model_t* model, uint32_t key)
+{
+    memmove(&model->order[1], &model->order[0], model->size * sizeof(uint32_t));
+    model->order[0] = key;
+    ++model->size;
+}
+
+/* 淘汰的一定是模型中最旧的条目 */
+static int lru_expect_evict(lru_model_t* model, uint32_t evictions_before)
+{
+    uint32_t oldest = model->order[model->size - 1];
+    CHECK(model->evictions == evictions_before + 1);
+    CHECK(model->evicted_key == oldest);
+    CHECK(model->evicted_value == model->value[oldest]);
+    --model->size;
+    return 1;
+}
+
+static int lru_verify(hlru_ptr_t lru)
+{
+    lru_model_t* model = &s_lru;
+    CHECK(hlru_size(lru) == model->size);
+    CHECK(hlru_full(lru) == (model->size == LRU_CAPACITY));
+    for (uint32_t key = 0; key < LRU_KEYS; ++key) {
+        uint64_t* value = (uint64_t*)hlru_peek(lru, &key);
+        bool present = lru_find(model, key) < model->size;
+        CHECK((value != NULL) == present);
+        if (present) CHECK(*value == model->value[key]);
+    }
+    return 1;
+}
+
+static int check_lru(void)
+{
+    lru_model_t* model = &s_lru;
+    check_begin("hlru");
+    memset(model, 0, sizeof(*model));
+    hlru_ptr_t lru = lru_new();
+    CHECK(lru != NULL);
+    CHECK(hlru_capacity(lru) == LRU_CAPACITY);
+    hlru_set_evict_cb(lru, lru_on_evict, model);
+
+    for (uint32_t i = 0; i < s_rounds; ++i) {
+        uint32_t key = rnd(LRU_KEYS);
+        uint32_t pos = lru_find(model, key);
+        bool present = pos < model->size;
+        uint32_t op = rnd(100);
+        uint32_t evictions = model->evictions;
+        if (op < 40) {
+            uint64_t value = ((uint64_t)rnd(0xFFFFFFFFu) << 32) | i;
+            CHECK(hlru_put(lru, &key, &value) == HLIB_OK);
+            /* 只有写入新键且已满时才淘汰 */
+            if (present) {
+                lru_unlink(model, pos);
+                CHECK(model->evictions == evictions);
+            } else if (model->size == LRU_CAPACITY) {
+                if (!lru_expect_evict(model, evictions)) return 0;
+            } else {
+                CHECK(model->evictions == evictions);
+            }
+            model->value[key] = value;
+            lru_push_front(model, key);
+        } else if (op < 70) {
+            uint64_t* value = (uint64_t*)hlru_get(lru, &key);
+            CHECK((value != NULL) == present);
+            if (present) {
+                CHECK(*value == model->value[key]);
+                lru_unlink(model, pos);
+                lru_push_front(model, key);
+            }
+        } else if (op < 90) {
+            CHECK(hlru_remove(lru, &key) == present);
+            if (present) lru_unlink(model, pos);
+            CHECK(model->evictions == evictions);
+        } else if (op < 97) {
+            CHECK(hlru_evict(lru) == (model->size != 0));
+            if (model->size != 0 && !lru_expect_evict(model, evictions)) return 0;
+        } else if (op < 98) {
+            hlru_clear(lru);
+            model->size = 0;
+            CHECK(model->evictions == evictions);
+        }
+        if (i % 64 == 0 && !lru_verify(lru)) return 0;
+    }
+    if (!lru_verify(lru)) return 0;
+
+    /* 逐个淘汰，顺序即为模型中从旧到新的顺序 */
+    while (model->size != 0) {
+        uint32_t evictions = model->evictions;
+        CHECK(hlru_evict(lru));
+        if (!lru_expect_evict(model, evictions)) return 0;
+    }
+    CHECK(hlru_empty(lru));
+    hlru_destroy(lru);
+    printf("ok\n");
+    return 1;
+}
+
+/* ==================== htimer_wheel ==================== */
+
+#define TIMER_SLOTS 512u
+
+#if HLIBC_USE_STATIC_ALLOC
+HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t s_timer_buffer[HTIMER_WHEEL_BUFFER_SIZE(TIMER_SLOTS)];
+#endif
+
+typedef enum { TIMER_FREE, TIMER_PENDING, TIMER_FIRED } timer_state_t;
+
+typedef struct {
+    htimer_t handle;
+    uint64_t expires;
+    timer_state_t state;
+} timer_record_t;
+
+typedef struct {
+    timer_record_t records[TIMER_SLOTS];
+    uint32_t pending;
+    uint32_t fired;
+    uint32_t errors;
+} timer_model_t;
+
+static timer_model_t s_timer;
+
+static htimer_wheel_ptr_t timer_new(uint64_t now)
+{
+#if HLIBC_USE_STATIC_ALLOC
+    return htimer_wheel_create_static(s_timer_buffer, sizeof(s_timer_buffer), now);
+#else
+    return htimer_wheel_create(now);
+#endif
+}
+
+/* 延迟分布覆盖第 0 层、各高层以及超出总跨度的情况 */
+static uint64_t timer_random_delay(void)
+{
+    uint32_t kind = rnd(100);
+    if (kind < 50) return rnd(80);
+    if (kind < 80) return rnd(1u << 12);
+    if (kind < 95) return rnd(1u << 20);
+    return (uint64_t)HTIMER_WHEEL_SLOTS * HTIMER_WHEEL_SLOTS * HTIMER_WHEEL_SLOTS * HTIMER_WHEEL_SLOTS +
+           rnd(1u << 22);
+}
+
+static int timer_add(htimer_wheel_ptr_t wheel, timer_record_t* rec, uint64_t delay);
+
+static void timer_on_expire(htimer_wheel_ptr_t wheel, void* ctx)
+{
+    timer_record_t* rec = (timer_record_t*)ctx;
+    timer_model_t* model = &s_timer;
+    /* 恰好在到期的 tick 调用一次 */
+    if (rec->state != TIMER_PENDING || htimer_wheel_now(wheel) != rec->expires ||
+        htimer_wheel_pending(wheel, &rec->handle))
+        ++model->errors;
+    rec->state = TIMER_FIRED;
+    --model->pending;
+    ++model->fired;
+
+    /* 回调中添加新的定时器，有时延迟为 0（下一个 tick） */
+    if (rnd(4) == 0) {
+        timer_record_t* next = &model->records[rnd(TIMER_SLOTS)];
+        if (next->state != TIMER_PENDING && !timer_add(wheel, next, rnd(4) == 0 ? 0 : timer_random_delay()))
+            ++model->errors;
+    }
+}
+
+static int timer_add(htimer_wheel_ptr_t wheel, timer_record_t* rec, uint64_t delay)
+{
+    timer_model_t* model = &s_timer;
+    CHECK(htimer_wheel_add(wheel, delay, timer_on_expire, rec, &rec->handle) == HLIB_OK);
+    rec->expires = htimer_wheel_now(wheel) + (delay != 0 ? delay : 1);
+    rec->state = TIMER_PENDING;
+    ++model->pending;
+    return 1;
+}
+
+static int timer_verify(htimer_wheel_ptr_t wheel)
+{
+    timer_model_t* model = &s_timer;
+    uint64_t now = htimer_wheel_now(wheel);
+    CHECK(model->errors == 0);
+    CHECK(htimer_wheel_size(wheel) == model->pending);
+    for (uint32_t i = 0; i < TIMER_SLOTS; ++i) {
+        timer_record_t* rec = &model->records[i];
+        if (rec->state == TIMER_PENDING) CHECK(rec->expires > now);
+        CHECK(htimer_wheel_pending(wheel, &rec->handle) == (rec->state == TIMER_PENDING));
+    }
+    return 1;
+}
+
+/* 推进到 now，期间到期的定时器必须全部被调用 */
+static int timer_advance(htimer_wheel_ptr_t wheel, uint64_t now)
+{
+    timer_model_t* model = &s_timer;
+    uint32_t fired = model->fired;
+    uint32_t n = htimer_wheel_advance(wheel, now);
+    CHECK(n == model->fired - fired);
+    CHECK(htimer_wheel_now(wheel) == now);
+    return timer_verify(wheel);
+}
+
+static int check_timer_wheel(void)
+{
+    timer_model_t* model = &s_timer;
+    check_begin("htimer_wheel");
+    memset(model, 0, sizeof(*model));
+    /* 起始时间不在圈的边界上，第一次级联发生在不完整的一圈之后 */
+    uint64_t start = 0x123456789ull;
+    htimer_wheel_ptr_t wheel = timer_new(start);
+    CHECK(wheel != NULL);
+#if HLIBC_USE_STATIC_ALLOC
+    CHECK(htimer_wheel_capacity(wheel) == TIMER_SLOTS);
+#endif
+
+    uint32_t rounds = s_rounds / 4;
+    for (uint32_t i = 0; i < rounds; ++i) {
+        timer_record_t* rec = &model->records[rnd(TIMER_SLOTS)];
+        uint32_t op = rnd(100);
+        if (op < 45) {
+            if (rec->state != TIMER_PENDING && !timer_add(wheel, rec, timer_random_delay())) return 0;
+        } else if (op < 60) {
+            bool pending = rec->state == TIMER_PENDING;
+            CHECK(htimer_wheel_cancel(wheel, &rec->handle) == pending);
+            CHECK(!htimer_wheel_cancel(wheel, &rec->handle));
+            if (pending) --model->pending;
+            rec->state = TIMER_FREE;
+        } else {
+            uint32_t kind = rnd(100);
+            uint64_t step = kind < 60 ? 1 + rnd(8) : kind < 95 ? 1 + rnd(600) : 1 + rnd(1u << 16);
+            if (!timer_advance(wheel, htimer_wheel_now(wheel) + step)) return 0;
+        }
+        CHECK(model->errors == 0);
+
+        /* 偶尔把挂起的定时器全部走完，再空转一大段（整段跳过） */
+        if (i % (rounds / 4 + 1) == rounds / 8) {
+            while (model->pending != 0) {
+                uint64_t last = htimer_wheel_now(wheel);
+                for (uint32_t j = 0; j < TIMER_SLOTS; ++j) {
+                    if (model->records[j].state == TIMER_PENDING && model->records[j].expires > last)
+                        last = model->records[j].expires;
+                }
+                if (!timer_advance(wheel, last)) return 0;
+            }
+            if (!timer_advance(wheel, htimer_wheel_now(wheel) + ((uint64_t)1 << 40))) return 0;
+        }
+    }
+
+    /* 清空后旧句柄全部失效 */
+    htimer_wheel_clear(wheel);
+    for (uint32_t j = 0; j < TIMER_SLOTS; ++j) {
+        if (model->records[j].state == TIMER_PENDING) model->records[j].state = TIMER_FREE;
+    }
+    model->pending = 0;
+    if (!timer_verify(wheel)) return 0;
+    htimer_wheel_destroy(wheel);
+    printf("ok\n");
+    return 1;
+}
+
+/* ==================== hring ==================== */
+
+#define RING_BYTES   2048u
+#define RING_RECORDS 1024u
+
+#if HLIBC_USE_STATIC_ALLOC
+HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t s_ring_buffer[HRING_BUFFER_SIZE(RING_BYTES)];
+#endif
+
+typedef struct {
+    uint32_t len;
+    uint32_t seed;
+} ring_record_t;
+
+typedef struct {
+    ring_record_t records[RING_RECORDS];    /* 环形，head 起的 count 条 */
+    uint32_t head;
+    uint32_t count;
+    uint32_t bytes;
+    uint32_t visited;                       /* foreach 的进度 */
+    bool mismatch;
+} ring_model_t;
+
+static ring_model_t s_ring;
+
+static hring_ptr_t ring_new(void)
+{
+#if HLIBC_USE_STATIC_ALLOC
+    return hring_create_static(s_ring_buffer, sizeof(s_ring_buffer));
+#else
+    return hring_create(64);
+#endif
+}
+
+static bool ring_visit(const void* data, uint32_t len, void* ctx)
+{
+    ring_model_t* model = (ring_model_t*)ctx;
+    const ring_record_t* rec = &model->records[(model->head + model->visited) % RING_RECORDS];
+    if (model->visited >= model->count || rec->len != len || !payload_equal(data, len, rec->seed))
+        model->mismatch = true;
+    ++model->visited;
+    return true;
+}
+
+static int ring_verify(hring_ptr_t ring)
+{
+    ring_model_t* model = &s_ring;
+    CHECK(hring_count(ring) == model->count);
+    CHECK(hring_empty(ring) == (model->count == 0));
+    CHECK(hring_bytes(ring) == model->bytes);
+    uint32_t len = 0;
+    const void* data = hring_peek(ring, &len);
+    CHECK((data != NULL) == (model->count != 0));
+    if (data != NULL) {
+        const ring_record_t* rec = &model->records[model->head];
+        CHECK(((uintptr_t)data & (HRING_ALIGN - 1)) == 0);
+        CHECK(len == rec->len && payload_equal(data, len, rec->seed));
+    }
+    model->visited = 0;
+    model->mismatch = false;
+    CHECK(hring_foreach(ring, ring_visit, model) == model->count);
+    CHECK(!model->mismatch && model->visited == model->count);
+    return 1;
+}
+
+/* 负载长度多数较小，偶尔接近数据区的一半，经常触发 A 段写满后另起 B 段 */
+static uint32_t ring_random_len(void)
+{
+    uint32_t kind = rnd(100);
+    if (kind < 70) return rnd(48);
+    if (kind < 95) return rnd(256);
+    return rnd(RING_BYTES / 2);
+}
+
+static void ring_append(ring_model_t* model, uint32_t len, uint32_t seed)
+{
+    ring_record_t* rec = &model->records[(model->head + model->count) % RING_RECORDS];
+    rec->len = len;
+    rec->seed = seed;
+    ++model->count;
+    model->bytes += (uint32_t)HRING_RECORD_SIZE(len);
+}
+
+static int check_ring(void)
+{
+    ring_model_t* model = &s_ring;
+    check_begin("hring");
+    memset(model, 0, sizeof(*model));
+    hring_ptr_t ring = ring_new();
+    CHECK(ring != NULL);
+    CHECK(hring_commit(ring, 0) == HLIB_ERROR);
+
+    for (uint32_t i = 0; i < s_rounds; ++i) {
+        uint32_t op = rnd(100);
+        /* 静态分配时写入失败当且仅当连续空间不够 */
+        uint32_t len = ring_random_len();
+        bool fits = true;
+#if HLIBC_USE_STATIC_ALLOC
+        fits = HRING_RECORD_SIZE(len) <= hring_free_contiguous(ring);
+#endif
+        if (model->count == RING_RECORDS) op = 99;
+        if (op < 30) {
+            uint8_t data[RING_BYTES];
+            payload_fill(data, len, i);
+            hlib_status_t ret = hring_push(ring, data, len);
+            CHECK(ret == (fits ? HLIB_OK : HLIB_OVERFLOW));
+            if (fits) ring_append(model, len, i);
+        } else if (op < 55) {
+            /* 预留 len 字节，实际提交较短的长度 */
+            void* dest = hring_reserve(ring, len);
+            CHECK((dest != NULL) == fits);
+            if (dest != NULL) {
+                CHECK(((uintptr_t)dest & (HRING_ALIGN - 1)) == 0);
+                uint32_t used = rnd(len + 1);
+                payload_fill(dest, used, i);
+                /* 超出预留的提交被拒绝，预留仍然有效 */
+                CHECK(hring_commit(ring, (uint32_t)HLIBC_ALIGN_UP(len, HRING_ALIGN) + 1) == HLIB_ERROR);
+                CHECK(hring_commit(ring, used) == HLIB_OK);
+                CHECK(hring_commit(ring, 0) == HLIB_ERROR);
+                ring_append(model, used, i);
+            }
+        } else if (op < 98) {
+            CHECK(hring_pop(ring) == (model->count != 0));
+            if (model->count != 0) {
+                model->bytes -= (uint32_t)HRING_RECORD_SIZE(model->records[model->head].len);
+                model->head = (model->head + 1) % RING_RECORDS;
+                --model->count;
+            }
+        } else {
+            hring_clear(ring);
+            model->count = 0;
+            model->bytes = 0;
+        }
+        if (i % 16 == 0 && !ring_verify(ring)) return 0;
+    }
+    if (!ring_verify(ring)) return 0;
+    hring_destroy(ring);
+    printf("ok\n");
+    return 1;
+}
+
+/* ==================== hpool ==================== */
+
+/* 块大小故意不是 2 的幂 */
+#define POOL_BLOCK_SIZE 24u
+#define POOL_BLOCKS     256u
+
+#if HLIBC_USE_STATIC_ALLOC
+HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t
+    s_pool_buffer[HPOOL_BUFFER_SIZE(POOL_BLOCK_SIZE, POOL_BLOCKS)];
+#endif
+
+typedef struct {
+    void* block;
+    uint32_t seed;
+} pool_live_t;
+
+static hpool_ptr_t pool_new(void)
+{
+#if HLIBC_USE_STATIC_ALLOC
+    return hpool_create_static(s_pool_buffer, sizeof(s_pool_buffer), POOL_BLOCK_SIZE);
+#else
+    return hpool_create(POOL_BLOCK_SIZE);
+#endif
+}
+
+/* 块互不重叠：每个存活的块都保持写入时的内容 */
+static int pool_verify(hpool_ptr_t pool, const pool_live_t* live, uint32_t count)
+{
+    CHECK(hpool_used(pool) == count);
+    for (uint32_t i = 0; i < count; ++i) {
+        CHECK(payload_equal(live[i].block, POOL_BLOCK_SIZE, live[i].seed));
+#if HLIBC_USE_STATIC_ALLOC
+        CHECK(hpool_owns(pool, live[i].block));
+#endif
+    }
+    return 1;
+}
+
+static int check_pool(void)
+{
+    static pool_live_t live[POOL_BLOCKS];
+    uint32_t count = 0;
+    check_begin("hpool");
+    hpool_ptr_t pool = pool_new();
+    CHECK(pool != NULL);
+    CHECK(hpool_block_size(pool) == POOL_BLOCK_SIZE);
+#if HLIBC_USE_STATIC_ALLOC
+    CHECK(hpool_capacity(pool) == POOL_BLOCKS);
+    CHECK(!hpool_owns(pool, s_pool_buffer));
+#endif
+
+    for (uint32_t i = 0; i < s_rounds; ++i) {
+        uint32_t op = rnd(100);
+        /* 前半段偏向申请，后半段偏向归还 */
+        uint32_t alloc_bias = (i / (s_rounds / 8 + 1)) % 2 == 0 ? 65 : 35;
+        if (op < alloc_bias) {
+            void* block = hpool_alloc(pool);
+#if HLIBC_USE_STATIC_ALLOC
+            CHECK((block == NULL) == (count == POOL_BLOCKS));
+            CHECK(((uintptr_t)block & (HLIBC_STATIC_ALIGN - 1)) == 0);
+#else
+            CHECK(block != NULL);
+            CHECK(((uintptr_t)block & (_Alignof(max_align_t) - 1)) == 0);
+            if (count == POOL_BLOCKS) {
+                hpool_free(pool, block);
+                block = NULL;
+            }
+#endif
+            if (block != NULL) {
+                payload_fill(block, POOL_BLOCK_SIZE, i);
+                live[count].block = block;
+                live[count].seed = i;
+                ++count;
+            }
+        } else if (op < 99) {
+            if (count != 0) {
+                uint32_t victim = rnd(count);
+                CHECK(payload_equal(live[victim].block, POOL_BLOCK_SIZE, live[victim].seed));
+                hpool_free(pool, live[victim].block);
+                live[victim] = live[--count];
+            }
+        } else {
+            hpool_clear(pool);
+            count = 0;
+        }
+        if (i % 64 == 0 && !pool_verify(pool, live, count)) return 0;
+    }
+    if (!pool_verify(pool, live, count)) return 0;
+    hpool_destroy(pool);
+    printf("ok\n");
+    return 1;
+}
+
+/* ==================== hlist ==================== */
+
+/*
+ * 定长 hlist：任意位置的插入、删除、区间删除与移动。
+ * 静态分配时另外穿插增量压缩以及追加、取回缓冲区
+ */
+#define LIST_CAPACITY     64u
+#define LIST_SEGMENT      24u
+#define LIST_SEGMENTS     2u
+#define LIST_MODEL_MAX    (LIST_CAPACITY + LIST_SEGMENTS * LIST_SEGMENT)
+
+#if HLIBC_USE_STATIC_ALLOC
+HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t
+    s_list_buffer[HLIST_CALC_BUFFER_SIZE(uint32_t, LIST_CAPACITY)];
+/* 每块缓冲区都要按 HLIBC_STATIC_ALIGN 对齐，数组的行长取整，传给 hlist_add_buffer 的仍是精确大小 */
+#define LIST_SEGMENT_BYTES HLIST_CALC_SEGMENT_SIZE(uint32_t, LIST_SEGMENT)
+HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t
+    s_list_segments[LIST_SEGMENTS][HLIBC_ALIGN_UP(LIST_SEGMENT_BYTES, HLIBC_STATIC_ALIGN)];
+#endif
+
+typedef struct {
+    uint32_t values[LIST_MODEL_MAX];
+    uint32_t size;
+    uint32_t capacity;
+    bool attached[LIST_SEGMENTS];
+} list_model_t;
+
+static list_model_t s_list;
+
+static hlist_ptr_t list_new(void)
+{
+#if HLIBC_USE_STATIC_ALLOC
+    return hlist_create_static(s_list_buffer, sizeof(s_list_buffer), sizeof(uint32_t));
+#else
+    return hlist_create(sizeof(uint32_t));
+#endif
+}
+
+/* 第 index 个元素的迭代器，index == size 时为头节点 */
+static hlist_iterator_ptr_t list_at(hlist_ptr_t list, uint32_t index)
+{
+    hlist_iterator_ptr_t iter = hlist_begin(list);
+    while (index-- != 0) hlist_iter_forward(&iter);
+    return iter;
+}
+
+static int list_verify(hlist_ptr_t list)
+{
+    list_model_t* model = &s_list;
+    CHECK(hlist_size(list) == model->size);
+    CHECK(hlist_empty(list) == (model->size == 0));
+#if HLIBC_USE_STATIC_ALLOC
+    CHECK(hlist_capacity(list) == model->capacity);
+    CHECK(hlist_full(list) == (model->size == model->capacity));
+#endif
+    hlist_iterator_ptr_t iter = hlist_begin(list);
+    for (uint32_t i = 0; i < model->size; ++i) {
+        CHECK(*(uint32_t*)hlist_iter_data(iter) == model->values[i]);
+        hlist_iter_forward(&iter);
+    }
+    CHECK(iter == hlist_end(list)->next);
+    /* 反向遍历同样一致 */
+    iter = hlist_end(list);
+    for (uint32_t i = model->size; i-- != 0;) {
+        CHECK(*(uint32_t*)hlist_iter_data(iter) == model->values[i]);
+        hlist_iter_backward(&iter);
+    }
+    return 1;
+}
+
+static void list_model_insert(list_model_t* model, uint32_t index, uint32_t value)
+{
+    memmove(&model->values[index + 1], &model->values[index], (model->size - index) * sizeof(uint32_t));
+    model->values[index] = value;
+    ++model->size;
+}
+
+static void list_model_erase(list_model_t* model, uint32_t first, uint32_t last)
+{
+    memmove(&model->values[first], &model->values[last], (model->size - last) * sizeof(uint32_t));
+    model->size -= last - first;
+}
+
+static int check_list(void)
+{
+    list_model_t* model = &s_list;
+    check_begin("hlist");
+    memset(model, 0, sizeof(*model));
+    hlist_ptr_t list = list_new();
+    CHECK(list != NULL);
+    /* 动态分配没有容量上限，模型的长度上限只用于约束测试规模 */
+    model->capacity = LIST_CAPACITY;
+
+    for (uint32_t i = 0; i < s_rounds; ++i) {
+        uint32_t op = rnd(100);
+        uint32_t value = i;
+        bool room = model->size < model->capacity;
+        if (op < 30) {
+            uint32_t index = rnd(model->size + 1);
+            uint32_t how = rnd(4);
+            if (how == 0) index = 0;
+            if (how == 1) index = model->size;
+#if HLIBC_USE_STATIC_ALLOC == 0
+            if (room)
+#endif
+            {
+                hlib_status_t ret = how == 0   ? hlist_push_front(list, &value, sizeof(value))
+                                    : how == 1 ? hlist_push_back(list, &value, sizeof(value))
+                                               : hlist_insert(list, list_at(list, index), &value, sizeof(value));
+                CHECK(ret == (room ? HLIB_OK : HLIB_OVERFLOW));
+            }
+            if (room) list_model_insert(model, index, value);
+        } else if (op < 40) {
+            /* 批量插入，失败时链表不变 */
+            uint32_t values[8];
+            uint32_t count = 1 + rnd(8);
+            uint32_t index = rnd(model->size + 1);
+            for (uint32_t j = 0; j < count; ++j) values[j] = i * 8 + j;
+            bool fits = model->size + count <= model->capacity;
+#if HLIBC_USE_STATIC_ALLOC
+            CHECK(hlist_insert_range(list, list_at(list, index), values, count) ==
+                  (fits ? HLIB_OK : HLIB_OVERFLOW));
+#else
+            if (fits) CHECK(hlist_insert_range(list, list_at(list, index), values, count) == HLIB_OK);
+#endif
+            if (fits) {
+                for (uint32_t j = 0; j < count; ++j) list_model_insert(model, index + j, values[j]);
+            }
+        } else if (op < 55) {
+            if (model->size != 0) {
+                uint32_t index = rnd(model->size);
+                hlist_iterator_ptr_t next = hlist_erase(list, list_at(list, index));
+                list_model_erase(model, index, index + 1);
+                CHECK(next == list_at(list, index));
+            }
+        } else if (op < 62) {
+            uint32_t first = rnd(model->size + 1);
+            uint32_t last = first + rnd(model->size - first + 1);
+            hlist_iterator_ptr_t end = list_at(list, last);
+            CHECK(hlist_erase_range(list, list_at(list, first), end) == end);
+            list_model_erase(model, first, last);
+        } else if (op < 64) {
+            /* 越过头节点的区间不删除任何元素 */
+            if (model->size >= 2) {
+                uint32_t first = 1 + rnd(model->size - 1);
+                hlist_iterator_ptr_t end = list_at(list, rnd(first));
+                CHECK(hlist_erase_range(list, list_at(list, first), end) == end);
+            }
+        } else if (op < 72) {
+            if (model->size != 0) {
+                uint32_t from = rnd(model->size);
+                uint32_t to = rnd(model->size + 1);
+                hlist_move(list, list_at(list, to), list_at(list, from));
+                uint32_t moved = model->values[from];
+                list_model_erase(model, from, from + 1);
+                list_model_insert(model, to > from ? to - 1 : to, moved);
+            }
+        } else if (op < 76) {
+            if (model->size != 0) {
+                if (rnd(2) == 0) {
+                    hlist_pop_front(list);
+                    list_model_erase(model, 0, 1);
+                } else {
+                    hlist_pop_back(list);
+                    list_model_erase(model, model->size - 1, model->size);
+                }
+            }
+        } else if (op < 77) {
+            hlist_clear(list);
+            model->size = 0;
+        }
+#if HLIBC_USE_STATIC_ALLOC
+        else if (op < 90) {
+            uint32_t left = hlist_compact(list, rnd(8));
+            CHECK(left <= model->size);
+        } else if (op < 95) {
+            uint32_t seg = rnd(LIST_SEGMENTS);
+            if (!model->attached[seg]) {
+                CHECK(hlist_add_buffer(list, s_list_segments[seg], LIST_SEGMENT_BYTES) == HLIB_OK);
+                model->attached[seg] = true;
+                model->capacity += LIST_SEGMENT;
+            }
+        } else {
+            /* 取回一块缓冲区：元素不多于最初的容量时，完整压缩之后一定能取回 */
+            uint32_t seg = rnd(LIST_SEGMENTS);
+            hlib_status_t ret = hlist_remove_buffer(list, s_list_segments[seg]);
+            if (!model->attached[seg]) {
+                CHECK(ret == HLIB_ERROR);
+            } else {
+                CHECK(ret == HLIB_OK || ret == HLIB_BUSY);
+                if (ret == HLIB_BUSY && model->size <= LIST_CAPACITY) {
+                    CHECK(hlist_compact(list, 0) == 0);
+                    ret = hlist_remove_buffer(list, s_list_segments[seg]);
+                    CHECK(ret == HLIB_OK);
+                }
+                if (ret == HLIB_OK) {
+                    model->attached[seg] = false;
+                    model->capacity -= LIST_SEGMENT;
+                }
+            }
+        }
+#endif
+        if (i % 32 == 0 && !list_verify(list)) return 0;
+    }
+    if (!list_verify(list)) return 0;
+
+#if HLIBC_USE_STATIC_ALLOC
+    /* 完整压缩后，顺序遍历即为对节点数组的线性扫描，追加的缓冲区全部排空 */
+    while (model->size > LIST_CAPACITY) {
+        hlist_pop_back(list);
+        --model->size;
+    }
+    CHECK(hlist_compact(list, 0) == 0);
+    if (!list_verify(list)) return 0;
+    for (uint32_t seg = 0; seg < LIST_SEGMENTS; ++seg) {
+        if (model->attached[seg]) CHECK(hlist_remove_buffer(list, s_list_segments[seg]) == HLIB_OK);
+    }
+    model->capacity = LIST_CAPACITY;
+    if (!list_verify(list)) return 0;
+#endif
+    hlist_destroy(list);
+    printf("ok\n");
+    return 1;
+}
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/* 变长 hlist：每个元素的长度不同，遍历得到的长度与内容都必须一致 */
+#define VAR_MODEL_MAX 128u
+
+typedef struct {
+    ring_record_t items[VAR_MODEL_MAX];
+    uint32_t size;
+    uint32_t visited;
+    bool mismatch;
+} var_model_t;
+
+static var_model_t s_var;
+
+static bool var_visit(hdata_ptr_t data, uint32_t size, void* ctx)
+{
+    var_model_t* model = (var_model_t*)ctx;
+    const ring_record_t* item = &model->items[model->visited];
+    if (model->visited >= model->size || item->len != size || !payload_equal(data, size, item->seed) ||
+        ((uintptr_t)data & (_Alignof(max_align_t) - 1)) != 0)
+        model->mismatch = true;
+    ++model->visited;
+    return true;
+}
+
+static int var_verify(hlist_ptr_t list)
+{
+    var_model_t* model = &s_var;
+    CHECK(hlist_size(list) == model->size);
+    model->visited = 0;
+    model->mismatch = false;
+    CHECK(hlist_foreach_sized(list, var_visit, model) == model->size);
+    CHECK(!model->mismatch);
+    hlist_iterator_ptr_t iter = hlist_begin(list);
+    for (uint32_t i = 0; i < model->size; ++i) {
+        CHECK(hlist_iter_size(list, iter) == model->items[i].len);
+        hlist_iter_forward(&iter);
+    }
+    CHECK(hlist_iter_size(list, iter) == 0);
+    return 1;
+}
+
+static int check_list_var(void)
+{
+    var_model_t* model = &s_var;
+    check_begin("hlist var");
+    memset(model, 0, sizeof(*model));
+    hlist_ptr_t list = hlist_create_var();
+    CHECK(list != NULL);
+    CHECK(hlist_emplace_back(list) == NULL);
+    uint32_t dummy = 0;
+    CHECK(hlist_insert_range(list, hlist_begin(list), &dummy, 1) == HLIB_ERROR);
+
+    for (uint32_t i = 0; i < s_rounds; ++i) {
+        uint32_t op = rnd(100);
+        uint32_t len = rnd(4) == 0 ? rnd(600) : 1 + rnd(40);
+        uint32_t index = rnd(model->size + 1);
+        if (model->size == VAR_MODEL_MAX) op = 60;
+        if (op < 40) {
+            uint8_t data[600];
+            payload_fill(data, len, i);
+            hlib_status_t ret;
+            if (index == 0 && rnd(2) == 0) ret = hlist_push_front(list, data, len);
+            else if (index == model->size && rnd(2) == 0) ret = hlist_push_back(list, data, len);
+            else ret = hlist_insert(list, list_at(list, index), data, len);
+            CHECK(ret == HLIB_OK);
+        } else if (op < 55) {
+            hdata_ptr_t dest = hlist_emplace_sized(list, list_at(list, index), len);
+            CHECK(dest != NULL);
+            payload_fill(dest, len, i);
+        } else if (op < 95) {
+            if (model->size != 0) {
+                index = rnd(model->size);
+                hlist_erase(list, list_at(list, index));
+                memmove(&model->items[index], &model->items[index + 1],
+                        (model->size - index - 1) * sizeof(ring_record_t));
+                --model->size;
+            }
+        } else {
+            hlist_clear(list);
+            model->size = 0;
+        }
+        if (op < 55) {
+            memmove(&model->items[index + 1], &model->items[index],
+                    (model->size - index) * sizeof(ring_record_t));
+            model->items[index].len = len;
+            model->items[index].seed = i;
+            ++model->size;
+        }
+        if (i % 32 == 0 && !var_verify(list)) return 0;
+    }
+    if (!var_verify(list)) return 0;
+    hlist_destroy(list);
+    printf("ok\n");
+    return 1;
+}
+#endif
+
+/* ==================== hqueue ==================== */
+
+/*
+ * 静态分配时另外检查覆盖模式、快照与追加缓冲区：
+ * 环形缓冲区写满后新元素暂存在追加的缓冲区中，pop 时按顺序搬回，快照只能看到已进入环形缓冲区的元素
+ */
+#define QUEUE_CAPACITY  16u
+#define QUEUE_SEGMENT   8u
+#define QUEUE_SEGMENTS  2u
+#define QUEUE_MODEL_MAX (QUEUE_CAPACITY + QUEUE_SEGMENTS * QUEUE_SEGMENT)
+
+#if HLIBC_USE_STATIC_ALLOC
+HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t
+    s_queue_buffer[HQUEUE_CALC_BUFFER_SIZE(uint32_t, QUEUE_CAPACITY)];
+#define QUEUE_SEGMENT_BYTES HQUEUE_CALC_SEGMENT_SIZE(uint32_t, QUEUE_SEGMENT)
+HLIBC_ALIGNAS(HLIBC_STATIC_ALIGN) static uint8_t
+    s_queue_segments[QUEUE_SEGMENTS][HLIBC_ALIGN_UP(QUEUE_SEGMENT_BYTES, HLIBC_STATIC_ALIGN)];
+#endif
+
+typedef struct {
+    uint32_t values[QUEUE_MODEL_MAX];
+    uint32_t size;
+    uint32_t capacity;
+    bool attached[QUEUE_SEGMENTS];
+    bool overwrite;
+    uint32_t dropped;
+    uint32_t* pushed;   /* clear 以来按顺序放入的元素 */
+    uint32_t pushes;
+    uint32_t visited;
+    bool mismatch;
+} queue_model_t;
+
+static queue_model_t s_queue;
+
+static hqueue_ptr_t queue_new(void)
+{
+#if HLIBC_USE_STATIC_ALLOC
+    return hqueue_create_static(s_queue_buffer, sizeof(s_queue_buffer), sizeof(uint32_t));
+#else
+    return hqueue_create(sizeof(uint32_t));
+#endif
+}
+
+static bool queue_visit(hdata_ptr_t data, void* ctx)
+{
+    queue_model_t* model = (queue_model_t*)ctx;
+    if (model->visited >= model->size || *(uint32_t*)data != model->values[model->visited])
+        model->mismatch = true;
+    ++model->visited;
+    return true;
+}
+
+#if HLIBC_USE_STATIC_ALLOC
+static bool queue_visit_span(hdata_ptr_t base, uint32_t count, void* ctx)
+{
+    for (uint32_t i = 0; i < count; ++i) queue_visit((uint32_t*)base + i, ctx);
+    return true;
+}
+#endif
+
+static int queue_verify(hqueue_ptr_t queue)
+{
+    queue_model_t* model = &s_queue;
+    CHECK(hqueue_size(queue) == model->size);
+    CHECK(hqueue_empty(queue) == (model->size == 0));
+    if (model->size != 0) {
+        CHECK(*(uint32_t*)hqueue_front(queue) == model->values[0]);
+        CHECK(*(uint32_t*)hqueue_rear(queue) == model->values[model->size - 1]);
+    }
+    model->visited = 0;
+    model->mismatch = false;
+    CHECK(hqueue_foreach(queue, queue_visit, model) == model->size);
+    CHECK(!model->mismatch);
+#if HLIBC_USE_STATIC_ALLOC
+    CHECK(hqueue_capacity(queue) == model->capacity);
+    CHECK(hqueue_full(queue) == (model->size == model->capacity));
+    CHECK(hqueue_dropped(queue) == model->dropped);
+    model->visited = 0;
+    CHECK(hqueue_foreach_span(queue, queue_visit_span, model) == model->size);
+    CHECK(!model->mismatch);
+
+    /* 已进入环形缓冲区的是最早放入的 pushes - 暂存数 个，快照单线程时返回其中最近的 capacity - 1 个 */
+    uint32_t snapshot[QUEUE_CAPACITY];
+    uint32_t spilled = model->size > QUEUE_CAPACITY ? model->size - QUEUE_CAPACITY : 0;
+    uint32_t published = model->pushes - spilled;
+    uint32_t expect = published < QUEUE_CAPACITY - 1 ? published : QUEUE_CAPACITY - 1;
+    uint32_t max_count = rnd(QUEUE_CAPACITY + 1);
+    if (expect > max_count) expect = max_count;
+    CHECK(hqueue_snapshot(queue, snapshot, max_count) == expect);
+    for (uint32_t i = 0; i < expect; ++i)
+        CHECK(snapshot[i] == model->pushed[published - expect + i]);
+#endif
+    return 1;
+}
+
+static int queue_push(hqueue_ptr_t queue, uint32_t value, bool emplace)
+{
+    queue_model_t* model = &s_queue;
+    bool room = model->size < model->capacity || model->overwrite;
+    if (emplace) {
+        uint32_t* dest = (uint32_t*)hqueue_emplace(queue);
+        CHECK((dest != NULL) == room);
+        if (dest != NULL) *dest = value;
+    } else {
+        CHECK(hqueue_push(queue, &value, sizeof(value), NULL) == (room ? HLIB_OK : HLIB_OVERFLOW));
+    }
+    if (!room) return 1;
+    if (model->size == model->capacity) {
+        memmove(&model->values[0], &model->values[1], (model->size - 1) * sizeof(uint32_t));
+        --model->size;
+        ++model->dropped;
+    }
+    model->values[model->size++] = value;
+    model->pushed[model->pushes++] = value;
+    return 1;
+}
+
+static int check_queue(void)
+{
+    queue_model_t* model = &s_queue;
+    check_begin("hqueue");
+    memset(model, 0, sizeof(*model));
+    model->pushed = (uint32_t*)malloc(((size_t)s_rounds + 1) * sizeof(uint32_t));
+    CHECK(model->pushed != NULL);
+    hqueue_ptr_t queue = queue_new();
+    CHECK(queue != NULL);
+    CHECK(hqueue_type_size(queue) == sizeof(uint32_t));
+    uint32_t wrong = 0;
+    CHECK(hqueue_push(queue, &wrong, sizeof(wrong) + 1, NULL) == HLIB_ERROR);
+#if HLIBC_USE_STATIC_ALLOC
+    model->capacity = QUEUE_CAPACITY;
+#else
+    /* 动态分配没有容量上限，模型的长度上限只用于约束测试规模 */
+    model->capacity = QUEUE_MODEL_MAX;
+#endif
+
+    for (uint32_t i = 0; i < s_rounds; ++i) {
+        uint32_t op = rnd(100);
+        if (op < 45) {
+#if HLIBC_USE_STATIC_ALLOC == 0
+            if (model->size == model->capacity) continue;
+#endif
+            if (!queue_push(queue, i, op < 10)) return 0;
+        } else if (op < 90) {
+            CHECK(hqueue_pop(queue) == (model->size != 0 ? HLIB_OK : HLIB_ERROR));
+            if (model->size != 0) {
+                memmove(&model->values[0], &model->values[1], (model->size - 1) * sizeof(uint32_t));
+                --model->size;
+            }
+        } else if (op < 91) {
+            hqueue_clear(queue);
+            model->size = 0;
+            model->dropped = 0;
+            model->pushes = 0;
+        }
+#if HLIBC_USE_STATIC_ALLOC
+        else if (op < 93) {
+            model->overwrite = !model->overwrite;
+            hqueue_set_overwrite(queue, model->overwrite);
+        } else if (op < 97) {
+            uint32_t seg = rnd(QUEUE_SEGMENTS);
+            if (!model->attached[seg]) {
+                CHECK(hqueue_add_buffer(queue, s_queue_segments[seg], QUEUE_SEGMENT_BYTES) ==
+                      HLIB_OK);
+                model->attached[seg] = true;
+                model->capacity += QUEUE_SEGMENT;
+            }
+        } else {
+            /* 没有暂存的元素时一定能取回 */
+            uint32_t seg = rnd(QUEUE_SEGMENTS);
+            hlib_status_t ret = hqueue_remove_buffer(queue, s_queue_segments[seg]);
+            if (!model->attached[seg]) {
+                CHECK(ret == HLIB_ERROR);
+            } else {
+                CHECK(ret == HLIB_OK || (ret == HLIB_BUSY && model->size > QUEUE_CAPACITY));
+                if (ret == HLIB_OK) {
+                    model->attached[seg] = false;
+                    model->capacity -= QUEUE_SEGMENT;
+                    CHECK(model->size <= model->capacity);
+                }
+            }
+        }
+#endif
+        if (!queue_verify(queue)) return 0;
+    }
+    hqueue_destroy(queue);
+    free(model->pushed);
+    printf("ok\n");
+    return 1;
+}
+
+#if HLIBC_USE_STATIC_ALLOC == 0
+/* ==================== 内联 hqueue / hstack ==================== */
+
+/*
+ * 结构体与前 INLINE_COUNT 个元素放在调用者的 buffer 中：
+ * 元素个数从未超过 INLINE_COUNT 时不调用分配器，超出后申请的内存在 destroy 时全部归还
+ */
+#define INLINE_COUNT 16u
+#define INLINE_MAX   96u
+
+typedef struct {
+    uint32_t allocs;
+    size_t live_bytes;
+} counting_allocator_t;
+
+static hdata_ptr_t counting_alloc(void* ctx, size_t size)
+{
+    counting_allocator_t* counter = (counting_allocator_t*)ctx;
+    ++counter->allocs;
+    counter->live_bytes += size;
+    return malloc(size);
+}
+
+static void counting_free(void* ctx, hdata_ptr_t ptr, size_t size)
+{
+    counting_allocator_t* counter = (counting_allocator_t*)ctx;
+    counter->live_bytes -= size;
+    free(ptr);
+}
+
+typedef struct {
+    uint64_t values[INLINE_MAX];    /* hqueue 从队头起，hstack 从栈顶起 */
+    uint32_t size;
+    uint32_t visited;
+    bool mismatch;
+} inline_model_t;
+
+static bool inline_visit(hdata_ptr_t data, void* ctx)
+{
+    inline_model_t* model = (inline_model_t*)ctx;
+    if (model->visited >= model->size || *(uint64_t*)data != model->values[model->visited])
+        model->mismatch = true;
+    ++model->visited;
+    return true;
+}
+
+static int check_inline_queue(void)
+{
+    static inline_model_t model;
+    counting_allocator_t counter = {0, 0};
+    hallocator_t allocator = {counting_alloc, counting_free, &counter};
+    HLIBC_ALIGNAS(HARENA_ALIGN) uint8_t buffer[HQUEUE_INLINE_BUFFER_SIZE(sizeof(uint64_t), INLINE_COUNT)];
+    check_begin("hqueue inline");
+    memset(&model, 0, sizeof(model));
+
+    CHECK(hqueue_create_inline(buffer, HQUEUE_INLINE_STRUCT_SIZE - 1, sizeof(uint64_t), &allocator) == NULL);
+    hqueue_ptr_t queue = hqueue_create_inline(buffer, sizeof(buffer), sizeof(uint64_t), &allocator);
+    CHECK(queue != NULL);
+    uint32_t peak = 0;
+    for (uint32_t i = 0; i < s_rounds / 4; ++i) {
+        /* 前一半的规模不超过内联容量，后一半会溢出到分配器 */
+        uint32_t limit = i < s_rounds / 8 ? INLINE_COUNT : INLINE_MAX;
+        if (rnd(2) == 0 && model.size < limit) {
+            uint64_t value = ((uint64_t)i << 32) | rnd(0xFFFFFFFFu);
+            if (rnd(4) == 0) {
+                uint64_t* dest = (uint64_t*)hqueue_emplace(queue);
+                CHECK(dest != NULL);
+                *dest = value;
+            } else {
+                CHECK(hqueue_push(queue, &value, sizeof(value), NULL) == HLIB_OK);
+            }
+            model.values[model.size++] = value;
+        } else if (model.size != 0) {
+            CHECK(*(uint64_t*)hqueue_front(queue) == model.values[0]);
+            CHECK(hqueue_pop(queue) == HLIB_OK);
+            memmove(&model.values[0], &model.values[1], (model.size - 1) * sizeof(uint64_t));
+            --model.size;
+        }
+        if (model.size > peak) peak = model.size;
+        if (peak <= INLINE_COUNT) CHECK(counter.allocs == 0);
+        CHECK(hqueue_size(queue) == model.size);
+        model.visited = 0;
+        CHECK(hqueue_foreach(queue, inline_visit, &model) == model.size);
+        CHECK(!model.mismatch);
+    }
+    CHECK(peak > INLINE_COUNT && counter.allocs != 0);
+    hqueue_destroy(queue);
+    CHECK(counter.live_bytes == 0);
+    printf("ok\n");
+    return 1;
+}
+
+static int check_inline_stack(void)
+{
+    static inline_model_t model;
+    counting_allocator_t counter = {0, 0};
+    hallocator_t allocator = {counting_alloc, counting_free, &counter};
+    HLIBC_ALIGNAS(HARENA_ALIGN) uint8_t buffer[HSTACK_INLINE_BUFFER_SIZE(sizeof(uint64_t), INLINE_COUNT)];
+    check_begin("hstack inline");
+    memset(&model, 0, sizeof(model));
+
+    CHECK(hstack_create_inline(buffer, HSTACK_INLINE_STRUCT_SIZE - 1, sizeof(uint64_t), &allocator) == NULL);
+    hstack_ptr_t stack = hstack_create_inline(buffer, sizeof(buffer), sizeof(uint64_t), &allocator);
+    CHECK(stack != NULL);
+    CHECK(hstack_type_size(stack) == sizeof(uint64_t));
+    uint32_t peak = 0;
+    for (uint32_t i = 0; i < s_rounds / 4; ++i) {
+        uint32_t limit = i < s_rounds / 8 ? INLINE_COUNT : INLINE_MAX;
+        if (rnd(2) == 0 && model.size < limit) {
+            uint64_t value = ((uint64_t)i << 32) | rnd(0xFFFFFFFFu);
+            if (rnd(4) == 0) {
+                uint64_t* dest = (uint64_t*)hstack_emplace(stack);
+                CHECK(dest != NULL);
+                *dest = value;
+            } else {
+                CHECK(hstack_push(stack, &value, sizeof(value), NULL) == HLIB_OK);
+            }
+            memmove(&model.values[1], &model.values[0], model.size * sizeof(uint64_t));
+            model.values[0] = value;
+            ++model.size;
+        } else if (model.size != 0) {
+            CHECK(*(uint64_t*)hstack_top(stack) == model.values[0]);
+            CHECK(hstack_pop(stack) == HLIB_OK);
+            memmove(&model.values[0], &model.values[1], (model.size - 1) * sizeof(uint64_t));
+            --model.size;
+        }
+        if (model.size > peak) peak = model.size;
+        if (peak <= INLINE_COUNT) CHECK(counter.allocs == 0);
+        CHECK(hstack_size(stack) == model.size);
+        model.visited = 0;
+        CHECK(hstack_foreach(stack, inline_visit, &model) == model.size);
+        CHECK(!model.mismatch);
+    }
+    CHECK(peak > INLINE_COUNT && counter.allocs != 0);
+    hstack_destroy(stack);
+    CHECK(counter.live_bytes == 0);
+    printf("ok\n");
+    return 1;
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            s_rounds = 20000;
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            s_seed = strtoull(argv[++i], NULL, 0);
+            if (s_seed == 0) s_seed = 1;
+        } else {
+            fprintf(stderr, "usage: %s [--quick] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    /* 输出到管道时按行刷新，进程异常退出也能看到已完成的检查 */
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    int ok = 1;
+    printf("mode: %s, rounds: %u\n", HLIBC_USE_STATIC_ALLOC ? "static" : "dynamic", s_rounds);
+    ok &= check_btree();
+    ok &= check_lru();
+    ok &= check_timer_wheel();
+    ok &= check_ring();
+    ok &= check_pool();
+    ok &= check_list();
+#if HLIBC_USE_STATIC_ALLOC == 0
+    ok &= check_list_var();
+    ok &= check_inline_queue();
+    ok &= check_inline_stack();
+#endif
+    ok &= check_queue();
+    return ok ? 0 : 1;
+}